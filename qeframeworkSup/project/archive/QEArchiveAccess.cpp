@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2017-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2017-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andraz Pozar
@@ -214,6 +214,13 @@ int QEArchiveAccess::getNumberPVs ()
    return archiveManager ? archiveManager->getNumberPVs() : 0;
 }
 
+//------------------------------------------------------------------------------
+//
+int QEArchiveAccess::getPvNamesGeneration ()
+{
+   return archiveManager ? archiveManager->getPvNamesGeneration() : 0;
+}
+
 //------------------------------------------------------------------------------
 //
 QStringList QEArchiveAccess::getAllPvNames ()
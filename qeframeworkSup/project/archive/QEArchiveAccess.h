@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2017-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2017-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andraz Pozar
@@ -81,6 +81,12 @@ public:
    //
    static int getNumberPVs ();
 
+   // Incremented each time the set of available PV names changes, i.e. when
+   // names are added or cleared. Allows users of getAllPvNames to determine
+   // whether any previously obtained list of names is still current.
+   //
+   static int getPvNamesGeneration ();
+
    static QStringList getAllPvNames ();
 
    // Requests re-transmission of archive status.
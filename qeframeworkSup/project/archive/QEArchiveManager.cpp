@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2012-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2012-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Starritt
@@ -187,6 +187,7 @@ QEArchiveManager::QEArchiveManager (const QEArchiveAccess::ArchiverTypes archive
 {
    this->setSourceId (9001);
    this->allowPendingRequests = true;
+   this->pvNamesGeneration = 0;
 
    this->pvNameToSourceLookUp = new PVNameToSourceSpecLookUp ();
    this->timer = new QTimer (this);
@@ -471,6 +472,15 @@ int QEArchiveManager::getNumberPVs () const
    return this->pvNameToSourceLookUp->count();
 }
 
+//------------------------------------------------------------------------------
+//
+int QEArchiveManager::getPvNamesGeneration () const
+{
+   QMutexLocker locker (archiveDataMutex);
+
+   return this->pvNamesGeneration;
+}
+
 //------------------------------------------------------------------------------
 //
 QString QEArchiveManager::getPattern () const
@@ -544,6 +554,7 @@ void QEArchiveManager::clear ()
 {
    QMutexLocker locker (archiveDataMutex);
    this->pvNameToSourceLookUp->clear ();
+   this->pvNamesGeneration++;
    this->allowPendingRequests = true;
 }
 
@@ -892,6 +903,7 @@ void QEArchiveManager::processPvChannel (QEArchiveInterfaceManager* interfaceMan
       sourceSpec.interfaceManager = interfaceManager;
       sourceSpec.insert (keyTimeSpec);
       this->pvNameToSourceLookUp->insert (pvChannel.pvName, sourceSpec);
+      this->pvNamesGeneration++;
       return;
    }
 
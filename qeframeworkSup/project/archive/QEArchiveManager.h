@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2012-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2012-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andraz Pozar, Andrew Starritt
@@ -76,6 +76,7 @@ private:
 
    int getInterfaceCount () const;
    int getNumberPVs () const;
+   int getPvNamesGeneration () const;
    QString getPattern () const;
    QStringList getAllPvNames () const;   
    bool getArchivePvInformation (const QString& pvName,
@@ -106,6 +107,7 @@ private:
    const QEArchiveAccess::ArchiverTypes archiverType;
    QString pattern;
    bool allowPendingRequests;
+   int pvNamesGeneration;    // incremented whenever the set of PV names changes
    uint32_t lastReadTime;    // only need seconds past epoch here
    QTimer* timer;
 
@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2013-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2013-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Starritt
@@ -24,6 +24,9 @@ QEArchiveNameSearch::QEArchiveNameSearch (QWidget* parent) : QEFrame (parent)
 {
    this->archiveAccess = new QEArchiveAccess (this);
    this->delayedText = new QEDelayedText (0.25, this);
+   this->nameSearch = new QEPvNameSearchThread (this);
+   this->searchedGeneration = -1;
+   this->searchRequestId = 0;
    this->createInternalWidgets ();
 
    // Use standard context menu - start with full option set and remove
@@ -46,6 +49,9 @@ QEArchiveNameSearch::QEArchiveNameSearch (QWidget* parent) : QEFrame (parent)
 
    QObject::connect (this->listWidget, SIGNAL (itemSelectionChanged ()),
                      this,             SLOT   (itemSelectionChanged ()));
+
+   QObject::connect (this->nameSearch, SIGNAL (searchComplete (const int, const QStringList&, const bool)),
+                     this,             SLOT   (searchComplete (const int, const QStringList&, const bool)));
 }
 
 //------------------------------------------------------------------------------
@@ -61,11 +67,11 @@ void QEArchiveNameSearch::search ()
 {
    QString searchText;
    QStringList parts;
-   QStringList matchingNames;
 
    searchText = this->lineEdit->text ().trimmed ();
 
    if (searchText.isEmpty ()) {
+      this->searchRequestId = 0;   // discard any outstanding results
       this->listWidget->clear ();
       this->setReadOut ("There are no matching names");
       return;
@@ -77,35 +83,41 @@ void QEArchiveNameSearch::search ()
    // Spilt the patterns into parts.
    //
    parts = QEUtilities::split (searchText);
-   matchingNames.clear ();
-
-   QEPvNameSearch findNames (QEArchiveAccess::getAllPvNames ());
 
-   // Use each part to find a set of matching names, and then merge the list.
+   // Only (re-)supply the set of names when the archiver's set of names changes.
+   // The search thread retains its index of the names between searches.
    //
-   for (int p = 0; p < parts.count (); p++) {
-      QString part = parts.value (p);
-      QStringList partMatches;
-
-      // QEArchiveAccess ensures the list is sorted.
-      // Find nay names containing this string (and ignore case as well).
-      //
-      partMatches = findNames.getMatchingPvNames (part, Qt::CaseInsensitive);
-
-      // Now nmerge the lists.
-      //
-      matchingNames.append (partMatches);
-      matchingNames.sort ();
-      matchingNames.removeDuplicates ();
+   const int generation = QEArchiveAccess::getPvNamesGeneration ();
+   if (generation != this->searchedGeneration) {
+      this->nameSearch->setPvNameList (QEArchiveAccess::getAllPvNames ());
+      this->searchedGeneration = generation;
    }
 
+   // Find any names containing any of the parts (and ignore case as well).
+   // The search is performed on a background thread - see searchComplete.
+   //
+   this->searchRequestId = this->nameSearch->search (parts, Qt::CaseInsensitive,
+                                                     QEArchiveNameSearch::maximumNames);
+}
+
+//------------------------------------------------------------------------------
+// slot
+void QEArchiveNameSearch::searchComplete (const int requestId, const QStringList& matchingNames,
+                                          const bool isTruncated)
+{
+   // Ignore the results of superseded searches.
+   //
+   if (requestId != this->searchRequestId) return;
+
    // Use names to populate the list.
    //
    this->listWidget->clear ();
    this->listWidget->addItems (matchingNames);
 
    int n = matchingNames.count ();
-   if (n == 1) {
+   if (isTruncated) {
+      this->setReadOut (QString ("Showing the first %1 matching names").arg (n));
+   } else if (n == 1) {
       this->setReadOut ("There is 1 matching name");
    } else {
       this->setReadOut (QString ("There are %1 matching names").arg (n));
@@ -175,6 +187,7 @@ QStringList QEArchiveNameSearch::getSelectedNames () const
 //
 void QEArchiveNameSearch::clear ()
 {
+   this->searchRequestId = 0;   // discard any outstanding results
    this->lineEdit->setText ("");
    this->listWidget->clear ();
 }
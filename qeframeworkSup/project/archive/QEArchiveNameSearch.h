@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2013-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2013-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Starritt
@@ -30,6 +30,8 @@
 
 #include <QEArchiveManager.h>
 
+class QEPvNameSearchThread;   // differed
+
 
 /// This is a non EPICS aware widget.
 /// It provides a simple user means to find archived PV names.
@@ -60,8 +62,15 @@ private:
    void search ();
    void setReadOut (const QString& text);
 
+   // Limit on the number of names listed.
+   //
+   static const int maximumNames = 10000;
+
    QEArchiveAccess *archiveAccess;
    QEDelayedText* delayedText;
+   QEPvNameSearchThread* nameSearch;   // searches on a background thread
+   int searchedGeneration;             // archive names generation given to nameSearch
+   int searchRequestId;                // latest request
 
    // Internal widgets.
    //
@@ -76,6 +85,8 @@ private slots:
    void textEdited (const QString &);
    void searchReturnPressed ();
    void itemSelectionChanged ();
+   void searchComplete (const int requestId, const QStringList& names,
+                        const bool isTruncated);
 };
 
 #endif  // QE_ARCHIVE_NAME_SEARCH_H
@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2013-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2013-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Starritt
@@ -12,8 +12,16 @@
  */
 
 #include "QEExpressionEvaluation.h"
+#include <ctype.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <QByteArray>
 #include <QDebug>
+#include <QtNumeric>
+#include <QEAdaptationParameters.h>
 #include <QECommon.h>
+#include <QEPlatform.h>
 #include <postfix.h>   // out of EPICS
 
 #define DEBUG  qDebug () << "QEExpressionEvaluation" << __LINE__ << __FUNCTION__ << "  "
@@ -25,6 +33,9 @@ QEExpressionEvaluation::QEExpressionEvaluation (const int numberOfInputsIn,
    numberOfInputs (numberOfInputsIn),
    allowPrimedInput (allowPrimedInputIn)
 {
+   this->stackDepth = 0;
+   this->compiled = false;
+
    // We are erroneous until Postfix called.
    //
    this->initialise ("");
@@ -43,6 +54,10 @@ bool QEExpressionEvaluation::initialise (const QString& expression)
 {
    QString translated;
 
+   this->operations.clear ();
+   this->stackDepth = 0;
+   this->compiled = false;
+
    // Tooo big ?
    //
    if (expression.length() > MaxInfixSize) {
@@ -58,11 +73,24 @@ bool QEExpressionEvaluation::initialise (const QString& expression)
 
    // Now apply map
    //
+   // Note: the Latin1 byte array must outlive the postfix call.
+   //
    short error;
-   const char* pinfix = translated.toLatin1 ().data ();
-   const long status = postfix (pinfix, this->postFix, &error);
+   const QByteArray infix = translated.toLatin1 ();
+   const long status = postfix (infix.constData (), this->postFix, &error);
    this->calcError = QString (calcErrorStr (error));
 
+   // Only attempt to compile valid expressions, and only use the compiled
+   // expression if it yields the same results as calcPerform.
+   //
+   if ((status == 0) && QEExpressionEvaluation::isEnabled ()) {
+      this->compiled = this->compile (translated) && this->verify ();
+      if (!this->compiled) {
+         this->operations.clear ();
+         this->stackDepth = 0;
+      }
+   }
+
    return (status == 0);
 }
 
@@ -78,6 +106,19 @@ void QEExpressionEvaluation::clear (CalculateArguments& userArgs)
    }
 }
 
+//---------------------------------------------------------------------------------
+// static
+void QEExpressionEvaluation::clear (ArrayArguments& userArgs)
+{
+   int i, j;
+   for (i = 0; i < ARRAY_LENGTH (userArgs); i++) {
+      for (j = 0; j < ARRAY_LENGTH (userArgs [i]); j++) {
+         userArgs [i][j].data = NULL;
+         userArgs [i][j].value = 0.0;
+      }
+   }
+}
+
 //---------------------------------------------------------------------------------
 //
 int QEExpressionEvaluation::indexOf (const char c)
@@ -127,6 +168,57 @@ double QEExpressionEvaluation::evaluate (const CalculateArguments& userArgs, boo
    return result;
 }
 
+//---------------------------------------------------------------------------------
+//
+bool QEExpressionEvaluation::evaluate (const ArrayArguments& userArgs, const int number,
+                                       double* results) const
+{
+   if (number <= 0) return true;
+
+   if (this->compiled) {
+      this->evaluateCompiled (userArgs, number, results);
+      return true;
+   }
+
+   // Fall back to calcPerform for each element. Resolve the argument sources once.
+   //
+   const ArrayArgument* sources [CALCPERFORM_NARGS];
+   double args [CALCPERFORM_NARGS];
+   int j;
+
+   for (j = 0; j < ARRAY_LENGTH (sources); j++) {
+      sources [j] = NULL;
+      if (this->argumentMap.contains (j)) {
+         const int u = this->argumentMap.value (j);
+         if (u >= 0 && u < 2*NumberUserArguments) {
+            sources [j] = &userArgs [u / NumberUserArguments] [u % NumberUserArguments];
+         }
+      }
+   }
+
+   bool allOkay = true;
+   for (int i = 0; i < number; i++) {
+      for (j = 0; j < ARRAY_LENGTH (args); j++) {
+         const ArrayArgument* source = sources [j];
+         if (source) {
+            args [j] = source->data ? source->data [i] : source->value;
+         } else {
+            args [j] = 0.0;
+         }
+      }
+
+      double result = 0.0;
+      const long status = calcPerform (args, &result, this->postFix);
+      if (status != 0) {
+         result = qQNaN ();
+         allOkay = false;
+      }
+      results [i] = result;
+   }
+
+   return allOkay;
+}
+
 //---------------------------------------------------------------------------------
 // Looks for and collates single input letters A .. Z and A' .. Z'  and maps
 // these onto A .. L.
@@ -219,4 +311,528 @@ bool QEExpressionEvaluation::buildMaps (const QString& expression, QString& tran
    return true;
 }
 
+//=================================================================================
+// Expression compiler.
+//=================================================================================
+//
+// Single argument functions - as per calcPerform.
+//
+static double fnAbs   (double x) { return fabs (x); }
+static double fnSqrt  (double x) { return sqrt (x); }
+static double fnExp   (double x) { return exp (x); }
+static double fnLog   (double x) { return log10 (x); }
+static double fnLn    (double x) { return log (x); }
+static double fnSin   (double x) { return sin (x); }
+static double fnCos   (double x) { return cos (x); }
+static double fnTan   (double x) { return tan (x); }
+static double fnAsin  (double x) { return asin (x); }
+static double fnAcos  (double x) { return acos (x); }
+static double fnAtan  (double x) { return atan (x); }
+static double fnSinh  (double x) { return sinh (x); }
+static double fnCosh  (double x) { return cosh (x); }
+static double fnTanh  (double x) { return tanh (x); }
+static double fnCeil  (double x) { return ceil (x); }
+static double fnFloor (double x) { return floor (x); }
+
+struct FunctionSpecifications {
+   const char* name;
+   double (*function) (double);
+};
+
+static const FunctionSpecifications functionList [] = {
+   { "ABS",   fnAbs   },  { "SQR",   fnSqrt  },  { "SQRT",  fnSqrt  },
+   { "EXP",   fnExp   },  { "LOG",   fnLog   },  { "LOGE",  fnLn    },
+   { "LN",    fnLn    },  { "SIN",   fnSin   },  { "COS",   fnCos   },
+   { "TAN",   fnTan   },  { "ASIN",  fnAsin  },  { "ACOS",  fnAcos  },
+   { "ATAN",  fnAtan  },  { "SINH",  fnSinh  },  { "COSH",  fnCosh  },
+   { "TANH",  fnTanh  },  { "CEIL",  fnCeil  },  { "FLOOR", fnFloor }
+};
+
+// As per calcPerform.
+//
+#define CALC_PI  3.14159265358979323
+
+//---------------------------------------------------------------------------------
+// A recursive descent parser for the supported subset of the CALC syntax. The
+// operator precedence and associativity follow that of the postfix function,
+// i.e. in increasing order:
+//    comparisons:  <  <=  >  >=  =  ==  !=  #
+//    additive:     +  -
+//    multiplicative: *  /
+//    power:        ^  **     (left associative as per postfix)
+//    unary minus             (binds tighter than power, e.g. -A^2 is (-A)^2)
+// Any other syntax, e.g. the conditional, logical and bit-wise operators, or
+// the multi-argument functions, causes the compilation to fail.
+//
+class QEExpressionEvaluation::Compiler {
+public:
+   explicit Compiler (const QByteArray& infix, const ArgumentMaps& argumentMap);
+
+   bool compile (QVector<Operation>& operations, int& stackDepth);
+
+private:
+   bool parseComparison ();
+   bool parseAdditive ();
+   bool parseTerm ();
+   bool parsePower ();
+   bool parseUnary ();
+   bool parsePrimary ();
+
+   void skipSpace ();
+   bool match (const char* token);
+   char peek (const int offset) const;
+   void emit (const OpCodes code, const int kind = 0, const int letter = 0,
+              const double value = 0.0, Function function = NULL);
+
+   const QByteArray infix;
+   const ArgumentMaps& argumentMap;
+   int pos;
+   int depth;
+   int maxDepth;
+   QVector<Operation> code;
+};
+
+//---------------------------------------------------------------------------------
+//
+QEExpressionEvaluation::Compiler::Compiler (const QByteArray& infixIn,
+                                            const ArgumentMaps& argumentMapIn) :
+   infix (infixIn),
+   argumentMap (argumentMapIn)
+{
+   this->pos = 0;
+   this->depth = 0;
+   this->maxDepth = 0;
+}
+
+//---------------------------------------------------------------------------------
+//
+bool QEExpressionEvaluation::Compiler::compile (QVector<Operation>& operations,
+                                                int& stackDepth)
+{
+   if (!this->parseComparison ()) return false;
+
+   // We must have consumed the whole expression.
+   //
+   this->skipSpace ();
+   if (this->pos != this->infix.length ()) return false;
+   if (this->depth != 1) return false;   // belts 'n' braces
+
+   operations = this->code;
+   stackDepth = this->maxDepth;
+   return true;
+}
+
+//---------------------------------------------------------------------------------
+//
+bool QEExpressionEvaluation::Compiler::parseComparison ()
+{
+   if (!this->parseAdditive ()) return false;
+
+   while (true) {
+      OpCodes op;
+
+      // Exclude the shift operators << and >>.
+      //
+      if (this->match ("<<") || this->match (">>")) return false;
+
+      if      (this->match ("<="))  op = opLessOrEqual;
+      else if (this->match (">="))  op = opGreaterOrEqual;
+      else if (this->match ("=="))  op = opEqual;
+      else if (this->match ("!="))  op = opNotEqual;
+      else if (this->match ("<"))   op = opLess;
+      else if (this->match (">"))   op = opGreater;
+      else if (this->match ("="))   op = opEqual;
+      else if (this->match ("#"))   op = opNotEqual;
+      else break;
+
+      if (!this->parseAdditive ()) return false;
+      this->emit (op);
+   }
+   return true;
+}
+
+//---------------------------------------------------------------------------------
+//
+bool QEExpressionEvaluation::Compiler::parseAdditive ()
+{
+   if (!this->parseTerm ()) return false;
+
+   while (true) {
+      OpCodes op;
+      if      (this->match ("+"))  op = opAdd;
+      else if (this->match ("-"))  op = opSubtract;
+      else break;
+
+      if (!this->parseTerm ()) return false;
+      this->emit (op);
+   }
+   return true;
+}
+
+//---------------------------------------------------------------------------------
+//
+bool QEExpressionEvaluation::Compiler::parseTerm ()
+{
+   if (!this->parsePower ()) return false;
+
+   while (true) {
+      OpCodes op;
+      this->skipSpace ();
+      if (this->peek (0) == '*' && this->peek (1) == '*') break;   // belts 'n' braces
+
+      if      (this->match ("*"))  op = opMultiply;
+      else if (this->match ("/"))  op = opDivide;
+      else break;
+
+      if (!this->parsePower ()) return false;
+      this->emit (op);
+   }
+   return true;
+}
+
+//---------------------------------------------------------------------------------
+//
+bool QEExpressionEvaluation::Compiler::parsePower ()
+{
+   if (!this->parseUnary ()) return false;
+
+   while (this->match ("^") || this->match ("**")) {
+      if (!this->parseUnary ()) return false;
+      this->emit (opPower);
+   }
+   return true;
+}
+
+//---------------------------------------------------------------------------------
+//
+bool QEExpressionEvaluation::Compiler::parseUnary ()
+{
+   if (this->match ("-")) {
+      if (!this->parseUnary ()) return false;
+      this->emit (opNegate);
+      return true;
+   }
+   return this->parsePrimary ();
+}
+
+//---------------------------------------------------------------------------------
+//
+bool QEExpressionEvaluation::Compiler::parsePrimary ()
+{
+   this->skipSpace ();
+   const char c = this->peek (0);
+
+   if (c == '(') {
+      this->pos++;
+      if (!this->parseComparison ()) return false;
+      return this->match (")");
+   }
+
+   if ((c >= '0' && c <= '9') || c == '.') {
+      // Exclude hexadecimal literals.
+      //
+      if (c == '0' && (this->peek (1) == 'x' || this->peek (1) == 'X')) return false;
+
+      const char* start = this->infix.constData () + this->pos;
+      char* end = NULL;
+      const double value = strtod (start, &end);
+      if (end == start) return false;
+      this->pos += int (end - start);
+
+      const char n = this->peek (0);
+      if (isalnum ((unsigned char) n) || n == '.' || n == '_') return false;
+
+      this->emit (opConstant, 0, 0, value);
+      return true;
+   }
+
+   // Note: the ctype functions require an unsigned char value (or EOF), and the
+   // Latin-1 infix may contain characters above 0x7F.
+   //
+   if (isalpha ((unsigned char) c)) {
+      int length = 0;
+      while (isalnum ((unsigned char) this->peek (length)) || this->peek (length) == '_') length++;
+      const QByteArray name = this->infix.mid (this->pos, length).toUpper ();
+      this->pos += length;
+
+      // Input argument - the translated expression only uses A .. L.
+      //
+      if (name.length () == 1) {
+         const int p = name.at (0) - 'A';
+         if (p < 0 || p >= CALCPERFORM_NARGS) return false;
+         if (!this->argumentMap.contains (p)) return false;
+
+         const int u = this->argumentMap.value (p);
+         if (u < 0 || u >= 2*NumberUserArguments) return false;
+         this->emit (opArgument, u / NumberUserArguments, u % NumberUserArguments);
+         return true;
+      }
+
+      if (name == "PI")  { this->emit (opConstant, 0, 0, CALC_PI);          return true; }
+      if (name == "D2R") { this->emit (opConstant, 0, 0, CALC_PI / 180.0); return true; }
+      if (name == "R2D") { this->emit (opConstant, 0, 0, 180.0 / CALC_PI); return true; }
+
+      for (int j = 0; j < ARRAY_LENGTH (functionList); j++) {
+         if (name == functionList [j].name) {
+            if (!this->match ("(")) return false;
+            if (!this->parseComparison ()) return false;
+            if (!this->match (")")) return false;
+            this->emit (opFunction, 0, 0, 0.0, functionList [j].function);
+            return true;
+         }
+      }
+   }
+
+   return false;   // not supported
+}
+
+//---------------------------------------------------------------------------------
+//
+void QEExpressionEvaluation::Compiler::skipSpace ()
+{
+   while (this->pos < this->infix.length () && isspace ((unsigned char) this->infix.at (this->pos))) {
+      this->pos++;
+   }
+}
+
+//---------------------------------------------------------------------------------
+//
+bool QEExpressionEvaluation::Compiler::match (const char* token)
+{
+   this->skipSpace ();
+
+   const int length = int (strlen (token));
+   if (strncmp (this->infix.constData () + this->pos, token, length) != 0) return false;
+
+   this->pos += length;
+   return true;
+}
+
+//---------------------------------------------------------------------------------
+//
+char QEExpressionEvaluation::Compiler::peek (const int offset) const
+{
+   const int index = this->pos + offset;
+   return (index < this->infix.length ()) ? this->infix.at (index) : '\0';
+}
+
+//---------------------------------------------------------------------------------
+//
+void QEExpressionEvaluation::Compiler::emit (const OpCodes opCode, const int kind,
+                                             const int letter, const double value,
+                                             Function function)
+{
+   Operation op;
+   op.code = opCode;
+   op.kind = kind;
+   op.letter = letter;
+   op.value = value;
+   op.function = function;
+   this->code.append (op);
+
+   // Track the required stack depth.
+   //
+   switch (opCode) {
+      case opArgument:
+      case opConstant:
+         this->depth++;
+         this->maxDepth = MAX (this->maxDepth, this->depth);
+         break;
+
+      case opNegate:
+      case opFunction:
+         break;
+
+      default:
+         this->depth--;   // binary operators
+         break;
+   }
+}
+
+//---------------------------------------------------------------------------------
+// static
+bool QEExpressionEvaluation::isEnabled ()
+{
+   static bool determined = false;
+   static bool enabled = true;
+
+   if (!determined) {
+      QEAdaptationParameters ap ("QE_");
+      enabled = !ap.getBool ("disable_compiled_expressions");  // default is false
+      determined = true;
+   }
+   return enabled;
+}
+
+//---------------------------------------------------------------------------------
+//
+bool QEExpressionEvaluation::compile (const QString& translated)
+{
+   Compiler compiler (translated.toLatin1 (), this->argumentMap);
+   return compiler.compile (this->operations, this->stackDepth);
+}
+
+//---------------------------------------------------------------------------------
+// Evaluates the compiled expression and calcPerform for a set of probe values,
+// and checks the results are bit-identical (or both NaN).
+//
+bool QEExpressionEvaluation::verify () const
+{
+   static const double probeValues [] = {
+      0.0, 1.0, -1.0, 2.0, 0.5, -0.25, 3.0, -7.5, 10.0, 1.0e-3, -1.0e6,
+      0.1, 45.0, -90.0, 1.0e300, qQNaN (), qInf ()
+   };
+
+   const int numberOfValues = ARRAY_LENGTH (probeValues);
+
+   double probes [CALCPERFORM_NARGS][NumberOfProbes];
+   ArrayArguments userArgs;
+   int p;
+   int i;
+
+   QEExpressionEvaluation::clear (userArgs);
+   for (p = 0; p < CALCPERFORM_NARGS; p++) {
+      for (i = 0; i < NumberOfProbes; i++) {
+         probes [p][i] = probeValues [(i * (2*p + 1) + 3*p) % numberOfValues];
+      }
+
+      if (this->argumentMap.contains (p)) {
+         const int u = this->argumentMap.value (p);
+         if (u < 0 || u >= 2*NumberUserArguments) return false;
+         userArgs [u / NumberUserArguments][u % NumberUserArguments].data = probes [p];
+      }
+   }
+
+   double results [NumberOfProbes];
+   this->evaluateCompiled (userArgs, NumberOfProbes, results);
+
+   for (i = 0; i < NumberOfProbes; i++) {
+      double args [CALCPERFORM_NARGS];
+      for (p = 0; p < CALCPERFORM_NARGS; p++) {
+         args [p] = probes [p][i];
+      }
+
+      double expected = 0.0;
+      const long status = calcPerform (args, &expected, this->postFix);
+      if (status != 0) return false;
+
+      if (QEPlatform::isNaN (expected) && QEPlatform::isNaN (results [i])) continue;
+      if (memcmp (&expected, &results [i], sizeof (double)) != 0) return false;
+   }
+
+   return true;
+}
+
+//---------------------------------------------------------------------------------
+// Each operation is applied to a block of elements at a time. The inner loops
+// are simple enough for the compiler to vectorise (functions excepted).
+//
+void QEExpressionEvaluation::evaluateCompiled (const ArrayArguments& userArgs,
+                                               const int number,
+                                               double* results) const
+{
+   QVector<double> workspace (this->stackDepth * BlockSize);
+   double* stack = workspace.data ();
+   const Operation* ops = this->operations.constData ();
+   const int numberOfOps = this->operations.count ();
+
+   for (int base = 0; base < number; base += BlockSize) {
+      const int n = MIN (BlockSize, number - base);
+      int sp = -1;    // stack pointer - empty
+      int i;
+
+      for (int k = 0; k < numberOfOps; k++) {
+         const Operation& op = ops [k];
+
+         // Binary operations pop the y operand and leave the result in x, the
+         // new top of stack; the load operations push a new top of stack.
+         //
+         const double* y = NULL;
+         if (op.code >= opAdd && op.code <= opGreaterOrEqual) {
+            y = stack + sp * BlockSize;
+            sp--;
+         } else if (op.code == opArgument || op.code == opConstant) {
+            sp++;
+         }
+         double* x = stack + sp * BlockSize;
+
+         switch (op.code) {
+            case opArgument:
+               {
+                  const ArrayArgument& arg = userArgs [op.kind][op.letter];
+                  if (arg.data) {
+                     const double* data = arg.data + base;
+                     for (i = 0; i < n; i++) x [i] = data [i];
+                  } else {
+                     const double value = arg.value;
+                     for (i = 0; i < n; i++) x [i] = value;
+                  }
+               }
+               break;
+
+            case opConstant:
+               for (i = 0; i < n; i++) x [i] = op.value;
+               break;
+
+            case opNegate:
+               for (i = 0; i < n; i++) x [i] = -x [i];
+               break;
+
+            case opAdd:
+               for (i = 0; i < n; i++) x [i] = x [i] + y [i];
+               break;
+
+            case opSubtract:
+               for (i = 0; i < n; i++) x [i] = x [i] - y [i];
+               break;
+
+            case opMultiply:
+               for (i = 0; i < n; i++) x [i] = x [i] * y [i];
+               break;
+
+            case opDivide:
+               for (i = 0; i < n; i++) x [i] = x [i] / y [i];
+               break;
+
+            case opPower:
+               for (i = 0; i < n; i++) x [i] = pow (x [i], y [i]);
+               break;
+
+            case opEqual:
+               for (i = 0; i < n; i++) x [i] = (x [i] == y [i]) ? 1.0 : 0.0;
+               break;
+
+            case opNotEqual:
+               for (i = 0; i < n; i++) x [i] = (x [i] != y [i]) ? 1.0 : 0.0;
+               break;
+
+            case opLess:
+               for (i = 0; i < n; i++) x [i] = (x [i] < y [i]) ? 1.0 : 0.0;
+               break;
+
+            case opLessOrEqual:
+               for (i = 0; i < n; i++) x [i] = (x [i] <= y [i]) ? 1.0 : 0.0;
+               break;
+
+            case opGreater:
+               for (i = 0; i < n; i++) x [i] = (x [i] > y [i]) ? 1.0 : 0.0;
+               break;
+
+            case opGreaterOrEqual:
+               for (i = 0; i < n; i++) x [i] = (x [i] >= y [i]) ? 1.0 : 0.0;
+               break;
+
+            case opFunction:
+               for (i = 0; i < n; i++) x [i] = op.function (x [i]);
+               break;
+         }
+      }
+
+      // The result is the one and only item on the stack.
+      //
+      double* target = results + base;
+      for (i = 0; i < n; i++) target [i] = stack [i];
+   }
+}
+
 // end
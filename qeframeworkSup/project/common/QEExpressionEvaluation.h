@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2013-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2013-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Starritt
@@ -16,6 +16,7 @@
 
 #include <QHash>
 #include <QString>
+#include <QVector>
 #include <QEFrameworkLibraryGlobal.h>
 
 //---------------------------------------------------------------------------------
@@ -50,6 +51,16 @@
 /// of the CALC field, but may use the full 100 characters allowed by the
 /// underlying postfix function.
 ///
+/// For array evaluation, the expression is also compiled into a sequence of
+/// typed operations that are applied to blocks of elements at a time, as opposed
+/// to interpreting the postfix code once per element. Only a commonly used subset
+/// of the CALC syntax is compiled (arithmetic, comparisons, the standard single
+/// argument functions and PI, D2R and R2D). The compiled code is checked against
+/// calcPerform using a set of probe values when initialised; any other expression,
+/// or any discrepancy, and array evaluation reverts to calcPerform per element.
+/// Compilation may be disabled by defining the QE_DISABLE_COMPILED_EXPRESSIONS
+/// environment variable, or equivalent adaptation parameter, as true.
+///
 /// Acknowledgements:
 /// QEExpressionEvaluation is a direct crib of TCalculate out of the Delphi OPI framework.
 /// The postfix and calcPerform functions were written by Bob Dalesio (12-12-86).
@@ -76,11 +87,74 @@ public:
    static void clear (CalculateArguments& userArgs);
    static int indexOf (const char c);
 
+   // Array evaluation. Each user argument is either an array of values or, when
+   // data is NULL, a single value that applies to all elements.
+   //
+   struct ArrayArgument {
+      const double* data;
+      double value;
+   };
+
+   typedef ArrayArgument ArrayArguments [NumberInputKinds][NumberUserArguments];
+
+   static void clear (ArrayArguments& userArgs);
+
+   // Evaluates the expression for number elements, writing the results to the
+   // results array. Each data array must have at least number elements.
+   // Returns true if all evaluations okay; the result of any evaluation that
+   // is not okay is set to NaN.
+   //
+   bool evaluate (const ArrayArguments& userArgs, const int number,
+                  double* results) const;
+
+   // Indicates if array evaluation uses the compiled expression.
+   //
+   bool isCompiled () const { return this->compiled; }
+
 private:
    const int numberOfInputs;
    const bool allowPrimedInput;
    bool buildMaps (const QString& expression, QString& translated);
 
+   // Compiled expression operations - a stack machine.
+   //
+   enum OpCodes {
+      opArgument, opConstant, opNegate,
+      opAdd, opSubtract, opMultiply, opDivide, opPower,
+      opEqual, opNotEqual, opLess, opLessOrEqual, opGreater, opGreaterOrEqual,
+      opFunction
+   };
+
+   typedef double (*Function) (double);
+
+   struct Operation {
+      OpCodes code;
+      int kind;                  // opArgument only
+      int letter;                // opArgument only
+      double value;              // opConstant only
+      Function function;         // opFunction only
+   };
+
+   class Compiler;               // defined in the cpp file
+   friend class Compiler;
+
+   static bool isEnabled ();
+
+   bool compile (const QString& translated);
+   bool verify () const;
+   void evaluateCompiled (const ArrayArguments& userArgs, const int number,
+                          double* results) const;
+
+   // Number of elements processed by each compiled operation at a time, and
+   // number of probes used to verify the compiled expression.
+   //
+   static const int BlockSize = 256;
+   static const int NumberOfProbes = 64;
+
+   QVector<Operation> operations;
+   int stackDepth;
+   bool compiled;
+
    static const int MaxInfixSize = 100;
 
    // This is the value from the INFIX_TO_POSTFIX_SIZE macro from postfix.h
@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2013-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2013-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Starritt
@@ -22,6 +22,9 @@
 #include <qevent.h>       // QEvent maps to qcoreevent.h, not qevent.h
 #include <qwt_scale_engine.h>
 #include <qwt_scale_widget.h>
+#if QWT_VERSION >= 0x060000
+#include <qwt_series_data.h>
+#endif
 
 #include <QECommon.h>
 #include <QEScaling.h>
@@ -37,6 +40,17 @@
 
 #define NUMBER_TRANISTION_STEPS   6
 
+// Default QwtPlotCurve z is 20, markers are 30.
+//
+static const double markupCurveZ = 25.0;
+
+// User and own curves are re-used and so the attach order no longer reflects
+// the plot order. Each curve is given a z value, from the default upwards, in
+// the order plotted since the last releaseCurves.
+//
+static const double userCurveZ = 20.0;
+static const double userCurveZStep = 1.0e-6;
+
 
 //==============================================================================
 // QEGraphicOwnPlot class
@@ -86,6 +100,133 @@ void QEGraphic::OwnPlot::drawCanvas (QPainter* painter)
    }
 }
 
+#if QWT_VERSION >= 0x060000
+//==============================================================================
+// QEGraphic::SeriesData class
+//==============================================================================
+// Presents a pair of x/y data vectors to a QwtPlotCurve without copying them.
+// The vectors are implicitly shared with the caller, and the real world/log
+// scaling is applied as each sample is requested by the curve, so this always
+// reflects the current axis scale and offset.
+//
+class QEGraphic::SeriesData : public QwtSeriesData<QPointF> {
+public:
+   explicit SeriesData (const QEGraphicNames::DoubleVector& xData,
+                        const QEGraphicNames::DoubleVector& yData,
+                        const QEGraphic::Axis* xAxis,
+                        const QEGraphic::Axis* yAxis);
+   ~SeriesData ();
+
+   size_t size () const;
+   QPointF sample (size_t i) const;
+   QRectF boundingRect () const;
+
+private:
+   static void findRange (const double* values, const int number,
+                          double& min, double& max);
+
+   const QEGraphicNames::DoubleVector xData;
+   const QEGraphicNames::DoubleVector yData;
+   const int number;
+   const QEGraphic::Axis* xAxis;
+   const QEGraphic::Axis* yAxis;
+
+   // The unscaled data extent - determined when first required.
+   //
+   mutable bool rangeIsDefined;
+   mutable double xMin;
+   mutable double xMax;
+   mutable double yMin;
+   mutable double yMax;
+};
+
+//------------------------------------------------------------------------------
+//
+QEGraphic::SeriesData::SeriesData (const QEGraphicNames::DoubleVector& xDataIn,
+                                   const QEGraphicNames::DoubleVector& yDataIn,
+                                   const QEGraphic::Axis* xAxisIn,
+                                   const QEGraphic::Axis* yAxisIn) :
+   QwtSeriesData<QPointF> (),
+   xData (xDataIn),
+   yData (yDataIn),
+   number (MIN (xDataIn.size (), yDataIn.size ())),
+   xAxis (xAxisIn),
+   yAxis (yAxisIn)
+{
+   this->rangeIsDefined = false;
+   this->xMin = this->xMax = 0.0;
+   this->yMin = this->yMax = 0.0;
+}
+
+//------------------------------------------------------------------------------
+//
+QEGraphic::SeriesData::~SeriesData () { }
+
+//------------------------------------------------------------------------------
+//
+size_t QEGraphic::SeriesData::size () const
+{
+   return this->number;
+}
+
+//------------------------------------------------------------------------------
+//
+QPointF QEGraphic::SeriesData::sample (size_t i) const
+{
+   return QPointF (this->xAxis->scaleValue (this->xData.constData () [i]),
+                   this->yAxis->scaleValue (this->yData.constData () [i]));
+}
+
+//------------------------------------------------------------------------------
+//
+QRectF QEGraphic::SeriesData::boundingRect () const
+{
+   if (!this->rangeIsDefined) {
+      SeriesData::findRange (this->xData.constData (), this->number, this->xMin, this->xMax);
+      SeriesData::findRange (this->yData.constData (), this->number, this->yMin, this->yMax);
+      this->rangeIsDefined = true;
+   }
+
+   // Same as qwt's invalid rectangle.
+   //
+   if ((this->xMin > this->xMax) || (this->yMin > this->yMax)) {
+      return QRectF (1.0, 1.0, -2.0, -2.0);
+   }
+
+   // Scaling is monotonic (although may be decreasing if scale is negative),
+   // so we need only scale the extremities.
+   //
+   const double x1 = this->xAxis->scaleValue (this->xMin);
+   const double x2 = this->xAxis->scaleValue (this->xMax);
+   const double y1 = this->yAxis->scaleValue (this->yMin);
+   const double y2 = this->yAxis->scaleValue (this->yMax);
+
+   return QRectF (MIN (x1, x2), MIN (y1, y2), ABS (x2 - x1), ABS (y2 - y1));
+}
+
+//------------------------------------------------------------------------------
+// static
+void QEGraphic::SeriesData::findRange (const double* values, const int number,
+                                       double& min, double& max)
+{
+   // Start with an undefined range (min > max), and ignore any NaN values.
+   //
+   min = +1.0;
+   max = -1.0;
+   for (int j = 0; j < number; j++) {
+      const double v = values [j];
+      if (QEPlatform::isNaN (v)) continue;
+      if (min > max) {
+         min = max = v;
+      } else {
+         if (v < min) min = v;
+         if (v > max) max = v;
+      }
+   }
+}
+
+#endif  // QWT_VERSION >= 0x060000
+
 //==============================================================================
 // QEGraphic::Axis class
 //==============================================================================
@@ -454,6 +595,7 @@ void QEGraphic::construct ()
    // Set defaults.
    //
    this->rightButtonIsPressed = false;
+   this->curvePlotOrder = 0;
 
    this->pen = QPen (QColor (0, 0, 0, 255));  // black
    // go with default brush for now.
@@ -490,6 +632,8 @@ QEGraphic::~QEGraphic ()
    // cause a segmentation fault when the associated QwtPolot object is deleted.
    //
    this->releaseCurves ();
+   this->trimCurveSet (this->userCurveSet);
+   this->trimCurveSet (this->markupCurveSet);
 
    if (this->plotGrid) {
       this->plotGrid->detach();
@@ -837,6 +981,35 @@ void QEGraphic::releaseCurveList (CurveLists& list)
    list.clear ();
 }
 
+//------------------------------------------------------------------------------
+//
+void QEGraphic::releaseCurveSet (CurveSets& set)
+{
+   // Just hide the curves - these are re-used by the next plot.
+   //
+   for (int j = 0; j < set.curves.size (); j++) {
+      QwtPlotCurve* curve = set.curves.value (j);
+      if (curve) curve->setVisible (false);
+   }
+   set.inUse = 0;
+}
+
+//------------------------------------------------------------------------------
+//
+void QEGraphic::trimCurveSet (CurveSets& set)
+{
+   // Delete any curves not re-used since the last release. This also drops
+   // the references to the now unused data.
+   //
+   while (set.curves.size () > set.inUse) {
+      QwtPlotCurve* curve = set.curves.takeLast ();
+      if (curve) {
+         curve->detach ();
+         delete curve;
+      }
+   }
+}
+
 //------------------------------------------------------------------------------
 //
 void QEGraphic::releaseTextItemList (TextItemLists& list)
@@ -849,9 +1022,11 @@ void QEGraphic::releaseTextItemList (TextItemLists& list)
 //
 void QEGraphic::releaseCurves ()
 {
-   this->releaseCurveList (this->userCurveList);
-   this->releaseCurveList (this->markupCurveList);
+   this->releaseCurveSet (this->userCurveSet);
+   this->releaseCurveSet (this->markupCurveSet);
+   this->releaseCurveList (this->ownCurveList);
    this->releaseTextItemList (this->textItemList);
+   this->curvePlotOrder = 0;
 }
 
 //------------------------------------------------------------------------------
@@ -860,13 +1035,15 @@ void QEGraphic::attchOwnCurve (QwtPlotCurve* curve)
 {
    if (curve) {
       curve->attach (this->plot);
-      this->userCurveList.append (curve);
+      curve->setZ (userCurveZ + userCurveZStep * this->curvePlotOrder++);
+      this->ownCurveList.append (curve);
    }
 }
 
 //------------------------------------------------------------------------------
 //
-QwtPlotCurve* QEGraphic::createCurveData (const QEGraphicNames::DoubleVector& xData,
+QwtPlotCurve* QEGraphic::updateCurveData (CurveSets& set,
+                                          const QEGraphicNames::DoubleVector& xData,
                                           const QEGraphicNames::DoubleVector& yData,
                                           const QwtPlot::Axis selectedYAxis)
 {
@@ -874,10 +1051,18 @@ QwtPlotCurve* QEGraphic::createCurveData (const QEGraphicNames::DoubleVector& xD
 
    if (curveLength <= 1) return NULL;  // sainity check
 
-   QwtPlotCurve* curve;
-   QEGraphicNames::DoubleVector useXData;
-   QEGraphicNames::DoubleVector useYData;
-   curve = new QwtPlotCurve ();
+   // Re-use the next unused curve if we can, otherwise allocate a new curve
+   // and attach it to the plot object.
+   //
+   QwtPlotCurve* curve = NULL;
+   if (set.inUse < set.curves.size ()) {
+      curve = set.curves.value (set.inUse);
+   } else {
+      curve = new QwtPlotCurve ();
+      curve->attach (this->plot);
+      set.curves.append (curve);
+   }
+   set.inUse++;
 
    // Set curve propeties using current curve attributes.
    //
@@ -887,33 +1072,31 @@ QwtPlotCurve* QEGraphic::createCurveData (const QEGraphicNames::DoubleVector& xD
    curve->setRenderHint (this->getCurveRenderHint (),
                          this->getCurveRenderHintOn ());
    curve->setStyle (this->getCurveStyle ());
-   curve->setYAxis(selectedYAxis);
+   curve->setYAxis (selectedYAxis);
 
-   // Scale data as need be. Underlying Qwr widget does basic transformation,
+#if QWT_VERSION >= 0x060000
+   // Underlying Qwt widget does basic transformation, the series data does
+   // any required real world/log scaling. The curve takes ownership of the
+   // series data, and deletes the previous series data (if any).
+   //
+   curve->setData (new SeriesData (xData, yData, this->xAxis,
+                                   this->axisFromPosition (selectedYAxis)));
+#else
+   // Scale data as need be. Underlying Qwt widget does basic transformation,
    // but we need to do any required real world/log scaling.
    //
-   useXData.clear();
-   useYData.clear();
+   const Axis* yAxis = this->axisFromPosition (selectedYAxis);
+   QEGraphicNames::DoubleVector useXData (curveLength);
+   QEGraphicNames::DoubleVector useYData (curveLength);
    for (int j = 0; j < curveLength; j++) {
-      double x, y;
-
-      x = this->xAxis->scaleValue (xData.value (j));
-      useXData.append (x);
-
-      y = axisFromPosition(selectedYAxis)->scaleValue (yData.value (j));
-      useYData.append (y);
+      useXData [j] = this->xAxis->scaleValue (xData.value (j));
+      useYData [j] = yAxis->scaleValue (yData.value (j));
    }
 
-#if QWT_VERSION >= 0x060000
-   curve->setSamples (useXData, useYData);
-#else
    curve->setData (useXData, useYData);
 #endif
 
-   // Attach new curve to the plot object.
-   // By defaut curves are plotted on the yLeft y axis.
-   //
-   curve->attach (this->plot);
+   curve->setVisible (true);
 
    return curve;
 }
@@ -925,8 +1108,11 @@ void QEGraphic::plotCurveData (const QEGraphicNames::DoubleVector& xData,
                                const QwtPlot::Axis yAxis)
 {
    QwtPlotCurve* curve;
-   curve = this->createCurveData (xData, yData, yAxis);
-   if (curve) this->userCurveList.append (curve);
+   curve = this->updateCurveData (this->userCurveSet, xData, yData, yAxis);
+
+   // Draw in plot order, interleaved with any own curves.
+   //
+   if (curve) curve->setZ (userCurveZ + userCurveZStep * this->curvePlotOrder++);
 }
 
 //------------------------------------------------------------------------------
@@ -935,8 +1121,12 @@ void QEGraphic::plotMarkupCurveData (const QEGraphicNames::DoubleVector& xData,
                                      const QEGraphicNames::DoubleVector& yData)
 {
    QwtPlotCurve* curve;
-   curve = this->createCurveData (xData, yData, QwtPlot::yLeft);
-   if (curve) this->markupCurveList.append (curve);
+   curve = this->updateCurveData (this->markupCurveSet, xData, yData, QwtPlot::yLeft);
+
+   // Markup curves are re-used, and so may well have been attached before
+   // the user curves - ensure drawn on top of them.
+   //
+   if (curve) curve->setZ (markupCurveZ);
 }
 
 //------------------------------------------------------------------------------
@@ -957,8 +1147,9 @@ void QEGraphic::plotMarkups ()
 //
 void QEGraphic::graphicReplot ()
 {
-   this->releaseCurveList (this->markupCurveList);
+   this->releaseCurveSet (this->markupCurveSet);
    this->plotMarkups ();
+   this->trimCurveSet (this->markupCurveSet);
    this->plot->replot ();
 }
 
@@ -1513,9 +1704,12 @@ bool QEGraphic::getAxisAutoScale (const QwtPlot::Axis selectedAxis) const
 //
 void QEGraphic::replot ()
 {
-   // User artefacts already plotted - now do markup plots.
+   // User artefacts already plotted - now do markup plots, and delete
+   // any curves not re-used this time around.
    //
    this->plotMarkups ();
+   this->trimCurveSet (this->userCurveSet);
+   this->trimCurveSet (this->markupCurveSet);
    this->plot->replot ();
 }
 
@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2013-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2013-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Starritt
@@ -42,7 +42,8 @@ class QEGraphicMarkup;  // differed declaration
 /// Provides a basic wrapper around QwtPlot, which:
 ///
 /// a) Allocates and attaches curves and grids, and releases these
-///    on delete, and releases curves on request;
+///    on delete, and releases curves on request. Curves are re-used from
+///    one plot to the next, and reference (rather than copy) the plot data;
 ///
 /// b) Interprets mouse events with real world co-ordinates;
 ///
@@ -75,11 +76,14 @@ public:
    QString getTitle () const;
 
    // Call before any replotting, releases all curves from previous plot.
+   // Note: internally allocated curves are not deleted, but re-used by the
+   // next plot. Any curves not re-used are deleted by replot.
    //
    void releaseCurves ();
 
    // User defined curve attached to the internal QwtPlot object.
-   // Will be released by releaseCurves.
+   // Will be released by releaseCurves. Curves are drawn in the order in which
+   // they are plotted/attached since the last releaseCurves.
    //
    void attchOwnCurve (QwtPlotCurve* curve);
 
@@ -123,7 +127,9 @@ public:
    QVariant getMarkupData (const QEGraphicNames::Markups markup) const;
 
    /**
-    * Allocates a curve, sets current curve attibutes and attaches to plot.
+    * Allocates (or re-uses) a curve, sets current curve attibutes and attaches to plot.
+    * The data is not copied - QVector (and hence QEFloatingArray) is implicitly
+    * shared - and any axis scaling is applied as the curve is drawn.
     *
     * @param xData Vector of X axis values
     * @param yData Vector of Y axis values
@@ -388,7 +394,8 @@ protected:
    bool eventFilter (QObject *obj, QEvent *event);
 
 private:
-   class OwnPlot;   // private and differed.
+   class OwnPlot;      // private and differed.
+   class SeriesData;   // private and differed.
 
    // Handle each axis in own class.
    //
@@ -471,8 +478,20 @@ private:
    void plotMarkupCurveData (const QEGraphicNames::DoubleVector& xData,
                              const QEGraphicNames::DoubleVector& yData);
 
-   // Creates curve data using left/right Y axis
-   QwtPlotCurve* createCurveData (const QEGraphicNames::DoubleVector& xData,
+   // Keep a list of allocated curves so that we can track, re-use and delete them.
+   // The first inUse curves have been plotted since the last release.
+   //
+   typedef QList<QwtPlotCurve*> CurveLists;
+   struct CurveSets {
+      CurveSets () : inUse (0) { }
+      CurveLists curves;
+      int inUse;
+   };
+
+   // Updates the next unused curve in the set (allocating as need be) using
+   // left/right Y axis.
+   QwtPlotCurve* updateCurveData (CurveSets& set,
+                                  const QEGraphicNames::DoubleVector& xData,
                                   const QEGraphicNames::DoubleVector& yData,
                                   const QwtPlot::Axis selectedYAxis = QwtPlot::yLeft);
 
@@ -495,12 +514,13 @@ private:
    QwtPlotGrid* plotGrid;
    QTimer* tickTimer;
 
-   // Keep a list of allocated curves so that we can track and delete them.
-   //
-   typedef QList<QwtPlotCurve*> CurveLists;
-   CurveLists userCurveList;                    // for user curves
-   CurveLists markupCurveList;                  // for internal markup curves
+   CurveSets userCurveSet;                      // for user curves
+   CurveSets markupCurveSet;                    // for internal markup curves
+   CurveLists ownCurveList;                     // for attached user defined curves
+   int curvePlotOrder;                          // number of user/own curves plotted
    void releaseCurveList (CurveLists& list);
+   void releaseCurveSet (CurveSets& set);       // marks all as unused and hides
+   void trimCurveSet (CurveSets& set);          // deletes unused curves
 
    // Keep a list of drawn texts.
    //
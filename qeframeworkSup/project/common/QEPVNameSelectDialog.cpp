@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2013-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2013-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Starritt
@@ -13,6 +13,7 @@
 
 #include "QEPVNameSelectDialog.h"
 #include <QtGlobal>
+#include <QApplication>
 #include <QDebug>
 #include <QRegularExpression>
 #include <QStringList>
@@ -28,11 +29,20 @@
 // static
 QStringList QEPVNameSelectDialog::pvNameList;
 
+// The name search thread is shared by all dialogs and is retained so that its
+// index may be re-used by subsequent filters. The set of names is refreshed
+// when either source of names changes. It is owned by the application.
+//
+static QEPvNameSearchThread* allNames = NULL;
+static bool allNamesAreStale = true;
+static int allNamesArchiveGeneration = -1;
+
 //------------------------------------------------------------------------------
 // static
 void QEPVNameSelectDialog::setPvNameList (const QStringList& pvNameListIn)
 {
    QEPVNameSelectDialog::pvNameList = pvNameListIn;
+   allNamesAreStale = true;
 }
 
 //------------------------------------------------------------------------------
@@ -55,6 +65,11 @@ QEPVNameSelectDialog::QEPVNameSelectDialog (QWidget *parent) :
    this->setSourceWidget (this->ui->pvNameEdit);
 
    this->returnIsMasked = false;
+   this->searchRequestId = 0;
+
+   if (!allNames) {
+      allNames = new QEPvNameSearchThread (qApp);
+   }
 
    this->ui->help_frame->setVisible (false);
    this->setFixedHeight (this->ui->frame_1->minimumHeight() +
@@ -76,6 +91,9 @@ QEPVNameSelectDialog::QEPVNameSelectDialog (QWidget *parent) :
    QObject::connect (this->ui->clearButton, SIGNAL (clicked       (bool)),
                      this,                  SLOT   (clearClicked  (bool)));
 
+   QObject::connect (allNames, SIGNAL (searchComplete (const int, const QStringList&, const bool)),
+                     this,     SLOT   (searchComplete (const int, const QStringList&, const bool)));
+
 #if QT_VERSION < 0x060000
 #ifndef QT_NO_COMPLETER
    // Could not get completer to work - yet.
@@ -135,15 +153,36 @@ void QEPVNameSelectDialog::applyFilter ()
    // Form list of PV names from both the user defined arbitary list
    // and the list extarcted from the QEArchiveAccess.
    //
-   QEPvNameSearch findNames (QEPVNameSelectDialog::pvNameList);
+   const int generation = QEArchiveAccess::getPvNamesGeneration ();
+   if (allNamesAreStale || (generation != allNamesArchiveGeneration)) {
+      allNames->setPvNameList (QEPVNameSelectDialog::pvNameList);
+
+      // addPvNameList ensures overall set of names is sorted and unique.
+      //
+      allNames->addPvNameList (QEArchiveAccess::getAllPvNames ());
+      allNamesAreStale = false;
+      allNamesArchiveGeneration = generation;
+   }
 
-   // addPvNameList ensures overall set of names is sorted and unique.
+   // The search is performed on a background thread - see searchComplete.
    //
-   findNames.addPvNameList (QEArchiveAccess::getAllPvNames ());
-   const int m = findNames.count ();
+   this->searchRequestId = allNames->search (re, true);
+}
 
-   this->filteredNames.clear ();
-   this->filteredNames = findNames.getMatchingPvNames (re, true);
+//------------------------------------------------------------------------------
+// slot
+void QEPVNameSelectDialog::searchComplete (const int requestId,
+                                           const QStringList& matchingNames,
+                                           const bool)
+{
+   // Ignore the results of superseded searches, including any requested
+   // by other dialogs.
+   //
+   if (requestId != this->searchRequestId) return;
+
+   const int m = allNames->count ();
+
+   this->filteredNames = matchingNames;
    const int n = this->filteredNames.count ();
 
    this->ui->pvNameEdit->clear ();
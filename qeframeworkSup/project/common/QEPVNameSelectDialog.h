@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2013-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2013-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Starritt
@@ -53,6 +53,7 @@ private:
    Ui::QEPVNameSelectDialog *ui;
    QString originalPvName;
    bool returnIsMasked;
+   int searchRequestId;                // latest name search request
    QStringList filteredNames;
    static QStringList pvNameList;
 
@@ -62,6 +63,8 @@ private slots:
    void editTextChanged (const QString &);
    void helpClicked (bool checked);
    void clearClicked (bool checked);
+   void searchComplete (const int requestId, const QStringList& matchingNames,
+                        const bool isTruncated);
 
    void on_buttonBox_rejected ();
    void on_buttonBox_accepted ();
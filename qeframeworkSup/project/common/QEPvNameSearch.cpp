@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2014-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2014-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Starritt
@@ -12,25 +12,71 @@
  */
 
 #include <QEPvNameSearch.h>
+#include <algorithm>
+#include <QDebug>
+#include <QMutexLocker>
+#include <QSet>
+
+#define DEBUG qDebug () << "QEPvNameSearch" << __LINE__ << __FUNCTION__ << "  "
+
+//------------------------------------------------------------------------------
+// Forms the trigram index key. The index is case insensitive, i.e. it is formed
+// from case folded names, and candidates are subsequently checked as required.
+//
+static inline quint64 trigramKey (const QString& folded, const int j)
+{
+   return (quint64 (folded.at (j).unicode ()) << 32) |
+          (quint64 (folded.at (j + 1).unicode ()) << 16) |
+           quint64 (folded.at (j + 2).unicode ());
+}
+
+//------------------------------------------------------------------------------
+//
+static QString caseFolded (const QString& s)
+{
+   QString result = s;
+   for (int j = 0; j < result.length (); j++) {
+      result [j] = result.at (j).toCaseFolded ();
+   }
+   return result;
+}
 
 //------------------------------------------------------------------------------
+// Append the current literal run, if any, to the literal list.
+//
+static void endRun (QString& run, QStringList& literals)
+{
+   if (run.length () >= 3) {     // shorter literals have no trigrams
+      literals.append (run);
+   }
+   run.clear ();
+}
+
+//==============================================================================
+// QEPvNameSearch
+//==============================================================================
 //
 QEPvNameSearch::QEPvNameSearch ()
 {
-   this->pvNameList.clear ();
+   this->clear ();
 }
 
 //------------------------------------------------------------------------------
 //
 QEPvNameSearch::QEPvNameSearch (const QEPvNameSearch& other)
 {
-   this->setPvNameList (other.pvNameList);
+   this->pvNameList = other.pvNameList;
+   this->position = other.position;
+   this->postings = other.postings;
+   this->indexIsBuilt = other.indexIsBuilt;
+   this->searchCount = other.searchCount;
 }
 
 //------------------------------------------------------------------------------
 //
 QEPvNameSearch::QEPvNameSearch (const QStringList& pvNameListIn)
 {
+   this->clear ();
    this->setPvNameList (pvNameListIn);
 }
 
@@ -38,14 +84,18 @@ QEPvNameSearch::QEPvNameSearch (const QStringList& pvNameListIn)
 //
 QEPvNameSearch::~QEPvNameSearch ()
 {
-   this->pvNameList.clear ();
+   this->clear ();
 }
 
 //------------------------------------------------------------------------------
 //
 void QEPvNameSearch::clear ()
 {
-   return this->pvNameList.clear();
+   this->pvNameList.clear ();
+   this->position.clear ();
+   this->postings.clear ();
+   this->indexIsBuilt = false;
+   this->searchCount = 0;
 }
 
 //------------------------------------------------------------------------------
@@ -59,21 +109,82 @@ int QEPvNameSearch::count () const
 //
 void QEPvNameSearch::setPvNameList (const QStringList& pvNameListIn)
 {
-   this->pvNameList = pvNameListIn;
-
-   // Ensure sorted/unique
-   //
-   this->pvNameList.sort ();
-   this->pvNameList.removeDuplicates ();
+   const int savedSearchCount = this->searchCount;
+   this->clear ();
+   this->addPvNameList (pvNameListIn);
+   this->searchCount = savedSearchCount;   // still a re-used object
 }
 
 //------------------------------------------------------------------------------
+// The new names are merged into the sorted list, and new ids are allocated
+// in ascending order, so that any existing index need only be extended.
 //
 void QEPvNameSearch::addPvNameList (const QStringList& pvNameListIn)
 {
-   this->pvNameList.append (pvNameListIn);
-   this->pvNameList.sort ();
-   this->pvNameList.removeDuplicates ();
+   // Ensure sorted/unique
+   //
+   QStringList additions = pvNameListIn;
+   additions.sort ();
+   additions.removeDuplicates ();
+
+   const int n = this->pvNameList.count ();
+
+   // Drop any names we already have.
+   //
+   QStringList newNames;
+   for (int k = 0; k < additions.count (); k++) {
+      const QString& name = additions.at (k);
+      QStringList::const_iterator it =
+            std::lower_bound (this->pvNameList.constBegin (), this->pvNameList.constEnd (), name);
+      if ((it == this->pvNameList.constEnd ()) || (*it != name)) {
+         newNames.append (name);
+      }
+   }
+
+   const int m = newNames.count ();
+   if (m == 0) return;
+
+   // Merge the two sorted lists, noting where each name ends up.
+   //
+   QStringList merged;
+   merged.reserve (n + m);
+   IdList oldToNew (n);
+   IdList addedAt (m);
+
+   int i = 0;
+   int k = 0;
+   while ((i < n) || (k < m)) {
+      if ((k >= m) || ((i < n) && (this->pvNameList.at (i) < newNames.at (k)))) {
+         oldToNew [i] = merged.count ();
+         merged.append (this->pvNameList.at (i));
+         i++;
+      } else {
+         addedAt [k] = merged.count ();
+         merged.append (newNames.at (k));
+         k++;
+      }
+   }
+
+   this->pvNameList = merged;
+
+   // Existing ids keep their id, but the position changes.
+   //
+   for (int id = 0; id < this->position.count (); id++) {
+      this->position [id] = oldToNew.value (this->position.value (id));
+   }
+
+   const qint32 firstNewId = this->position.count ();
+   for (k = 0; k < m; k++) {
+      this->position.append (addedAt.value (k));
+   }
+
+   // Extend the index if it already exists.
+   //
+   if (this->indexIsBuilt) {
+      for (k = 0; k < m; k++) {
+         this->indexName (firstNewId + k, newNames.at (k));
+      }
+   }
 }
 
 //------------------------------------------------------------------------------
@@ -86,7 +197,8 @@ QStringList QEPvNameSearch::getAllPvNames () const
 //------------------------------------------------------------------------------
 //
 QStringList QEPvNameSearch::getMatchingPvNames (const QRegularExpression& reIn,
-                                                const bool exactMatch) const
+                                                const bool exactMatch,
+                                                const int maxResults) const
 {
    QStringList result;
 
@@ -98,16 +210,577 @@ QStringList QEPvNameSearch::getMatchingPvNames (const QRegularExpression& reIn,
       QString pattern = QString ("^") + reIn.pattern() + QString ("$");
       re.setPattern (pattern);
    }
-   result = this->pvNameList.filter (re);
+
+   if (!re.isValid ()) {
+      return result;  // as per QStringList::filter
+   }
+
+   QStringList literals;
+   QString prefix;
+   QEPvNameSearch::requiredLiterals (re, literals, prefix);
+
+   IdList candidates;
+   const bool isFiltered = this->findCandidates (literals, candidates);
+
+   int first = 0;
+   int last = this->pvNameList.count ();    // exclusive
+   if (!prefix.isEmpty ()) {
+      this->prefixRange (prefix, first, last);
+   }
+
+   const int n = isFiltered ? candidates.count () : last;
+   for (int j = isFiltered ? 0 : first; j < n; j++) {
+      const int p = isFiltered ? candidates.value (j) : j;
+      if ((p < first) || (p >= last)) continue;
+
+      const QString& name = this->pvNameList.at (p);
+      if (re.match (name).hasMatch ()) {
+         result.append (name);
+         if ((maxResults >= 0) && (result.count () >= maxResults)) break;
+      }
+   }
+
    return result;
 }
 
 //------------------------------------------------------------------------------
 //
 QStringList QEPvNameSearch::getMatchingPvNames (const QString& str,
-                                                const Qt::CaseSensitivity cs) const
+                                                const Qt::CaseSensitivity cs,
+                                                const int maxResults) const
+{
+   QStringList result;
+
+   QStringList literals;
+   literals.append (str);
+
+   IdList candidates;
+   const bool isFiltered = this->findCandidates (literals, candidates);
+
+   const int n = isFiltered ? candidates.count () : this->pvNameList.count ();
+   for (int j = 0; j < n; j++) {
+      const int p = isFiltered ? candidates.value (j) : j;
+      const QString& name = this->pvNameList.at (p);
+      if (name.contains (str, cs)) {
+         result.append (name);
+         if ((maxResults >= 0) && (result.count () >= maxResults)) break;
+      }
+   }
+
+   return result;
+}
+
+//------------------------------------------------------------------------------
+// The first maxResults names of the union are within the union of the first
+// maxResults names matching each of the strings.
+//
+QStringList QEPvNameSearch::getMatchingPvNames (const QStringList& strList,
+                                                const Qt::CaseSensitivity cs,
+                                                const int maxResults) const
+{
+   QStringList result;
+
+   for (int s = 0; s < strList.count (); s++) {
+      result.append (this->getMatchingPvNames (strList.value (s), cs, maxResults));
+   }
+
+   if (strList.count () > 1) {
+      result.sort ();
+      result.removeDuplicates ();
+   }
+
+   if ((maxResults >= 0) && (result.count () > maxResults)) {
+      result = result.mid (0, maxResults);
+   }
+
+   return result;
+}
+
+//------------------------------------------------------------------------------
+//
+bool QEPvNameSearch::indexIsAvailable () const
+{
+   // Only build the index once the object is being re-used.
+   //
+   const bool isReused = (this->searchCount > 0);
+   this->searchCount++;
+
+   if (!this->indexIsBuilt) {
+      if (!isReused) return false;
+      if (this->pvNameList.count () < QEPvNameSearch::minimumIndexSize) return false;
+      this->buildIndex ();
+   }
+   return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void QEPvNameSearch::buildIndex () const
+{
+   // Ids must be indexed in ascending order.
+   //
+   this->postings.clear ();
+   for (qint32 id = 0; id < this->position.count (); id++) {
+      this->indexName (id, this->pvNameList.at (this->position.value (id)));
+   }
+   this->indexIsBuilt = true;
+}
+
+//------------------------------------------------------------------------------
+//
+void QEPvNameSearch::indexName (const qint32 id, const QString& name) const
+{
+   const QString folded = caseFolded (name);
+
+   for (int j = 0; j + 3 <= folded.length (); j++) {
+      const quint64 key = trigramKey (folded, j);
+
+      QHash<quint64, Posting>::iterator it = this->postings.find (key);
+      if (it == this->postings.end ()) {
+         Posting posting;
+         posting.last = -1;
+         posting.count = 0;
+         it = this->postings.insert (key, posting);
+      }
+
+      Posting& posting = it.value ();
+      if (posting.last == id) continue;   // repeated trigram within the name
+
+      // Variable length encoded delta, least significant 7 bits first.
+      //
+      quint32 delta = quint32 (id - posting.last);
+      while (delta >= 0x80) {
+         posting.deltas.append (char ((delta & 0x7F) | 0x80));
+         delta >>= 7;
+      }
+      posting.deltas.append (char (delta));
+      posting.last = id;
+      posting.count++;
+   }
+}
+
+//------------------------------------------------------------------------------
+// static
+void QEPvNameSearch::decode (const Posting& posting, IdList& ids)
+{
+   ids.resize (posting.count);
+
+   const char* data = posting.deltas.constData ();
+   const int size = posting.deltas.size ();
+   qint32 id = -1;
+   int n = 0;
+   int j = 0;
+   while ((j < size) && (n < posting.count)) {
+      quint32 delta = 0;
+      int shift = 0;
+      quint8 byte;
+      do {
+         byte = quint8 (data [j++]);
+         delta |= quint32 (byte & 0x7F) << shift;
+         shift += 7;
+      } while ((byte & 0x80) && (j < size));
+
+      id += qint32 (delta);
+      ids [n++] = id;
+   }
+   ids.resize (n);
+}
+
+//------------------------------------------------------------------------------
+//
+bool QEPvNameSearch::findCandidates (const QStringList& literals, IdList& positions) const
+{
+   positions.clear ();
+
+   if (!this->indexIsAvailable ()) return false;
+
+   // Find the posting list for each trigram of each literal.
+   //
+   QSet<quint64> keys;
+   for (int k = 0; k < literals.count (); k++) {
+      const QString folded = caseFolded (literals.value (k));
+      for (int j = 0; j + 3 <= folded.length (); j++) {
+         keys.insert (trigramKey (folded, j));
+      }
+   }
+
+   if (keys.isEmpty ()) return false;
+
+   QList<QPair<qint32, quint64> > lists;    // count, key
+   QSet<quint64>::const_iterator kt;
+   for (kt = keys.constBegin (); kt != keys.constEnd (); ++kt) {
+      QHash<quint64, Posting>::const_iterator it = this->postings.constFind (*kt);
+      if (it == this->postings.constEnd ()) {
+         return true;   // no name contains this trigram, so no candidates
+      }
+      lists.append (qMakePair (it.value ().count, *kt));
+   }
+
+   // Intersect the posting lists, shortest first.
+   //
+   std::sort (lists.begin (), lists.end ());
+
+   IdList ids;
+   QEPvNameSearch::decode (this->postings.value (lists.value (0).second), ids);
+
+   for (int k = 1; k < lists.count () && !ids.isEmpty (); k++) {
+      IdList other;
+      QEPvNameSearch::decode (this->postings.value (lists.value (k).second), other);
+
+      IdList common (qMin (ids.count (), other.count ()));
+      IdList::iterator end = std::set_intersection (ids.begin (), ids.end (),
+                                                    other.begin (), other.end (),
+                                                    common.begin ());
+      common.resize (int (end - common.begin ()));
+      ids = common;
+   }
+
+   // Convert to positions so that names are checked, and hence found, in sort order.
+   //
+   positions.reserve (ids.count ());
+   for (int j = 0; j < ids.count (); j++) {
+      positions.append (this->position.value (ids.value (j)));
+   }
+   std::sort (positions.begin (), positions.end ());
+
+   return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void QEPvNameSearch::prefixRange (const QString& prefix, int& first, int& last) const
+{
+   const int n = this->pvNameList.count ();
+
+   QStringList::const_iterator begin = this->pvNameList.constBegin ();
+   QStringList::const_iterator it = std::lower_bound (begin, this->pvNameList.constEnd (), prefix);
+   first = int (it - begin);
+
+   // All names with the prefix immediately follow the lower bound. Find the
+   // end of the range by a binary search on the first name without the prefix.
+   //
+   int lo = first;
+   int hi = n;
+   while (lo < hi) {
+      const int mid = lo + (hi - lo) / 2;
+      if (this->pvNameList.at (mid).startsWith (prefix)) {
+         lo = mid + 1;
+      } else {
+         hi = mid;
+      }
+   }
+   last = lo;
+}
+
+//------------------------------------------------------------------------------
+// static
+// Conservatively determines the literal strings (of 3 or more characters) which
+// must occur within any match, and a literal prefix, if any, any match must start
+// with. Where the pattern is too complex to analyse, e.g. it contains alternation,
+// no literals are returned, and all the names become candidates.
+//
+bool QEPvNameSearch::requiredLiterals (const QRegularExpression& re,
+                                       QStringList& literals, QString& prefix)
+{
+   literals.clear ();
+   prefix.clear ();
+
+   const QRegularExpression::PatternOptions options = re.patternOptions ();
+   if (options & QRegularExpression::ExtendedPatternSyntaxOption) return false;
+
+   const QString pattern = re.pattern ();
+   const int n = pattern.length ();
+
+   QStringList found;
+   QString run;
+   QString start;
+   int j = 0;
+
+   // Prefix applicable only while we are in the initial run following a '^'.
+   //
+   bool prefixIsOpen = (n > 0) && (pattern.at (0) == QChar ('^')) &&
+                       !(options & QRegularExpression::CaseInsensitiveOption);
+   if ((n > 0) && (pattern.at (0) == QChar ('^'))) j = 1;
+
+   while (j < n) {
+      const QChar c = pattern.at (j);
+      const QChar next = (j + 1 < n) ? pattern.at (j + 1) : QChar ();
+      QChar literal;
+      int width = 1;
+
+      if (c == QChar ('|')) {
+         return false;            // alternation - any literal may be optional
+
+      } else if (c == QChar ('\\')) {
+         if (j + 1 >= n) return false;
+         if (next.isLetterOrNumber ()) {
+            // Escapes with operands, i.e. \x41 \x{41} \cA \012 \o{12} \N{U+41}
+            // \pL \p{Lu} and back references \1 \g1 \g{-1} \k<name>, and \Q..\E
+            // quoting, are not worth analysing. The operands are not literals.
+            if (next.isDigit () ||
+                (next == QChar ('x')) || (next == QChar ('c')) || (next == QChar ('o')) ||
+                (next == QChar ('N')) || (next == QChar ('p')) || (next == QChar ('P')) ||
+                (next == QChar ('g')) || (next == QChar ('k')) ||
+                (next == QChar ('Q')) || (next == QChar ('E'))) return false;
+
+            // Character class or anchor, e.g. \d or \b.
+            endRun (run, found);
+            prefixIsOpen = false;
+            j += 2;
+            continue;
+         }
+         literal = next;          // escaped character
+         width = 2;
+
+      } else if (c == QChar ('(')) {
+         if (next == QChar ('?')) return false;   // options, look arounds etc.
+         endRun (run, found);
+         prefixIsOpen = false;
+         j++;
+         continue;
+
+      } else if (c == QChar (')')) {
+         // An optional group could contain required literals.
+         if ((next == QChar ('?')) || (next == QChar ('*')) || (next == QChar ('{'))) return false;
+         endRun (run, found);
+         j++;
+         continue;
+
+      } else if (c == QChar ('[')) {
+         // Skip the character class.
+         j++;
+         if ((j < n) && (pattern.at (j) == QChar ('^'))) j++;
+         if ((j < n) && (pattern.at (j) == QChar (']'))) j++;
+         while ((j < n) && (pattern.at (j) != QChar (']'))) {
+            if (pattern.at (j) == QChar ('\\')) j++;
+            j++;
+         }
+         if (j >= n) return false;
+         j++;
+         endRun (run, found);
+         prefixIsOpen = false;
+         continue;
+
+      } else if (c == QChar ('{')) {
+         // Stand alone quantifier - skip.
+         while ((j < n) && (pattern.at (j) != QChar ('}'))) j++;
+         j++;
+         endRun (run, found);
+         prefixIsOpen = false;
+         continue;
+
+      } else if ((c == QChar ('.')) || (c == QChar ('^')) || (c == QChar ('$')) ||
+                 (c == QChar ('?')) || (c == QChar ('*')) || (c == QChar ('+'))) {
+         endRun (run, found);
+         prefixIsOpen = false;
+         j++;
+         continue;
+
+      } else {
+         literal = c;
+      }
+
+      // We have a literal character - is it quantified?
+      //
+      const QChar q = (j + width < n) ? pattern.at (j + width) : QChar ();
+      if ((q == QChar ('?')) || (q == QChar ('*')) || (q == QChar ('{'))) {
+         // Optional, or may be - the quantifier handled next time round.
+         endRun (run, found);
+         prefixIsOpen = false;
+         j += width;
+         continue;
+      }
+
+      run.append (literal);
+      if (prefixIsOpen) start.append (literal);
+      j += width;
+
+      if (q == QChar ('+')) {
+         // Required at least once, but the run ends here.
+         endRun (run, found);
+         prefixIsOpen = false;
+         j++;
+      }
+   }
+   endRun (run, found);
+
+   literals = found;
+   prefix = start;
+   return true;
+}
+
+//==============================================================================
+// QEPvNameSearchThread
+//==============================================================================
+//
+QEPvNameSearchThread::QEPvNameSearchThread (QObject* parent) : QThread (parent)
+{
+   this->isStopping = false;
+   this->hasNewList = false;
+   this->hasRequest = false;
+   this->nextRequestId = 1;
+   this->nameCount = 0;
+
+   this->request.id = 0;
+   this->request.isRegExp = false;
+   this->request.cs = Qt::CaseSensitive;
+   this->request.exactMatch = false;
+   this->request.maxResults = -1;
+
+   this->start (QThread::LowPriority);
+}
+
+//------------------------------------------------------------------------------
+//
+QEPvNameSearchThread::~QEPvNameSearchThread ()
+{
+   this->mutex.lock ();
+   this->isStopping = true;
+   this->wakeUp.wakeAll ();
+   this->mutex.unlock ();
+
+   this->wait ();
+}
+
+//------------------------------------------------------------------------------
+//
+void QEPvNameSearchThread::setPvNameList (const QStringList& pvNameList)
+{
+   QMutexLocker locker (&this->mutex);
+   this->hasNewList = true;
+   this->newList = pvNameList;
+   this->additions.clear ();   // superseded
+   this->wakeUp.wakeAll ();
+}
+
+//------------------------------------------------------------------------------
+//
+void QEPvNameSearchThread::addPvNameList (const QStringList& pvNameList)
+{
+   QMutexLocker locker (&this->mutex);
+   this->additions.append (pvNameList);
+   this->wakeUp.wakeAll ();
+}
+
+//------------------------------------------------------------------------------
+//
+int QEPvNameSearchThread::search (const QStringList& strList,
+                                  const Qt::CaseSensitivity cs,
+                                  const int maxResults)
+{
+   Request item;
+   item.isRegExp = false;
+   item.strList = strList;
+   item.cs = cs;
+   item.exactMatch = false;
+   item.maxResults = maxResults;
+   return this->submit (item);
+}
+
+//------------------------------------------------------------------------------
+//
+int QEPvNameSearchThread::search (const QRegularExpression& re,
+                                  const bool exactMatch,
+                                  const int maxResults)
+{
+   Request item;
+   item.isRegExp = true;
+   item.cs = Qt::CaseSensitive;
+   item.re = re;
+   item.exactMatch = exactMatch;
+   item.maxResults = maxResults;
+   return this->submit (item);
+}
+
+//------------------------------------------------------------------------------
+//
+int QEPvNameSearchThread::count ()
+{
+   QMutexLocker locker (&this->mutex);
+   return this->nameCount;
+}
+
+//------------------------------------------------------------------------------
+//
+int QEPvNameSearchThread::submit (Request& item)
+{
+   QMutexLocker locker (&this->mutex);
+   item.id = this->nextRequestId++;
+   this->request = item;        // supersedes any pending request
+   this->hasRequest = true;
+   this->wakeUp.wakeAll ();
+   return item.id;
+}
+
+//------------------------------------------------------------------------------
+//
+void QEPvNameSearchThread::run ()
 {
-   return this->pvNameList.filter (str, cs);
+   while (true) {
+      bool applyNewList;
+      QStringList replacement;
+      QList<QStringList> added;
+      bool doSearch;
+      Request item;
+
+      // Wait for, and then take, the next lot of work.
+      //
+      this->mutex.lock ();
+      while (!this->isStopping && !this->hasNewList &&
+             this->additions.isEmpty () && !this->hasRequest) {
+         this->wakeUp.wait (&this->mutex);
+      }
+
+      if (this->isStopping) {
+         this->mutex.unlock ();
+         break;
+      }
+
+      applyNewList = this->hasNewList;
+      replacement = this->newList;
+      added = this->additions;
+      doSearch = this->hasRequest;
+      item = this->request;
+
+      this->hasNewList = false;
+      this->newList.clear ();
+      this->additions.clear ();
+      this->hasRequest = false;
+      this->mutex.unlock ();
+
+      // Name updates are applied prior to any search.
+      //
+      if (applyNewList) {
+         this->nameSearch.setPvNameList (replacement);
+      }
+      for (int j = 0; j < added.count (); j++) {
+         this->nameSearch.addPvNameList (added.value (j));
+      }
+
+      this->mutex.lock ();
+      this->nameCount = this->nameSearch.count ();
+      this->mutex.unlock ();
+
+      if (doSearch) {
+         // Look for one more name than required, so that we can tell whether the
+         // results have actually been truncated.
+         //
+         const int limit = (item.maxResults >= 0) ? item.maxResults + 1 : -1;
+
+         QStringList names;
+         if (item.isRegExp) {
+            names = this->nameSearch.getMatchingPvNames (item.re, item.exactMatch, limit);
+         } else {
+            names = this->nameSearch.getMatchingPvNames (item.strList, item.cs, limit);
+         }
+
+         const bool isTruncated = (item.maxResults >= 0) && (names.count () > item.maxResults);
+         if (isTruncated) {
+            names = names.mid (0, item.maxResults);
+         }
+         emit this->searchComplete (item.id, names, isTruncated);
+      }
+   }
 }
 
 // end
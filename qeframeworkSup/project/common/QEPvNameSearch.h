@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2014-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2014-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Starritt
@@ -14,17 +14,35 @@
 #ifndef QE_PV_NAME_SEARCH_H
 #define QE_PV_NAME_SEARCH_H
 
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMutex>
 #include <QRegularExpression>
 #include <QString>
 #include <QStringList>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
 
 #include <QEFrameworkLibraryGlobal.h>
 
 /// Provides a basic name search capability. Extracted from archiver manager
 /// in ordger to provide a more flexibility, i.e. using sets of PV names which
 /// can be sourced from anywhere, not just the archiver.
-//
-// QEPvNameSearch is essentially just a contrainer/wrapper around a QStringList
+///
+/// For large sets of names, searches use an index of the names' trigrams, i.e.
+/// each three character sequence, to find a set of candidate names which are
+/// then checked against the actual search criteria. Regular expressions are
+/// analysed for the literal strings any match must contain, and for a literal
+/// prefix, which is found directly from within the sorted name list.
+///
+/// The index is built when the object is first re-used for a search, i.e. on
+/// the second search, so one-off searches do not incur the cost of building
+/// the index. Once built, the index is maintained by addPvNameList.
+///
+/// Note: a QEPvNameSearch object is not thread safe, however see the
+/// QEPvNameSearchThread class below.
 //
 class QE_FRAMEWORK_LIBRARY_SHARED_EXPORT QEPvNameSearch {
 public:
@@ -52,16 +70,130 @@ public:
    // The getMatchingPVnames functions allow the caller to extract a subset of
    // available PV names. The first uses a regular expression and allows for
    // sophisticated pattern matching. The second just returns a list of all the
-   // PV names containing the substring str. The cs parameter determines whether
-   // the string comparison is case sensitive or case insensitive.
+   // PV names containing the substring str, and the third a list of all the
+   // PV names containing any of the substrings. The cs parameter determines
+   // whether the string comparison is case sensitive or case insensitive.
    //
    // If exact match set true, the given expression is braketed with '^' and '$'.
    //
-   QStringList getMatchingPvNames (const QRegularExpression& re, const bool exactMatch) const;
-   QStringList getMatchingPvNames (const QString& str, const Qt::CaseSensitivity cs) const;
+   // The result is sorted. When maxResults is non-negative, the search terminates
+   // once that many matching names have been found, i.e. only the first maxResults
+   // matching names are returned.
+   //
+   QStringList getMatchingPvNames (const QRegularExpression& re, const bool exactMatch,
+                                   const int maxResults = -1) const;
+   QStringList getMatchingPvNames (const QString& str, const Qt::CaseSensitivity cs,
+                                   const int maxResults = -1) const;
+   QStringList getMatchingPvNames (const QStringList& strList, const Qt::CaseSensitivity cs,
+                                   const int maxResults = -1) const;
+
+private:
+   typedef QVector<qint32> IdList;
+
+   // Posting list - the ids of the names that contain a particular trigram.
+   // The ids are held in ascending order as variable length encoded deltas.
+   //
+   struct Posting {
+      QByteArray deltas;
+      qint32 last;                     // last id added
+      qint32 count;                    // number of ids
+   };
+
+   // Minimum number of names for which an index is worthwhile.
+   //
+   static const int minimumIndexSize = 1000;
+
+   static bool requiredLiterals (const QRegularExpression& re,
+                                 QStringList& literals, QString& prefix);
+   static void decode (const Posting& posting, IdList& ids);
+
+   bool indexIsAvailable () const;
+   void buildIndex () const;
+   void indexName (const qint32 id, const QString& name) const;
+
+   // Finds the sorted candidate positions using the index. Returns false when
+   // no filtering is possible, i.e. all the names are candidates.
+   //
+   bool findCandidates (const QStringList& literals, IdList& positions) const;
+
+   // Finds the sorted positions of those names with the given prefix.
+   //
+   void prefixRange (const QString& prefix, int& first, int& last) const;
+
+   QStringList pvNameList;             // sorted
+   IdList position;                    // name id => position within pvNameList
+
+   // Lazily built index - name ids are assigned in the order names are added.
+   //
+   mutable QHash<quint64, Posting> postings;
+   mutable bool indexIsBuilt;
+   mutable int searchCount;
+};
+
+
+/// Performs QEPvNameSearch searches on a background thread, so that searching
+/// very large sets of names, e.g. all archived PV names, does not block the GUI.
+/// Any name list updates are also applied on the background thread.
+///
+/// Each search request supersedes any earlier request not yet started, and the
+/// results are delivered by the searchComplete signal, emitted from the background
+/// thread. The requestId allows the receiver to discard any stale results.
+///
+class QE_FRAMEWORK_LIBRARY_SHARED_EXPORT QEPvNameSearchThread : public QThread {
+   Q_OBJECT
+public:
+   explicit QEPvNameSearchThread (QObject* parent = 0);
+   ~QEPvNameSearchThread ();
+
+   void setPvNameList (const QStringList& pvNameList);
+   void addPvNameList (const QStringList& pvNameList);
+
+   // These functions return the request id, as used by searchComplete.
+   //
+   int search (const QStringList& strList, const Qt::CaseSensitivity cs,
+               const int maxResults = -1);
+   int search (const QRegularExpression& re, const bool exactMatch,
+               const int maxResults = -1);
+
+   // Number of PV names held, as at the latest search.
+   //
+   int count ();
+
+signals:
+   // The isTruncated parameter indicates more than maxResults names matched,
+   // in which case only the first maxResults names are provided.
+   //
+   void searchComplete (const int requestId, const QStringList& names,
+                        const bool isTruncated);
+
+protected:
+   void run ();
 
 private:
-   QStringList pvNameList;
+   struct Request {
+      int id;
+      bool isRegExp;
+      QStringList strList;
+      Qt::CaseSensitivity cs;
+      QRegularExpression re;
+      bool exactMatch;
+      int maxResults;
+   };
+
+   int submit (Request& request);
+
+   QMutex mutex;                       // protects all but nameSearch
+   QWaitCondition wakeUp;
+   bool isStopping;
+   bool hasNewList;
+   QStringList newList;                // replacement names, if hasNewList
+   QList<QStringList> additions;       // pending names additions
+   bool hasRequest;
+   Request request;                    // latest request, if hasRequest
+   int nextRequestId;
+   int nameCount;                      // number of names held by nameSearch
+
+   QEPvNameSearch nameSearch;          // only accessed by run ()
 };
 
 #endif // QE_PV_NAME_SEARCH_H
@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2013-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2013-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Starritt
@@ -22,7 +22,7 @@
 #include <QPushButton>
 #include <QRegularExpression>
 #include <QSize>
-#include <QTableWidget>
+#include <QTableView>
 #include <QTreeView>
 #include <QWidget>
 #include <QVariantList>
@@ -62,6 +62,7 @@ static int gcd (int a, int b)
 #define MAGIC_NUMBER        0x23571113
 #define BASELINE_SIZEING    "__QE_BASELINE_SIZEING__"
 #define CURRENT_SCALE       "__QE_CURRENT_SCALE__"
+#define SUBTREE_SCALE       "__QE_SUBTREE_SCALE__"
 
 // The baseline sizing information is stored as a dynamic widget property.
 // The stored porprty is a QVariantList with two elements, the enum type names
@@ -267,10 +268,12 @@ void QEScaling::extractFromWidget (const QWidget* widget)
       this->resizeFrameAllowedMax = resizeableFrame->getAllowedMaximum ();
    }
 
-   const QTableWidget* tableWidget = qobject_cast <const QTableWidget *>(widget);
-   if (tableWidget) {
-      this->tableDefaultHorizontalSectionSize = tableWidget->horizontalHeader ()->defaultSectionSize ();
-      this->tableDefaultVerticalSectionSize = tableWidget->verticalHeader ()->defaultSectionSize ();
+   // Includes QTableWidget, and QTableView based widgets such as QETable.
+   //
+   const QTableView* tableView = qobject_cast <const QTableView *>(widget);
+   if (tableView) {
+      this->tableDefaultHorizontalSectionSize = tableView->horizontalHeader ()->defaultSectionSize ();
+      this->tableDefaultVerticalSectionSize = tableView->verticalHeader ()->defaultSectionSize ();
    }
 
    const QTreeView* treeView = qobject_cast <const QTreeView *>(widget);
@@ -339,28 +342,6 @@ void QEScaling::getFontScaling (int& fm, int& fd)
    fd = QEScaling::currentFontScaleD;
 }
 
-//------------------------------------------------------------------------------
-// static
-//
-void QEScaling::widgetCapture (QWidget* widget)
-{
-   if (!widget) return;
-
-   // Extract base line sizing and constraints. This is idempotent, first time
-   // through, it extracts data from the widget and creates a property to save
-   // relevant data; second and subqequent times through extracts data from the
-   // property.
-   //
-   QEScaling s;
-   bool okay = s.extractBaselineInformation (widget);
-   if (!okay) {
-      // The extraction of the baseline sizing info returned false, so assume
-      // first time called for this widget - capture the sizing data.
-      //
-      s.captureBaselineInformation (widget);
-   } // else func. returned true - info already extracted.
-}
-
 //------------------------------------------------------------------------------
 // static
 QSize QEScaling::scaleSize (const QSize& size)
@@ -389,22 +370,12 @@ QSize QEScaling::scaleSize (const QSize& size)
 
 //------------------------------------------------------------------------------
 // static
-void QEScaling::applyScalingToWidget (QWidget* widget)
+void QEScaling::applyScalingToWidget (QWidget* widget, const QEScaling& baseline)
 {
    // sainity check.
    //
    if (!widget) return;
 
-   // Extract base line sizing and constraints.
-   //
-   QEScaling baseline;
-   bool okay = baseline.extractBaselineInformation (widget);
-   if (!okay) {
-      // no/invalid baseline scaling info.
-      // This typically in internal widget created post capture - just ignore.
-      return;
-   }
-
    QEWidget* qeWidget = dynamic_cast <QEWidget *>(widget);
    if (!qeWidget) {
       // This widget is not is not a QEWidget.
@@ -534,17 +505,17 @@ void QEScaling::applyScalingToWidget (QWidget* widget)
       }
    }
 
-   QTableWidget* tableWidget = qobject_cast <QTableWidget *>(widget);
-   if (tableWidget) {
+   QTableView* tableView = qobject_cast <QTableView *>(widget);
+   if (tableView) {
       int defaultSectionSize;
 
       defaultSectionSize = baseline.tableDefaultHorizontalSectionSize;
       defaultSectionSize = QEScaling::scale (defaultSectionSize);
-      tableWidget->horizontalHeader ()->setDefaultSectionSize (defaultSectionSize);
+      tableView->horizontalHeader ()->setDefaultSectionSize (defaultSectionSize);
 
       defaultSectionSize =  baseline.tableDefaultVerticalSectionSize;
       defaultSectionSize = QEScaling::scale (defaultSectionSize);
-      tableWidget->verticalHeader ()->setDefaultSectionSize (defaultSectionSize);
+      tableView->verticalHeader ()->setDefaultSectionSize (defaultSectionSize);
    }
 
    QTreeView* treeView = qobject_cast <QTreeView *>(widget);
@@ -565,51 +536,161 @@ void QEScaling::applyScalingToWidget (QWidget* widget)
 
    // Lastly save the scaling as applied to THIS widget.
    //
-   QVariant mp = QVariant (int (QEScaling::currentScaleM));
-   QVariant md = QVariant (int (QEScaling::currentScaleD));
+   widget->setProperty (CURRENT_SCALE, QEScaling::currentScaleList ());
+}
 
-   QVariantList appliedScale;
-   appliedScale.append (mp);
-   appliedScale.append (md);
+//------------------------------------------------------------------------------
+//
+struct QEScaling::WalkContext {
+   QEScaling baseline;               // re-used for each widget's baseline info
+   QList<QWidget*> widgets;          // widgets to be scaled
+   QList<QWidget*> staleRoots;       // sub-tree roots with out of date markers
+   QList<int> staleCounts;           // and corresponding sub-tree widget counts
+};
 
-   widget->setProperty (CURRENT_SCALE, appliedScale);
+//------------------------------------------------------------------------------
+// static
+QVariantList QEScaling::currentScaleList ()
+{
+   // Note: getWidgetScaling only uses the first two items.
+   //
+   QVariantList result;
+   result.append (QVariant (int (QEScaling::currentScaleM)));
+   result.append (QVariant (int (QEScaling::currentScaleD)));
+   result.append (QVariant (int (QEScaling::currentFontScaleM)));
+   result.append (QVariant (int (QEScaling::currentFontScaleD)));
+   return result;
 }
 
 //------------------------------------------------------------------------------
-//
-void QEScaling::widgetTreeWalk (QWidget* widget, ScalingFunction sf)
+// static
+bool QEScaling::isScaledWidget (const QWidget* widget)
+{
+   const QVariant property = widget->property (CURRENT_SCALE);
+   const QMetaType::Type ptype = QEPlatform::metaType (property);
+   if (ptype != QMetaType::QVariantList) return false;
+
+   return property.toList () == QEScaling::currentScaleList ();
+}
+
+//------------------------------------------------------------------------------
+// static
+int QEScaling::countWidgets (const QWidget* widget)
 {
-   // Sanity checks and avoid divide by zero.
+   int count = 1;
+
+   // As per collectWidgets, don't tree-walk inside of a QEImage widget.
    //
-   if (!widget) return;
-   if (!sf) return;
+   if (qobject_cast <const QEImage*> (widget)) return count;
+
+   const QObjectList& childList = widget->children ();
+   const int n = childList.count();
+   for (int j = 0; j < n; j++) {
+      const QWidget* childWidget = qobject_cast <const QWidget *>(childList.value (j));
+      if (childWidget) {
+         count += QEScaling::countWidgets (childWidget);
+      }
+   }
+   return count;
+}
+
+//------------------------------------------------------------------------------
+// The sub-tree marker holds the scale plus the number of widgets in the sub-tree
+// when scaled. The widget count detects the addition or removal of widgets
+// within the sub-tree since it was scaled, e.g. an embedded form's contents.
+// static
+bool QEScaling::isScaledSubtree (const QWidget* widget, int& count, bool& isMarked)
+{
+   isMarked = false;
 
-   // Apply scaling function to this widget.
+   const QVariant property = widget->property (SUBTREE_SCALE);
+   const QMetaType::Type ptype = QEPlatform::metaType (property);
+   if (ptype != QMetaType::QVariantList) return false;
+
+   isMarked = true;
+
+   QVariantList marker = property.toList ();
+   if (marker.count () != 5) return false;
+
+   const int markedCount = marker.takeLast ().toInt ();
+   if (marker != QEScaling::currentScaleList ()) return false;
+
+   count = QEScaling::countWidgets (widget);
+   return count == markedCount;
+}
+
+//------------------------------------------------------------------------------
+// static
+void QEScaling::markScaledSubtree (QWidget* widget, const int count)
+{
+   QVariantList marker = QEScaling::currentScaleList ();
+   marker.append (QVariant (count));
+   widget->setProperty (SUBTREE_SCALE, marker);
+}
+
+//------------------------------------------------------------------------------
+// static
+int QEScaling::collectWidgets (QWidget* widget, WalkContext& context)
+{
+   const QObjectList& childList = widget->children ();
+
+   // Only widgets with children are candidate sub-tree roots.
    //
-   sf (widget);
+   bool isMarked = false;
+   if (!childList.isEmpty ()) {
+      int count;
+      if (QEScaling::isScaledSubtree (widget, count, isMarked)) {
+         return count;   // already done - skip the lot
+      }
+   }
+
+   if (!QEScaling::isScaledWidget (widget)) {
+      // Extract base line sizing and constraints. This is idempotent, first time
+      // through, it extracts data from the widget and creates a property to save
+      // relevant data; second and subqequent times through extracts data from the
+      // property.
+      //
+      bool okay = context.baseline.extractBaselineInformation (widget);
+      if (!okay) {
+         // The extraction of the baseline sizing info returned false, so assume
+         // first time called for this widget - capture the sizing data.
+         //
+         context.baseline.captureBaselineInformation (widget);
+      } // else func. returned true - info already extracted.
+
+      context.widgets.append (widget);
+   }
+
+   int count = 1;
 
    // Don't tree-walk inside of a QEImage widget - it does more harm than good.
    // Maybe QEimage can be made more scaling robust.
    //
    QEImage* image = qobject_cast <QEImage*> (widget);
-   if (image) return;
-
-   // Apply scaling to any child widgets.
-   //
-   QObjectList childList = widget->children ();
-   int n = childList.count();
-   for (int j = 0; j < n; j++) {
-      QObject* child = childList.value (j);
-
-      // We need only tree walk widgets. All widget parents are themselves widgets.
+   if (!image) {
+      // Collect any child widgets.
       //
-      QWidget* childWidget = qobject_cast <QWidget *>(child);
-      if (childWidget) {
-         // Recursive call.
+      const int n = childList.count();
+      for (int j = 0; j < n; j++) {
+         QObject* child = childList.value (j);
+
+         // We need only tree walk widgets. All widget parents are themselves widgets.
          //
-         QEScaling::widgetTreeWalk (childWidget, sf);
+         QWidget* childWidget = qobject_cast <QWidget *>(child);
+         if (childWidget) {
+            // Recursive call.
+            //
+            count += QEScaling::collectWidgets (childWidget, context);
+         }
       }
    }
+
+   if (isMarked) {
+      context.staleRoots.append (widget);
+      context.staleCounts.append (count);
+   }
+
+   return count;
 }
 
 //------------------------------------------------------------------------------
@@ -618,16 +699,51 @@ void QEScaling::applyToWidget (QWidget* widget)
 {
    if (!widget) return;
 
-   // We do two tree walks, first does a pure data capture, the second applies scaling.
-   // The capture phase only actually captures info the first time call for the widget.
+   // We do one tree walk to capture data and collect the widgets needing scaling,
+   // and then apply the scaling to the collected widgets. The capture only actually
+   // captures info the first time called for the widget.
    //
    // This is particularly important for font sizes. If a child's font same as its
    // parent's then is scaled auto-magically when the parent's font is scaled, and
    // if we do it again it will get scalled twice. And the font of a grand-child item
    // will be scaled three times etc.
    //
-   QEScaling::widgetTreeWalk (widget, QEScaling::widgetCapture);
-   QEScaling::widgetTreeWalk (widget, QEScaling::applyScalingToWidget);
+   WalkContext context;
+   const int count = QEScaling::collectWidgets (widget, context);
+
+   // The baseline info is re-extracted from each widget's property, rather
+   // than allocating and holding a baseline object per collected widget.
+   //
+   QEScaling& baseline = context.baseline;
+   const int n = context.widgets.count ();
+   for (int j = 0; j < n; j++) {
+      QWidget* target = context.widgets.value (j);
+
+      // A widget without valid baseline scaling info is typically an internal
+      // widget created post capture - just ignore.
+      //
+      if (baseline.extractBaselineInformation (target) && baseline.isDefined) {
+         QEScaling::applyScalingToWidget (target, baseline);
+      }
+   }
+
+   for (int j = 0; j < context.staleRoots.count (); j++) {
+      QEScaling::markScaledSubtree (context.staleRoots.value (j), context.staleCounts.value (j));
+   }
+   QEScaling::markScaledSubtree (widget, count);
+
+   // Any enclosing sub-tree that was marked as scaled may now be at odds
+   // with this sub-tree - so un-mark it.
+   //
+   if (n > 0) {
+      QWidget* ancestor = widget->parentWidget ();
+      while (ancestor) {
+         if (ancestor->property (SUBTREE_SCALE).isValid ()) {
+            ancestor->setProperty (SUBTREE_SCALE, QVariant ());
+         }
+         ancestor = ancestor->parentWidget ();
+      }
+   }
 }
 
 //------------------------------------------------------------------------------
@@ -686,7 +802,7 @@ void QEScaling::getWidgetScaling (const QWidget* widget, int& m, int& d)
    if (ptype != QMetaType::QVariantList) return;
 
    QVariantList variantList = property.toList ();
-   if (variantList.count () != 2) return;
+   if (variantList.count () < 2) return;
 
    QVariant mp = variantList.value (0);
    const QMetaType::Type mtype = QEPlatform::metaType (mp);
@@ -70,6 +70,10 @@ public:
     /// no scaling occurs.
     /// The function tree walks the hiearchy of widgets paranted by the specified widget.
     /// This function is idempotent.
+    /// Scaling is applied once per widget per scale change. Widgets already scaled
+    /// to the current scale are not re-scaled, and sub-trees previously scaled by a
+    /// call to this function, e.g. the contents of an embedded QEForm, are skipped
+    /// entirely provided the scale and number of widgets in the sub-tree are unchanged.
     //
     static void applyToWidget (QWidget* widget);
 
@@ -114,14 +118,34 @@ private:
     static int currentFontScaleM;
     static int currentFontScaleD;
 
-    /// Tree walks the QWidget hierarchy in order to apply supplied scaling finction.
+    /// Holds the widgets (and their baseline info) to be scaled, as collected by the
+    /// tree walk, together with any stale sub-tree markers found along the way.
     ///
-    typedef void (*ScalingFunction) (QWidget* widget);
-    static void widgetTreeWalk (QWidget* widget, ScalingFunction sf);
+    struct WalkContext;
 
-    /// Captures baseline scaling info as property, if not already done so.
+    /// Tree walks the QWidget hierarchy, capturing baseline scaling info as a property
+    /// (if not already done so) and collecting the widgets that require scaling.
+    /// Returns the number of widgets in the sub-tree.
     ///
-    static void widgetCapture (QWidget* widget);
+    static int collectWidgets (QWidget* widget, WalkContext& context);
+
+    /// Counts the number of widgets in the sub-tree as would be walked by collectWidgets.
+    ///
+    static int countWidgets (const QWidget* widget);
+
+    /// Returns true if widget is the root of a sub-tree already scaled at the current
+    /// scale. The isMarked output indicates if the widget has a sub-tree marker at all.
+    ///
+    static bool isScaledSubtree (const QWidget* widget, int& count, bool& isMarked);
+    static void markScaledSubtree (QWidget* widget, const int count);
+
+    /// Returns true if the widget has already been scaled at the current scale.
+    ///
+    static bool isScaledWidget (const QWidget* widget);
+
+    /// Current scale, including font scale, as saved in widget properties.
+    ///
+    static QVariantList currentScaleList ();
 
     /// Scales a single widget
     /// Applies some special processing above and beyond size, min size, max size and font
@@ -129,7 +153,7 @@ private:
     /// method.
     // This function does all the hard work.
     //
-    static void applyScalingToWidget (QWidget* widget);
+    static void applyScalingToWidget (QWidget* widget, const QEScaling& baseline);
 
     /// Applies scale to a size object.
     //
@@ -0,0 +1,334 @@
+/*  QEStartupProfiler.cpp
+ *
+ *  This file is part of the EPICS QT Framework, initially developed at the
+ *  Australian Synchrotron.
+ *
+ *  SPDX-FileCopyrightText: 2026 Australian Synchrotron
+ *  SPDX-License-Identifier: LGPL-3.0-only
+ *
+ *  Author:     Andrew Starritt
+ *  Maintainer: Andrew Starritt
+ *  Contact:    andrews@ansto.gov.au
+ */
+
+#include "QEStartupProfiler.h"
+#include <algorithm>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTimer>
+#include <QEAdaptationParameters.h>
+
+#define DEBUG qDebug () << "QEStartupProfiler" << __LINE__ << __FUNCTION__ << "  "
+
+QHash<int, QEStartupProfiler::Record> QEStartupProfiler::records;
+QList<int> QEStartupProfiler::contextStack;
+int QEStartupProfiler::nextId = 0;
+
+//------------------------------------------------------------------------------
+// static
+bool QEStartupProfiler::isEnabled ()
+{
+   static bool determined = false;
+   static bool enabled = false;
+
+   if (!determined) {
+      QEAdaptationParameters ap ("QE_");
+      enabled = ap.getBool ("startup_profile");
+      determined = true;
+   }
+   return enabled;
+}
+
+//------------------------------------------------------------------------------
+// static
+int QEStartupProfiler::timeoutSecs ()
+{
+   static bool determined = false;
+   static int secs = 30;
+
+   if (!determined) {
+      QEAdaptationParameters ap ("QE_");
+      secs = ap.getInt ("startup_profile_timeout", 30);
+      determined = true;
+   }
+   return secs;
+}
+
+//------------------------------------------------------------------------------
+// static
+qint64 QEStartupProfiler::now ()
+{
+   static QElapsedTimer timer;
+   if (!timer.isValid ()) {
+      timer.start ();
+   }
+   return timer.nsecsElapsed ();
+}
+
+//------------------------------------------------------------------------------
+// static
+int QEStartupProfiler::beginForm (const QString& name)
+{
+   if (!QEStartupProfiler::isEnabled ()) return 0;
+
+   const int id = ++QEStartupProfiler::nextId;
+   const qint64 t = QEStartupProfiler::now ();
+
+   Record record;
+   record.name = name;
+   record.startTime = t;
+   record.lastMark = t;
+   for (int p = 0; p < NUMBER_OF_PHASES; p++) {
+      record.phaseTimes [p] = 0;
+   }
+   record.channelsCreated = 0;
+   record.valuesExpected = 0;
+   record.channelsConnected = 0;
+   record.channelsUpdated = 0;
+   record.firstConnect = -1;
+   record.lastConnect = -1;
+   record.firstValue = -1;
+   record.lastValue = -1;
+   record.loadedTime = -1;
+   record.isLoaded = false;
+   record.isReported = false;
+
+   QEStartupProfiler::records.insert (id, record);
+   QEStartupProfiler::contextStack.append (id);
+   return id;
+}
+
+//------------------------------------------------------------------------------
+// static
+void QEStartupProfiler::mark (const int id, const Phases phase)
+{
+   if (id == 0) return;
+   if (!QEStartupProfiler::records.contains (id)) return;
+   if ((phase < 0) || (phase >= NUMBER_OF_PHASES)) return;
+
+   Record& record = QEStartupProfiler::records [id];
+   const qint64 t = QEStartupProfiler::now ();
+   record.phaseTimes [phase] += t - record.lastMark;
+   record.lastMark = t;
+}
+
+//------------------------------------------------------------------------------
+// static
+void QEStartupProfiler::endForm (const int id)
+{
+   if (id == 0) return;
+
+   QEStartupProfiler::contextStack.removeAll (id);
+   if (!QEStartupProfiler::records.contains (id)) return;
+
+   Record& record = QEStartupProfiler::records [id];
+   record.isLoaded = true;
+   record.loadedTime = QEStartupProfiler::now ();
+   QEStartupProfiler::checkComplete (record);
+
+   // Ensure we output something even if some channels never connect, which
+   // is typically the very case we are trying to diagnose.
+   //
+   if (!record.isReported) {
+      QTimer::singleShot (1000 * QEStartupProfiler::timeoutSecs () + 100,
+                          QEStartupProfilerTimer::singleton (), SLOT (timeoutHandler ()));
+   }
+}
+
+//------------------------------------------------------------------------------
+// static
+void QEStartupProfiler::formClosed (const int id)
+{
+   if (id == 0) return;
+
+   QEStartupProfiler::contextStack.removeAll (id);
+   if (!QEStartupProfiler::records.contains (id)) return;
+
+   Record& record = QEStartupProfiler::records [id];
+   QEStartupProfiler::reportIncomplete (record, "form closed");
+}
+
+//------------------------------------------------------------------------------
+// static
+int QEStartupProfiler::channelCreated (const bool expectValue)
+{
+   if (QEStartupProfiler::contextStack.isEmpty ()) return 0;
+
+   const int id = QEStartupProfiler::contextStack.last ();
+   if (!QEStartupProfiler::records.contains (id)) return 0;
+
+   Record& record = QEStartupProfiler::records [id];
+   record.channelsCreated++;
+   if (expectValue) record.valuesExpected++;
+   return id;
+}
+
+//------------------------------------------------------------------------------
+// static
+void QEStartupProfiler::channelConnected (const int id)
+{
+   if (id == 0) return;
+   if (!QEStartupProfiler::records.contains (id)) return;
+
+   Record& record = QEStartupProfiler::records [id];
+   const qint64 t = QEStartupProfiler::now () - record.startTime;
+   if (record.firstConnect < 0) record.firstConnect = t;
+   record.lastConnect = t;
+   record.channelsConnected++;
+   QEStartupProfiler::checkComplete (record);
+}
+
+//------------------------------------------------------------------------------
+// static
+void QEStartupProfiler::channelUpdated (const int id)
+{
+   if (id == 0) return;
+   if (!QEStartupProfiler::records.contains (id)) return;
+
+   Record& record = QEStartupProfiler::records [id];
+   const qint64 t = QEStartupProfiler::now () - record.startTime;
+   if (record.firstValue < 0) record.firstValue = t;
+   record.lastValue = t;
+   record.channelsUpdated++;
+   QEStartupProfiler::checkComplete (record);
+}
+
+//------------------------------------------------------------------------------
+// static
+void QEStartupProfiler::checkComplete (Record& record)
+{
+   if (record.isReported || !record.isLoaded) return;
+   if (record.channelsConnected < record.channelsCreated) return;
+   if (record.channelsUpdated < record.valuesExpected) return;
+
+   record.isReported = true;
+   DEBUG << QEStartupProfiler::recordImage (record).toStdString().c_str();   // drop quotes
+}
+
+//------------------------------------------------------------------------------
+// static
+void QEStartupProfiler::reportIncomplete (Record& record, const QString& reason)
+{
+   if (record.isReported) return;
+
+   record.isReported = true;
+   const QString image = QEStartupProfiler::recordImage (record) +
+                         QString (" (incomplete - %1)").arg (reason);
+   DEBUG << image.toStdString().c_str();   // drop quotes
+}
+
+//------------------------------------------------------------------------------
+// static
+void QEStartupProfiler::checkTimeouts ()
+{
+   const qint64 limit = qint64 (QEStartupProfiler::timeoutSecs ()) * 1000000000;
+   const qint64 t = QEStartupProfiler::now ();
+
+   QHash<int, Record>::iterator it;
+   for (it = QEStartupProfiler::records.begin (); it != QEStartupProfiler::records.end (); ++it) {
+      Record& record = it.value ();
+      if (record.isReported || !record.isLoaded) continue;
+      if (t - record.loadedTime < limit) continue;
+      QEStartupProfiler::reportIncomplete (record, "timed out");
+   }
+}
+
+//------------------------------------------------------------------------------
+// static
+QString QEStartupProfiler::phaseImage (const Phases phase)
+{
+   switch (phase) {
+      case Open:      return "open";
+      case Load:      return "load";
+      case Scale:     return "scale";
+      case Activate:  return "activate";
+      case Finalise:  return "finalise";
+      default:        return "unknown";
+   }
+}
+
+//------------------------------------------------------------------------------
+// static
+QString QEStartupProfiler::recordImage (const Record& record)
+{
+   // Convert nS to mS with 0.1 mS resolution, or "-" when undefined.
+   //
+   #define MS_IMAGE(t) ((t) < 0 ? QString ("-") : QString::number (double (t) / 1.0e6, 'f', 1))
+
+   QString result = record.name + ":";
+   for (int p = 0; p < NUMBER_OF_PHASES; p++) {
+      result.append (QString (" %1 %2 mS")
+                     .arg (QEStartupProfiler::phaseImage (Phases (p)))
+                     .arg (MS_IMAGE (record.phaseTimes [p])));
+   }
+
+   result.append (QString ("; channels %1, connected %2/%3 (first/last %4/%5 mS), updated %6/%7 (first/last %8/%9 mS)")
+                  .arg (record.channelsCreated)
+                  .arg (record.channelsConnected)
+                  .arg (record.channelsCreated)
+                  .arg (MS_IMAGE (record.firstConnect))
+                  .arg (MS_IMAGE (record.lastConnect))
+                  .arg (record.channelsUpdated)
+                  .arg (record.valuesExpected)
+                  .arg (MS_IMAGE (record.firstValue))
+                  .arg (MS_IMAGE (record.lastValue)));
+
+   #undef MS_IMAGE
+
+   return result;
+}
+
+//------------------------------------------------------------------------------
+// static
+QString QEStartupProfiler::report ()
+{
+   QList<int> ids = QEStartupProfiler::records.keys ();
+   std::sort (ids.begin (), ids.end ());
+
+   QString result;
+   for (int j = 0; j < ids.count (); j++) {
+      result.append (QEStartupProfiler::recordImage (QEStartupProfiler::records.value (ids.value (j))));
+      result.append ("\n");
+   }
+   return result;
+}
+
+//------------------------------------------------------------------------------
+// static
+void QEStartupProfiler::dump ()
+{
+   const QStringList lines = QEStartupProfiler::report ().split ("\n");
+   for (int j = 0; j < lines.count(); j++) {
+      if (lines.value (j).isEmpty ()) continue;
+      DEBUG << lines.value (j).toStdString().c_str();   // drop quotes
+   }
+}
+
+
+//==============================================================================
+// QEStartupProfilerTimer
+//==============================================================================
+//
+QEStartupProfilerTimer::QEStartupProfilerTimer () : QObject (NULL) { }
+
+//------------------------------------------------------------------------------
+//
+QEStartupProfilerTimer::~QEStartupProfilerTimer () { }
+
+//------------------------------------------------------------------------------
+// static
+QEStartupProfilerTimer* QEStartupProfilerTimer::singleton ()
+{
+   static QEStartupProfilerTimer instance;
+   return &instance;
+}
+
+//------------------------------------------------------------------------------
+// slot
+void QEStartupProfilerTimer::timeoutHandler ()
+{
+   QEStartupProfiler::checkTimeouts ();
+}
+
+// end
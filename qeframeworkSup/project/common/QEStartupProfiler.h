@@ -0,0 +1,138 @@
+/*  QEStartupProfiler.h
+ *
+ *  This file is part of the EPICS QT Framework, initially developed at the
+ *  Australian Synchrotron.
+ *
+ *  SPDX-FileCopyrightText: 2026 Australian Synchrotron
+ *  SPDX-License-Identifier: LGPL-3.0-only
+ *
+ *  Author:     Andrew Starritt
+ *  Maintainer: Andrew Starritt
+ *  Contact:    andrews@ansto.gov.au
+ */
+
+#ifndef QE_STARTUP_PROFILER_H
+#define QE_STARTUP_PROFILER_H
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QtGlobal>
+#include <QEFrameworkLibraryGlobal.h>
+
+/// The QEStartupProfiler class provides simple, per form, startup profiling.
+/// For each form loaded, it accumulates the time spent in each load phase,
+/// counts the channels created by the form, and notes when the first and last
+/// of these channels first connect and first provide a value.
+///
+/// A one line summary is output (using qDebug) once all of a form's channels
+/// have connected and provided a value. If this has not happened within the
+/// QE_STARTUP_PROFILE_TIMEOUT period (seconds, default 30) after the form has
+/// loaded, or the form is closed first, the summary is output anyway and marked
+/// as incomplete. A full report is available at any time.
+///
+/// Profiling is enabled by defining the QE_STARTUP_PROFILE environment variable,
+/// or equivalent adaptation parameter, as true. When not enabled, all functions
+/// are effectively no-ops.
+///
+/// All functions must be called from the main GUI thread.
+///
+class QE_FRAMEWORK_LIBRARY_SHARED_EXPORT QEStartupProfiler {
+public:
+   enum Phases {
+      Open = 0,      // locate and open the ui file
+      Load,          // ui parse and widget construction
+      Scale,         // QEScaling applied to the loaded widgets
+      Activate,      // channel creation
+      Finalise,      // layout, sizing, etc.
+      NUMBER_OF_PHASES
+   };
+
+   static bool isEnabled ();
+
+   // Starts profiling a form, and makes it the current context. Channels created
+   // while a form is the current context are attributed to that form.
+   // Returns a profile id, or 0 when profiling is not enabled.
+   //
+   static int beginForm (const QString& name);
+
+   // Accumulates the time since the previous mark against the specified phase.
+   //
+   static void mark (const int id, const Phases phase);
+
+   // Ends the form's current context.
+   //
+   static void endForm (const int id);
+
+   // Called when the form is closed/deleted. Outputs the summary if not already
+   // output.
+   //
+   static void formClosed (const int id);
+
+   // Called by QCaObject. channelCreated returns the current context id.
+   // Write only channels do not expect a value.
+   //
+   static int channelCreated (const bool expectValue);
+   static void channelConnected (const int id);
+   static void channelUpdated (const int id);
+
+   static QString phaseImage (const Phases phase);
+
+   static QString report ();     // all forms
+   static void dump ();          // diagnostic debug output only.
+
+private:
+   explicit QEStartupProfiler () { }   // static functions only - no instances.
+   ~QEStartupProfiler () { }
+
+   friend class QEStartupProfilerTimer;
+
+   struct Record {
+      QString name;
+      qint64 startTime;
+      qint64 lastMark;
+      qint64 phaseTimes [NUMBER_OF_PHASES];
+      int channelsCreated;
+      int valuesExpected;
+      int channelsConnected;
+      int channelsUpdated;
+      qint64 firstConnect;
+      qint64 lastConnect;
+      qint64 firstValue;
+      qint64 lastValue;
+      qint64 loadedTime;
+      bool isLoaded;
+      bool isReported;
+   };
+
+   static qint64 now ();         // nS since the profiler started
+   static QString recordImage (const Record& record);
+   static void checkComplete (Record& record);
+   static void reportIncomplete (Record& record, const QString& reason);
+   static void checkTimeouts ();
+   static int timeoutSecs ();
+
+   static QHash<int, Record> records;
+   static QList<int> contextStack;
+   static int nextId;
+};
+
+//------------------------------------------------------------------------------
+// Private helper class - provides the slot for the incomplete form timeout.
+//
+class QEStartupProfilerTimer : public QObject {
+   Q_OBJECT
+private:
+   explicit QEStartupProfilerTimer ();
+   ~QEStartupProfilerTimer ();
+
+   static QEStartupProfilerTimer* singleton ();
+
+   friend class QEStartupProfiler;
+
+private slots:
+   void timeoutHandler ();
+};
+
+#endif // QE_STARTUP_PROFILER_H
@@ -101,6 +101,9 @@ SOURCES += $$PWD/QEScaling.cpp
 HEADERS += $$PWD/QEScanTimers.h
 SOURCES += $$PWD/QEScanTimers.cpp
 
+HEADERS += $$PWD/QEStartupProfiler.h
+SOURCES += $$PWD/QEStartupProfiler.cpp
+
 HEADERS += $$PWD/QEThreadSafeQueue.h
 
 HEADERS += $$PWD/QETwinScaleSelectDialog.h
@@ -17,6 +17,10 @@
 
 #define DEBUG qDebug () << "macroSubstitution" << __LINE__  << __FUNCTION__ << "  "
 
+// We limit the number of substitution passes to ten to avoid infinite loops.
+//
+static const int numberOfPasses = 10;
+
 
 //==============================================================================
 // macroSubstitutionfunctions
@@ -56,12 +60,16 @@ const QString macroSubstitution::getValue () const
 // macroSubstitutionList functions
 //==============================================================================
 // Constructor - parse string
-macroSubstitutionList::macroSubstitutionList () { }
+macroSubstitutionList::macroSubstitutionList ()
+{
+   this->isCompiled = true;   // trivially
+}
 
 //------------------------------------------------------------------------------
 //
 macroSubstitutionList::macroSubstitutionList (const QString& string)
 {
+   this->isCompiled = true;
    this->addMacroSubstitutions (string);
 }
 
@@ -71,6 +79,7 @@ macroSubstitutionList::macroSubstitutionList (const QString& string)
 macroSubstitutionList::~macroSubstitutionList ()
 {
    this->parts.clear();
+   this->keyIndex.clear();
 }
 
 //------------------------------------------------------------------------------
@@ -327,6 +336,8 @@ void macroSubstitutionList::addMacroSubstitutions (const QString& substitutions)
       default:
          break;
    }
+
+   this->compile ();
 }
 
 //------------------------------------------------------------------------------
@@ -338,16 +349,133 @@ void macroSubstitutionList::append (const QString& key, const QString& value)
 {
    // Don't bother appending if the key is already present.
    //
-   const int count = parts.count ();
+   if (this->keyIndex.contains (key)) return;
+
+   // Add the key/value pair
+   //
+   this->keyIndex.insert (key, this->parts.count ());
+   this->parts.append (macroSubstitution (key, value));
+}
+
+//------------------------------------------------------------------------------
+// Build the compiled substitution table.
+//
+// The multiple pass algorithm replaces each $(KEY) with its value, and repeats
+// until there is no change. Provided no key contains a '$', '(' or ')'
+// character, references cannot overlap, so the order in which references are
+// replaced does not affect the final outcome. We can therefore resolve each
+// value once here, and then substitute strings in a single pass.
+// If any key does contain such a character, we always use the original
+// algorithm.
+//
+void macroSubstitutionList::compile ()
+{
+   const int count = this->parts.count ();
+
+   this->states.clear ();
+   this->expandedValues.clear ();
+   this->expandedDepths.clear ();
+   this->isCompiled = false;
+
    for (int i = 0; i < count; i++) {
-      if (key == this->parts.at (i).key) {
+      const QString& key = this->parts.at (i).key;
+      if (key.contains ('$') || key.contains ('(') || key.contains (')')) {
          return;
       }
    }
 
-   // Add the key/value pair
-   //
-   this->parts.append (macroSubstitution (key, value));
+   for (int i = 0; i < count; i++) {
+      this->states.append (Unresolved);
+      this->expandedValues.append (QString ());
+      this->expandedDepths.append (0);
+   }
+
+   for (int i = 0; i < count; i++) {
+      this->resolve (i);
+   }
+
+   this->isCompiled = true;
+}
+
+//------------------------------------------------------------------------------
+// Resolve any nested references within the nth value, e.g. AA='$(BB)', BB='CC'.
+// Values involved in a cyclic reference, e.g. AA='$(BB)', BB='$(AA)', are
+// marked as unresolvable.
+//
+void macroSubstitutionList::resolve (const int index)
+{
+   if (this->states.value (index) != Unresolved) return;
+
+   this->states [index] = InProgress;
+
+   const QString value = this->parts.at (index).value;
+   int from = 0;
+   int start;
+   int end;
+   int ref;
+   while ((ref = this->nextReference (value, from, start, end)) >= 0) {
+      this->resolve (ref);   // does nothing if in progress, i.e. a cycle
+      from = end;
+   }
+
+   QString expanded;
+   int depth;
+   if (this->expandString (value, expanded, depth)) {
+      this->expandedValues [index] = expanded;
+      this->expandedDepths [index] = depth;
+      this->states [index] = Resolved;
+   } else {
+      this->states [index] = Unresolvable;
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+int macroSubstitutionList::nextReference (const QString& string, const int from,
+                                          int& start, int& end) const
+{
+   int pos = from;
+   while (true) {
+      const int s = string.indexOf ("$(", pos);
+      if (s < 0) return -1;
+
+      const int e = string.indexOf (')', s + 2);
+      if (e < 0) return -1;
+
+      const int index = this->keyIndex.value (string.mid (s + 2, e - s - 2), -1);
+      if (index >= 0) {
+         start = s;
+         end = e + 1;
+         return index;
+      }
+      pos = s + 1;   // not a known key - keep looking
+   }
+}
+
+//------------------------------------------------------------------------------
+// The depth is the number of passes the multiple pass algorithm would require
+// to make all the substitutions, excluding the final no change pass.
+//
+bool macroSubstitutionList::expandString (const QString& string,
+                                          QString& result, int& depth) const
+{
+   result.clear ();
+   depth = 0;
+
+   int from = 0;
+   int start;
+   int end;
+   int index;
+   while ((index = this->nextReference (string, from, start, end)) >= 0) {
+      if (this->states.value (index) != Resolved) return false;
+
+      result.append (string.constData () + from, start - from);
+      result.append (this->expandedValues.at (index));
+      depth = qMax (depth, this->expandedDepths.at (index) + 1);
+      from = end;
+   }
+   result.append (string.constData () + from, string.length () - from);
+   return true;
 }
 
 //------------------------------------------------------------------------------
@@ -365,25 +493,48 @@ void macroSubstitutionList::substituteKey (QString& string, QString key, const Q
 //
 QString macroSubstitutionList::substitute (const QString& string) const
 {
-   static const int numberOfPasses = 10;
-
-   QString result = string;
-   const int count = this->parts.count ();
-
    // Anything to do? Skip if input is empty or does noy even contain
    // a '$' character or the number of substitution elements is zero.
    // Avoids a lot debug clutter (when debugging) and may speed things
    // up a bit.
-   // 
-   if (result.isEmpty() ||
-       !result.contains('$') ||
-       (count == 0)) return result;
+   //
+   if (string.isEmpty() ||
+       !string.contains('$') ||
+       (this->parts.count () == 0)) return string;
+
+   // Try the single pass substitution using the compiled table.
+   // The result is only used if it is what the multiple pass algorithm would
+   // yield, i.e. no cyclic references, within the pass limit, and no new
+   // references formed by joining a value with the surrounding text,
+   // e.g. '$($(AA)BB)' where AA=''.
+   //
+   if (this->isCompiled) {
+      QString result;
+      int depth;
+      if (this->expandString (string, result, depth) && (depth < numberOfPasses)) {
+         int start;
+         int end;
+         if (this->nextReference (result, 0, start, end) < 0) {
+            return result;
+         }
+      }
+   }
+
+   return this->multiPassSubstitute (string);
+}
+
+//------------------------------------------------------------------------------
+// The original multiple pass substitution algorithm.
+//
+QString macroSubstitutionList::multiPassSubstitute (const QString& string) const
+{
+   QString result = string;
+   const int count = this->parts.count ();
 
    // Apply the substitutions
    // We apply multiple times to allow for dereferencing,
    // i.e. supposed  AA='$(BB)' and BB='CC'
    // On pass 1 $(AA) becones $(BB), on pass 2 $(BB) becomes CC
-   // We limit the number of passes to ten to avoid infinite loops
    //
    for (int j = 1; j <= numberOfPasses; j++) {
       const QString preSubstitutionResult = result;
@@ -478,12 +629,9 @@ const QString macroSubstitutionList::getValue (const int i) const
 //
 const QString macroSubstitutionList::getValue (const QString& keyIn) const
 {
-   const int count = this->parts.count ();
-
-   for (int i = 0; i < count; i++) {
-      if (this->parts.at (i).key == keyIn) {
-         return this->parts.at (i).value;
-      }
+   const int index = this->keyIndex.value (keyIn, -1);
+   if (index >= 0) {
+      return this->parts.at (index).value;
    }
    return QString ();
 }
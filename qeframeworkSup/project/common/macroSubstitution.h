@@ -15,6 +15,7 @@
 #define QE_MACRO_SUBSTITUTION_H
 
 #include <QDebug>
+#include <QHash>
 #include <QString>
 #include <QList>
 #include <QEFrameworkLibraryGlobal.h>
@@ -29,6 +30,13 @@
  * This class parses such strings, and manages macro substitutions using
  * a list of keys and values.
  *
+ * When the substitutions are set, a compiled table is also built. This holds
+ * a hashed key lookup and, for each key, the value with any nested references
+ * to other keys already resolved. This allows most strings to be substituted
+ * in a single pass. Where the single pass result could differ from the
+ * original multiple pass algorithm, e.g. cyclic references, the original
+ * algorithm is used.
+ *
  */
 
 // Macro substitution key/value pair
@@ -75,6 +83,31 @@ public:
 
 private:
    QList<macroSubstitution> parts;                          // List of key/value pairs
+   QHash<QString, int> keyIndex;                            // Key to parts index lookup
+
+   // Compiled substitution table - see compile ().
+   //
+   enum ResolveStates { Unresolved, InProgress, Resolved, Unresolvable };
+
+   bool isCompiled;                                         // Compiled table usable
+   QList<ResolveStates> states;                             // Per key resolve state
+   QList<QString> expandedValues;                           // Per key value with nested references resolved
+   QList<int> expandedDepths;                               // Per key reference nesting depth
+
+   void compile ();                                         // Build the compiled table
+   void resolve (const int index);                          // Resolve the nth value
+
+   // Find the next $(KEY) reference for a known key at or after from.
+   // Returns the key's index, or -1 when there are no more references.
+   int nextReference (const QString& string, const int from,
+                      int& start, int& end) const;
+
+   // Single pass substitution using the compiled table. Returns false if
+   // the string references an unresolvable key.
+   bool expandString (const QString& string,
+                      QString& result, int& depth) const;
+
+   QString multiPassSubstitute (const QString& string) const;
 
    // Substitution a single key/value
    void static substituteKey (QString& string,
@@ -21,9 +21,12 @@
 #include <QECommon.h>
 #include <QEAdaptationParameters.h>
 #include <QEPlatform.h>
+#include <QEStartupProfiler.h>
 #include <QEPvNameUri.h>
 #include <QENullClient.h>
 #include <QECaClient.h>
+#include <QEChannelRegistry.h>
+#include <QEChannelOpenScheduler.h>
 #include <QEPvaClient.h>
 #include <QEStringFormatting.h>
 #include <QEIntegerFormatting.h>
@@ -101,6 +104,7 @@ void QCaObject::initialise (const QString& newPvName,
    // Ensure client object pointer is null.
    //
    this->client = NULL;
+   this->clientIsShared = false;
 
    // Allocate a new object identity for this QCaObject.
    // We do not worry about wrap arround (it has ~1E19 values).
@@ -108,6 +112,7 @@ void QCaObject::initialise (const QString& newPvName,
    this->objectIdentity = ++QCaObject::nextObjectIdentity;
 
    this->arrayIndex = 0;
+   this->isFirstMetaUpdate = false;
 
    // Note the record required name and associated index.
    //
@@ -116,6 +121,26 @@ void QCaObject::initialise (const QString& newPvName,
    this->userMessage = userMessageIn;
    this->signalsToSend = signalsToSendIn;
 
+   this->priority = priorityIn;
+   this->requestedElementCount = 0;
+   this->usePutCallback = false;
+   this->openModes = QEBaseClient::None;
+   this->openIsPending = false;
+   this->connectionReported = false;
+   this->dataReported = false;
+
+   this->profileId = 0;
+   this->profileConnectPending = false;
+   this->profileValuePending = false;
+
+   this->absoluteDeadband = 0.0;
+   this->relativeDeadband = 0.0;
+   this->maxUpdateRate = 0.0;
+   this->filterTimer = NULL;
+   this->lastEmittedValue = 0.0;
+   this->lastEmittedValueIsDefined = false;
+   this->filterIsPending = false;
+
    // Attempt to decode the given name into a protocol and an actual PV name.
    // If not specified, the 'ca://' Channel Access protocol is the default.
    //
@@ -123,29 +148,84 @@ void QCaObject::initialise (const QString& newPvName,
    const bool decodeOkay = uri.decodeUri (newPvName, /* strict=> */ false);
    if (!decodeOkay) {
       DEBUG << "PV protocol identification failed for:" << newPvName;
-      // See comment below
+      // See comment in createPrivateClient
+      this->protocol = QEPvNameUri::undefined;
+      this->clientPvName = newPvName;
       this->client = new QENullClient (newPvName, this);
       return;
    }
 
-   const QEPvNameUri::Protocol protocol = uri.getProtocol ();
-   const QString pvName = uri.getPvName ();
+   this->protocol = uri.getProtocol ();
+   this->clientPvName = uri.getPvName ();
 
+   // Do the plumbing.
+   //
+   this->attachClient (this->createPrivateClient (), false);
+
+   // Setup any the mechanism to handle messages to the user, if supplied
+   //
+   this->setUserMessage (userMessageIn);
+
+   // Update counters. Ensure consistant
+   //
+   QCaObject::totalChannelCount++;
+   QCaObject::connectedCount = LIMIT (QCaObject::connectedCount, 0, QCaObject::totalChannelCount);
+   QCaObject::disconnectedCount = QCaObject::totalChannelCount - QCaObject::connectedCount;
+}
+
+//------------------------------------------------------------------------------
+// Destructor.
+//
+QCaObject::~QCaObject()
+{
+   // NOTE: Sometimes explicitly calling closeChannel() here causes error:
+   //   corrupted double-linked list
+   //   Aborted (core dumped)
+   //
+   // We avoid the corruption by using deleteLater.
+   // Note: the client is NOT parented by the QCaObject.
+   //
+   if (this->openIsPending) {
+      QEChannelOpenScheduler::remove (this);
+   }
+
+   if (this->client && this->clientIsShared) {
+      // Other QCaObjects may still be using this client.
+      //
+      this->releaseClient ();
+
+   } else if (this->client) {
+      this->client->closeChannel();
+      this->client->deleteLater();
+      this->client = NULL;
+   }
+
+   QCaObject::totalChannelCount--;
+   QCaObject::connectedCount = LIMIT (QCaObject::connectedCount, 0, QCaObject::totalChannelCount);
+   QCaObject::disconnectedCount = QCaObject::totalChannelCount - QCaObject::connectedCount;
+}
+
+//------------------------------------------------------------------------------
+// Creates a private, i.e. non-shared, client for the decoded protocol.
+//
+QEBaseClient* QCaObject::createPrivateClient () const
+{
+   QEBaseClient* result = NULL;
    QECaClient* caClient = NULL;
 
-   switch (protocol) {
+   switch (this->protocol) {
 
       case QEPvNameUri::ca:
-         this->client = caClient = new QECaClient (pvName, NULL);
-         caClient->setPriority (int (priorityIn));
+         result = caClient = new QECaClient (this->clientPvName, NULL);
+         caClient->setPriority (int (this->priority));
          break;
 
       case QEPvNameUri::pva:
-         this->client = new QEPvaClient (pvName, NULL);
+         result = new QEPvaClient (this->clientPvName, NULL);
          break;
 
       default:
-         DEBUG << "Unknown protocol" << protocol << int (protocol);
+         DEBUG << "Unknown protocol" << this->protocol << int (this->protocol);
          // By having a null client, it saves the need to have code like, e.g.:
          //
          //   if (this->client) result = this->client->getEgu();
@@ -154,11 +234,19 @@ void QCaObject::initialise (const QString& newPvName,
          //
          //   result = this->client->getEgu();
          //
-         this->client = new QENullClient (pvName, NULL);
+         result = new QENullClient (this->clientPvName, NULL);
    }
 
-   // Do the plumbing.
-   //
+   return result;
+}
+
+//------------------------------------------------------------------------------
+//
+void QCaObject::attachClient (QEBaseClient* clientIn, const bool isShared)
+{
+   this->client = clientIn;
+   this->clientIsShared = isShared;
+
    QObject::connect (this->client, SIGNAL (connectionUpdated (const bool)),
                      this,         SLOT   (connectionUpdate  (const bool)));
    QObject::connect (this->client, SIGNAL (dataUpdated (const bool)),
@@ -166,38 +254,99 @@ void QCaObject::initialise (const QString& newPvName,
    QObject::connect (this->client, SIGNAL (putCallbackComplete    (const bool)),
                      this,         SLOT   (putCallbackNotifcation (const bool)));
 
-   // Setup any the mechanism to handle messages to the user, if supplied
+   // A shared client does not hold any particular QCaObject's user message.
    //
-   this->setUserMessage (userMessageIn);
+   if (!isShared) {
+      this->client->setUserMessage (this->userMessage);
+   }
+}
 
-   // Update counters. Ensure consistant
-   //
-   QCaObject::totalChannelCount++;
-   QCaObject::connectedCount = LIMIT (QCaObject::connectedCount, 0, QCaObject::totalChannelCount);
-   QCaObject::disconnectedCount = QCaObject::totalChannelCount - QCaObject::connectedCount;
+//------------------------------------------------------------------------------
+// Detach from and close/release the current client.
+//
+void QCaObject::releaseClient ()
+{
+   if (!this->client) return;   // sanity check
+
+   if (this->clientIsShared) {
+      QObject::disconnect (this->client, NULL, this, NULL);
+
+      // The shared client stays connected, so we will not be notified.
+      //
+      if (this->connectionReported) {
+         QCaObject::connectedCount--;
+         QCaObject::connectedCount = LIMIT (QCaObject::connectedCount, 0, QCaObject::totalChannelCount);
+         QCaObject::disconnectedCount = QCaObject::totalChannelCount - QCaObject::connectedCount;
+      }
+
+      QEChannelRegistry::release (this->client, this);
+
+   } else {
+      this->client->closeChannel ();
+      QObject::disconnect (this->client, NULL, this, NULL);
+      this->client->deleteLater ();
+   }
+
+   this->client = NULL;
+   this->clientIsShared = false;
+   this->connectionReported = false;
+   this->dataReported = false;
 }
 
 //------------------------------------------------------------------------------
-// Destructor.
+// Only monitor subscriptions are shared. Single shot reads and write only
+// connections are rare and would need a distinct client anyway, and those
+// using put callbacks need the put completion for themselves.
 //
-QCaObject::~QCaObject()
+bool QCaObject::canShareClient (const QEBaseClient::ChannelModesFlags modes) const
 {
-   // NOTE: Sometimes explicitly calling closeChannel() here causes error:
-   //   corrupted double-linked list
-   //   Aborted (core dumped)
-   //
-   // We avoid the corruption by using deleteLater.
-   // Note: the client is NOT parented by the QCaObject.
-   //
-   if (this->client) {
-      this->client->closeChannel();
-      this->client->deleteLater();
-      this->client = NULL;
+   if (!QEChannelRegistry::isEnabled ()) return false;
+   if (!(modes & QEBaseClient::Monitor)) return false;
+   if (this->usePutCallback) return false;
+
+   return (this->protocol == QEPvNameUri::ca) ||
+          (this->protocol == QEPvNameUri::pva);
+}
+
+//------------------------------------------------------------------------------
+// Swap to a shared client. If that client is already connected and/or has data,
+// the connection and data updates are replayed for this object's benefit.
+//
+bool QCaObject::openSharedClient (const QEBaseClient::ChannelModesFlags modes)
+{
+   QEBaseClient* sharedClient =
+         QEChannelRegistry::acquire (this->protocol, this->clientPvName,
+                                     this->requestedElementCount, modes,
+                                     int (this->priority), this);
+   if (!sharedClient) return false;
+   if (sharedClient == this->client) return true;    // no change
+
+   this->releaseClient ();
+   this->attachClient (sharedClient, true);
+
+   QTimer::singleShot (0, this, SLOT (sharedClientCatchUp ()));
+   return true;
+}
+
+//------------------------------------------------------------------------------
+// Swap from a shared client back to a private client.
+//
+void QCaObject::revertToPrivateClient (const bool reopen)
+{
+   this->releaseClient ();
+
+   QEBaseClient* privateClient = this->createPrivateClient ();
+   QECaClient* caClient = qobject_cast <QECaClient*>(privateClient);
+   if (caClient) {
+      caClient->setRequestCount (this->requestedElementCount);
+      caClient->setUsePutCallback (this->usePutCallback);
    }
+   this->attachClient (privateClient, false);
 
-   QCaObject::totalChannelCount--;
-   QCaObject::connectedCount = LIMIT (QCaObject::connectedCount, 0, QCaObject::totalChannelCount);
-   QCaObject::disconnectedCount = QCaObject::totalChannelCount - QCaObject::connectedCount;
+   if (reopen && (this->openModes != QEBaseClient::None)) {
+      this->clearConnectionState ();
+      this->client->openChannel (this->openModes);
+   }
 }
 
 //------------------------------------------------------------------------------
@@ -269,7 +418,8 @@ void QCaObject::clearConnectionState()
 bool QCaObject::subscribe()
 {
    this->clearConnectionState();
-   return this->client->openChannel (QEBaseClient::Monitor | QEBaseClient::Write);
+   this->openModes = QEBaseClient::Monitor | QEBaseClient::Write;
+   return this->requestOpen ();
 }
 
 //------------------------------------------------------------------------------
@@ -277,7 +427,8 @@ bool QCaObject::subscribe()
 bool QCaObject::singleShotRead()
 {
    this->clearConnectionState();
-   return this->client->openChannel (QEBaseClient::Read | QEBaseClient::Write);
+   this->openModes = QEBaseClient::Read | QEBaseClient::Write;
+   return this->requestOpen ();
 }
 
 //------------------------------------------------------------------------------
@@ -285,14 +436,73 @@ bool QCaObject::singleShotRead()
 bool QCaObject::connectChannel()
 {
    this->clearConnectionState();
-   return this->client->openChannel (QEBaseClient::Write);
+   this->openModes = QEBaseClient::Write;
+   return this->requestOpen ();
+}
+
+//------------------------------------------------------------------------------
+// If a form is being loaded, the open request is handed to the scheduler,
+// which will call openChannelNow in due course.
+//
+bool QCaObject::requestOpen ()
+{
+   // Attribute this channel to the form currently being loaded, if any.
+   //
+   if (this->profileId == 0) {
+      const bool expectValue = this->openModes.testFlag (QEBaseClient::Monitor) ||
+                               this->openModes.testFlag (QEBaseClient::Read);
+      this->profileId = QEStartupProfiler::channelCreated (expectValue);
+      this->profileConnectPending = (this->profileId != 0);
+      this->profileValuePending = (this->profileId != 0) && expectValue;
+   }
+
+   if (QEChannelOpenScheduler::enqueue (this)) {
+      this->openIsPending = true;
+      return true;
+   }
+   return this->openChannelNow ();
+}
+
+//------------------------------------------------------------------------------
+// Open the channel per the currently required open modes.
+// Only monitor subscriptions use a shared client.
+//
+bool QCaObject::openChannelNow ()
+{
+   this->openIsPending = false;
+   if (this->openModes == QEBaseClient::None) return false;
+
+   if (this->canShareClient (this->openModes) &&
+       this->openSharedClient (this->openModes)) {
+      return true;
+   }
+
+   if (this->clientIsShared) {
+      this->revertToPrivateClient (false);
+   }
+   return this->client->openChannel (this->openModes);
 }
 
 //------------------------------------------------------------------------------
+// For a shared client, we just let go of it and revert to an unopened
+// private client, and generate the disconnect notification ourselves.
 //
 void QCaObject::closeChannel()
 {
-   this->client->closeChannel();
+   if (this->openIsPending) {
+      QEChannelOpenScheduler::remove (this);
+      this->openIsPending = false;
+   }
+
+   if (this->clientIsShared) {
+      if (this->connectionReported) {
+         this->connectionUpdate (false);
+      }
+      this->revertToPrivateClient (false);
+   } else {
+      this->client->closeChannel();
+   }
+   this->openModes = QEBaseClient::None;
 }
 
 //------------------------------------------------------------------------------
@@ -319,7 +529,9 @@ unsigned int QCaObject::getVariableIndex() const
 void QCaObject::setUserMessage (UserMessage* userMessageIn)
 {
    this->userMessage = userMessageIn;
-   this->client->setUserMessage (userMessageIn);
+   if (!this->clientIsShared) {
+      this->client->setUserMessage (userMessageIn);
+   }
 }
 
 //------------------------------------------------------------------------------
@@ -329,6 +541,18 @@ void QCaObject::setUserMessage (UserMessage* userMessageIn)
 //
 void  QCaObject::setRequestedElementCount (unsigned int elementCount)
 {
+   this->requestedElementCount = elementCount;
+
+   // The element count forms part of the shared client key, so re-bind to
+   // the appropriate shared client.
+   //
+   if (this->clientIsShared) {
+      if (!this->openSharedClient (this->openModes)) {
+         this->revertToPrivateClient (true);
+      }
+      return;
+   }
+
    QECaClient* caClient = this->asCaClient();
    if (caClient) {
       caClient->setRequestCount (elementCount);
@@ -629,6 +853,48 @@ int QCaObject::getArrayIndex() const
    return this->arrayIndex;
 }
 
+//------------------------------------------------------------------------------
+//
+void QCaObject::setAbsoluteDeadband (const double deadband)
+{
+   this->absoluteDeadband = MAX (0.0, deadband);
+}
+
+//------------------------------------------------------------------------------
+//
+double QCaObject::getAbsoluteDeadband () const
+{
+   return this->absoluteDeadband;
+}
+
+//------------------------------------------------------------------------------
+//
+void QCaObject::setRelativeDeadband (const double deadband)
+{
+   this->relativeDeadband = MAX (0.0, deadband);
+}
+
+//------------------------------------------------------------------------------
+//
+double QCaObject::getRelativeDeadband () const
+{
+   return this->relativeDeadband;
+}
+
+//------------------------------------------------------------------------------
+//
+void QCaObject::setMaxUpdateRate (const double rate)
+{
+   this->maxUpdateRate = MAX (0.0, rate);
+}
+
+//------------------------------------------------------------------------------
+//
+double QCaObject::getMaxUpdateRate () const
+{
+   return this->maxUpdateRate;
+}
+
 //------------------------------------------------------------------------------
 // Return the enumerations strings, if any
 //
@@ -724,6 +990,16 @@ double  QCaObject::getControlLimitLower() const
 //
 void QCaObject::enableWriteCallbacks (bool enable)
 {
+   this->usePutCallback = enable;
+
+   // Put callback notifications are specific to the writer, so a shared
+   // client is not appropriate.
+   //
+   if (enable && this->clientIsShared) {
+      this->revertToPrivateClient (true);   // also sets put callback
+      return;
+   }
+
    QECaClient* caClient = this->asCaClient();
    if (caClient)
       caClient->setUsePutCallback( enable );
@@ -815,10 +1091,17 @@ void QCaObject::connectionUpdate (const bool isConnected)
 {
    QCaConnectionInfo connectionInfo;
 
+   this->connectionReported = isConnected;
+
    if (isConnected) {
       connectionInfo = QCaConnectionInfo (QCaConnectionInfo::CONNECTED,
                                           this->processVariableName);
       QCaObject::connectedCount++;
+
+      if (this->profileConnectPending) {
+         this->profileConnectPending = false;
+         QEStartupProfiler::channelConnected (this->profileId);
+      }
    } else {
       connectionInfo = QCaConnectionInfo (QCaConnectionInfo::CLOSED,
                                           this->processVariableName);
@@ -848,18 +1131,174 @@ void QCaObject::connectionUpdate (const bool isConnected)
 }
 
 //------------------------------------------------------------------------------
-// New data available - emit to awaiting objects.
+// New data available - emit to awaiting objects, subject to any filtering.
 //
 void QCaObject::dataUpdate (const bool isMetaUpdateIn)
 {
    if (!this->client) return;   // sanity check
 
+   if (this->profileValuePending) {
+      this->profileValuePending = false;
+      QEStartupProfiler::channelUpdated (this->profileId);
+   }
+
+   // Meta data updates, e.g. the first update after a connection, are always
+   // emitted. Note: isFilterActive is a quick check.
+   //
+   if (!isMetaUpdateIn && this->isFilterActive () && !this->filterAcceptsUpdate ()) {
+      return;
+   }
+
+   this->emitDataUpdate (isMetaUpdateIn);
+}
+
+//------------------------------------------------------------------------------
+// Deadbands are only applied to numeric scalar values.
+//
+static bool isNumericScalar (const QVariant& value)
+{
+   switch (QEPlatform::metaType (value)) {
+      case QMetaType::Double:
+      case QMetaType::Float:
+      case QMetaType::Int:
+      case QMetaType::UInt:
+      case QMetaType::Long:
+      case QMetaType::ULong:
+      case QMetaType::LongLong:
+      case QMetaType::ULongLong:
+      case QMetaType::Short:
+      case QMetaType::UShort:
+      case QMetaType::Char:
+      case QMetaType::UChar:
+         return true;
+      default:
+         return false;
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+bool QCaObject::isFilterActive () const
+{
+   return (this->absoluteDeadband > 0.0) ||
+          (this->relativeDeadband > 0.0) ||
+          (this->maxUpdateRate > 0.0);
+}
+
+//------------------------------------------------------------------------------
+// Returns true if the update should be emitted now. Otherwise the update is
+// noted as pending, and the trailing-edge flush timer started if needs be.
+//
+bool QCaObject::filterAcceptsUpdate ()
+{
+   bool accept = true;
+
+   // Apply maximum update rate first - this is the cheaper check.
+   //
+   int remaining = 0;    // mSec
+   if ((this->maxUpdateRate > 0.0) && this->lastEmitTime.isValid ()) {
+      const qint64 minInterval = qint64 (1000.0 / this->maxUpdateRate);
+      const qint64 elapsed = this->lastEmitTime.elapsed ();
+      if (elapsed < minInterval) {
+         accept = false;
+         remaining = int (minInterval - elapsed);
+      }
+   }
+
+   // Apply deadbands to numeric scalar values only. Any change of alarm
+   // state is always of interest.
+   //
+   if (accept && this->lastEmittedValueIsDefined &&
+       ((this->absoluteDeadband > 0.0) || (this->relativeDeadband > 0.0)) &&
+       (this->client->getAlarmInfo () == this->lastEmittedAlarmInfo))
+   {
+      const QVariant value = this->getVariant ();
+      if (isNumericScalar (value)) {
+         // The effective deadband is the larger of the two.
+         //
+         const double relative = ABS (this->lastEmittedValue) * this->relativeDeadband / 100.0;
+         const double deadband = MAX (this->absoluteDeadband, relative);
+         const double delta = ABS (value.toDouble () - this->lastEmittedValue);
+         if (delta <= deadband) {
+            accept = false;
+         }
+      }
+   }
+
+   if (accept) return true;
+
+   // Update suppressed - ensure the final value is delivered.
+   // Rate limited values are flushed at the end of the current interval.
+   // Deadband suppressed values are flushed after 1 second of inactivity,
+   // i.e. if and when the updates stop.
+   //
+   this->filterIsPending = true;
+
+   if (!this->filterTimer) {
+      this->filterTimer = new QTimer (this);
+      this->filterTimer->setSingleShot (true);
+      QObject::connect (this->filterTimer, SIGNAL (timeout ()),
+                        this,              SLOT   (filterTimeout ()));
+   }
+
+   if (remaining > 0) {
+      if (!this->filterTimer->isActive ()) {
+         this->filterTimer->start (remaining);
+      }
+   } else {
+      this->filterTimer->start (1000);   // (re)start
+   }
+
+   return false;
+}
+
+//------------------------------------------------------------------------------
+// Note the state of the update just emitted for subsequent filtering.
+//
+void QCaObject::noteEmittedUpdate ()
+{
+   this->filterIsPending = false;
+   if (this->filterTimer) this->filterTimer->stop ();
+
+   this->lastEmitTime.start ();
+   this->lastEmittedAlarmInfo = this->client->getAlarmInfo ();
+
+   const QVariant value = this->getVariant ();
+   this->lastEmittedValueIsDefined = isNumericScalar (value);
+   if (this->lastEmittedValueIsDefined) {
+      this->lastEmittedValue = value.toDouble ();
+   }
+}
+
+//------------------------------------------------------------------------------
+// Trailing-edge flush.
+//
+void QCaObject::filterTimeout ()
+{
+   if (!this->filterIsPending) return;
+   if (!this->client || !this->client->dataIsAvailable ()) return;
+
+   this->emitDataUpdate (false);
+}
+
+//------------------------------------------------------------------------------
+// Emit the current data.
+//
+void QCaObject::emitDataUpdate (const bool isMetaUpdateIn)
+{
+   if (!this->client) return;   // sanity check
+
    // We need non-const copies, at least for now, for old style signals.
    //
    QCaAlarmInfo alarmInfo = this->client->getAlarmInfo ();
    QCaDateTime timeStamp = this->client->getTimeStamp ();
 
    this->isFirstMetaUpdate = isMetaUpdateIn;
+   this->dataReported = true;
+
+   if (this->isFilterActive ()) {
+      this->noteEmittedUpdate ();
+   }
 
    if (this->signalsToSend & SIG_VARIANT) {
       // Only form variant and emit signal if a varient has been requested.
@@ -915,6 +1354,23 @@ void QCaObject::dataUpdate (const bool isMetaUpdateIn)
    }
 }
 
+//------------------------------------------------------------------------------
+// Replay the connection and data updates that the shared client may have
+// received before we started sharing it.
+//
+void QCaObject::sharedClientCatchUp ()
+{
+   if (!this->client || !this->clientIsShared) return;
+
+   if (this->client->getIsConnected () && !this->connectionReported) {
+      this->connectionUpdate (true);
+   }
+
+   if (this->client->dataIsAvailable () && !this->dataReported) {
+      this->dataUpdate (true);
+   }
+}
+
 //------------------------------------------------------------------------------
 // Putcallback notification.
 //
@@ -999,6 +1455,16 @@ bool QCaObject::writeData (const QVariant& value)
 {
    if (!this->client) return false;   // sanity check
    if (!this->writeEnabled()) return false;
+
+   if (this->clientIsShared) {
+      // Any put error is reported using this object's user message.
+      //
+      this->client->setUserMessage (this->userMessage);
+      const bool result = this->client->putPvData (value);
+      this->client->setUserMessage (NULL);
+      return result;
+   }
+
    return this->client->putPvData (value);
 }
 
@@ -1065,7 +1531,7 @@ bool QCaObject::writeDataElement (const QVariant& elementValue)
 void QCaObject::resendLastData()
 {
    if (this->getDataIsAvailable()) {
-      this->dataUpdate (false);
+      this->emitDataUpdate (false);
    }
 }
 
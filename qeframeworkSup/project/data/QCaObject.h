@@ -14,10 +14,12 @@
 #ifndef QCA_OBJECT_H
 #define QCA_OBJECT_H
 
+#include <QElapsedTimer>
 #include <QMetaType>
 #include <QObject>
 #include <QString>
 #include <QFlags>
+#include <QTimer>
 #include <QVariant>
 
 #include <UserMessage.h>
@@ -26,12 +28,14 @@
 #include <QCaDateTime.h>
 #include <QCaConnectionInfo.h>
 #include <QEBaseClient.h>
+#include <QEPvNameUri.h>
 #include <QEFrameworkLibraryGlobal.h>
 
 // differed, so we don't need to include headers
 //
 class QECaClient;
 class QEPvaClient;
+class QEChannelOpenScheduler;
 
 // Structures used in signals to indicate connection and data updates.
 //
@@ -168,6 +172,25 @@ public:
    void setArrayIndex( const int index );
    int getArrayIndex() const;
 
+   // Client-side update filtering. These are applied to all non meta data
+   // updates prior to the update signals being emitted.
+   //
+   // The absolute deadband and the relative deadband (as a percentage of the
+   // last emitted value) only apply to numeric scalar values. An update is
+   // suppressed if it is within the deadband(s) and the alarm state unchanged.
+   // The maximum update rate (Hz) applies to all values.
+   // A value of 0.0 (the default) means no deadband/no rate limit.
+   //
+   // A suppressed update is not lost: if no subsequent update is emitted,
+   // the latest value is delivered by a trailing-edge flush.
+   //
+   void setAbsoluteDeadband (const double deadband);
+   double getAbsoluteDeadband () const;
+   void setRelativeDeadband (const double deadband);
+   double getRelativeDeadband () const;
+   void setMaxUpdateRate (const double rate);
+   double getMaxUpdateRate () const;
+
    // Essentially provides same data as the dataChanged signal. The parameter isDefined indicates whether
    // the data is valid, i.e. has been received since the channel last connected.
    void getLastData( bool& isDefined, QVariant& value, QCaAlarmInfo& alarmInfo, QCaDateTime& timeStamp ) const;
@@ -255,6 +278,32 @@ private:
    QECaClient* asCaClient () const;
    QEPvaClient* asPvaClient () const;
 
+   // Client management. Monitor subscriptions may use a client shared with
+   // other QCaObjects by means of the QEChannelRegistry, otherwise this object
+   // has its own private client.
+   //
+   QEBaseClient* createPrivateClient () const;
+   void attachClient (QEBaseClient* client, const bool isShared);
+   void releaseClient ();
+   bool canShareClient (const QEBaseClient::ChannelModesFlags modes) const;
+   bool openSharedClient (const QEBaseClient::ChannelModesFlags modes);
+   void revertToPrivateClient (const bool reopen);
+
+   // Open requests may be deferred by the QEChannelOpenScheduler when a form
+   // is being loaded. requestOpen returns true if the channel has been opened
+   // or the open request has been queued.
+   //
+   friend class ::QEChannelOpenScheduler;
+   bool requestOpen ();
+   bool openChannelNow ();
+
+   // Update filtering - returns true if this update is to be emitted now.
+   //
+   bool isFilterActive () const;
+   bool filterAcceptsUpdate ();
+   void noteEmittedUpdate ();
+   void emitDataUpdate (const bool isMetaUpdate);
+
    // Clear the connection state - and signal
    //
    void clearConnectionState();
@@ -269,6 +318,38 @@ private:
    // This can be one of QECaClient, QEPvaClient or QENullClient.
    //
    QEBaseClient* client;
+   bool clientIsShared;
+
+   QEPvNameUri::Protocol protocol;   // decoded protocol and PV name,
+   QString clientPvName;             // i.e. sans the protocol prefix.
+   priorities priority;
+   unsigned int requestedElementCount;
+   bool usePutCallback;
+   QEBaseClient::ChannelModesFlags openModes;
+   bool openIsPending;
+
+   // Startup profiling: the profile id and the first connect/value pending flags.
+   //
+   int profileId;
+   bool profileConnectPending;
+   bool profileValuePending;
+
+   // Update filter parameters and state.
+   //
+   double absoluteDeadband;
+   double relativeDeadband;
+   double maxUpdateRate;
+   QTimer* filterTimer;              // created when first needed
+   QElapsedTimer lastEmitTime;
+   double lastEmittedValue;
+   bool lastEmittedValueIsDefined;
+   QCaAlarmInfo lastEmittedAlarmInfo;
+   bool filterIsPending;             // an update has been suppressed
+
+   // Last connection state and if data has been reported to our users.
+   //
+   bool connectionReported;
+   bool dataReported;
 
    QVariant getVariant () const;
    QByteArray getByteArray () const;
@@ -290,6 +371,8 @@ private slots:
    void connectionUpdate (const bool isConnected);
    void dataUpdate (const bool firstUpdate);
    void putCallbackNotifcation (const bool isSuccessful);
+   void sharedClientCatchUp ();
+   void filterTimeout ();
 };
 
 }    // end qcaobject namespace
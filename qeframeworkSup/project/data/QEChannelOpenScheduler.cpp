@@ -0,0 +1,185 @@
+/*  QEChannelOpenScheduler.cpp
+ *
+ *  This file is part of the EPICS QT Framework, initially developed at the
+ *  Australian Synchrotron.
+ *
+ *  SPDX-FileCopyrightText: 2026 Australian Synchrotron
+ *  SPDX-License-Identifier: LGPL-3.0-only
+ *
+ *  Author:     Andrew Starritt
+ *  Maintainer: Andrew Starritt
+ *  Contact:    andrews@ansto.gov.au
+ */
+
+#include "QEChannelOpenScheduler.h"
+#include <QDebug>
+#include <QWidget>
+#include <QEAdaptationParameters.h>
+#include <QCaObject.h>
+
+#define DEBUG qDebug () << "QEChannelOpenScheduler" << __LINE__ << __FUNCTION__ << "  "
+
+//------------------------------------------------------------------------------
+// static
+bool QEChannelOpenScheduler::isEnabled ()
+{
+   static bool determined = false;
+   static bool enabled = true;
+
+   if (!determined) {
+      QEAdaptationParameters ap ("QE_");
+      enabled = !ap.getBool ("disable_channel_open_batching");  // default is false
+      determined = true;
+   }
+   return enabled;
+}
+
+//------------------------------------------------------------------------------
+// static
+QEChannelOpenScheduler* QEChannelOpenScheduler::singleton ()
+{
+   // As per QECaClientManager, the singleton object created when first needed.
+   //
+   static QEChannelOpenScheduler instance;
+   return &instance;
+}
+
+//------------------------------------------------------------------------------
+//
+QEChannelOpenScheduler::QEChannelOpenScheduler () : QObject (NULL)
+{
+   this->batchDepth = 0;
+
+   this->timer = new QTimer (this);
+   this->timer->setInterval (20);   // mSec
+   QObject::connect (this->timer, SIGNAL (timeout ()),
+                     this,        SLOT   (timeoutHandler ()));
+}
+
+//------------------------------------------------------------------------------
+//
+QEChannelOpenScheduler::~QEChannelOpenScheduler ()
+{
+   this->timer->stop ();
+}
+
+//------------------------------------------------------------------------------
+// static
+void QEChannelOpenScheduler::beginBatch ()
+{
+   if (!QEChannelOpenScheduler::isEnabled ()) return;
+
+   QEChannelOpenScheduler* self = QEChannelOpenScheduler::singleton ();
+   self->batchDepth++;
+}
+
+//------------------------------------------------------------------------------
+// static
+void QEChannelOpenScheduler::endBatch ()
+{
+   if (!QEChannelOpenScheduler::isEnabled ()) return;
+
+   QEChannelOpenScheduler* self = QEChannelOpenScheduler::singleton ();
+   if (self->batchDepth <= 0) {
+      DEBUG << "unbalanced endBatch call";
+      return;
+   }
+
+   self->batchDepth--;
+   if (self->batchDepth > 0) return;    // still in an outer batch
+
+   // Take a copy and clear the batch list before we open any channels,
+   // just in case an open leads to a new request.
+   //
+   const QList<qcaobject::QCaObject*> batch = self->batchList;
+   self->batchList.clear ();
+
+   // Visible channels first - all opened in this event.
+   //
+   for (int j = 0; j < batch.count (); j++) {
+      qcaobject::QCaObject* qca = batch.value (j);
+      if (QEChannelOpenScheduler::isVisibleChannel (qca)) {
+         QEChannelOpenScheduler::openChannel (qca);
+      } else {
+         self->deferredList.append (qca);
+      }
+   }
+
+   if (!self->deferredList.isEmpty () && !self->timer->isActive ()) {
+      self->timer->start ();
+   }
+}
+
+//------------------------------------------------------------------------------
+// static
+bool QEChannelOpenScheduler::isBatching ()
+{
+   if (!QEChannelOpenScheduler::isEnabled ()) return false;
+   return QEChannelOpenScheduler::singleton ()->batchDepth > 0;
+}
+
+//------------------------------------------------------------------------------
+// static
+bool QEChannelOpenScheduler::enqueue (qcaobject::QCaObject* qca)
+{
+   if (!qca) return false;   // sanity check
+   if (!QEChannelOpenScheduler::isBatching ()) return false;
+
+   QEChannelOpenScheduler* self = QEChannelOpenScheduler::singleton ();
+   if (!self->batchList.contains (qca)) {
+      self->batchList.append (qca);
+   }
+   return true;
+}
+
+//------------------------------------------------------------------------------
+// static
+void QEChannelOpenScheduler::remove (qcaobject::QCaObject* qca)
+{
+   if (!QEChannelOpenScheduler::isEnabled ()) return;
+
+   QEChannelOpenScheduler* self = QEChannelOpenScheduler::singleton ();
+   self->batchList.removeAll (qca);
+   self->deferredList.removeAll (qca);
+}
+
+//------------------------------------------------------------------------------
+// A channel is deemed visible if it is not owned by a widget, or the owning
+// widget would become visible when its window is shown.
+// static
+bool QEChannelOpenScheduler::isVisibleChannel (const qcaobject::QCaObject* qca)
+{
+   const QWidget* widget = qobject_cast<const QWidget*>(qca->parent ());
+   if (!widget) return true;
+
+   const QWidget* window = widget->window ();
+   return (widget == window) || widget->isVisibleTo (window);
+}
+
+//------------------------------------------------------------------------------
+// static
+void QEChannelOpenScheduler::openChannel (qcaobject::QCaObject* qca)
+{
+   if (!qca->openIsPending) return;   // closed in the mean time
+   qca->openChannelNow ();
+}
+
+//------------------------------------------------------------------------------
+// Open the next chunk of deferred channels.
+//
+void QEChannelOpenScheduler::timeoutHandler ()
+{
+   int n = 0;
+   while (!this->deferredList.isEmpty () &&
+          (n < QEChannelOpenScheduler::deferredChunkSize)) {
+      qcaobject::QCaObject* qca = this->deferredList.takeFirst ();
+      QEChannelOpenScheduler::openChannel (qca);
+      n++;
+   }
+
+   if (this->deferredList.isEmpty ()) {
+      this->timer->stop ();
+   }
+}
+
+// end
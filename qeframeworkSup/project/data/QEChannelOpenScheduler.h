@@ -0,0 +1,84 @@
+/*  QEChannelOpenScheduler.h
+ *
+ *  This file is part of the EPICS QT Framework, initially developed at the
+ *  Australian Synchrotron.
+ *
+ *  SPDX-FileCopyrightText: 2026 Australian Synchrotron
+ *  SPDX-License-Identifier: LGPL-3.0-only
+ *
+ *  Author:     Andrew Starritt
+ *  Maintainer: Andrew Starritt
+ *  Contact:    andrews@ansto.gov.au
+ */
+
+#ifndef QE_CHANNEL_OPEN_SCHEDULER_H
+#define QE_CHANNEL_OPEN_SCHEDULER_H
+
+#include <QList>
+#include <QObject>
+#include <QTimer>
+#include <QEFrameworkLibraryGlobal.h>
+
+namespace qcaobject {
+class QCaObject;   // differed
+}
+
+/// The QEChannelOpenScheduler class co-ordinates the opening of channels when
+/// a form is loaded, i.e. when a connection storm is likely. Between beginBatch
+/// and the matching endBatch calls, QCaObject channel open requests are queued
+/// rather than actioned immediately.
+///
+/// At the end of the (outermost) batch, channels associated with widgets that
+/// are or will be visible when the form's window is shown are opened en masse,
+/// so that all the search requests are flushed together. Channels associated
+/// with hidden widgets, e.g. on a non-current tab, are opened progressively in
+/// the background so that they do not delay the visible channels.
+///
+/// Batching may be disabled by defining the QE_DISABLE_CHANNEL_OPEN_BATCHING
+/// environment variable, or equivalent adaptation parameter, as true.
+///
+/// All functions must be called from the main GUI thread.
+///
+class QE_FRAMEWORK_LIBRARY_SHARED_EXPORT QEChannelOpenScheduler : private QObject {
+   Q_OBJECT
+public:
+   static bool isEnabled ();
+
+   // Batches may be nested - the batch is actioned at the outermost endBatch.
+   //
+   static void beginBatch ();
+   static void endBatch ();
+   static bool isBatching ();
+
+   // Returns true if the channel open request was queued. Returns false if
+   // the channel should be opened immediately by the caller.
+   //
+   static bool enqueue (qcaobject::QCaObject* qca);
+
+   // Removes any pending open request for the channel, e.g. on close/deletion.
+   //
+   static void remove (qcaobject::QCaObject* qca);
+
+private:
+   explicit QEChannelOpenScheduler ();
+   ~QEChannelOpenScheduler ();
+
+   static QEChannelOpenScheduler* singleton ();
+
+   static bool isVisibleChannel (const qcaobject::QCaObject* qca);
+   static void openChannel (qcaobject::QCaObject* qca);
+
+   // Number of deferred channels opened per timer tick.
+   //
+   static const int deferredChunkSize = 200;
+
+   int batchDepth;
+   QList<qcaobject::QCaObject*> batchList;
+   QList<qcaobject::QCaObject*> deferredList;
+   QTimer* timer;
+
+private slots:
+   void timeoutHandler ();
+};
+
+#endif // QE_CHANNEL_OPEN_SCHEDULER_H
@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2013-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2013-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Starritt
@@ -13,11 +13,20 @@
 
 #include "QEFloatingArray.h"
 #include <algorithm>
+#include <limits>
+#include <set>
 #include <QDebug>
 #include <QtAlgorithms>
 #include <QECommon.h>
 #include <QEPlatform.h>
 
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+#define QE_FLOATING_ARRAY_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+#define MIN_DELTA_X  (1.0E-20)
+
 //=================================================================================
 // QEFloatingArray
 //=================================================================================
@@ -46,51 +55,86 @@ QEFloatingArray& QEFloatingArray::operator=( const  QVector<double>& other )
 //
 double QEFloatingArray::minimumValue (const double& defaultValue, const bool includeInf)
 {
-   const int n = this->count ();
-
-   double result = defaultValue;
-   bool isFirst = true;
-   for (int j = 0; j < n; j++) {
-      const double v = this->value (j);
-
-      // Ignore nan values, and only include inf if requested
-      //
-      if (QEPlatform::isNaN (v)) continue;
-      if (!includeInf && QEPlatform::isInf (v)) continue;
-
-      if (isFirst) {
-         result = v;
-         isFirst = false;
-      } else {
-         result = MIN (result, v);   // not first, so must merge
-      }
-   }
-   return result;
+   return QEFloatingArray::extremeValue (this->constData (), this->count (),
+                                         defaultValue, includeInf, true);
 }
 
 //---------------------------------------------------------------------------------
 //
 double QEFloatingArray::maximumValue (const double& defaultValue, const bool includeInf)
 {
-   const int n = this->count ();
+   return QEFloatingArray::extremeValue (this->constData (), this->count (),
+                                         defaultValue, includeInf, false);
+}
 
-   double result = defaultValue;
-   bool isFirst = true;
-   for (int j = 0; j < n; j++) {
-      const double v = this->value (j);
+//---------------------------------------------------------------------------------
+// static
+double QEFloatingArray::extremeValue (const double* data, const int n,
+                                      const double& defaultValue,
+                                      const bool includeInf,
+                                      const bool findMinimum)
+{
+   // Find the first usable value - ignore nan values, and only include inf
+   // if requested.
+   //
+   int j = 0;
+   while ((j < n) && (QEPlatform::isNaN (data [j]) ||
+                      (!includeInf && QEPlatform::isInf (data [j])))) {
+      j++;
+   }
+   if (j >= n) return defaultValue;    // no usable values
 
-      // Ignore nan values, and only include inf if requested
-      //
-      if (QEPlatform::isNaN (v)) continue;
-      if (!includeInf && QEPlatform::isInf (v)) continue;
-
-      if (isFirst) {
-         result = v;
-         isFirst = false;
-      } else {
-         result = MAX (result, v);   // not first, so must merge
+   double result = data [j++];
+
+   // A nan never compares less/greater than the result, so nan values drop
+   // out without any explicit test. When excluding +/-inf, these are the only
+   // values (other than nan) for which |v| is not less than or equal to the
+   // maximum double.
+   //
+   const double limit = includeInf ? std::numeric_limits<double>::infinity () :
+                                     std::numeric_limits<double>::max ();
+
+#ifdef QE_FLOATING_ARRAY_USE_SSE2
+   // Two values at a time. Each lane holds the extreme value of its half of
+   // the values, starting from the first usable value; the lanes are merged
+   // at the end. Note: of equal values, e.g. 0.0 and -0.0, it is unspecified
+   // which one is returned.
+   //
+   if (n - j >= 2) {
+      const __m128d signBit = _mm_set1_pd (-0.0);
+      const __m128d limits = _mm_set1_pd (limit);
+      __m128d extreme = _mm_set1_pd (result);
+
+      for (; j + 1 < n; j += 2) {
+         const __m128d v = _mm_loadu_pd (data + j);
+         const __m128d better = findMinimum ? _mm_cmplt_pd (v, extreme)
+                                            : _mm_cmpgt_pd (v, extreme);
+         const __m128d usable = _mm_cmple_pd (_mm_andnot_pd (signBit, v), limits);
+         const __m128d mask = _mm_and_pd (better, usable);
+         extreme = _mm_or_pd (_mm_and_pd (mask, v), _mm_andnot_pd (mask, extreme));
       }
+
+      double lanes [2];
+      _mm_storeu_pd (lanes, extreme);
+      result = lanes [0];
+      result = (findMinimum ? (lanes [1] < result) : (lanes [1] > result)) ? lanes [1] : result;
    }
+#endif
+
+   // Any remaining values (all values when SSE2 is not available).
+   //
+   if (findMinimum) {
+      for (; j < n; j++) {
+         const double v = data [j];
+         result = ((v < result) && (ABS (v) <= limit)) ? v : result;
+      }
+   } else {
+      for (; j < n; j++) {
+         const double v = data [j];
+         result = ((v > result) && (ABS (v) <= limit)) ? v : result;
+      }
+   }
+
    return result;
 }
 
@@ -100,90 +144,169 @@ QEFloatingArray QEFloatingArray::calcDyByDx (const QVector<double>& x)
 {
    const int size = MIN (this->size(), x.size());
    QEFloatingArray result;
-   double s;
-   int j;
 
-   result.clear ();
+   if (size <= 0) return result;
 
    if (size == 1) {
       result.append (0.0);
+      return result;
+   }
 
-   } else if (size == 2) {
-
-      s = derivative (x.value (0), this->value (0),
-                      x.value (1), this->value (1));
-
-      result.append (s);
-      result.append (s);
+   // Allocate up front and access raw data - avoids the per element append
+   // and bounds checking.
+   //
+   result.resize (size);
+   const double* xd = x.constData ();
+   const double* yd = this->constData ();
+   double* rd = result.data ();
 
-   } else if (size >= 3) {
+   // First and last points based on two-point polynomials. For size 2 these
+   // are the same.
+   //
+   rd [0] = derivative (xd [0], yd [0], xd [1], yd [1]);
+   rd [size - 1] = derivative (xd [size - 2], yd [size - 2],
+                               xd [size - 1], yd [size - 1]);
 
-      // First point.
-      //
-      s = derivative (x.value (0), this->value (0),
-                      x.value (1), this->value (1));
-      result.append (s);
+   // Middle points.
+   //
+   int j = 1;
 
-      // Middle points.
+#ifdef QE_FLOATING_ARRAY_USE_SSE2
+   // Two points at a time - exactly as per derivative (xp1, yp1, ... yp3),
+   // i.e. the same operations in the same order, so the results are identical.
+   //
+   const __m128d signBit = _mm_set1_pd (-0.0);
+   const __m128d minDeltaX = _mm_set1_pd (MIN_DELTA_X);
+
+   for (; j + 1 < size - 1; j += 2) {
+      const __m128d xp2 = _mm_loadu_pd (xd + j);
+      const __m128d yp2 = _mm_loadu_pd (yd + j);
+      const __m128d x1 = _mm_sub_pd (_mm_loadu_pd (xd + j - 1), xp2);
+      const __m128d y1 = _mm_sub_pd (_mm_loadu_pd (yd + j - 1), yp2);
+      const __m128d x3 = _mm_sub_pd (_mm_loadu_pd (xd + j + 1), xp2);
+      const __m128d y3 = _mm_sub_pd (_mm_loadu_pd (yd + j + 1), yp2);
+
+      const __m128d divisor = _mm_mul_pd (_mm_mul_pd (x1, x3), _mm_sub_pd (x3, x1));
+      const __m128d numerator = _mm_sub_pd (_mm_mul_pd (_mm_mul_pd (y1, x3), x3),
+                                            _mm_mul_pd (_mm_mul_pd (y3, x1), x1));
+
+      // Avoid the divide by zero - the quotient is discarded, i.e. set to 0.0,
+      // where the divisor is too small.
       //
-      for (j = 1 ; j < size - 1; j++) {
-         s = derivative (x.value(j - 1), this->value(j - 1),
-                         x.value(j    ), this->value(j    ),
-                         x.value(j + 1), this->value(j + 1));
-         result.append (s);
-      }
+      const __m128d valid = _mm_cmpge_pd (_mm_andnot_pd (signBit, divisor), minDeltaX);
+      _mm_storeu_pd (rd + j, _mm_and_pd (valid, _mm_div_pd (numerator, divisor)));
+   }
+#endif
 
-      // Last point.
-      //
-      s = derivative (x.value (size - 2), this->value (size - 2),
-                      x.value (size - 1), this->value (size - 1));
-      result.append (s);
+   // Any remaining points (all points when SSE2 is not available).
+   //
+   for (; j < size - 1; j++) {
+      rd [j] = derivative (xd [j - 1], yd [j - 1],
+                           xd [j    ], yd [j    ],
+                           xd [j + 1], yd [j + 1]);
    }
 
    return result;
 }
 
+//---------------------------------------------------------------------------------
+// Provides a strict weak ordering that includes nan values - these are ordered
+// after all other values, and are all equivalent to each other.
+//
+struct QEFloatingArrayMedianOrder {
+   bool operator () (const double a, const double b) const {
+      if (QEPlatform::isNaN (a)) return false;
+      if (QEPlatform::isNaN (b)) return true;
+      return a < b;
+   }
+};
+
 //---------------------------------------------------------------------------------
 //
 QEFloatingArray QEFloatingArray::medianFilter (const int window)
 {
    const int size = this->size ();
-   QEFloatingArray result;
-   result.reserve (size);
-
-   if (window > 1) {
-      const int offset = window / 2;
-      for (int j = 0; j < size; j++) {
-         // Must cater for edge effects
-         //
-         int pos = MAX (j - offset, 0);
-         int end = MIN (j + offset, size - 1);
-
-         // Extract vector slice, sort and extract middle, i.e. median, value.
-         //
-         QVector<double> qtemp = this->mid (pos, end - pos + 1);
-         std::vector <double> temp;
-
-         // Create a std vector form the QVector. Is there a better way?
-         //
-         for (int j = 0; j < qtemp.size(); j++) {
-            temp.push_back(qtemp[j]);
+
+   if ((window <= 1) || (size == 0)) {
+      // Window size is 1 (identity) or invalid - just return this vector.
+      //
+      return *this;
+   }
+
+   QEFloatingArray result (size);
+   const double* source = this->constData ();
+   double* target = result.data ();
+
+   // The window for element j is [j - offset, j + offset], truncated at the
+   // edges, and the median is the (count/2)'th sorted element (zero based),
+   // i.e. the upper median when the truncated window has an even count.
+   //
+   // As both window ends only ever move forwards, we maintain the window
+   // contents in two sorted multisets such that lower holds the count/2
+   // smallest values and upper holds the rest; the median is then the first
+   // element of upper. Each step is O(log window) as opposed to sorting the
+   // whole window for each element.
+   //
+   typedef std::multiset<double, QEFloatingArrayMedianOrder> Sets;
+   const QEFloatingArrayMedianOrder lessThan = QEFloatingArrayMedianOrder ();
+   const int offset = window / 2;
+
+   Sets lower;
+   Sets upper;
+   int first = 0;    // first element in the window
+   int last = -1;    // last element in the window
+
+   for (int j = 0; j < size; j++) {
+      const int pos = MAX (j - offset, 0);
+      const int end = MIN (j + offset, size - 1);
+
+      // Add new elements into the window.
+      //
+      while (last < end) {
+         last++;
+         const double v = source [last];
+         if (!lower.empty () && !lessThan (*lower.rbegin (), v)) {
+            lower.insert (v);
+         } else {
+            upper.insert (v);
          }
+      }
 
-         std::sort (temp.begin(), temp.end());
-         result.append (temp [qtemp.size ()/2]);
+      // Remove old elements from the window. Any value not greater than the
+      // largest lower value must be in lower (there may also be an equivalent
+      // value in upper, but then it does not matter which one is removed).
+      //
+      while (first < pos) {
+         const double v = source [first];
+         first++;
+         if (!lower.empty () && !lessThan (*lower.rbegin (), v)) {
+            lower.erase (lower.find (v));
+         } else {
+            upper.erase (upper.find (v));
+         }
       }
-   } else {
-      // Window size is 1 (identity) or invalid - just return this vector.
+
+      // Re-balance.
       //
-      result = *this;
+      const size_t lowerSize = size_t (end - pos + 1) / 2;
+      while (lower.size () > lowerSize) {
+         Sets::iterator it = lower.end ();
+         --it;
+         upper.insert (*it);
+         lower.erase (it);
+      }
+      while (lower.size () < lowerSize) {
+         Sets::iterator it = upper.begin ();
+         lower.insert (*it);
+         upper.erase (it);
+      }
+
+      target [j] = *upper.begin ();
    }
+
    return result;
 }
 
-
-#define MIN_DELTA_X  (1.0E-20)
-
 //---------------------------------------------------------------------------------
 // static
 double QEFloatingArray::derivative (const double xp1, const double yp1,
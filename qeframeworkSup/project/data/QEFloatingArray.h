@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2013-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2013-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Starritt
@@ -47,10 +47,16 @@ public:
 
    // Calc median filter. window is median window size.
    // Should be > 0 and odd. 1 is essentuially no filter.
+   // This is O(n.log(window)), i.e. the window is not sorted for each element.
    //
    QEFloatingArray medianFilter (const int window);
 
 private:
+   static double extremeValue (const double* data, const int n,
+                               const double& defaultValue,
+                               const bool includeInf,
+                               const bool findMinimum);
+
    static double derivative (const double xp1, const double yp1,
                              const double xp2, const double yp2);
 
@@ -38,6 +38,9 @@ SOURCES += $$PWD/QEByteArray.cpp
 HEADERS += $$PWD/QEChannel.h
 SOURCES += $$PWD/QEChannel.cpp
 
+HEADERS += $$PWD/QEChannelOpenScheduler.h
+SOURCES += $$PWD/QEChannelOpenScheduler.cpp
+
 HEADERS += $$PWD/QEFloating.h
 SOURCES += $$PWD/QEFloating.cpp
 
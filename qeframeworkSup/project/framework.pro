@@ -177,6 +177,7 @@ include (common/common.pri)
 include (protocol/protocol.pri)
 include (data/data.pri)
 include (archive/archive.pri)
+include (threads/threads.pri)
 include (widgets/QEWidget/QEWidget.pri)
 include (widgets/QE2DDataVisualisation/QE2DDataVisualisation.pri)
 include (widgets/QEAbstractWidget/QEAbstractWidget.pri)
@@ -13,11 +13,16 @@
 
 #include "QECaClient.h"
 #include <new>
+#include <QCoreApplication>
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
 #include <QMetaType>
+#include <QTextStream>
 #include <QTimer>
 #include <QtGlobal>
 #include <acai_version.h>
+#include <QEAdaptationParameters.h>
 #include <QEPlatform.h>
 #include <QEPvNameUri.h>
 #include <QERecordFieldName.h>
@@ -82,6 +87,46 @@ void QE_ACAI_Client::putCallbackNotifcation (const bool isSuccessful)
 }
 
 
+//==============================================================================
+// QE_ACAI_DescClient
+//==============================================================================
+//
+// Its sole purpose is to override dataUpdate and forward to the description
+// manager.
+//
+class QE_ACAI_DescClient : public ACAI::Client {
+public:
+   explicit QE_ACAI_DescClient (const QString& descPvName);
+   ~QE_ACAI_DescClient ();
+
+   const QString descPvName;
+   QElapsedTimer openTime;    // started when the channel is opened.
+
+protected:
+   // Override ACAI::Client parent class function.
+   //
+   void dataUpdate (const bool firstUpdate);
+};
+
+//------------------------------------------------------------------------------
+//
+QE_ACAI_DescClient::QE_ACAI_DescClient (const QString& descPvNameIn) :
+   ACAI::Client (descPvNameIn.toStdString()),
+   descPvName (descPvNameIn)
+{ }
+
+//------------------------------------------------------------------------------
+//
+QE_ACAI_DescClient::~QE_ACAI_DescClient () { }
+
+//------------------------------------------------------------------------------
+//
+void QE_ACAI_DescClient::dataUpdate (const bool)
+{
+   QECaDescriptionManager::dataUpdate (this);
+}
+
+
 //==============================================================================
 // QECaClient
 //==============================================================================
@@ -94,7 +139,19 @@ QECaClient::QECaClient (const QString& pvNameIn,
     static_assert (sizeof (this->mainClientBuffer) >= sizeof(QE_ACAI_Client),
                    "Preallocated buffer too small for QE_ACAI_Client object");
 
-   this->descClient = NULL;     // we don't create a DESC client unless requested.
+   // Note: the assumption here is that the PV is a the name of a record or a
+   // record field hosted on an IOC. However if this is a PV hosted on a Portable
+   // Channel Access Server (PCAS) such as a gateway generated PV or a pycas PV,
+   // the <name>.DESC PV may not exist, or if it does it may not actually be
+   // a description.
+   // If this client is already looking at a description field, we leave the
+   // description PV name empty.
+   //
+   if (!pvNameIn.endsWith (".DESC")) {
+      this->descPvName = QERecordFieldName::fieldPvName (pvNameIn, "DESC");
+   }
+   this->descriptionRequested = false;   // we don't request a DESC unless needed.
+   this->cachedPvDataIsValid = false;
    QECaClientManager::initialise ();   // idempotent
 }
 
@@ -102,43 +159,35 @@ QECaClient::QECaClient (const QString& pvNameIn,
 //
 QECaClient::~QECaClient ()
 {
-   // valueClient and descriptionClient have an owner(this) but not a parent,
-   // so we must explicitly delete these QE_ACAI_Client objects.
+   // mainClient has an owner(this) but not a parent, so we must explicitly
+   // close and destruct this QE_ACAI_Client object.
    //
    this->mainClient->closeChannel ();
 
-   if (this->descClient && (this->descClient != this->mainClient)) {
-      // This is a separate client
-      this->descClient->closeChannel();
-      delete this->descClient;
-      this->descClient = NULL;
+   if (this->descriptionRequested) {
+      QECaDescriptionManager::cancel (this->descPvName, this);
    }
 
    this->mainClient->~QE_ACAI_Client();
 }
 
 //------------------------------------------------------------------------------
-// Form DESCription PV name and request data.
-// Note: the assumption here is that the PV is a the name of a record or a
-// record field hosted on an IOC. However if this is a PV hosted on a Portable
-// Channel Access Server (PCAS) such as a gateway generated PV or a pycas PV,
-// the <name>.DESC PV may not exist, or if it does it may not actually be
-// a description.
+// Request DESCription from the description manager.
 //
 void QECaClient::requestDescription ()
 {
-   if (!this->descClient) {
-      QString pvName = this->getPvName();
+   QECaDescriptionManager::request (this->descPvName, this);
+}
 
-      if (pvName.endsWith (".DESC")) {
-         // This client is already looking at a description field.
-         //
-         this->descClient = this->mainClient;
-      } else {
-         QString descPvName = QERecordFieldName::fieldPvName (pvName, "DESC");
-         this->descClient = new QE_ACAI_Client (descPvName, this);
-         this->descClient->openChannel();
-      }
+//------------------------------------------------------------------------------
+// Called by the description manager when our description has been read.
+// Emulate a data update so that interested widgets re-read the description.
+//
+void QECaClient::descriptionAvailable ()
+{
+   this->descriptionRequested = false;
+   if (this->dataIsAvailable ()) {
+      emit this->dataUpdated (false);
    }
 }
 
@@ -179,6 +228,7 @@ bool QECaClient::openChannel (const ChannelModesFlags modes)
       this->mainClient->setEventMask (mask);
    }
 
+   this->cachedPvDataIsValid = false;
    this->mainClient->setReadMode (readMode);
    return this->mainClient->openChannel ();
 }
@@ -187,6 +237,7 @@ bool QECaClient::openChannel (const ChannelModesFlags modes)
 //
 void QECaClient::closeChannel ()
 {
+   this->cachedPvDataIsValid = false;
    this->mainClient->closeChannel ();
 }
 
@@ -223,6 +274,17 @@ const void* QECaClient::getRawDataPointer (size_t& count,
 //------------------------------------------------------------------------------
 //
 QVariant QECaClient::getPvData () const
+{
+   if (!this->cachedPvDataIsValid) {
+      this->cachedPvData = this->convertPvData ();
+      this->cachedPvDataIsValid = true;
+   }
+   return this->cachedPvData;
+}
+
+//------------------------------------------------------------------------------
+//
+QVariant QECaClient::convertPvData () const
 {
    QVariant result = QVariant ();  // default - invalid/unknown
 
@@ -778,12 +840,18 @@ QCaDateTime QECaClient::getTimeStamp () const
 //
 QString QECaClient::getDescription () const
 {
-   QString result;
-   if (this->descClient) {
-      result = QString::fromStdString (this->descClient->getString());
-   } else {
+   if (this->descPvName.isEmpty ()) {
+      // This client is already looking at a description field.
+      //
+      return QString::fromStdString (this->mainClient->getString());
+   }
+
+   bool isKnown;
+   QString result = QECaDescriptionManager::getDescription (this->descPvName, isKnown);
+   if (!isKnown && !this->descriptionRequested) {
       // We use a slot, mainly to overcome the const qualifier error.
       //
+      this->descriptionRequested = true;
       QTimer::singleShot (0, this, SLOT (requestDescription ()));
    }
    return result;
@@ -792,17 +860,25 @@ QString QECaClient::getDescription () const
 //------------------------------------------------------------------------------
 // As-is call throughs.
 void QECaClient::setPriority (const unsigned int priority)   { this->mainClient->setPriority (priority); }
-void QECaClient::setRequestCount (const unsigned int number) { this->mainClient->setRequestCount (number); }
 bool QECaClient::getReadAccess() const                       { return this->mainClient->readAccess(); }
 bool QECaClient::getWriteAccess() const                      { return this->mainClient->writeAccess(); }
 void QECaClient::setUsePutCallback (const bool enable)       { this->mainClient->setUsePutCallback (enable); }
 bool QECaClient::getUsePutCallback() const                   { return this->mainClient->usePutCallback(); }
 unsigned QECaClient::getDataElementSize() const              { return this->mainClient->dataElementSize(); }
 
+//------------------------------------------------------------------------------
+//
+void QECaClient::setRequestCount (const unsigned int number)
+{
+   this->cachedPvDataIsValid = false;
+   this->mainClient->setRequestCount (number);
+}
+
 //------------------------------------------------------------------------------
 //
 void QECaClient::connectionUpdate (const bool isConnected)
 {
+   this->cachedPvDataIsValid = false;
    emit this->connectionUpdated (isConnected);
 }
 
@@ -810,6 +886,7 @@ void QECaClient::connectionUpdate (const bool isConnected)
 //
 void QECaClient::dataUpdate (const bool firstUpdate)
 {
+    this->cachedPvDataIsValid = false;
     emit this->dataUpdated (firstUpdate);
 }
 
@@ -886,4 +963,323 @@ void QECaClientManager::timeoutHandler ()
    QTimer::singleShot (16, this, SLOT (timeoutHandler ()));
 }
 
+
+//==============================================================================
+// Helper class: QECaDescriptionManager
+//==============================================================================
+//
+static bool descriptionManagerIsDestroyed = false;
+
+//------------------------------------------------------------------------------
+// static
+QECaDescriptionManager* QECaDescriptionManager::singleton ()
+{
+   // As per QECaClientManager, the singleton object created when first needed.
+   //
+   static QECaDescriptionManager instance;
+   return &instance;
+}
+
+//------------------------------------------------------------------------------
+//
+QECaDescriptionManager::QECaDescriptionManager () : QObject (NULL)
+{
+   QEAdaptationParameters ap ("QE_");
+   this->cacheFilename = ap.getFilename ("description_cache_file", "");
+   this->maxAgeSecs = ap.getInt ("description_cache_age", 24) * 3600;
+
+   this->batchTimer = new QTimer (this);
+   this->batchTimer->setSingleShot (true);
+   this->batchTimer->setInterval (20);   // allows requests to accumulate.
+   QObject::connect (this->batchTimer, SIGNAL (timeout ()),
+                     this,             SLOT   (batchHandler ()));
+
+   // Only runs while there are active clients.
+   //
+   this->timeoutTimer = new QTimer (this);
+   this->timeoutTimer->setInterval (1000);
+   QObject::connect (this->timeoutTimer, SIGNAL (timeout ()),
+                     this,               SLOT   (timeoutHandler ()));
+
+   QObject::connect (qApp, SIGNAL (aboutToQuit ()),
+                     this, SLOT   (aboutToQuitHandler ()));
+
+   this->loadCache ();
+}
+
+//------------------------------------------------------------------------------
+//
+QECaDescriptionManager::~QECaDescriptionManager ()
+{
+   descriptionManagerIsDestroyed = true;
+}
+
+//------------------------------------------------------------------------------
+// static
+QString QECaDescriptionManager::getDescription (const QString& descPvName,
+                                                bool& isKnown)
+{
+   isKnown = false;
+   if (descriptionManagerIsDestroyed) return "";
+
+   QECaDescriptionManager* self = QECaDescriptionManager::singleton ();
+   if (!self->cache.contains (descPvName)) return "";
+
+   isKnown = true;
+   const CacheItem item = self->cache.value (descPvName);
+
+   // Persisted descriptions may be stale - initiate a refresh if needs be.
+   // Timed out reads are retried much sooner.
+   //
+   const int maxAge = item.timedOut ? int (retryAgeSecs) : self->maxAgeSecs;
+   if (item.obtained.secsTo (QDateTime::currentDateTime ()) > maxAge) {
+      QECaDescriptionManager::request (descPvName, NULL);
+   }
+
+   return item.description;
+}
+
+//------------------------------------------------------------------------------
+// static
+void QECaDescriptionManager::request (const QString& descPvName, QECaClient* client)
+{
+   if (descriptionManagerIsDestroyed) return;
+   if (descPvName.isEmpty ()) return;
+
+   QECaDescriptionManager* self = QECaDescriptionManager::singleton ();
+
+   if (client) {
+      self->waitingClients [descPvName].insert (client);
+   }
+
+   // Do we already have a read pending or in progress?
+   //
+   if (self->pendingSet.contains (descPvName)) return;
+   if (self->activeClients.contains (descPvName)) return;
+
+   self->pendingNames.append (descPvName);
+   self->pendingSet.insert (descPvName);
+   self->scheduleBatch ();
+}
+
+//------------------------------------------------------------------------------
+// static
+void QECaDescriptionManager::cancel (const QString& descPvName, QECaClient* client)
+{
+   if (descriptionManagerIsDestroyed) return;
+
+   QECaDescriptionManager* self = QECaDescriptionManager::singleton ();
+
+   if (self->waitingClients.contains (descPvName)) {
+      QSet<QECaClient*>& clients = self->waitingClients [descPvName];
+      clients.remove (client);
+      if (clients.isEmpty ()) {
+         self->waitingClients.remove (descPvName);
+      }
+   }
+}
+
+//------------------------------------------------------------------------------
+// static - called from within the ACAI poll, i.e. on the main thread.
+void QECaDescriptionManager::dataUpdate (QE_ACAI_DescClient* descClient)
+{
+   if (descriptionManagerIsDestroyed) return;
+
+   QECaDescriptionManager* self = QECaDescriptionManager::singleton ();
+   const QString descPvName = descClient->descPvName;
+
+   CacheItem item;
+   item.description = QString::fromStdString (descClient->getString ());
+   item.obtained = QDateTime::currentDateTime ();
+   item.timedOut = false;
+   self->cache.insert (descPvName, item);
+
+   // We can't close/delete the client from within its own callback.
+   //
+   self->activeClients.remove (descPvName);
+   self->finishedClients.append (descClient);
+   self->scheduleBatch ();
+
+   const QSet<QECaClient*> clients = self->waitingClients.take (descPvName);
+   QSet<QECaClient*>::const_iterator it;
+   for (it = clients.constBegin (); it != clients.constEnd (); ++it) {
+      (*it)->descriptionAvailable ();
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+void QECaDescriptionManager::scheduleBatch ()
+{
+   if (!this->batchTimer->isActive ()) {
+      this->batchTimer->start ();
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+void QECaDescriptionManager::batchHandler ()
+{
+   // Close and delete the clients that have done their job.
+   //
+   while (!this->finishedClients.isEmpty ()) {
+      QE_ACAI_DescClient* descClient = this->finishedClients.takeFirst ();
+      descClient->closeChannel ();
+      delete descClient;
+   }
+
+   // Create the next batch of channels. Channel creation requests are
+   // flushed together by the next ACAI poll.
+   //
+   int count = 0;
+   while (!this->pendingNames.isEmpty () && (count < maxBatchSize)) {
+      const QString descPvName = this->pendingNames.takeFirst ();
+      this->pendingSet.remove (descPvName);
+
+      QE_ACAI_DescClient* descClient = new QE_ACAI_DescClient (descPvName);
+      descClient->setReadMode (ACAI::SingleRead);
+      this->activeClients.insert (descPvName, descClient);
+      descClient->openTime.start ();
+      descClient->openChannel ();
+      count++;
+   }
+
+   if (!this->pendingNames.isEmpty ()) {
+      this->scheduleBatch ();
+   }
+
+   if (!this->activeClients.isEmpty () && !this->timeoutTimer->isActive ()) {
+      this->timeoutTimer->start ();
+   }
+}
+
+//------------------------------------------------------------------------------
+// Abandon any .DESC channels that have not connected and provided a value in
+// a timely manner, e.g. the IOC is down, and release the waiting clients.
+//
+void QECaDescriptionManager::timeoutHandler ()
+{
+   const qint64 limit = qint64 (readTimeoutSecs) * 1000;
+
+   QStringList timedOutNames;
+   QHash<QString, QE_ACAI_DescClient*>::const_iterator it;
+   for (it = this->activeClients.constBegin (); it != this->activeClients.constEnd (); ++it) {
+      if (it.value ()->openTime.elapsed () >= limit) {
+         timedOutNames.append (it.key ());
+      }
+   }
+
+   for (int j = 0; j < timedOutNames.count (); j++) {
+      const QString descPvName = timedOutNames.value (j);
+
+      this->finishedClients.append (this->activeClients.take (descPvName));
+
+      // Cache as known but empty so that the waiting clients do not just
+      // re-request the description straight away.
+      //
+      CacheItem item;
+      item.description = "";
+      item.obtained = QDateTime::currentDateTime ();
+      item.timedOut = true;
+      this->cache.insert (descPvName, item);
+
+      const QSet<QECaClient*> clients = this->waitingClients.take (descPvName);
+      QSet<QECaClient*>::const_iterator cit;
+      for (cit = clients.constBegin (); cit != clients.constEnd (); ++cit) {
+         (*cit)->descriptionAvailable ();
+      }
+   }
+
+   if (!this->finishedClients.isEmpty ()) {
+      this->scheduleBatch ();
+   }
+
+   if (this->activeClients.isEmpty ()) {
+      this->timeoutTimer->stop ();
+   }
+}
+
+//------------------------------------------------------------------------------
+// The file format is one description per line: name <tab> time <tab> description
+//
+void QECaDescriptionManager::loadCache ()
+{
+   if (this->cacheFilename.isEmpty ()) return;
+
+   QFile file (this->cacheFilename);
+   if (!file.open (QIODevice::ReadOnly | QIODevice::Text)) return;
+
+   QTextStream source (&file);
+   while (!source.atEnd ()) {
+      const QString line = source.readLine ();
+      const QStringList parts = line.split ('\t');
+      if (parts.count () != 3) continue;
+
+      bool okay;
+      const qint64 secs = parts.value (1).toLongLong (&okay);
+      if (!okay) continue;
+
+      // Note: the file holds seconds, but fromSecsSinceEpoch requires Qt 5.8
+      // or later, so use fromMSecsSinceEpoch.
+      //
+      CacheItem item;
+      item.description = parts.value (2);
+      item.obtained = QDateTime::fromMSecsSinceEpoch (secs * 1000);
+      item.timedOut = false;
+      this->cache.insert (parts.value (0), item);
+   }
+   file.close ();
+}
+
+//------------------------------------------------------------------------------
+//
+void QECaDescriptionManager::saveCache ()
+{
+   if (this->cacheFilename.isEmpty ()) return;
+
+   QFile file (this->cacheFilename);
+   if (!file.open (QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+      DEBUG << "unable to write description cache file" << this->cacheFilename;
+      return;
+   }
+
+   QTextStream target (&file);
+   QHash<QString, CacheItem>::const_iterator it;
+   for (it = this->cache.constBegin (); it != this->cache.constEnd (); ++it) {
+      if (it.value ().timedOut) continue;   // never obtained
+
+      QString description = it.value ().description;
+      description.replace ('\t', ' ');
+      description.replace ('\n', ' ');
+      target << it.key () << '\t'
+             << (it.value ().obtained.toMSecsSinceEpoch () / 1000) << '\t'
+             << description << '\n';
+   }
+   target.flush ();
+   file.close ();
+}
+
+//------------------------------------------------------------------------------
+//
+void QECaDescriptionManager::aboutToQuitHandler ()
+{
+   this->saveCache ();
+   this->batchTimer->stop ();
+   this->timeoutTimer->stop ();
+
+   QHash<QString, QE_ACAI_DescClient*>::const_iterator it;
+   for (it = this->activeClients.constBegin (); it != this->activeClients.constEnd (); ++it) {
+      this->finishedClients.append (it.value ());
+   }
+   this->activeClients.clear ();
+   this->pendingNames.clear ();
+   this->pendingSet.clear ();
+
+   while (!this->finishedClients.isEmpty ()) {
+      QE_ACAI_DescClient* descClient = this->finishedClients.takeFirst ();
+      descClient->closeChannel ();
+      delete descClient;
+   }
+}
+
 // end
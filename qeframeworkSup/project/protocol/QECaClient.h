@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2018-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2018-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Starritt
@@ -17,6 +17,12 @@
 #include <acai_client_types.h>
 #include <acai_client.h>
 
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
 #include <QEBaseClient.h>
 #include <QCaAlarmInfo.h>
 #include <QCaDateTime.h>
@@ -24,7 +30,8 @@
 
 // We use encapsulation rather than direct inheritance.
 //
-class QE_ACAI_Client;  // differed - internal class
+class QE_ACAI_Client;        // differed - internal class
+class QE_ACAI_DescClient;    // differed - internal class
 
 //------------------------------------------------------------------------------
 /// The main purpose of this class is to convert regular call backs from
@@ -90,15 +97,29 @@ protected:
    void dataUpdate (const bool firstUpdate);
    void putCallbackNotifcation (const bool isSuccessful);
 
+   // Called by QECaDescriptionManager.
+   //
+   friend class QECaDescriptionManager;
+
+   void descriptionAvailable ();
+
 private:
    // Local conveniance functions.
    //
+   QVariant convertPvData () const;
    bool variantToFloat (const QVariant& qValue, ACAI::ClientFloating& fValue, bool& valueInRange);
    bool variantToInteger (const QVariant& qValue, ACAI::ClientInteger& iValue, bool& valueInRange);
    bool variantToEnumIndex (const QVariant& qValue, ACAI::ClientInteger& index, bool& valueInRange);
 
    QE_ACAI_Client* mainClient;    // Typically but not necessarily .VAL field.
-   QE_ACAI_Client* descClient;    // connects to the .DESC field (when needed).
+   QString descPvName;            // The associated .DESC field PV name.
+   mutable bool descriptionRequested;
+
+   // The variant conversion is done at most once per update, and the result is
+   // shared (QVariant is implicitly shared) between all interested parties.
+   //
+   mutable QVariant cachedPvData;
+   mutable bool cachedPvDataIsValid;
 
    alignas (8) uint8_t mainClientBuffer [952];  // holds the main client
 
@@ -134,4 +155,80 @@ private slots:
    void timeoutHandler ();
 };
 
+//------------------------------------------------------------------------------
+// This is also essentially a singleton private class using the Meyer’s Singleton
+// design pattern. It provides a process wide, deduplicated, DESCription cache.
+// Requests for as yet unknown descriptions are queued and the .DESC channels are
+// created in batches from a single timer event, so that they are all flushed
+// together on the next poll. Each channel performs a single read, and is closed
+// and deleted once the value has been obtained.
+//
+// The cache may optionally be persisted between sessions by defining the
+// QE_DESCRIPTION_CACHE_FILE adaptation parameter. Persisted descriptions are
+// used immediately, but are refreshed once they are older than
+// QE_DESCRIPTION_CACHE_AGE hours (default 24).
+//
+// A .DESC channel that does not provide a value within a timeout is abandoned,
+// and its waiting clients are released with an empty description. Such names
+// are retried, on request, after a short interval and are not persisted.
+//
+class QECaDescriptionManager : private QObject {
+   Q_OBJECT
+public:
+   // Returns the cached description, if known, otherwise an empty string.
+   //
+   static QString getDescription (const QString& descPvName, bool& isKnown);
+
+   // Queue a request on behalf of the client. The client is notified, by means
+   // of QECaClient::descriptionAvailable, once the description has been read.
+   //
+   static void request (const QString& descPvName, QECaClient* client);
+   static void cancel (const QString& descPvName, QECaClient* client);
+
+protected:
+   // Called by QE_ACAI_DescClient.
+   //
+   friend class QE_ACAI_DescClient;
+   static void dataUpdate (QE_ACAI_DescClient* descClient);
+
+private:
+   explicit QECaDescriptionManager ();
+   ~QECaDescriptionManager ();
+
+   static QECaDescriptionManager* singleton ();
+
+   struct CacheItem {
+      QString description;
+      QDateTime obtained;
+      bool timedOut;          // no value obtained - description is empty.
+   };
+
+   enum Constants {
+      maxBatchSize = 400,     // max number of channels created per batch.
+      readTimeoutSecs = 10,   // max time allowed to connect and read a .DESC
+      retryAgeSecs = 60       // time before a timed out read may be retried.
+   };
+
+   void scheduleBatch ();
+   void loadCache ();
+   void saveCache ();
+
+   QString cacheFilename;
+   int maxAgeSecs;
+
+   QHash<QString, CacheItem> cache;                    // keyed by .DESC PV name
+   QHash<QString, QSet<QECaClient*> > waitingClients;  // ditto
+   QStringList pendingNames;                           // awaiting channel creation
+   QSet<QString> pendingSet;                           // ditto - quick lookup
+   QHash<QString, QE_ACAI_DescClient*> activeClients;  // awaiting data
+   QList<QE_ACAI_DescClient*> finishedClients;         // awaiting close/delete
+   QTimer* batchTimer;
+   QTimer* timeoutTimer;
+
+private slots:
+   void batchHandler ();
+   void timeoutHandler ();
+   void aboutToQuitHandler ();
+};
+
 #endif // QE_CA_CLIENT_H
@@ -0,0 +1,268 @@
+/*  QEChannelRegistry.cpp
+ *
+ *  This file is part of the EPICS QT Framework, initially developed at the
+ *  Australian Synchrotron.
+ *
+ *  SPDX-FileCopyrightText: 2026 Australian Synchrotron
+ *  SPDX-License-Identifier: LGPL-3.0-only
+ *
+ *  Author:     Andrew Starritt
+ *  Maintainer: Andrew Starritt
+ *  Contact:    andrews@ansto.gov.au
+ */
+
+#include "QEChannelRegistry.h"
+#include <algorithm>
+#include <QDebug>
+#include <QList>
+#include <QPair>
+#include <QStringList>
+#include <QECommon.h>
+#include <QEAdaptationParameters.h>
+#include <QECaClient.h>
+#include <QEPvaClient.h>
+
+#define DEBUG qDebug () << "QEChannelRegistry" << __LINE__ << __FUNCTION__ << "  "
+
+//==============================================================================
+// QEChannelRegistry::Entry
+//==============================================================================
+//
+class QEChannelRegistry::Entry {
+public:
+   QString key;
+   QEBaseClient* client;
+   QEBaseClient::ChannelModesFlags modes;
+   int appliedPriority;
+
+   // Subscribers and their requested priorities.
+   //
+   QHash<const QObject*, int> subscribers;
+};
+
+//==============================================================================
+// QEChannelRegistry
+//==============================================================================
+//
+QEChannelRegistry::KeyEntryMap QEChannelRegistry::keyEntryMap;
+QEChannelRegistry::ClientEntryMap QEChannelRegistry::clientEntryMap;
+int QEChannelRegistry::totalSubscribers = 0;
+int QEChannelRegistry::peakClients = 0;
+int QEChannelRegistry::peakSubscribers = 0;
+
+//------------------------------------------------------------------------------
+// static
+bool QEChannelRegistry::isEnabled ()
+{
+   static bool determined = false;
+   static bool enabled = true;
+
+   if (!determined) {
+      QEAdaptationParameters ap ("QE_");
+      enabled = !ap.getBool ("disable_channel_sharing");  // default is false
+      determined = true;
+   }
+   return enabled;
+}
+
+//------------------------------------------------------------------------------
+// static
+QString QEChannelRegistry::formKey (const QEPvNameUri::Protocol protocol,
+                                    const QString& pvName,
+                                    const unsigned int elementCount,
+                                    const QEBaseClient::ChannelModesFlags modes)
+{
+   return QString ("%1|%2|%3|%4")
+         .arg (int (protocol))
+         .arg (elementCount)
+         .arg (int (modes))
+         .arg (pvName);
+}
+
+//------------------------------------------------------------------------------
+// static
+QEBaseClient* QEChannelRegistry::acquire (const QEPvNameUri::Protocol protocol,
+                                          const QString& pvName,
+                                          const unsigned int elementCount,
+                                          const QEBaseClient::ChannelModesFlags modes,
+                                          const int priority,
+                                          const QObject* subscriber)
+{
+   if (!subscriber) return NULL;   // sanity check
+
+   const QString key = QEChannelRegistry::formKey (protocol, pvName, elementCount, modes);
+
+   Entry* entry = QEChannelRegistry::keyEntryMap.value (key, NULL);
+   if (!entry) {
+      // First subscriber - create the client and open the channel.
+      //
+      QEBaseClient* client = NULL;
+      QECaClient* caClient = NULL;
+
+      switch (protocol) {
+         case QEPvNameUri::ca:
+            client = caClient = new QECaClient (pvName, NULL);
+            caClient->setPriority (priority);
+            caClient->setRequestCount (elementCount);
+            break;
+
+         case QEPvNameUri::pva:
+            client = new QEPvaClient (pvName, NULL);
+            break;
+
+         default:
+            // Null clients are not worth sharing.
+            return NULL;
+      }
+
+      entry = new Entry ();
+      entry->key = key;
+      entry->client = client;
+      entry->modes = modes;
+      entry->appliedPriority = priority;
+
+      QEChannelRegistry::keyEntryMap.insert (key, entry);
+      QEChannelRegistry::clientEntryMap.insert (client, entry);
+
+      client->openChannel (modes);
+
+      QEChannelRegistry::peakClients =
+            MAX (QEChannelRegistry::peakClients, QEChannelRegistry::keyEntryMap.count ());
+   }
+
+   if (!entry->subscribers.contains (subscriber)) {
+      QEChannelRegistry::totalSubscribers++;
+      QEChannelRegistry::peakSubscribers =
+            MAX (QEChannelRegistry::peakSubscribers, QEChannelRegistry::totalSubscribers);
+   }
+   entry->subscribers.insert (subscriber, priority);
+   QEChannelRegistry::reconcilePriority (entry);
+
+   return entry->client;
+}
+
+//------------------------------------------------------------------------------
+// static
+void QEChannelRegistry::release (QEBaseClient* client, const QObject* subscriber)
+{
+   Entry* entry = QEChannelRegistry::clientEntryMap.value (client, NULL);
+   if (!entry) {
+      DEBUG << "unknown client";
+      return;
+   }
+
+   if (entry->subscribers.remove (subscriber) > 0) {
+      QEChannelRegistry::totalSubscribers--;
+   }
+
+   if (entry->subscribers.isEmpty ()) {
+      // Last subscriber gone - close channel and delete the client.
+      // As per QCaObject, we use deleteLater to avoid any issues with
+      // any in-flight signals.
+      //
+      QEChannelRegistry::keyEntryMap.remove (entry->key);
+      QEChannelRegistry::clientEntryMap.remove (client);
+
+      client->closeChannel ();
+      client->deleteLater ();
+      delete entry;
+
+   } else {
+      QEChannelRegistry::reconcilePriority (entry);
+   }
+}
+
+//------------------------------------------------------------------------------
+// static
+void QEChannelRegistry::reconcilePriority (Entry* entry)
+{
+   int required = 0;
+   QHash<const QObject*, int>::const_iterator it;
+   for (it = entry->subscribers.constBegin(); it != entry->subscribers.constEnd(); ++it) {
+      required = MAX (required, it.value ());
+   }
+
+   if (required == entry->appliedPriority) return;   // nothing to do
+
+   // Only CA supports priorities.
+   //
+   QECaClient* caClient = qobject_cast <QECaClient*>(entry->client);
+   if (caClient) {
+      caClient->setPriority (required);
+
+      // The priority is only applied when the channel is created, so when the
+      // priority must rise, re-create the channel. The client object itself is
+      // retained, so the subscribers remain connected to it.
+      //
+      if (required > entry->appliedPriority) {
+         caClient->closeChannel ();
+         caClient->openChannel (entry->modes);
+      }
+   }
+   entry->appliedPriority = required;
+}
+
+//------------------------------------------------------------------------------
+// static
+bool QEChannelRegistry::isShared (const QEBaseClient* client)
+{
+   return QEChannelRegistry::clientEntryMap.contains (client);
+}
+
+//------------------------------------------------------------------------------
+// static
+int QEChannelRegistry::subscriberCount (const QEBaseClient* client)
+{
+   const Entry* entry = QEChannelRegistry::clientEntryMap.value (client, NULL);
+   return entry ? entry->subscribers.count () : 0;
+}
+
+//------------------------------------------------------------------------------
+// static
+QString QEChannelRegistry::statistics (const int maxChannels)
+{
+   const int numberClients = QEChannelRegistry::keyEntryMap.count ();
+   const int numberSubscribers = QEChannelRegistry::totalSubscribers;
+   const double ratio = numberClients > 0 ? double (numberSubscribers) / double (numberClients) : 0.0;
+
+   QString result;
+   result.append (QString ("shared clients: %1 (peak %2)\n")
+                  .arg (numberClients).arg (QEChannelRegistry::peakClients));
+   result.append (QString ("subscribers:    %1 (peak %2)\n")
+                  .arg (numberSubscribers).arg (QEChannelRegistry::peakSubscribers));
+   result.append (QString ("sharing ratio:  %1\n").arg (ratio, 0, 'f', 2));
+
+   // Order the most shared channels first.
+   //
+   QList<QPair<int, QString> > usage;
+   KeyEntryMap::const_iterator it;
+   for (it = QEChannelRegistry::keyEntryMap.constBegin();
+        it != QEChannelRegistry::keyEntryMap.constEnd(); ++it) {
+      const Entry* entry = it.value ();
+      usage.append (QPair<int, QString> (-entry->subscribers.count (),
+                                         entry->client->getPvName ()));
+   }
+   std::sort (usage.begin (), usage.end ());
+
+   const int n = MIN (maxChannels, usage.count ());
+   for (int j = 0; j < n; j++) {
+      result.append (QString ("%1  %2\n")
+                     .arg (-usage.value (j).first, 6)
+                     .arg (usage.value (j).second));
+   }
+
+   return result;
+}
+
+//------------------------------------------------------------------------------
+// static
+void QEChannelRegistry::dump ()
+{
+   const QStringList lines = QEChannelRegistry::statistics ().split ("\n");
+   for (int j = 0; j < lines.count(); j++) {
+      if (lines.value (j).isEmpty ()) continue;
+      DEBUG << lines.value (j).toStdString().c_str();   // drop quotes
+   }
+}
+
+// end
@@ -0,0 +1,98 @@
+/*  QEChannelRegistry.h
+ *
+ *  This file is part of the EPICS QT Framework, initially developed at the
+ *  Australian Synchrotron.
+ *
+ *  SPDX-FileCopyrightText: 2026 Australian Synchrotron
+ *  SPDX-License-Identifier: LGPL-3.0-only
+ *
+ *  Author:     Andrew Starritt
+ *  Maintainer: Andrew Starritt
+ *  Contact:    andrews@ansto.gov.au
+ */
+
+#ifndef QE_CHANNEL_REGISTRY_H
+#define QE_CHANNEL_REGISTRY_H
+
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QEBaseClient.h>
+#include <QEPvNameUri.h>
+#include <QEFrameworkLibraryGlobal.h>
+
+/// The QEChannelRegistry provides a process wide, reference counted, registry
+/// of shared QEBaseClient objects. Clients are keyed on protocol, PV name,
+/// requested element count and channel modes, so that many QCaObjects that
+/// reference the same PV (e.g. a label, a strip chart item and a tool tip)
+/// can share a single underlying channel, subscription and data conversion.
+///
+/// Priority is reconciled per client: the client priority is the highest
+/// priority requested by any of its current subscribers. For Channel Access,
+/// the priority is only applied when the channel is created, so when the
+/// priority must rise the underlying channel is closed and re-opened (the
+/// subscribers will see a brief disconnection). A lowered priority is not
+/// worth a reconnection and only takes effect when the channel next reconnects.
+///
+/// Sharing may be disabled by defining the QE_DISABLE_CHANNEL_SHARING
+/// environment variable, or equivalent adaptation parameter, as true.
+///
+/// All functions must be called from the main GUI thread.
+///
+class QE_FRAMEWORK_LIBRARY_SHARED_EXPORT QEChannelRegistry {
+public:
+   // Returns true if channel sharing is enabled. This is determined once.
+   //
+   static bool isEnabled ();
+
+   // Returns a shared client for the specified key, creating and opening the
+   // underlying channel if required, and registers the subscriber.
+   // Returns NULL if the client can't be shared, e.g. an undefined protocol.
+   // The returned client is owned by the registry, and must be handed back
+   // using release.
+   //
+   static QEBaseClient* acquire (const QEPvNameUri::Protocol protocol,
+                                 const QString& pvName,
+                                 const unsigned int elementCount,
+                                 const QEBaseClient::ChannelModesFlags modes,
+                                 const int priority,
+                                 const QObject* subscriber);
+
+   // Deregisters the subscriber. When the last subscriber has been released,
+   // the channel is closed and the client deleted.
+   //
+   static void release (QEBaseClient* client, const QObject* subscriber);
+
+   static bool isShared (const QEBaseClient* client);
+   static int subscriberCount (const QEBaseClient* client);
+
+   // Diagnostics - number of clients, number of subscribers and the sharing
+   // ratio, together with the most shared channels.
+   //
+   static QString statistics (const int maxChannels = 20);
+   static void dump ();          // diagnostic debug output only.
+
+private:
+   explicit QEChannelRegistry () { }   // static functions only - no instances.
+   ~QEChannelRegistry () { }
+
+   class Entry;   // differed
+
+   typedef QHash<QString, Entry*> KeyEntryMap;
+   typedef QHash<const QEBaseClient*, Entry*> ClientEntryMap;
+
+   static QString formKey (const QEPvNameUri::Protocol protocol,
+                           const QString& pvName,
+                           const unsigned int elementCount,
+                           const QEBaseClient::ChannelModesFlags modes);
+
+   static void reconcilePriority (Entry* entry);
+
+   static KeyEntryMap keyEntryMap;
+   static ClientEntryMap clientEntryMap;
+   static int totalSubscribers;
+   static int peakClients;
+   static int peakSubscribers;
+};
+
+#endif // QE_CHANNEL_REGISTRY_H
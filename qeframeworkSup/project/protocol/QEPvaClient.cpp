@@ -12,12 +12,14 @@
  */
 
 #include "QEPvaClient.h"
+#include <QStringList>
 
 #ifdef QE_INCLUDE_PV_ACCESS
 
 #include <QDebug>
 #include <QMetaType>
 #include <QQueue>
+#include <QStringList>
 #include <QMutex>
 
 #include <epicsTime.h>
@@ -127,6 +129,16 @@ public:
    QEPvaData::Display display;
    QEPvaData::ValueAlarm valueAlarm;
 
+   // Indicates which of the above have been extracted, i.e. have changed.
+   // Unchanged items are not extracted and must not be assigned.
+   //
+   bool enumerationChanged;
+   bool alarmChanged;
+   bool timeStampChanged;
+   bool controlChanged;
+   bool displayChanged;
+   bool valueAlarmChanged;
+
 private:
    const QEPvaClientReference clientReference;
    const QString id;
@@ -150,7 +162,14 @@ QEPvaClient::Update::Update (const QEPvaClientReference& clientReferenceIn,
    pvData (pvDataIn),
    pvType (pvTypeIn),
    isConnected (isConnectedIn)
-{ }
+{
+   this->enumerationChanged = true;
+   this->alarmChanged = true;
+   this->timeStampChanged = true;
+   this->controlChanged = true;
+   this->displayChanged = true;
+   this->valueAlarmChanged = true;
+}
 
 //------------------------------------------------------------------------------
 //
@@ -315,9 +334,86 @@ public:
    void stopMonitor ();
 
 private:
+   // The bit range occupied by a field within the PV structure, as used by the
+   // monitor element changed bit set.
+   //
+   struct FieldRange {
+      bool isPresent;
+      uint32_t offset;
+      uint32_t nextOffset;
+   };
+
    void processElement (pva::MonitorElement::const_shared_pointer element);
+
+   // Only called when the structure changes, i.e. typically once per connection.
+   //
+   void noteStructure (const pvd::PVStructure::shared_pointer& pv);
+   static FieldRange fieldRange (const pvd::PVStructure::shared_pointer& pv,
+                                 const char* name);
+   static bool fieldHasChanged (const pvd::BitSet::shared_pointer& changed,
+                                const FieldRange& range);
+
+   pvd::StructureConstPtr lastStructure;
+   QString pvIdentity;
+   FieldRange valueRange;    // holds enumeration choices when an NTEnum
+   FieldRange alarmRange;
+   FieldRange timeStampRange;
+   FieldRange controlRange;
+   FieldRange displayRange;
+   FieldRange valueAlarmRange;
 };
 
+//------------------------------------------------------------------------------
+// static
+QEPvaMonitorRequesterInterface::FieldRange
+QEPvaMonitorRequesterInterface::fieldRange (const pvd::PVStructure::shared_pointer& pv,
+                                            const char* name)
+{
+   FieldRange result;
+   pvd::PVField::shared_pointer field = pv->getSubField (name);
+   if (field) {
+      result.isPresent = true;
+      result.offset = uint32_t (field->getFieldOffset ());
+      result.nextOffset = uint32_t (field->getNextFieldOffset ());
+   } else {
+      result.isPresent = false;
+      result.offset = 0;
+      result.nextOffset = 0;
+   }
+   return result;
+}
+
+//------------------------------------------------------------------------------
+// static
+bool QEPvaMonitorRequesterInterface::fieldHasChanged (const pvd::BitSet::shared_pointer& changed,
+                                                      const FieldRange& range)
+{
+   if (!changed) return true;                 // no change info - assume changed
+   if (changed->get (0)) return true;         // whole structure has changed
+   if (!range.isPresent) return false;
+
+   // A changed sub-structure sets its own bit; a changed sub-field sets the
+   // bit of that sub-field. Either way, the bit lies within the field's range.
+   //
+   const int32_t n = changed->nextSetBit (range.offset);
+   return (n >= 0) && (uint32_t (n) < range.nextOffset);
+}
+
+//------------------------------------------------------------------------------
+//
+void QEPvaMonitorRequesterInterface::noteStructure (const pvd::PVStructure::shared_pointer& pv)
+{
+   this->lastStructure = pv->getStructure ();
+   this->pvIdentity = QString::fromStdString (this->lastStructure->getID ());
+
+   this->valueRange      = fieldRange (pv, "value");
+   this->alarmRange      = fieldRange (pv, "alarm");
+   this->timeStampRange  = fieldRange (pv, "timeStamp");
+   this->controlRange    = fieldRange (pv, "control");
+   this->displayRange    = fieldRange (pv, "display");
+   this->valueAlarmRange = fieldRange (pv, "valueAlarm");
+}
+
 //------------------------------------------------------------------------------
 // Duplicated connection reported by channelStateChange
 //
@@ -377,7 +473,13 @@ void QEPvaMonitorRequesterInterface::processElement (pva::MonitorElement::const_
       return;
    }
 
-   const QString pvIdentity = QString::fromStdString (ptr->getID ());
+   // The structure identity and field offsets only change when the structure
+   // changes, which in practice means on (re)connection.
+   //
+   if (ptr != this->lastStructure) {
+      this->noteStructure (pv);
+   }
+   const QString pvIdentity = this->pvIdentity;
 
    // The extracted value is a basic variant, a QE vector varient or one
    // of the specialised variants: QENTTableData, QENTImageData, or QEOpaque.
@@ -404,14 +506,25 @@ void QEPvaMonitorRequesterInterface::processElement (pva::MonitorElement::const_
          new QEPvaClient::Update (this->clientReference, pvIdentity,
                                   QEPvaClient::Update::ukData, value, type, false);
 
-   // Extract associated meta data
+   // Extract associated meta data, but only where changed as indicated by
+   // the changed bit set. The first monitor element always has bit 0 set,
+   // i.e. the whole structure, so everything is extracted.
    //
-   item->enumeration.extract (pv);     // i.e. the choices
-   item->timeStamp.extract (pv);
-   item->alarm.extract (pv);
-   item->control.extract (pv);
-   item->display.extract (pv);
-   item->valueAlarm.extract (pv);
+   const pvd::BitSet::shared_pointer& changed = element->changedBitSet;
+
+   item->enumerationChanged = fieldHasChanged (changed, this->valueRange);
+   item->timeStampChanged   = fieldHasChanged (changed, this->timeStampRange);
+   item->alarmChanged       = fieldHasChanged (changed, this->alarmRange);
+   item->controlChanged     = fieldHasChanged (changed, this->controlRange);
+   item->displayChanged     = fieldHasChanged (changed, this->displayRange);
+   item->valueAlarmChanged  = fieldHasChanged (changed, this->valueAlarmRange);
+
+   if (item->enumerationChanged) item->enumeration.extract (pv);     // i.e. the choices
+   if (item->timeStampChanged)   item->timeStamp.extract (pv);
+   if (item->alarmChanged)       item->alarm.extract (pv);
+   if (item->controlChanged)     item->control.extract (pv);
+   if (item->displayChanged)     item->display.extract (pv);
+   if (item->valueAlarmChanged)  item->valueAlarm.extract (pv);
 
    // We have copied all the element data.
    //
@@ -596,6 +709,7 @@ QEPvaClient::QEPvaClient (const QString& pvName,
    this->id = "";
    this->pvData = nullVariant;
    this->firstUpdate = false;
+   this->requestFields = AllFields;
 
    // Create the channel, monitor, put and get requestor and convert to saved shared pointers
    //
@@ -635,8 +749,8 @@ QEPvaClient::~QEPvaClient()
 //
 bool QEPvaClient::openChannel (const ChannelModesFlags modes)
 {
-   static const std::string monitorRequest ("field()");   // the lot - all fields
    static const std::string putRequest ("field(value)");  // just the value
+   const std::string monitorRequest = QEPvaClient::formRequest (this->requestFields).toStdString ();
 
    bool result = false;
    pvd::PVStructure::shared_pointer pvRequest;
@@ -983,12 +1097,14 @@ void QEPvaClient::processUpdate (QEPvaClient::Update* update)
          //
          isMetaUpdate = false;   // hypothesize not a meta data update.
 
-         this->alarm.assign (update->alarm);
-         this->timeStamp.assign (update->timeStamp);
-         this->display.assign (update->display, isMetaUpdate);
-         this->control.assign (update->control, isMetaUpdate);
-         this->valueAlarm.assign (update->valueAlarm, isMetaUpdate);
-         this->enumeration.assign (update->enumeration, isMetaUpdate);
+         // Unchanged items were not extracted, and we retain current values.
+         //
+         if (update->alarmChanged)       this->alarm.assign (update->alarm);
+         if (update->timeStampChanged)   this->timeStamp.assign (update->timeStamp);
+         if (update->displayChanged)     this->display.assign (update->display, isMetaUpdate);
+         if (update->controlChanged)     this->control.assign (update->control, isMetaUpdate);
+         if (update->valueAlarmChanged)  this->valueAlarm.assign (update->valueAlarm, isMetaUpdate);
+         if (update->enumerationChanged) this->enumeration.assign (update->enumeration, isMetaUpdate);
 
          // The first post connection update is always considered
          // a meta data update.
@@ -1066,7 +1182,7 @@ void QEPvaClientManager::timeoutHandler ()
 
 QEPvaClient::QEPvaClient (const QString& pvName,
                           QObject* parent) :
-   QEBaseClient (QEBaseClient::PVAType, pvName, parent) { }
+   QEBaseClient (QEBaseClient::PVAType, pvName, parent) { this->requestFields = AllFields; }
 QEPvaClient::~QEPvaClient () { }
 bool QEPvaClient::openChannel (const ChannelModesFlags) { return false; }
 void QEPvaClient::closeChannel () { }
@@ -1104,4 +1220,39 @@ void QEPvaClientManager::timeoutHandler () { }
 
 #endif
 
+// Request field functions - available with or without PVA support.
+
+//------------------------------------------------------------------------------
+//
+void QEPvaClient::setRequestFields (const RequestFieldsFlags fields)
+{
+   this->requestFields = fields | ValueField;   // we always need the value
+}
+
+//------------------------------------------------------------------------------
+//
+QEPvaClient::RequestFieldsFlags QEPvaClient::getRequestFields () const
+{
+   return this->requestFields;
+}
+
+//------------------------------------------------------------------------------
+// static
+QString QEPvaClient::formRequest (const RequestFieldsFlags fields)
+{
+   if ((fields & AllFields) == AllFields) {
+      return "field()";    // the lot - all fields
+   }
+
+   QStringList names;
+   if (fields & ValueField)      names << "value";
+   if (fields & AlarmField)      names << "alarm";
+   if (fields & TimeStampField)  names << "timeStamp";
+   if (fields & DisplayField)    names << "display";
+   if (fields & ControlField)    names << "control";
+   if (fields & ValueAlarmField) names << "valueAlarm";
+
+   return QString ("field(%1)").arg (names.join (","));
+}
+
 // end
@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2018-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2018-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Starritt
@@ -40,10 +40,40 @@ public:
    class Update;       // differed
    class UpdateQueue;  // differed
 
+   // Standard fields that may be requested - bit significant.
+   //
+   enum RequestFields {
+      NoFields = 0x00,
+      ValueField = 0x01,
+      AlarmField = 0x02,
+      TimeStampField = 0x04,
+      DisplayField = 0x08,
+      ControlField = 0x10,
+      ValueAlarmField = 0x20,
+      AllFields = 0xFF          // includes any non-standard fields
+   };
+
+   Q_DECLARE_FLAGS (RequestFieldsFlags, RequestFields)
+
    explicit QEPvaClient (const QString& pvName,
                          QObject* parent);
    ~QEPvaClient ();
 
+   // By default, the get and monitor requests are for all fields, i.e. "field()".
+   // A client that only needs some standard fields may restrict the request,
+   // e.g. to ValueField | AlarmField | TimeStampField, which reduces both network
+   // bandwidth and update processing. The value field is always requested.
+   // Note: NTTable, NTNDArray and other non NTScalar/NTScalarArray types
+   // require AllFields. Must be called prior to openChannel to take effect.
+   //
+   void setRequestFields (const RequestFieldsFlags fields);
+   RequestFieldsFlags getRequestFields () const;
+
+   // Forms the get/monitor pvRequest string for the given fields,
+   // e.g. "field()" or "field(value,alarm,timeStamp)".
+   //
+   static QString formRequest (const RequestFieldsFlags fields);
+
    bool openChannel (const ChannelModesFlags modes);
    void closeChannel ();
 
@@ -96,6 +126,7 @@ private:
    QString id;             // e.g.  "epics:nt/NTScalar:1.0"
    QString pvType;         // e.g.  "double" when NTScalar or NTArray
    QVariant pvData;        // holds the value data
+   RequestFieldsFlags requestFields;
 
 #ifdef QE_INCLUDE_PV_ACCESS
    // We need to keep strong references to these objects.
@@ -121,6 +152,8 @@ private:
    friend class QEPvaPutRequesterInterface;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS (QEPvaClient::RequestFieldsFlags)
+
 //------------------------------------------------------------------------------
 // This is essentially a singleton private class, but must be declared in the
 // header file in order to use the meta object compiler (moc) to allow setup of
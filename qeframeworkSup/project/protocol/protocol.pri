@@ -20,6 +20,9 @@ SOURCES += $$PWD/QEBaseClient.cpp
 HEADERS += $$PWD/QECaClient.h
 SOURCES += $$PWD/QECaClient.cpp
 
+HEADERS += $$PWD/QEChannelRegistry.h
+SOURCES += $$PWD/QEChannelRegistry.cpp
+
 HEADERS += $$PWD/QENTNDArrayConverter.h
 SOURCES += $$PWD/QENTNDArrayConverter.cpp
 
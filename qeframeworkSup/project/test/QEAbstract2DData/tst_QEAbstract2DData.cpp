@@ -0,0 +1,476 @@
+/*  tst_QEAbstract2DData.cpp
+ *
+ *  This file is part of the EPICS QT Framework, initially developed at the
+ *  Australian Synchrotron.
+ *
+ *  SPDX-FileCopyrightText: 2026 Australian Synchrotron
+ *  SPDX-License-Identifier: LGPL-3.0-only
+ *
+ *  Author:     Andrew Starritt
+ *  Maintainer: Andrew Starritt
+ *  Contact:    andrews@ansto.gov.au
+ */
+
+// Compares the QEAbstract2DData slicing and binning with the previous
+// implementation, i.e. getDataValue for every cell of every bin and a full
+// sort for median binning, which is reproduced here as the reference. The
+// results must be identical - the mean binning adds the values in the same
+// order and so has the same rounding.
+//
+// Also benchmarks the mean and median binning of 2048 x 2048 data against
+// the reference.
+//
+
+#include <algorithm>
+#include <vector>
+#include <QList>
+#include <QString>
+#include <QVector>
+#include <QtTest>
+#include <QECommon.h>
+#include <QEFloating.h>
+#include <QEAbstract2DData.h>
+
+static const double noValue = -281474976710656.0;   // as per QEAbstract2DData
+
+//==============================================================================
+// The previous binning implementation.
+//
+class ReferenceBinning
+{
+public:
+   explicit ReferenceBinning ();
+
+   void calculate ();
+
+   QList<QVector<double> > data;
+   bool is1D;
+   int width;
+   int numberOfSets;
+   int verticalSliceFirst;
+   int verticalSliceLast;
+   int horizontalSliceFirst;
+   int horizontalSliceLast;
+   int verticalBin;
+   int horizontalBin;
+   QEAbstract2DData::DataBinning binning;
+
+   QVector<QVector<double> > binnedData;
+   int binnedNumberOfRows;
+   int binnedNumberOfCols;
+
+private:
+   double getDataValue (const int sourceRow, const int sourceCol,
+                        const double defaultValue) const;
+   double getBinnedValue (const int r1, const int r2,
+                          const int c1, const int c2) const;
+
+   int sliceRowOffset;
+   int sliceColOffset;
+   int slicedNumberOfRows;
+   int slicedNumberOfCols;
+};
+
+//------------------------------------------------------------------------------
+//
+ReferenceBinning::ReferenceBinning ()
+{
+   this->is1D = false;
+   this->width = 1;
+   this->numberOfSets = 40;
+   this->verticalSliceFirst = 0;
+   this->verticalSliceLast = -1;
+   this->horizontalSliceFirst = 0;
+   this->horizontalSliceLast = -1;
+   this->verticalBin = 1;
+   this->horizontalBin = 1;
+   this->binning = QEAbstract2DData::decimate;
+   this->binnedNumberOfRows = 0;
+   this->binnedNumberOfCols = 0;
+}
+
+//------------------------------------------------------------------------------
+//
+double ReferenceBinning::getDataValue (const int sourceRow, const int sourceCol,
+                                       const double defaultValue) const
+{
+   const QVector<double> emptyArray;
+   double result = defaultValue;
+
+   if (this->is1D) {
+      QVector<double> dataSet = this->data.value (sourceRow, emptyArray);
+      result = dataSet.value (sourceCol, defaultValue);
+   } else {
+      const QVector<double> dataSet = this->data.value (0, emptyArray);
+      const int index = this->width * sourceRow + sourceCol;
+      result = dataSet.value (index, defaultValue);
+   }
+
+   return result;
+}
+
+//------------------------------------------------------------------------------
+//
+double ReferenceBinning::getBinnedValue (const int r1, const int r2,
+                                         const int c1, const int c2) const
+{
+   const int number = (r2 - r1 + 1)*(c2 - c1 + 1);
+   double result = noValue;
+
+   if (number < 1) {
+      result = noValue;
+
+   } else if (number == 1) {
+      result = this->getDataValue (r1, c1, noValue);
+
+   } else if (this->binning == QEAbstract2DData::decimate) {
+      const int row = (r1 + r2) / 2;
+      const int col = (c1 + c2) / 2;
+      result = this->getDataValue (row, col, noValue);
+
+   } else if (this->binning == QEAbstract2DData::mean) {
+      double total = 0.0;
+      int count = 0;
+      for (int r = r1; r <= r2; r++) {
+         for (int c = c1; c <= c2; c++) {
+            double value = this->getDataValue (r, c, noValue);
+            if (value != noValue) {
+               total += value;
+               count += 1;
+            }
+         }
+      }
+      result = (count > 0) ? total / double (count) : noValue;
+
+   } else if (this->binning == QEAbstract2DData::median) {
+      std::vector<double> theBin;
+      for (int r = r1; r <= r2; r++) {
+         for (int c = c1; c <= c2; c++) {
+            double value = this->getDataValue (r, c, noValue);
+            if (value != noValue) {
+               theBin.push_back (value);
+            }
+         }
+      }
+
+      const int count = theBin.size();
+      if (count > 0) {
+         std::sort (theBin.begin(), theBin.end());
+         result = theBin [count/2];
+      } else {
+         result = noValue;
+      }
+   }
+
+   return result;
+}
+
+//------------------------------------------------------------------------------
+//
+void ReferenceBinning::calculate ()
+{
+   int rawNumberOfRows;
+   int rawNumberOfCols;
+
+   if (this->is1D) {
+      rawNumberOfRows = this->numberOfSets;
+      rawNumberOfCols = this->data.value (0).count();
+   } else {
+      const int total = this->data.value (0).count();
+      rawNumberOfCols = this->width;
+      rawNumberOfRows = (total + rawNumberOfCols - 1) / MAX (rawNumberOfCols, 1);
+   }
+
+   #define UNSIGN_INDEX(index, number) LIMIT((index >= 0 ? index : number + index), 0, number)
+
+   const int rowFirst = UNSIGN_INDEX (this->verticalSliceFirst, rawNumberOfRows);
+   const int rowLast  = UNSIGN_INDEX (this->verticalSliceLast,  rawNumberOfRows);
+   this->sliceRowOffset = rowFirst;
+   this->slicedNumberOfRows = MAX (rowLast - rowFirst + 1, 0);
+
+   const int colFirst = UNSIGN_INDEX (this->horizontalSliceFirst, rawNumberOfCols);
+   const int colLast  = UNSIGN_INDEX (this->horizontalSliceLast,  rawNumberOfCols);
+   this->sliceColOffset = colFirst;
+   this->slicedNumberOfCols = MAX (colLast - colFirst + 1, 0);
+
+   #undef UNSIGN_INDEX
+
+   const int rowBin = this->verticalBin;
+   const int colBin = this->horizontalBin;
+   this->binnedNumberOfRows = (this->slicedNumberOfRows + rowBin - 1) / rowBin;
+   this->binnedNumberOfCols = (this->slicedNumberOfCols + colBin - 1) / colBin;
+
+   const int sliceRowLast = this->sliceRowOffset + this->slicedNumberOfRows - 1;
+   const int sliceColLast = this->sliceColOffset + this->slicedNumberOfCols - 1;
+
+   this->binnedData.clear();
+   for (int br = 0; br < this->binnedNumberOfRows; br++) {
+      QVector<double> row (this->binnedNumberOfCols, noValue);
+
+      const int sourceRowFirst = this->sliceRowOffset + br * rowBin;
+      const int sourceRowLast = MIN (sourceRowFirst + rowBin - 1, sliceRowLast);
+
+      for (int c = 0; c < this->binnedNumberOfCols; c++) {
+         const int sourceColFirst = this->sliceColOffset + c * colBin;
+         const int sourceColLast = MIN (sourceColFirst + colBin - 1, sliceColLast);
+         row [c] = this->getBinnedValue (sourceRowFirst, sourceRowLast,
+                                         sourceColFirst, sourceColLast);
+      }
+      this->binnedData.append (row);
+   }
+}
+
+
+//==============================================================================
+// Provides access to the QEAbstract2DData protected functions.
+//
+class TestData : public QEAbstract2DData
+{
+public:
+   explicit TestData () : QEAbstract2DData () { }
+
+   using QEAbstract2DData::getValue;
+   using QEAbstract2DData::getNumberRowsAndCols;
+
+   void addData (const QVector<double>& values);
+
+protected:
+   void updateDataVisulation () { }   // nothing to visualise
+};
+
+//------------------------------------------------------------------------------
+//
+void TestData::addData (const QVector<double>& values)
+{
+   QEFloatingArrayUpdate update;
+   update.variableIndex = DATA_PV_INDEX;
+   update.isMetaUpdate = false;
+   update.values = values;
+   this->onDataArrayUpdate (update);
+}
+
+
+//==============================================================================
+//
+class QEAbstract2DDataTest : public QObject
+{
+   Q_OBJECT
+private slots:
+   void sameResults_data ();
+   void sameResults ();
+
+   void binningBenchmark_data ();
+   void binningBenchmark ();
+   void referenceBenchmark_data ();
+   void referenceBenchmark ();
+
+private:
+   static QVector<double> makeData (const int size, const int seed);
+   static void benchmarkCases ();
+};
+
+//------------------------------------------------------------------------------
+// static
+QVector<double> QEAbstract2DDataTest::makeData (const int size, const int seed)
+{
+   // Simple linear congruential generator - repeatable. Half the values are
+   // small integers so that there are plenty of equal values for the median.
+   //
+   QVector<double> result (size);
+   quint32 state = 12345 + seed;
+   for (int j = 0; j < size; j++) {
+      state = state * 1103515245 + 12345;
+      const quint32 r = state >> 8;
+      result [j] = (r & 1) ? double (r % 17) : double (r % 100000) / 7.0 - 5000.0;
+   }
+   return result;
+}
+
+//------------------------------------------------------------------------------
+//
+void QEAbstract2DDataTest::sameResults_data ()
+{
+   QTest::addColumn<bool> ("is1D");
+   QTest::addColumn<int> ("binning");
+   QTest::addColumn<int> ("verticalBin");
+   QTest::addColumn<int> ("horizontalBin");
+   QTest::addColumn<bool> ("isSliced");
+   QTest::addColumn<int> ("numberOfUpdates");
+
+   static const char* binningNames [3] = { "decimate", "mean", "median" };
+   static const int bins [4][2] = { { 1, 1 }, { 3, 2 }, { 4, 4 }, { 7, 5 } };
+
+   for (int format = 0; format < 2; format++) {
+      const bool is1D = (format == 1);
+      for (int binning = 0; binning < 3; binning++) {
+         for (int b = 0; b < 4; b++) {
+            for (int sliced = 0; sliced < 2; sliced++) {
+               // For 1D data, both partially filled and scrolled sets of data.
+               //
+               const int updateOptions = is1D ? 2 : 1;
+               for (int u = 0; u < updateOptions; u++) {
+                  const int numberOfUpdates = is1D ? (u == 0 ? 30 : 65) : 1;
+                  const QString name = QString ("%1 %2 %3x%4%5 %6")
+                        .arg (is1D ? "1D" : "2D")
+                        .arg (binningNames [binning])
+                        .arg (bins [b][0]).arg (bins [b][1])
+                        .arg (sliced ? " sliced" : "")
+                        .arg (numberOfUpdates);
+
+                  QTest::newRow (name.toLatin1 ().constData ())
+                        << is1D << binning << bins [b][0] << bins [b][1]
+                        << bool (sliced) << numberOfUpdates;
+               }
+            }
+         }
+      }
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+void QEAbstract2DDataTest::sameResults ()
+{
+   QFETCH (bool, is1D);
+   QFETCH (int, binning);
+   QFETCH (int, verticalBin);
+   QFETCH (int, horizontalBin);
+   QFETCH (bool, isSliced);
+   QFETCH (int, numberOfUpdates);
+
+   // 2D data deliberately not an exact multiple of the width.
+   //
+   const int width = is1D ? 83 : 97;
+   const int size = is1D ? width : 97 * 61 + 13;
+   const int numberOfSets = 50;
+
+   ReferenceBinning reference;
+   reference.is1D = is1D;
+   reference.width = width;
+   reference.numberOfSets = numberOfSets;
+   reference.verticalBin = verticalBin;
+   reference.horizontalBin = horizontalBin;
+   reference.binning = QEAbstract2DData::DataBinning (binning);
+   if (isSliced) {
+      reference.verticalSliceFirst = 3;
+      reference.verticalSliceLast = -2;
+      reference.horizontalSliceFirst = 5;
+      reference.horizontalSliceLast = -7;
+   }
+
+   TestData testData;
+   testData.setDataFormat (is1D ? QEAbstract2DData::array1D : QEAbstract2DData::array2D);
+   testData.setDataWidth (width);
+   testData.setNumberOfSets (numberOfSets);
+   testData.setVerticalBin (verticalBin);
+   testData.setHorizontalBin (horizontalBin);
+   testData.setDataBinning (QEAbstract2DData::DataBinning (binning));
+   testData.setVerticalSliceFirst (reference.verticalSliceFirst);
+   testData.setVerticalSliceLast (reference.verticalSliceLast);
+   testData.setHorizontalSliceFirst (reference.horizontalSliceFirst);
+   testData.setHorizontalSliceLast (reference.horizontalSliceLast);
+
+   for (int u = 0; u < numberOfUpdates; u++) {
+      const QVector<double> values = QEAbstract2DDataTest::makeData (size, u);
+      testData.addData (values);
+
+      reference.data.append (values);
+      while (reference.data.count () > (is1D ? numberOfSets : 1)) {
+         reference.data.removeFirst ();
+      }
+   }
+   reference.calculate ();
+
+   int numberRows;
+   int numberCols;
+   testData.getNumberRowsAndCols (numberRows, numberCols);
+   QCOMPARE (numberRows, reference.binnedNumberOfRows);
+   QCOMPARE (numberCols, reference.binnedNumberOfCols);
+
+   for (int r = 0; r < numberRows; r++) {
+      for (int c = 0; c < numberCols; c++) {
+         const double expected = reference.binnedData.at (r).at (c);
+         const double actual = testData.getValue (r, c, noValue);
+         if (actual != expected) {
+            QFAIL (QString ("row %1 col %2: %3 != %4").arg (r).arg (c)
+                   .arg (actual, 0, 'g', 17).arg (expected, 0, 'g', 17)
+                   .toLatin1 ().constData ());
+         }
+      }
+   }
+}
+
+//------------------------------------------------------------------------------
+// static
+void QEAbstract2DDataTest::benchmarkCases ()
+{
+   QTest::addColumn<int> ("binning");
+   QTest::addColumn<int> ("bin");
+
+   QTest::newRow ("mean 4x4")     << int (QEAbstract2DData::mean)   << 4;
+   QTest::newRow ("mean 16x16")   << int (QEAbstract2DData::mean)   << 16;
+   QTest::newRow ("median 4x4")   << int (QEAbstract2DData::median) << 4;
+   QTest::newRow ("median 16x16") << int (QEAbstract2DData::median) << 16;
+}
+
+//------------------------------------------------------------------------------
+//
+void QEAbstract2DDataTest::binningBenchmark_data ()
+{
+   QEAbstract2DDataTest::benchmarkCases ();
+}
+
+//------------------------------------------------------------------------------
+//
+void QEAbstract2DDataTest::binningBenchmark ()
+{
+   QFETCH (int, binning);
+   QFETCH (int, bin);
+
+   const int width = 2048;
+   const QVector<double> values = QEAbstract2DDataTest::makeData (width * width, 0);
+
+   TestData testData;
+   testData.setDataFormat (QEAbstract2DData::array2D);
+   testData.setDataWidth (width);
+   testData.setVerticalBin (bin);
+   testData.setHorizontalBin (bin);
+   testData.setDataBinning (QEAbstract2DData::DataBinning (binning));
+
+   QBENCHMARK {
+      testData.addData (values);
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+void QEAbstract2DDataTest::referenceBenchmark_data ()
+{
+   QEAbstract2DDataTest::benchmarkCases ();
+}
+
+//------------------------------------------------------------------------------
+//
+void QEAbstract2DDataTest::referenceBenchmark ()
+{
+   QFETCH (int, binning);
+   QFETCH (int, bin);
+
+   const int width = 2048;
+
+   ReferenceBinning reference;
+   reference.width = width;
+   reference.verticalBin = bin;
+   reference.horizontalBin = bin;
+   reference.binning = QEAbstract2DData::DataBinning (binning);
+   reference.data.append (QEAbstract2DDataTest::makeData (width * width, 0));
+
+   QBENCHMARK {
+      reference.calculate ();
+   }
+}
+
+QTEST_MAIN (QEAbstract2DDataTest)
+#include "tst_QEAbstract2DData.moc"
+
+// end
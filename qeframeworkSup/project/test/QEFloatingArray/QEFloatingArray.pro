@@ -0,0 +1,20 @@
+# QEFloatingArray.pro
+#
+# This file is part of the EPICS QT Framework, initially developed at
+# the Australian Synchrotron.
+#
+# SPDX-FileCopyrightText: 2026 Australian Synchrotron
+# SPDX-License-Identifier: LGPL-3.0-only
+#
+# Author:     Andrew Starritt
+# Maintainer: Andrew Starritt
+# Contact:    andrews@ansto.gov.au
+#
+
+include (../test.pri)
+
+TARGET = tst_QEFloatingArray
+
+SOURCES += tst_QEFloatingArray.cpp
+
+# end
@@ -0,0 +1,514 @@
+/*  tst_QEFloatingArray.cpp
+ *
+ *  This file is part of the EPICS QT Framework, initially developed at the
+ *  Australian Synchrotron.
+ *
+ *  SPDX-FileCopyrightText: 2026 Australian Synchrotron
+ *  SPDX-License-Identifier: LGPL-3.0-only
+ *
+ *  Author:     Andrew Starritt
+ *  Maintainer: Andrew Starritt
+ *  Contact:    andrews@ansto.gov.au
+ */
+
+// Compares the QEFloatingArray minimumValue, maximumValue, calcDyByDx and
+// medianFilter functions with the previous implementations, which are
+// reproduced here as the reference, over random inputs. The results must be
+// identical.
+//
+// Note: the median filter comparison excludes NaN values, as the previous
+// implementation left their ordering to std::sort, i.e. undefined.
+//
+// Also benchmarks each function against the reference.
+//
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include <QString>
+#include <QVector>
+#include <QtTest>
+#include <QECommon.h>
+#include <QEFloatingArray.h>
+
+//==============================================================================
+// The previous implementations.
+//
+namespace Reference {
+
+static double minimumValue (const QVector<double>& data, const double& defaultValue,
+                            const bool includeInf)
+{
+   const int n = data.count ();
+
+   double result = defaultValue;
+   bool isFirst = true;
+   for (int j = 0; j < n; j++) {
+      const double v = data.value (j);
+
+      if (qIsNaN (v)) continue;
+      if (!includeInf && qIsInf (v)) continue;
+
+      if (isFirst) {
+         result = v;
+         isFirst = false;
+      } else {
+         result = MIN (result, v);
+      }
+   }
+   return result;
+}
+
+//------------------------------------------------------------------------------
+//
+static double maximumValue (const QVector<double>& data, const double& defaultValue,
+                            const bool includeInf)
+{
+   const int n = data.count ();
+
+   double result = defaultValue;
+   bool isFirst = true;
+   for (int j = 0; j < n; j++) {
+      const double v = data.value (j);
+
+      if (qIsNaN (v)) continue;
+      if (!includeInf && qIsInf (v)) continue;
+
+      if (isFirst) {
+         result = v;
+         isFirst = false;
+      } else {
+         result = MAX (result, v);
+      }
+   }
+   return result;
+}
+
+#define MIN_DELTA_X  (1.0E-20)
+
+//------------------------------------------------------------------------------
+//
+static double derivative (const double xp1, const double yp1,
+                          const double xp2, const double yp2)
+{
+   const double dx = xp2 - xp1;
+   const double dy = yp2 - yp1;
+   return (ABS(dx) >= MIN_DELTA_X) ?  (dy / dx ) : 0.0;
+}
+
+//------------------------------------------------------------------------------
+//
+static double derivative (const double xp1, const double yp1,
+                          const double xp2, const double yp2,
+                          const double xp3, const double yp3)
+{
+   const double x1 = xp1 - xp2;
+   const double y1 = yp1 - yp2;
+   const double x3 = xp3 - xp2;
+   const double y3 = yp3 - yp2;
+
+   const double divisor = x1*x3*(x3 - x1);
+   if (ABS (divisor) >= MIN_DELTA_X) {
+      return (y1*x3*x3 - y3*x1*x1) / divisor;
+   }
+   return 0.0;
+}
+
+#undef MIN_DELTA_X
+
+//------------------------------------------------------------------------------
+//
+static QVector<double> calcDyByDx (const QVector<double>& y, const QVector<double>& x)
+{
+   const int size = MIN (y.size(), x.size());
+   QVector<double> result;
+   double s;
+
+   if (size == 1) {
+      result.append (0.0);
+
+   } else if (size == 2) {
+      s = derivative (x.value (0), y.value (0), x.value (1), y.value (1));
+      result.append (s);
+      result.append (s);
+
+   } else if (size >= 3) {
+      s = derivative (x.value (0), y.value (0), x.value (1), y.value (1));
+      result.append (s);
+
+      for (int j = 1 ; j < size - 1; j++) {
+         s = derivative (x.value(j - 1), y.value(j - 1),
+                         x.value(j    ), y.value(j    ),
+                         x.value(j + 1), y.value(j + 1));
+         result.append (s);
+      }
+
+      s = derivative (x.value (size - 2), y.value (size - 2),
+                      x.value (size - 1), y.value (size - 1));
+      result.append (s);
+   }
+
+   return result;
+}
+
+//------------------------------------------------------------------------------
+//
+static QVector<double> medianFilter (const QVector<double>& data, const int window)
+{
+   const int size = data.size ();
+   QVector<double> result;
+   result.reserve (size);
+
+   if (window > 1) {
+      const int offset = window / 2;
+      for (int j = 0; j < size; j++) {
+         int pos = MAX (j - offset, 0);
+         int end = MIN (j + offset, size - 1);
+
+         QVector<double> qtemp = data.mid (pos, end - pos + 1);
+         std::vector <double> temp;
+         for (int k = 0; k < qtemp.size(); k++) {
+            temp.push_back (qtemp[k]);
+         }
+
+         std::sort (temp.begin(), temp.end());
+         result.append (temp [qtemp.size ()/2]);
+      }
+   } else {
+      result = data;
+   }
+   return result;
+}
+
+}   // end Reference namespace
+
+
+//==============================================================================
+//
+class QEFloatingArrayTest : public QObject
+{
+   Q_OBJECT
+private slots:
+   void minMax_data ();
+   void minMax ();
+   void calcDyByDx_data ();
+   void calcDyByDx ();
+   void medianFilter_data ();
+   void medianFilter ();
+
+   void minMaxBenchmark ();
+   void minMaxReferenceBenchmark ();
+   void calcDyByDxBenchmark ();
+   void calcDyByDxReferenceBenchmark ();
+   void medianFilterBenchmark_data ();
+   void medianFilterBenchmark ();
+   void medianFilterReferenceBenchmark_data ();
+   void medianFilterReferenceBenchmark ();
+
+private:
+   // Kinds of random data.
+   //
+   enum Kinds {
+      Plain,      // random values
+      Repeated,   // small integers, i.e. many equal values
+      Special     // includes +/-inf and NaN
+   };
+
+   static QVector<double> makeData (const int size, const int seed,
+                                    const Kinds kind, const bool allowNaN = true);
+   static bool isSame (const double a, const double b);
+   static bool isSame (const QVector<double>& a, const QVector<double>& b);
+   static void addKindRows (const QList<int>& sizes, const int otherValue,
+                            const char* otherName);
+   static void medianCases ();
+};
+
+//------------------------------------------------------------------------------
+// static
+QVector<double> QEFloatingArrayTest::makeData (const int size, const int seed,
+                                               const Kinds kind, const bool allowNaN)
+{
+   const double inf = std::numeric_limits<double>::infinity ();
+   const double nan = std::numeric_limits<double>::quiet_NaN ();
+
+   // Simple linear congruential generator - repeatable.
+   //
+   QVector<double> result (size);
+   quint32 state = 12345 + 7919 * seed;
+   for (int j = 0; j < size; j++) {
+      state = state * 1103515245 + 12345;
+      const quint32 r = state >> 8;
+
+      double value = double (r % 2000003) / 1000.0 - 1000.0;
+      if (kind == Repeated) {
+         value = double (r % 11);
+      } else if (kind == Special) {
+         switch (r % 29) {
+            case 0:  value = inf;                   break;
+            case 1:  value = -inf;                  break;
+            case 2:  value = allowNaN ? nan : 0.0;  break;
+            default:                                break;
+         }
+      }
+      result [j] = value;
+   }
+   return result;
+}
+
+//------------------------------------------------------------------------------
+// static
+bool QEFloatingArrayTest::isSame (const double a, const double b)
+{
+   if (qIsNaN (a) || qIsNaN (b)) return qIsNaN (a) && qIsNaN (b);
+   return a == b;
+}
+
+//------------------------------------------------------------------------------
+// static
+bool QEFloatingArrayTest::isSame (const QVector<double>& a, const QVector<double>& b)
+{
+   if (a.size () != b.size ()) return false;
+   for (int j = 0; j < a.size (); j++) {
+      if (!QEFloatingArrayTest::isSame (a.at (j), b.at (j))) return false;
+   }
+   return true;
+}
+
+//------------------------------------------------------------------------------
+// static
+void QEFloatingArrayTest::addKindRows (const QList<int>& sizes, const int otherValue,
+                                       const char* otherName)
+{
+   static const char* kindNames [3] = { "plain", "repeated", "special" };
+
+   for (int s = 0; s < sizes.count (); s++) {
+      for (int kind = Plain; kind <= Special; kind++) {
+         for (int seed = 0; seed < 3; seed++) {
+            const QString name = QString ("%1 %2 %3 %4 %5")
+                  .arg (sizes.value (s)).arg (kindNames [kind])
+                  .arg (otherName).arg (otherValue).arg (seed);
+
+            QTest::newRow (name.toLatin1 ().constData ())
+                  << sizes.value (s) << kind << otherValue << seed;
+         }
+      }
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+void QEFloatingArrayTest::minMax_data ()
+{
+   QTest::addColumn<int> ("size");
+   QTest::addColumn<int> ("kind");
+   QTest::addColumn<int> ("includeInf");
+   QTest::addColumn<int> ("seed");
+
+   const QList<int> sizes = QList<int> () << 0 << 1 << 2 << 3 << 7 << 1000 << 100003;
+   QEFloatingArrayTest::addKindRows (sizes, 0, "includeInf");
+   QEFloatingArrayTest::addKindRows (sizes, 1, "includeInf");
+}
+
+//------------------------------------------------------------------------------
+//
+void QEFloatingArrayTest::minMax ()
+{
+   QFETCH (int, size);
+   QFETCH (int, kind);
+   QFETCH (int, includeInf);
+   QFETCH (int, seed);
+
+   const QVector<double> data = QEFloatingArrayTest::makeData (size, seed, Kinds (kind));
+   QEFloatingArray array (data);
+   const double defaultValue = -123.0;
+
+   QVERIFY (isSame (array.minimumValue (defaultValue, includeInf != 0),
+                    Reference::minimumValue (data, defaultValue, includeInf != 0)));
+   QVERIFY (isSame (array.maximumValue (defaultValue, includeInf != 0),
+                    Reference::maximumValue (data, defaultValue, includeInf != 0)));
+
+   // All NaN - must yield the default value.
+   //
+   QEFloatingArray allNaN (size, std::numeric_limits<double>::quiet_NaN ());
+   QVERIFY (isSame (allNaN.minimumValue (defaultValue, includeInf != 0), defaultValue));
+   QVERIFY (isSame (allNaN.maximumValue (defaultValue, includeInf != 0), defaultValue));
+}
+
+//------------------------------------------------------------------------------
+//
+void QEFloatingArrayTest::calcDyByDx_data ()
+{
+   QTest::addColumn<int> ("size");
+   QTest::addColumn<int> ("kind");
+   QTest::addColumn<int> ("xMode");
+   QTest::addColumn<int> ("seed");
+
+   // xMode 0: increasing, 1: random (including repeated x values), 2: x shorter than y.
+   //
+   const QList<int> sizes = QList<int> () << 0 << 1 << 2 << 3 << 4 << 1000;
+   QEFloatingArrayTest::addKindRows (sizes, 0, "x mode");
+   QEFloatingArrayTest::addKindRows (sizes, 1, "x mode");
+   QEFloatingArrayTest::addKindRows (sizes, 2, "x mode");
+}
+
+//------------------------------------------------------------------------------
+//
+void QEFloatingArrayTest::calcDyByDx ()
+{
+   QFETCH (int, size);
+   QFETCH (int, kind);
+   QFETCH (int, xMode);
+   QFETCH (int, seed);
+
+   const QVector<double> y = QEFloatingArrayTest::makeData (size, seed, Kinds (kind));
+
+   QVector<double> x;
+   if (xMode == 0) {
+      x = QEFloatingArrayTest::makeData (size, seed + 100, Plain);
+      std::sort (x.begin (), x.end ());
+   } else if (xMode == 1) {
+      x = QEFloatingArrayTest::makeData (size, seed + 100, Repeated);
+   } else {
+      x = QEFloatingArrayTest::makeData (MAX (size - 1, 0), seed + 100, Plain);
+      std::sort (x.begin (), x.end ());
+   }
+
+   QEFloatingArray array (y);
+   QVERIFY (isSame (array.calcDyByDx (x), Reference::calcDyByDx (y, x)));
+}
+
+//------------------------------------------------------------------------------
+// static
+void QEFloatingArrayTest::medianCases ()
+{
+   QTest::addColumn<int> ("size");
+   QTest::addColumn<int> ("kind");
+   QTest::addColumn<int> ("window");
+   QTest::addColumn<int> ("seed");
+
+   const QList<int> sizes = QList<int> () << 0 << 1 << 2 << 5 << 100 << 10007;
+   const QList<int> windows = QList<int> () << 0 << 1 << 2 << 3 << 4 << 7 << 31 << 301;
+
+   for (int w = 0; w < windows.count (); w++) {
+      QEFloatingArrayTest::addKindRows (sizes, windows.value (w), "window");
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+void QEFloatingArrayTest::medianFilter_data ()
+{
+   QEFloatingArrayTest::medianCases ();
+}
+
+//------------------------------------------------------------------------------
+//
+void QEFloatingArrayTest::medianFilter ()
+{
+   QFETCH (int, size);
+   QFETCH (int, kind);
+   QFETCH (int, window);
+   QFETCH (int, seed);
+
+   const QVector<double> data = QEFloatingArrayTest::makeData (size, seed, Kinds (kind), false);
+
+   QEFloatingArray array (data);
+   QVERIFY (isSame (array.medianFilter (window), Reference::medianFilter (data, window)));
+}
+
+//------------------------------------------------------------------------------
+//
+void QEFloatingArrayTest::minMaxBenchmark ()
+{
+   QEFloatingArray array (QEFloatingArrayTest::makeData (1000000, 0, Special));
+   double total = 0.0;
+   QBENCHMARK {
+      total += array.minimumValue () + array.maximumValue ();
+   }
+   QVERIFY (!qIsNaN (total));
+}
+
+//------------------------------------------------------------------------------
+//
+void QEFloatingArrayTest::minMaxReferenceBenchmark ()
+{
+   const QVector<double> data = QEFloatingArrayTest::makeData (1000000, 0, Special);
+   double total = 0.0;
+   QBENCHMARK {
+      total += Reference::minimumValue (data, 0.0, false) +
+               Reference::maximumValue (data, 0.0, false);
+   }
+   QVERIFY (!qIsNaN (total));
+}
+
+//------------------------------------------------------------------------------
+//
+void QEFloatingArrayTest::calcDyByDxBenchmark ()
+{
+   QEFloatingArray y (QEFloatingArrayTest::makeData (1000000, 0, Plain));
+   QVector<double> x = QEFloatingArrayTest::makeData (1000000, 1, Plain);
+   std::sort (x.begin (), x.end ());
+
+   QBENCHMARK {
+      y.calcDyByDx (x);
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+void QEFloatingArrayTest::calcDyByDxReferenceBenchmark ()
+{
+   const QVector<double> y = QEFloatingArrayTest::makeData (1000000, 0, Plain);
+   QVector<double> x = QEFloatingArrayTest::makeData (1000000, 1, Plain);
+   std::sort (x.begin (), x.end ());
+
+   QBENCHMARK {
+      Reference::calcDyByDx (y, x);
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+void QEFloatingArrayTest::medianFilterBenchmark_data ()
+{
+   QTest::addColumn<int> ("window");
+
+   QTest::newRow ("100k window 31")  << 31;
+   QTest::newRow ("100k window 301") << 301;
+}
+
+//------------------------------------------------------------------------------
+//
+void QEFloatingArrayTest::medianFilterBenchmark ()
+{
+   QFETCH (int, window);
+
+   QEFloatingArray array (QEFloatingArrayTest::makeData (100000, 0, Plain));
+   QBENCHMARK {
+      array.medianFilter (window);
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+void QEFloatingArrayTest::medianFilterReferenceBenchmark_data ()
+{
+   this->medianFilterBenchmark_data ();
+}
+
+//------------------------------------------------------------------------------
+//
+void QEFloatingArrayTest::medianFilterReferenceBenchmark ()
+{
+   QFETCH (int, window);
+
+   const QVector<double> data = QEFloatingArrayTest::makeData (100000, 0, Plain);
+   QBENCHMARK {
+      Reference::medianFilter (data, window);
+   }
+}
+
+QTEST_MAIN (QEFloatingArrayTest)
+#include "tst_QEFloatingArray.moc"
+
+// end
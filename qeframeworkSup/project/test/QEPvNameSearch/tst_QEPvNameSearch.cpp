@@ -0,0 +1,198 @@
+/*  tst_QEPvNameSearch.cpp
+ *
+ *  This file is part of the EPICS QT Framework, initially developed at the
+ *  Australian Synchrotron.
+ *
+ *  SPDX-FileCopyrightText: 2026 Australian Synchrotron
+ *  SPDX-License-Identifier: LGPL-3.0-only
+ *
+ *  Author:     Andrew Starritt
+ *  Maintainer: Andrew Starritt
+ *  Contact:    andrews@ansto.gov.au
+ */
+
+// Compares the QEPvNameSearch indexed regular expression search with a plain
+// QRegularExpression scan of all the names, including patterns with escapes
+// whose operands look like literals, e.g. \x41BC or \cAB, which must not be
+// used to filter the candidate names. Also benchmarks both.
+//
+
+#include <QRegularExpression>
+#include <QString>
+#include <QStringList>
+#include <QtTest>
+#include <QEPvNameSearch.h>
+
+//==============================================================================
+// A plain scan of all the names, as per QStringList::filter.
+//
+static QStringList referenceSearch (const QStringList& names,
+                                    const QRegularExpression& reIn,
+                                    const bool exactMatch)
+{
+   QRegularExpression re = reIn;
+   if (exactMatch) {
+      re.setPattern (QString ("^") + reIn.pattern () + QString ("$"));
+   }
+
+   QStringList result;
+   if (!re.isValid ()) return result;
+
+   for (int j = 0; j < names.count (); j++) {
+      if (re.match (names.value (j)).hasMatch ()) {
+         result.append (names.value (j));
+      }
+   }
+   return result;
+}
+
+
+//==============================================================================
+//
+class QEPvNameSearchTest : public QObject
+{
+   Q_OBJECT
+private slots:
+   void initTestCase ();
+   void cleanupTestCase ();
+
+   void sameResults_data ();
+   void sameResults ();
+
+   void referenceBenchmark ();
+   void indexedBenchmark ();
+
+private:
+   QStringList names;                  // sorted, no duplicates
+   QEPvNameSearch* search;
+};
+
+//------------------------------------------------------------------------------
+// Many more names than QEPvNameSearch::minimumIndexSize, plus some names
+// designed to match the escape sequence patterns.
+//
+void QEPvNameSearchTest::initTestCase ()
+{
+   static const char* const devices [] = {
+      "BCM", "DCCT", "VAC", "RF", "MAG", "BPM", "ABC", "ABCD"
+   };
+   static const char* const attributes [] = {
+      "CURRENT", "CURRENT_MONITOR", "PRESSURE", "VOLTAGE", "STATUS", "BC", "AB"
+   };
+
+   for (int sector = 1; sector <= 14; sector++) {
+      for (int d = 0; d < 8; d++) {
+         for (int inst = 1; inst <= 12; inst++) {
+            for (int a = 0; a < 7; a++) {
+               this->names.append (QString ("SR%1%2%3:%4")
+                                   .arg (sector, 2, 10, QChar ('0'))
+                                   .arg (devices [d])
+                                   .arg (inst, 2, 10, QChar ('0'))
+                                   .arg (attributes [a]));
+            }
+         }
+      }
+   }
+
+   this->names.append ("ABC");
+   this->names.append ("XABCY");
+   this->names.append (QString ("X") + QChar (0x01) + "BC:TEST");       // \cA
+   this->names.append (QString ("Y") + QChar (0x01) + "B:TEST");
+   this->names.append ("SR1SR1:LOOP");                                   // back reference
+   this->names.append ("ABAB:LOOP");
+
+   this->names.sort ();
+   this->names.removeDuplicates ();
+
+   this->search = new QEPvNameSearch (this->names);
+
+   // The index is only built on re-use - so do a throw away search now.
+   //
+   this->search->getMatchingPvNames (QRegularExpression ("BCM"), false);
+}
+
+//------------------------------------------------------------------------------
+//
+void QEPvNameSearchTest::cleanupTestCase ()
+{
+   delete this->search;
+   this->search = NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+void QEPvNameSearchTest::sameResults_data ()
+{
+   QTest::addColumn<QString> ("pattern");
+   QTest::addColumn<bool> ("caseInsensitive");
+
+   static const char* const patterns [] = {
+      // Plain literals, prefixes and classes.
+      "BCM", "CURRENT", "^SR01", "^SR0[1-3]BCM", "MONITOR$", "SR1[0-4]VAC0.:PRE",
+      "BC", "ABC", "^ABC", "ABC$", "BCM|DCCT", "SR(01|02)RF", "RF0?1:ST",
+      "CUR+ENT", "C(URR)?ENT", "\\.", "VAC\\d\\d:", "\\bSR", "[^A-Z]BCM",
+
+      // Escapes with operands - the operands are not literals.
+      "\\x41BC", "\\x{41}BCD", "\\x42CM", "\\cABC", "\\cAB:TEST", "\\101BC",
+      "\\o{101}BCD", "\\0101BC", "\\N{U+0041}BC", "\\pLBCM", "\\p{Lu}BCM",
+      "\\PLBCM", "(SR1)\\1:LOOP", "(AB)\\1:LOOP", "(AB)\\g1:LOOP",
+      "(AB)\\g{1}:LOOP", "(AB)\\g{-1}:LOOP", "(?<n>AB)\\k<n>:LOOP",
+      "(?<n>AB)\\k{n}:LOOP", "\\QABC\\E", "A\\QBC\\E",
+
+      // Escaped literal characters.
+      "SR01BCM01\\:CURRENT", "\\:CURRENT\\_MON"
+   };
+   static const int numberPatterns = sizeof (patterns) / sizeof (patterns [0]);
+
+   for (int j = 0; j < numberPatterns; j++) {
+      for (int ci = 0; ci < 2; ci++) {
+         const QString name = QString ("%1 %2").arg (patterns [j]).arg (ci ? "ci" : "cs");
+         QTest::newRow (name.toLatin1 ().constData ())
+               << QString (patterns [j]) << bool (ci != 0);
+      }
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+void QEPvNameSearchTest::sameResults ()
+{
+   QFETCH (QString, pattern);
+   QFETCH (bool, caseInsensitive);
+
+   const QRegularExpression re (pattern, caseInsensitive
+                                ? QRegularExpression::CaseInsensitiveOption
+                                : QRegularExpression::NoPatternOption);
+   QVERIFY (re.isValid ());
+
+   for (int exact = 0; exact < 2; exact++) {
+      const QStringList expected = referenceSearch (this->names, re, exact != 0);
+      const QStringList actual = this->search->getMatchingPvNames (re, exact != 0);
+      QCOMPARE (actual, expected);
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+void QEPvNameSearchTest::referenceBenchmark ()
+{
+   const QRegularExpression re ("VAC07:PRE");
+   QBENCHMARK {
+      referenceSearch (this->names, re, false);
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+void QEPvNameSearchTest::indexedBenchmark ()
+{
+   const QRegularExpression re ("VAC07:PRE");
+   QBENCHMARK {
+      this->search->getMatchingPvNames (re, false);
+   }
+}
+
+QTEST_MAIN (QEPvNameSearchTest)
+#include "tst_QEPvNameSearch.moc"
+
+// end
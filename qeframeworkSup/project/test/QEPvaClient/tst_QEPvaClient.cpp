@@ -0,0 +1,165 @@
+/*  tst_QEPvaClient.cpp
+ *
+ *  This file is part of the EPICS QT Framework, initially developed at the
+ *  Australian Synchrotron.
+ *
+ *  SPDX-FileCopyrightText: 2026 Australian Synchrotron
+ *  SPDX-License-Identifier: LGPL-3.0-only
+ *
+ *  Author:     Andrew Starritt
+ *  Maintainer: Andrew Starritt
+ *  Contact:    andrews@ansto.gov.au
+ */
+
+// Checks the QEPvaClient get/monitor request formation, both the default full
+// structure request and a selective field request. When built with PV Access
+// support, also checks that the request strings parse to the expected pvRequest
+// field structures, as used by QEPvaClient::openChannel.
+//
+
+#include <QString>
+#include <QStringList>
+#include <QtTest>
+#include <QEPvaClient.h>
+
+#ifdef QE_INCLUDE_PV_ACCESS
+#include <pv/createRequest.h>
+#include <pv/pvData.h>
+#endif
+
+Q_DECLARE_METATYPE (QEPvaClient::RequestFieldsFlags)
+
+//==============================================================================
+//
+class QEPvaClientTest : public QObject
+{
+   Q_OBJECT
+private slots:
+   void defaultRequest ();
+   void valueAlwaysRequested ();
+
+   void formRequest_data ();
+   void formRequest ();
+
+#ifdef QE_INCLUDE_PV_ACCESS
+   void pvRequest_data ();
+   void pvRequest ();
+#endif
+
+private:
+   static void requests ();
+};
+
+//------------------------------------------------------------------------------
+// A client requests the full structure unless told otherwise.
+//
+void QEPvaClientTest::defaultRequest ()
+{
+   QEPvaClient client ("TEST:PV", NULL);
+   QCOMPARE (client.getRequestFields (), QEPvaClient::RequestFieldsFlags (QEPvaClient::AllFields));
+   QCOMPARE (QEPvaClient::formRequest (client.getRequestFields ()), QString ("field()"));
+}
+
+//------------------------------------------------------------------------------
+//
+void QEPvaClientTest::valueAlwaysRequested ()
+{
+   QEPvaClient client ("TEST:PV", NULL);
+
+   client.setRequestFields (QEPvaClient::AlarmField | QEPvaClient::TimeStampField);
+   QCOMPARE (client.getRequestFields (),
+             QEPvaClient::ValueField | QEPvaClient::AlarmField | QEPvaClient::TimeStampField);
+   QCOMPARE (QEPvaClient::formRequest (client.getRequestFields ()),
+             QString ("field(value,alarm,timeStamp)"));
+
+   client.setRequestFields (QEPvaClient::NoFields);
+   QCOMPARE (QEPvaClient::formRequest (client.getRequestFields ()), QString ("field(value)"));
+
+   client.setRequestFields (QEPvaClient::AllFields);
+   QCOMPARE (QEPvaClient::formRequest (client.getRequestFields ()), QString ("field()"));
+}
+
+//------------------------------------------------------------------------------
+// static
+void QEPvaClientTest::requests ()
+{
+   QTest::addColumn<QEPvaClient::RequestFieldsFlags> ("fields");
+   QTest::addColumn<QStringList> ("names");     // empty means the full structure
+
+   QTest::newRow ("all") << QEPvaClient::RequestFieldsFlags (QEPvaClient::AllFields)
+                         << QStringList ();
+
+   QTest::newRow ("value") << QEPvaClient::RequestFieldsFlags (QEPvaClient::ValueField)
+                           << (QStringList () << "value");
+
+   QTest::newRow ("value alarm time")
+         << (QEPvaClient::ValueField | QEPvaClient::AlarmField | QEPvaClient::TimeStampField)
+         << (QStringList () << "value" << "alarm" << "timeStamp");
+
+   QTest::newRow ("standard")
+         << (QEPvaClient::ValueField | QEPvaClient::AlarmField | QEPvaClient::TimeStampField |
+             QEPvaClient::DisplayField | QEPvaClient::ControlField | QEPvaClient::ValueAlarmField)
+         << (QStringList () << "value" << "alarm" << "timeStamp"
+                            << "display" << "control" << "valueAlarm");
+}
+
+//------------------------------------------------------------------------------
+//
+void QEPvaClientTest::formRequest_data ()
+{
+   QEPvaClientTest::requests ();
+}
+
+//------------------------------------------------------------------------------
+//
+void QEPvaClientTest::formRequest ()
+{
+   QFETCH (QEPvaClient::RequestFieldsFlags, fields);
+   QFETCH (QStringList, names);
+
+   const QString expected = QString ("field(%1)").arg (names.join (","));
+   QCOMPARE (QEPvaClient::formRequest (fields), expected);
+}
+
+#ifdef QE_INCLUDE_PV_ACCESS
+
+//------------------------------------------------------------------------------
+//
+void QEPvaClientTest::pvRequest_data ()
+{
+   QEPvaClientTest::requests ();
+}
+
+//------------------------------------------------------------------------------
+// The full structure request has an empty field structure, i.e. everything,
+// a selective request has exactly the requested sub fields.
+//
+void QEPvaClientTest::pvRequest ()
+{
+   namespace pvd = epics::pvData;
+
+   QFETCH (QEPvaClient::RequestFieldsFlags, fields);
+   QFETCH (QStringList, names);
+
+   const std::string request = QEPvaClient::formRequest (fields).toStdString ();
+   pvd::PVStructure::shared_pointer pvRequest =
+         pvd::CreateRequest::create()->createRequest (request);
+   QVERIFY (pvRequest.get ());
+
+   pvd::PVStructure::shared_pointer field = pvRequest->getSubField<pvd::PVStructure> ("field");
+   QVERIFY (field.get ());
+
+   const pvd::StringArray& fieldNames = field->getStructure ()->getFieldNames ();
+   QStringList actual;
+   for (size_t j = 0; j < fieldNames.size (); j++) {
+      actual << QString::fromStdString (fieldNames [j]);
+   }
+   QCOMPARE (actual, names);
+}
+
+#endif
+
+QTEST_MAIN (QEPvaClientTest)
+#include "tst_QEPvaClient.moc"
+
+// end
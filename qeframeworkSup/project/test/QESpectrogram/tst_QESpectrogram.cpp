@@ -0,0 +1,402 @@
+/*  tst_QESpectrogram.cpp
+ *
+ *  This file is part of the EPICS QT Framework, initially developed at the
+ *  Australian Synchrotron.
+ *
+ *  SPDX-FileCopyrightText: 2026 Australian Synchrotron
+ *  SPDX-License-Identifier: LGPL-3.0-only
+ *
+ *  Author:     Andrew Starritt
+ *  Maintainer: Andrew Starritt
+ *  Contact:    andrews@ansto.gov.au
+ */
+
+// Benchmarks the QESpectrogram colour mapping for the 8 cases, i.e.
+//   grey scale vs. false colour;
+//   data source: 1D vs. 2D; and
+//   orientation: horizontal (no rotation) vs. vertical (rotate 90 right),
+// using 2048 x 2048 data (1D data: 1024 sets of 2048 elements).
+//
+// The render benchmark times a full image render, i.e. the lookup table,
+// contiguous row access and parallel render path. The reference benchmark
+// times the per-pixel calculation previously used by renderImage, i.e. getValue,
+// scale, wrap, log scale and pixel map look up for every pixel, on one thread.
+//
+// Also checks that the rendered image is pixel for pixel identical to that
+// produced by the previous per-pixel calculation, for grey scale and false
+// colour, with and without scale wrap and log scale.
+//
+
+#include <QColor>
+#include <QImage>
+#include <QString>
+#include <QVector>
+#include <QtTest>
+#include <QECommon.h>
+#include <QEEnums.h>
+#include <QEFloating.h>
+#include <QESpectrogram.h>
+
+static const int dataWidth = 2048;
+static const int dataHeight = 2048;
+static const int numberOfSets = 1024;     // maximum allowed
+
+//==============================================================================
+// Provides access to the QESpectrogram and QEAbstract2DData protected functions.
+//
+class TestSpectrogram : public QESpectrogram
+{
+public:
+   explicit TestSpectrogram () : QESpectrogram () { }
+
+   using QEAbstract2DData::getNumberRowsAndCols;
+   using QEAbstract2DData::getValue;
+   using QESpectrogram::getImage;
+
+   void setUp (const bool useFalseColour, const bool is1D,
+               const QE::RotationOptions rotation);
+
+   void render () { this->updateDataVisulation (); }
+   void referenceRender (QImage& target);
+   bool rowValuesMatch ();
+};
+
+//------------------------------------------------------------------------------
+//
+void TestSpectrogram::setUp (const bool useFalseColour, const bool is1D,
+                             const QE::RotationOptions rotation)
+{
+   this->setUseFalseColour (useFalseColour);
+   this->setScaleMode (manual);
+   this->setMinimum (0.0);
+   this->setMaximum (1000.0);
+   this->setDataWidth (dataWidth);
+   this->setNumberOfSets (numberOfSets);
+   this->setDataFormat (is1D ? array1D : array2D);
+   this->setRotation (rotation);
+
+   // Some arbitary data - slightly over range to exercise the limits.
+   //
+   const int rows = is1D ? numberOfSets : 1;
+   const int size = is1D ? dataWidth : dataWidth * dataHeight;
+
+   QEFloatingArrayUpdate update;
+   update.variableIndex = DATA_PV_INDEX;
+   update.isMetaUpdate = false;
+   update.values.resize (size);
+
+   for (int r = 0; r < rows; r++) {
+      for (int j = 0; j < size; j++) {
+         update.values [j] = double ((j * 7 + r * 13) % 1100) - 50.0;
+      }
+      this->onDataArrayUpdate (update);
+   }
+}
+
+//------------------------------------------------------------------------------
+// The false colour map, as per QESpectrogram::getFalseColor.
+//
+static const int breakPoint1 = 32;
+static const int breakPoint2 = 224;
+
+static QRgb referenceFalseColour (const int value)
+{
+   const int max = 0xFF;
+   const int half = 0x80;
+   const int lightness_slope = 4;
+   const int low_hue = 240;    // blue.
+   const int high_hue = 0;     // red
+
+   int h, l;
+   if (value < breakPoint1) {
+      h = low_hue;
+      l = lightness_slope*value;
+   }
+   else if (value > breakPoint2) {
+      h = high_hue;
+      l = max - lightness_slope*(max-value);
+   }
+   else {
+      h = ((value - breakPoint1)*high_hue + (breakPoint2 - value)*low_hue) /
+            (breakPoint2 - breakPoint1);
+      l = half;
+   }
+
+   QColor c;
+   c.setHsl (h, max, l);
+   return qRgb (c.red(), c.green(), c.blue());
+}
+
+//------------------------------------------------------------------------------
+// The per-pixel calculation, as previously performed by renderImage.
+//
+void TestSpectrogram::referenceRender (QImage& target)
+{
+   QRgb pixelMap [256];
+   for (int j = 0; j < 256; j++) {
+      pixelMap [j] = this->getUseFalseColour() ? referenceFalseColour (j) : qRgb (j, j, j);
+   }
+
+   double min;
+   double max;
+   this->getScaleModeMinMaxValues (min, max);
+
+   const int scaledMin = 0;
+   const int maxLoops = this->getScaleWrap() - 1;
+   const int wrapSpread = (breakPoint2 - breakPoint1);
+   const int scaledMax = 255 + (maxLoops * wrapSpread);
+
+   const double scale = double (scaledMax - scaledMin)/(max - min);
+   const double offset = -scale * min;
+
+   const bool logScale = this->getLogScale();
+   const QRect area = target.rect();
+
+   for (int row = area.top(); row <= area.bottom(); row++) {
+      QRgb* rowOut = (QRgb*)(target.scanLine (row));
+
+      for (int col = area.left(); col <= area.right(); col++) {
+
+         double value = this->getValue (row, col, min);
+
+         value = scale*value + offset;
+         value = LIMIT (value, scaledMin, scaledMax);
+
+         int index = int (value);
+         int loops = (index - breakPoint1) / wrapSpread;
+         loops = MIN (loops, maxLoops);
+
+         index = index - (loops*wrapSpread);
+         index = LIMIT (index, 0, 255);
+
+         if (logScale) {
+            index = int (LOG10 (index + 1.0) * 105.9903);
+         }
+
+         rowOut [col] = pixelMap [index];
+      }
+   }
+}
+
+//------------------------------------------------------------------------------
+// Checks the whole row access against the per element access.
+//
+bool TestSpectrogram::rowValuesMatch ()
+{
+   int numberRows;
+   int numberCols;
+   this->getNumberRowsAndCols (numberRows, numberCols);
+
+   QVector<double> values (numberCols);
+   for (int row = 0; row < numberRows; row++) {
+      this->getDisplayedRowValues (row, 0, numberCols, values.data (), -1.0);
+      for (int col = 0; col < numberCols; col++) {
+         if (values [col] != this->getValue (row, col, -1.0)) return false;
+      }
+   }
+   return true;
+}
+
+
+//==============================================================================
+//
+class QESpectrogramTest : public QObject
+{
+   Q_OBJECT
+private slots:
+   void sameValues_data ();
+   void sameValues ();
+   void samePixels_data ();
+   void samePixels ();
+
+   void renderBenchmark_data ();
+   void renderBenchmark ();
+   void referenceBenchmark_data ();
+   void referenceBenchmark ();
+
+private:
+   static void cases ();
+};
+
+//------------------------------------------------------------------------------
+// static
+void QESpectrogramTest::cases ()
+{
+   QTest::addColumn<bool> ("useFalseColour");
+   QTest::addColumn<bool> ("is1D");
+   QTest::addColumn<int> ("rotation");
+
+   for (int c = 0; c < 8; c++) {
+      const bool useFalseColour = (c & 4) != 0;
+      const bool is1D = (c & 2) != 0;
+      const QE::RotationOptions rotation = (c & 1) ? QE::Rotate90Right : QE::NoRotation;
+
+      const QString name = QString ("%1 %2 %3")
+            .arg (useFalseColour ? "false colour" : "grey")
+            .arg (is1D ? "1D" : "2D")
+            .arg (rotation == QE::NoRotation ? "horizontal" : "vertical");
+
+      QTest::newRow (name.toLatin1 ().constData ())
+            << useFalseColour << is1D << int (rotation);
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+void QESpectrogramTest::sameValues_data ()
+{
+   QESpectrogramTest::cases ();
+}
+
+//------------------------------------------------------------------------------
+// The contiguous row access must provide the same values as getValue, for all
+// the orientations, including the flips.
+//
+void QESpectrogramTest::sameValues ()
+{
+   QFETCH (bool, useFalseColour);
+   QFETCH (bool, is1D);
+   QFETCH (int, rotation);
+
+   TestSpectrogram spectrogram;
+   spectrogram.setUp (useFalseColour, is1D, QE::RotationOptions (rotation));
+
+   for (int flip = 0; flip < 4; flip++) {
+      spectrogram.setVerticalFlip ((flip & 1) != 0);
+      spectrogram.setHorizontalFlip ((flip & 2) != 0);
+      QVERIFY (spectrogram.rowValuesMatch ());
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+void QESpectrogramTest::samePixels_data ()
+{
+   QTest::addColumn<bool> ("useFalseColour");
+   QTest::addColumn<bool> ("is1D");
+   QTest::addColumn<int> ("rotation");
+   QTest::addColumn<int> ("scaleWrap");
+   QTest::addColumn<bool> ("logScale");
+
+   static const int wraps [] = { 1, 3, 10 };
+
+   for (int c = 0; c < 2; c++) {
+      const bool useFalseColour = (c != 0);
+      for (int w = 0; w < 3; w++) {
+         for (int log = 0; log < 2; log++) {
+            const QString name = QString ("%1 wrap %2 %3")
+                  .arg (useFalseColour ? "false colour" : "grey")
+                  .arg (wraps [w])
+                  .arg (log ? "log" : "linear");
+
+            QTest::newRow (name.toLatin1 ().constData ())
+                  << useFalseColour << false << int (QE::NoRotation)
+                  << wraps [w] << bool (log != 0);
+         }
+      }
+   }
+
+   // The parallel render with the row access for the other orientation.
+   //
+   QTest::newRow ("false colour 1D vertical wrap 3 log")
+         << true << true << int (QE::Rotate90Right) << 3 << true;
+}
+
+//------------------------------------------------------------------------------
+// The lookup table render must match the per-pixel calculation exactly,
+// including the over and under range values.
+//
+void QESpectrogramTest::samePixels ()
+{
+   QFETCH (bool, useFalseColour);
+   QFETCH (bool, is1D);
+   QFETCH (int, rotation);
+   QFETCH (int, scaleWrap);
+   QFETCH (bool, logScale);
+
+   TestSpectrogram spectrogram;
+   spectrogram.setUp (useFalseColour, is1D, QE::RotationOptions (rotation));
+   spectrogram.setScaleWrap (scaleWrap);
+   spectrogram.setLogScale (logScale);
+   QCOMPARE (spectrogram.getScaleWrap (), scaleWrap);
+
+   spectrogram.render ();
+   const QImage actual = spectrogram.getImage ();
+
+   int numberRows;
+   int numberCols;
+   spectrogram.getNumberRowsAndCols (numberRows, numberCols);
+   QImage expected (numberCols, numberRows, QImage::Format_RGB32);
+   spectrogram.referenceRender (expected);
+
+   QCOMPARE (actual.size (), expected.size ());
+   QCOMPARE (actual.format (), expected.format ());
+
+   for (int row = 0; row < numberRows; row++) {
+      const QRgb* a = (const QRgb*) actual.constScanLine (row);
+      const QRgb* e = (const QRgb*) expected.constScanLine (row);
+      for (int col = 0; col < numberCols; col++) {
+         if (a [col] != e [col]) {
+            qDebug () << "row:" << row << " col:" << col
+                      << " value:" << spectrogram.getValue (row, col, 0.0);
+            QCOMPARE (a [col], e [col]);
+         }
+      }
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+void QESpectrogramTest::renderBenchmark_data ()
+{
+   QESpectrogramTest::cases ();
+}
+
+//------------------------------------------------------------------------------
+//
+void QESpectrogramTest::renderBenchmark ()
+{
+   QFETCH (bool, useFalseColour);
+   QFETCH (bool, is1D);
+   QFETCH (int, rotation);
+
+   TestSpectrogram spectrogram;
+   spectrogram.setUp (useFalseColour, is1D, QE::RotationOptions (rotation));
+
+   QBENCHMARK {
+      spectrogram.render ();
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+void QESpectrogramTest::referenceBenchmark_data ()
+{
+   QESpectrogramTest::cases ();
+}
+
+//------------------------------------------------------------------------------
+//
+void QESpectrogramTest::referenceBenchmark ()
+{
+   QFETCH (bool, useFalseColour);
+   QFETCH (bool, is1D);
+   QFETCH (int, rotation);
+
+   TestSpectrogram spectrogram;
+   spectrogram.setUp (useFalseColour, is1D, QE::RotationOptions (rotation));
+
+   int numberRows;
+   int numberCols;
+   spectrogram.getNumberRowsAndCols (numberRows, numberCols);
+   QImage image (numberCols, numberRows, QImage::Format_RGB32);
+
+   QBENCHMARK {
+      spectrogram.referenceRender (image);
+   }
+}
+
+QTEST_MAIN (QESpectrogramTest)
+#include "tst_QESpectrogram.moc"
+
+// end
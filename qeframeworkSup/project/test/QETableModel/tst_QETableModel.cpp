@@ -0,0 +1,428 @@
+/*  tst_QETableModel.cpp
+ *
+ *  This file is part of the EPICS QT Framework, initially developed at the
+ *  Australian Synchrotron.
+ *
+ *  SPDX-FileCopyrightText: 2026 Australian Synchrotron
+ *  SPDX-License-Identifier: LGPL-3.0-only
+ *
+ *  Author:     Andrew Starritt
+ *  Maintainer: Andrew Starritt
+ *  Contact:    andrews@ansto.gov.au
+ */
+
+// Checks the QETableModel, the common model behind the QETable and QENTTable
+// widgets: the changed range calculation used to limit the view updates, the
+// row/col insertion and removal when the shape changes (including the always
+// at least one row and col rule), and the transposition of the sets and
+// elements when the orientation changes.
+//
+
+#include <QModelIndex>
+#include <QSignalSpy>
+#include <QString>
+#include <QVariant>
+#include <QVariantList>
+#include <QVector>
+#include <QtTest>
+#include <QETableModel.h>
+
+//==============================================================================
+// A model with a settable number of sets and elements. The cell data identifies
+// the set and element.
+//
+class TestModel : public QETableModel
+{
+public:
+   explicit TestModel () : QETableModel (NULL)
+   {
+      this->sets = 0;
+      this->elements = 0;
+   }
+
+   static QString cellText (const int set, const int element)
+   {
+      return QString ("%1:%2").arg (set).arg (element);
+   }
+
+   int sets;
+   int elements;
+
+protected:
+   int getSetCount () const { return this->sets; }
+   int getElementCount () const { return this->elements; }
+   QString getSetTitle (const int set) const { return QString ("Set %1").arg (set); }
+   QVariant getElementData (const int set, const int element, const int role) const
+   {
+      if (role != Qt::DisplayRole) return QVariant ();
+      return QVariant (TestModel::cellText (set, element));
+   }
+};
+
+
+//==============================================================================
+//
+class QETableModelTest : public QObject
+{
+   Q_OBJECT
+private slots:
+   void initTestCase ();
+
+   void findChangedRange_data ();
+   void findChangedRange ();
+
+   void initialShape ();
+   void updateShape_data ();
+   void updateShape ();
+   void orientation ();
+   void elementsChanged ();
+   void titlesChanged ();
+
+private:
+   static bool isTransposed (const TestModel& model);
+   static void checkSpy (const QSignalSpy& spy, const int first, const int last);
+};
+
+//------------------------------------------------------------------------------
+//
+void QETableModelTest::initTestCase ()
+{
+   qRegisterMetaType<QModelIndex> ("QModelIndex");
+   qRegisterMetaType<Qt::Orientation> ("Qt::Orientation");
+   qRegisterMetaType<QVector<int> > ("QVector<int>");
+}
+
+//------------------------------------------------------------------------------
+// static
+// Checks the model's cells and headers match its sets and elements, allowing
+// for the orientation.
+//
+bool QETableModelTest::isTransposed (const TestModel& model)
+{
+   const bool vertical = (model.getOrientation () == Qt::Vertical);
+   const Qt::Orientation setHeader = vertical ? Qt::Horizontal : Qt::Vertical;
+   const Qt::Orientation elementHeader = vertical ? Qt::Vertical : Qt::Horizontal;
+
+   for (int row = 0; row < model.rowCount (); row++) {
+      for (int col = 0; col < model.columnCount (); col++) {
+         const int set = vertical ? col : row;
+         const int element = vertical ? row : col;
+         const QVariant cell = model.data (model.index (row, col));
+         if (cell.toString () != TestModel::cellText (set, element)) return false;
+      }
+   }
+
+   const int numberOfSets = vertical ? model.columnCount () : model.rowCount ();
+   const int numberOfElements = vertical ? model.rowCount () : model.columnCount ();
+
+   for (int set = 0; set < numberOfSets; set++) {
+      if (model.headerData (set, setHeader).toString () != QString ("Set %1").arg (set)) {
+         return false;
+      }
+   }
+   for (int element = 0; element < numberOfElements; element++) {
+      if (model.headerData (element, elementHeader).toString () != QString::number (element + 1)) {
+         return false;
+      }
+   }
+   return true;
+}
+
+//------------------------------------------------------------------------------
+// static
+// Checks the spy caught exactly one insert/remove signal, for first to last.
+//
+void QETableModelTest::checkSpy (const QSignalSpy& spy, const int first, const int last)
+{
+   QCOMPARE (spy.count (), 1);
+   const QList<QVariant> arguments = spy.at (0);
+   QCOMPARE (arguments.at (1).toInt (), first);
+   QCOMPARE (arguments.at (2).toInt (), last);
+}
+
+//------------------------------------------------------------------------------
+//
+void QETableModelTest::findChangedRange_data ()
+{
+   QTest::addColumn<QVariantList> ("before");
+   QTest::addColumn<QVariantList> ("after");
+   QTest::addColumn<bool> ("changed");
+   QTest::addColumn<int> ("first");
+   QTest::addColumn<int> ("last");
+
+   const QVariantList none;
+   const QVariantList v123 = QVariantList () << 1 << 2 << 3;
+
+   QTest::newRow ("both empty") << none << none << false << 0 << 0;
+   QTest::newRow ("same")       << v123 << v123 << false << 0 << 0;
+   QTest::newRow ("first")      << v123 << (QVariantList () << 9 << 2 << 3) << true << 0 << 0;
+   QTest::newRow ("last")       << v123 << (QVariantList () << 1 << 2 << 9) << true << 2 << 2;
+   QTest::newRow ("both ends")  << v123 << (QVariantList () << 9 << 2 << 9) << true << 0 << 2;
+   QTest::newRow ("middle")     << (QVariantList () << 1 << 2 << 3 << 4 << 5)
+                                << (QVariantList () << 1 << 9 << 9 << 4 << 5) << true << 1 << 2;
+   QTest::newRow ("repeated")   << (QVariantList () << 1 << 1 << 1)
+                                << (QVariantList () << 1 << 2 << 1) << true << 1 << 1;
+   QTest::newRow ("grown")      << (QVariantList () << 1 << 2)
+                                << (QVariantList () << 1 << 2 << 3 << 4) << true << 2 << 3;
+   QTest::newRow ("shrunk")     << (QVariantList () << 1 << 2 << 3 << 4)
+                                << (QVariantList () << 1 << 2) << true << 2 << 3;
+   QTest::newRow ("grown and changed") << v123 << (QVariantList () << 1 << 9 << 3 << 4)
+                                       << true << 1 << 3;
+   QTest::newRow ("from empty") << none << (QVariantList () << 1 << 2) << true << 0 << 1;
+   QTest::newRow ("to empty")   << (QVariantList () << 1 << 2) << none << true << 0 << 1;
+   QTest::newRow ("strings")    << (QVariantList () << "a" << "b" << "c")
+                                << (QVariantList () << "a" << "x" << "c") << true << 1 << 1;
+}
+
+//------------------------------------------------------------------------------
+//
+void QETableModelTest::findChangedRange ()
+{
+   QFETCH (QVariantList, before);
+   QFETCH (QVariantList, after);
+   QFETCH (bool, changed);
+   QFETCH (int, first);
+   QFETCH (int, last);
+
+   int actualFirst = -1;
+   int actualLast = -1;
+   QCOMPARE (QETableModel::findChangedRange (before, after, actualFirst, actualLast), changed);
+   if (changed) {
+      QCOMPARE (actualFirst, first);
+      QCOMPARE (actualLast, last);
+
+      // And the reverse must give the same range.
+      //
+      QVERIFY (QETableModel::findChangedRange (after, before, actualFirst, actualLast));
+      QCOMPARE (actualFirst, first);
+      QCOMPARE (actualLast, last);
+   }
+}
+
+//------------------------------------------------------------------------------
+// Always at least one row and col - even before updateShape is called.
+//
+void QETableModelTest::initialShape ()
+{
+   TestModel model;
+   QCOMPARE (model.getOrientation (), Qt::Vertical);
+   QCOMPARE (model.rowCount (), 1);
+   QCOMPARE (model.columnCount (), 1);
+
+   model.updateShape ();
+   QCOMPARE (model.rowCount (), 1);
+   QCOMPARE (model.columnCount (), 1);
+
+   // Not a tree.
+   //
+   QCOMPARE (model.rowCount (model.index (0, 0)), 0);
+   QCOMPARE (model.columnCount (model.index (0, 0)), 0);
+}
+
+//------------------------------------------------------------------------------
+//
+void QETableModelTest::updateShape_data ()
+{
+   QTest::addColumn<int> ("orientation");
+   QTest::newRow ("vertical")   << int (Qt::Vertical);
+   QTest::newRow ("horizontal") << int (Qt::Horizontal);
+}
+
+//------------------------------------------------------------------------------
+// Rows and cols are inserted and removed at the end, and only as needed.
+//
+void QETableModelTest::updateShape ()
+{
+   QFETCH (int, orientation);
+   const bool vertical = (orientation == Qt::Vertical);
+
+   TestModel model;
+   model.setOrientation (Qt::Orientation (orientation));
+
+   // When vertical, the sets are the columns and the elements the rows.
+   //
+   const char* setInserted   = vertical ? SIGNAL (columnsInserted (QModelIndex, int, int))
+                                        : SIGNAL (rowsInserted (QModelIndex, int, int));
+   const char* setRemoved    = vertical ? SIGNAL (columnsRemoved (QModelIndex, int, int))
+                                        : SIGNAL (rowsRemoved (QModelIndex, int, int));
+   const char* elemInserted  = vertical ? SIGNAL (rowsInserted (QModelIndex, int, int))
+                                        : SIGNAL (columnsInserted (QModelIndex, int, int));
+   const char* elemRemoved   = vertical ? SIGNAL (rowsRemoved (QModelIndex, int, int))
+                                        : SIGNAL (columnsRemoved (QModelIndex, int, int));
+
+   // Grow.
+   //
+   {
+      QSignalSpy setInsertSpy (&model, setInserted);
+      QSignalSpy elemInsertSpy (&model, elemInserted);
+      QSignalSpy resetSpy (&model, SIGNAL (modelReset ()));
+
+      model.sets = 3;
+      model.elements = 5;
+      model.updateShape ();
+
+      QETableModelTest::checkSpy (setInsertSpy, 1, 2);
+      QETableModelTest::checkSpy (elemInsertSpy, 1, 4);
+      QCOMPARE (resetSpy.count (), 0);
+      QCOMPARE (model.rowCount (), vertical ? 5 : 3);
+      QCOMPARE (model.columnCount (), vertical ? 3 : 5);
+      QVERIFY (QETableModelTest::isTransposed (model));
+   }
+
+   // No change - no signals.
+   //
+   {
+      QSignalSpy setInsertSpy (&model, setInserted);
+      QSignalSpy setRemoveSpy (&model, setRemoved);
+      QSignalSpy elemInsertSpy (&model, elemInserted);
+      QSignalSpy elemRemoveSpy (&model, elemRemoved);
+
+      model.updateShape ();
+
+      QCOMPARE (setInsertSpy.count (), 0);
+      QCOMPARE (setRemoveSpy.count (), 0);
+      QCOMPARE (elemInsertSpy.count (), 0);
+      QCOMPARE (elemRemoveSpy.count (), 0);
+   }
+
+   // Shrink - to no sets, but there is still one.
+   //
+   {
+      QSignalSpy setRemoveSpy (&model, setRemoved);
+      QSignalSpy elemRemoveSpy (&model, elemRemoved);
+
+      model.sets = 0;
+      model.elements = 2;
+      model.updateShape ();
+
+      QETableModelTest::checkSpy (setRemoveSpy, 1, 2);
+      QETableModelTest::checkSpy (elemRemoveSpy, 2, 4);
+      QCOMPARE (model.rowCount (), vertical ? 2 : 1);
+      QCOMPARE (model.columnCount (), vertical ? 1 : 2);
+      QVERIFY (QETableModelTest::isTransposed (model));
+   }
+
+   // Out of range cells - no data.
+   //
+   QVERIFY (!model.data (model.index (5, 5)).isValid ());
+   QVERIFY (!model.data (QModelIndex ()).isValid ());
+}
+
+//------------------------------------------------------------------------------
+// Changing the orientation resets the model and transposes the table.
+//
+void QETableModelTest::orientation ()
+{
+   TestModel model;
+   model.sets = 3;
+   model.elements = 5;
+   model.updateShape ();
+   QVERIFY (QETableModelTest::isTransposed (model));
+
+   QSignalSpy resetSpy (&model, SIGNAL (modelReset ()));
+
+   model.setOrientation (Qt::Horizontal);
+   QCOMPARE (resetSpy.count (), 1);
+   QCOMPARE (model.getOrientation (), Qt::Horizontal);
+   QCOMPARE (model.rowCount (), 3);
+   QCOMPARE (model.columnCount (), 5);
+   QVERIFY (QETableModelTest::isTransposed (model));
+
+   // Same again - no reset.
+   //
+   model.setOrientation (Qt::Horizontal);
+   QCOMPARE (resetSpy.count (), 1);
+
+   // A shape change while horizontal.
+   //
+   QSignalSpy rowSpy (&model, SIGNAL (rowsInserted (QModelIndex, int, int)));
+   model.sets = 4;
+   model.updateShape ();
+   QETableModelTest::checkSpy (rowSpy, 3, 3);
+   QVERIFY (QETableModelTest::isTransposed (model));
+
+   model.setOrientation (Qt::Vertical);
+   QCOMPARE (resetSpy.count (), 2);
+   QCOMPARE (model.rowCount (), 5);
+   QCOMPARE (model.columnCount (), 4);
+   QVERIFY (QETableModelTest::isTransposed (model));
+
+   // Cells are selectable and enabled, but not editable.
+   //
+   QCOMPARE (model.flags (model.index (0, 0)), Qt::ItemIsSelectable | Qt::ItemIsEnabled);
+   QCOMPARE (model.flags (QModelIndex ()), Qt::NoItemFlags);
+}
+
+//------------------------------------------------------------------------------
+// The changed cells are those of the set, limited to the elements presented.
+//
+void QETableModelTest::elementsChanged ()
+{
+   TestModel model;
+   model.sets = 3;
+   model.elements = 5;
+   model.updateShape ();
+
+   QSignalSpy spy (&model, SIGNAL (dataChanged (QModelIndex, QModelIndex, QVector<int>)));
+
+   model.elementsChanged (1, 2, 10);
+   QCOMPARE (spy.count (), 1);
+   QCOMPARE (spy.at (0).at (0).value<QModelIndex> (), model.index (2, 1));
+   QCOMPARE (spy.at (0).at (1).value<QModelIndex> (), model.index (4, 1));
+
+   // Transposed.
+   //
+   model.setOrientation (Qt::Horizontal);
+   spy.clear ();
+   model.elementsChanged (1, -3, 3);
+   QCOMPARE (spy.count (), 1);
+   QCOMPARE (spy.at (0).at (0).value<QModelIndex> (), model.index (1, 0));
+   QCOMPARE (spy.at (0).at (1).value<QModelIndex> (), model.index (1, 3));
+
+   // Out of range - nothing to update.
+   //
+   spy.clear ();
+   model.elementsChanged (3, 0, 4);
+   model.elementsChanged (-1, 0, 4);
+   model.elementsChanged (0, 5, 9);
+   model.elementsChanged (0, 3, 2);
+   QCOMPARE (spy.count (), 0);
+
+   // Everything.
+   //
+   model.allChanged ();
+   QCOMPARE (spy.count (), 1);
+   QCOMPARE (spy.at (0).at (0).value<QModelIndex> (), model.index (0, 0));
+   QCOMPARE (spy.at (0).at (1).value<QModelIndex> (), model.index (2, 4));
+}
+
+//------------------------------------------------------------------------------
+// The titles are on the set header, which depends on the orientation.
+//
+void QETableModelTest::titlesChanged ()
+{
+   TestModel model;
+   model.sets = 3;
+   model.elements = 5;
+   model.updateShape ();
+
+   QSignalSpy spy (&model, SIGNAL (headerDataChanged (Qt::Orientation, int, int)));
+
+   model.titlesChanged ();
+   QCOMPARE (spy.count (), 1);
+   QCOMPARE (spy.at (0).at (0).value<Qt::Orientation> (), Qt::Horizontal);
+   QCOMPARE (spy.at (0).at (1).toInt (), 0);
+   QCOMPARE (spy.at (0).at (2).toInt (), 2);
+
+   model.setOrientation (Qt::Horizontal);
+   spy.clear ();
+   model.titlesChanged ();
+   QCOMPARE (spy.count (), 1);
+   QCOMPARE (spy.at (0).at (0).value<Qt::Orientation> (), Qt::Vertical);
+   QCOMPARE (spy.at (0).at (2).toInt (), 2);
+}
+
+QTEST_MAIN (QETableModelTest)
+#include "tst_QETableModel.moc"
+
+// end
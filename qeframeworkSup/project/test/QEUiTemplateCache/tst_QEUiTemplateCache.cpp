@@ -0,0 +1,182 @@
+/*  tst_QEUiTemplateCache.cpp
+ *
+ *  This file is part of the EPICS QT Framework, initially developed at the
+ *  Australian Synchrotron.
+ *
+ *  SPDX-FileCopyrightText: 2026 Australian Synchrotron
+ *  SPDX-License-Identifier: LGPL-3.0-only
+ *
+ *  Author:     Andrew Starritt
+ *  Maintainer: Andrew Starritt
+ *  Contact:    andrews@ansto.gov.au
+ */
+
+// Benchmarks the loading of a 200 cell form grid, i.e. 200 QEForms all using
+// the same ui file, as per QEFormGrid. The "uncached" case replicates the ui
+// loading of QEForm::readUiFile prior to the introduction of the ui template
+// cache, i.e. a new QUiLoader and a read from disk for every form.
+// The cold case clears the cache first, the warm case does not.
+//
+// For a like for like comparison that includes the QEForm overheads, also run
+// with QE_DISABLE_UI_TEMPLATE_CACHE=1 and compare the gridCold results.
+//
+
+#include <QFile>
+#include <QString>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QUiLoader>
+#include <QWidget>
+#include <QtTest>
+#include <QEForm.h>
+#include <QEUiTemplateCache.h>
+
+static const int numberOfCells = 200;
+
+//==============================================================================
+//
+class QEUiTemplateCacheTest : public QObject
+{
+   Q_OBJECT
+private slots:
+   void initTestCase ();
+   void sameWidgets ();
+   void gridUncached ();
+   void gridCold ();
+   void gridWarm ();
+
+private:
+   void loadGrid ();
+   static int countChildren (QWidget* widget);
+
+   QTemporaryDir tempDir;
+   QString uiFileName;
+};
+
+//------------------------------------------------------------------------------
+// Generate a moderately sized ui file, i.e. the sort of thing that is used as
+// a grid sub-form.
+//
+void QEUiTemplateCacheTest::initTestCase ()
+{
+   QVERIFY (this->tempDir.isValid ());
+   this->uiFileName = this->tempDir.path () + "/cell.ui";
+
+   QFile file (this->uiFileName);
+   QVERIFY (file.open (QIODevice::WriteOnly | QIODevice::Text));
+
+   QTextStream target (&file);
+   target << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+          << "<ui version=\"4.0\">\n"
+          << " <class>Cell</class>\n"
+          << " <widget class=\"QWidget\" name=\"Cell\">\n"
+          << "  <layout class=\"QGridLayout\" name=\"gridLayout\">\n";
+
+   for (int row = 0; row < 10; row++) {
+      target << QString ("   <item row=\"%1\" column=\"0\">\n"
+                         "    <widget class=\"QLabel\" name=\"label_%1\">\n"
+                         "     <property name=\"text\"><string>Item %1</string></property>\n"
+                         "    </widget>\n"
+                         "   </item>\n"
+                         "   <item row=\"%1\" column=\"1\">\n"
+                         "    <widget class=\"QLineEdit\" name=\"edit_%1\"/>\n"
+                         "   </item>\n"
+                         "   <item row=\"%1\" column=\"2\">\n"
+                         "    <widget class=\"QFrame\" name=\"frame_%1\">\n"
+                         "     <property name=\"frameShape\"><enum>QFrame::Box</enum></property>\n"
+                         "    </widget>\n"
+                         "   </item>\n").arg (row);
+   }
+
+   target << "  </layout>\n"
+          << " </widget>\n"
+          << "</ui>\n";
+   target.flush ();
+   file.close ();
+}
+
+//------------------------------------------------------------------------------
+// static
+int QEUiTemplateCacheTest::countChildren (QWidget* widget)
+{
+   return widget ? widget->findChildren<QWidget*> ().count () : -1;
+}
+
+//------------------------------------------------------------------------------
+// Cached loads must create the same widget hierarchy as a direct load.
+//
+void QEUiTemplateCacheTest::sameWidgets ()
+{
+   QFile file (this->uiFileName);
+   QVERIFY (file.open (QIODevice::ReadOnly));
+   QUiLoader loader;
+   QWidget* direct = loader.load (&file);
+   file.close ();
+   QVERIFY (direct);
+
+   QEUiTemplateCache::clear ();
+   for (int j = 0; j < 2; j++) {   // cold then warm
+      QEForm form (this->uiFileName);
+      QVERIFY (form.readUiFile ());
+      QWidget* ui = form.findChild<QWidget*> ("Cell");
+      QVERIFY (ui);
+      QCOMPARE (QEUiTemplateCacheTest::countChildren (ui),
+                QEUiTemplateCacheTest::countChildren (direct));
+   }
+
+   delete direct;
+}
+
+//------------------------------------------------------------------------------
+//
+void QEUiTemplateCacheTest::loadGrid ()
+{
+   QWidget grid;
+   for (int j = 0; j < numberOfCells; j++) {
+      QEForm* form = new QEForm (this->uiFileName, &grid);
+      form->readUiFile ();
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+void QEUiTemplateCacheTest::gridUncached ()
+{
+   QBENCHMARK {
+      QWidget grid;
+      for (int j = 0; j < numberOfCells; j++) {
+         QUiLoader loader;
+         QFile file (this->uiFileName);
+         file.open (QIODevice::ReadOnly);
+         loader.load (&file, &grid);
+         file.close ();
+      }
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+void QEUiTemplateCacheTest::gridCold ()
+{
+   QBENCHMARK {
+      QEUiTemplateCache::clear ();
+      this->loadGrid ();
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+void QEUiTemplateCacheTest::gridWarm ()
+{
+   QEUiTemplateCache::clear ();
+   this->loadGrid ();    // prime the cache
+
+   QBENCHMARK {
+      this->loadGrid ();
+   }
+}
+
+QTEST_MAIN (QEUiTemplateCacheTest)
+#include "tst_QEUiTemplateCache.moc"
+
+// end
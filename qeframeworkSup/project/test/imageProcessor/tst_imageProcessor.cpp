@@ -0,0 +1,375 @@
+/*  tst_imageProcessor.cpp
+ *
+ *  This file is part of the EPICS QT Framework, initially developed at the
+ *  Australian Synchrotron.
+ *
+ *  SPDX-FileCopyrightText: 2026 Australian Synchrotron
+ *  SPDX-License-Identifier: LGPL-3.0-only
+ *
+ *  Author:     Andrew Starritt
+ *  Maintainer: Andrew Starritt
+ *  Contact:    andrews@ansto.gov.au
+ */
+
+// Compares the two mono image build paths of imagePropertiesCore::buildImageCore
+// for 8, 12 and 16 bit images, i.e. the previous path that scales each pixel for
+// local brightness and contrast and then uses the 8 bit lookup table, and the
+// path that uses the full depth lookup table (one lookup per pixel).
+//
+// The image under test is built by the imageProcessor itself, i.e. buildImage,
+// getPixelTranslation and getFullPixelTranslation, on the image processing
+// thread. The reference image is built from the same processor's 8 bit lookup
+// table and local brightness and contrast using the previous path, selected by
+// providing an empty full depth table. Both must be identical for each of the
+// translation settings, i.e. log, false colour, contrast reversal, clipping and
+// local brightness and contrast.
+//
+// Also checks the full depth table is only regenerated when the settings it
+// depends on change.
+//
+
+#include <QByteArray>
+#include <QImage>
+#include <QString>
+#include <QVector>
+#include <QtTest>
+#include <QEEnums.h>
+#include <brightnessContrast.h>
+#include <imageProcessor.h>
+
+typedef imageDisplayProperties::rgbPixel rgbPixel;
+
+static const int imageWidth = 2048;
+static const int imageHeight = 2048;
+
+//==============================================================================
+// Receives the images built on the image processing thread.
+//
+class ImageReceiver : public QObject
+{
+   Q_OBJECT
+public:
+   explicit ImageReceiver () : QObject (NULL) { this->received = false; }
+
+   QImage image;
+   bool received;
+
+public slots:
+   void onImageBuilt (QImage imageIn, QString)
+   {
+      this->image = imageIn;
+      this->received = true;
+   }
+};
+
+//==============================================================================
+// An image processor holding a synthetic mono image, with access to the
+// processor's lookup tables.
+//
+class TestProcessor : public imageProcessor
+{
+public:
+   explicit TestProcessor (const unsigned int bitDepth);
+
+   void setBrightnessContrast (const int low, const int high);
+
+   QImage buildCore (const bool useFullLookup);   // on this thread
+   const rgbPixel* getFullLookupData () const { return this->fullPixelLookup.constData (); }
+
+   imageDisplayProperties displayProperties;
+};
+
+//------------------------------------------------------------------------------
+//
+TestProcessor::TestProcessor (const unsigned int bitDepthIn) : imageProcessor ()
+{
+   this->setFormat (QE::Mono);
+   this->setBitDepth (bitDepthIn);
+   this->setImageBuffWidth (imageWidth);
+   this->setImageBuffHeight (imageHeight);
+   this->setImageDisplayProperties (&this->displayProperties);
+
+   const unsigned long dataSize = (bitDepthIn <= 8) ? 1 : 2;
+
+   // Simple linear congruential generator - repeatable and covers all values.
+   // The upper bits (above the bit depth) are set too, as they are masked off.
+   // Pixels are extracted as an unsigned int, hence the extra padding.
+   //
+   QByteArray data;
+   data.resize (imageWidth * imageHeight * dataSize + sizeof (unsigned int));
+   unsigned char* raw = (unsigned char*) data.data ();
+
+   quint32 seed = 12345;
+   for (int j = 0; j < data.size (); j++) {
+      seed = seed * 1103515245 + 12345;
+      raw [j] = (unsigned char) (seed >> 16);
+   }
+
+   this->setImage (data, dataSize);
+
+   // A local brightness and contrast range within the pixel range, so that
+   // both the clipped and scaled values are exercised.
+   //
+   const unsigned int maxValue = (1U << bitDepthIn) - 1;
+   this->setBrightnessContrast (maxValue / 10, (maxValue * 9) / 10);
+}
+
+//------------------------------------------------------------------------------
+// As if set by the user.
+//
+void TestProcessor::setBrightnessContrast (const int low, const int high)
+{
+   this->displayProperties.statisticsSet = true;
+   this->displayProperties.zeroValue = low;
+   this->displayProperties.fullValue = high;
+}
+
+//------------------------------------------------------------------------------
+// Builds the image as per buildImage, but on this thread, and optionally
+// without the full depth table.
+//
+QImage TestProcessor::buildCore (const bool useFullLookup)
+{
+   const QVector<rgbPixel> noLookup;
+
+   imagePropertiesCore core (this->imageData,
+                             this->imageBuffWidth,
+                             this->imageBuffHeight,
+                             this->getScanOption (),
+                             this->bytesPerPixel,
+                             this->pixelLow,
+                             this->pixelHigh,
+                             this->bitDepth,
+                             this->pixelLookup,
+                             useFullLookup ? this->fullPixelLookup : noLookup,
+                             this->formatOption,
+                             this->imageDataSize,
+                             this->imageDisplayProps,
+                             this->rotatedImageBuffWidth (),
+                             this->rotatedImageBuffHeight ());
+
+   return core.buildImageCore ();
+}
+
+
+//==============================================================================
+//
+class imageProcessorTest : public QObject
+{
+   Q_OBJECT
+private slots:
+   void sameImages_data ();
+   void sameImages ();
+   void fullLookupRegeneration ();
+
+   void referenceBenchmark_data ();
+   void referenceBenchmark ();
+   void fullLookupBenchmark_data ();
+   void fullLookupBenchmark ();
+
+private:
+   static void bitDepths ();
+};
+
+//------------------------------------------------------------------------------
+//
+void imageProcessorTest::sameImages_data ()
+{
+   QTest::addColumn<int> ("bitDepth");
+   QTest::addColumn<int> ("rotation");
+   QTest::addColumn<bool> ("flip");
+   QTest::addColumn<QString> ("settings");
+
+   static const QE::RotationOptions rotations [4] = {
+      QE::NoRotation, QE::Rotate90Right, QE::Rotate90Left, QE::Rotate180
+   };
+   static const char* const settings [] = {
+      "log", "false colour", "reversal", "clipping", "full range", "all"
+   };
+
+   const int depths [3] = { 8, 12, 16 };
+   for (int d = 0; d < 3; d++) {
+
+      // All eight scan options.
+      //
+      for (int r = 0; r < 4; r++) {
+         for (int flip = 0; flip < 2; flip++) {
+            const QString name = QString ("%1 bit rotation %2%3")
+                  .arg (depths [d]).arg (int (rotations [r])).arg (flip ? " flip" : "");
+            QTest::newRow (name.toLatin1 ().constData ())
+                  << depths [d] << int (rotations [r]) << bool (flip != 0) << QString ("");
+         }
+      }
+
+      for (int s = 0; s < 6; s++) {
+         const QString name = QString ("%1 bit %2").arg (depths [d]).arg (settings [s]);
+         QTest::newRow (name.toLatin1 ().constData ())
+               << depths [d] << int (QE::NoRotation) << false << QString (settings [s]);
+      }
+   }
+}
+
+//------------------------------------------------------------------------------
+// The image built by the image processor using the full depth lookup table
+// must be identical to the image built using the previous path.
+//
+void imageProcessorTest::sameImages ()
+{
+   QFETCH (int, bitDepth);
+   QFETCH (int, rotation);
+   QFETCH (bool, flip);
+   QFETCH (QString, settings);
+
+   TestProcessor processor (bitDepth);
+   processor.setRotation (QE::RotationOptions (rotation));
+   processor.setFlipHoz (flip);
+
+   const bool all = (settings == "all");
+   processor.displayProperties.setLog (all || settings == "log");
+   processor.displayProperties.setFalseColour (all || settings == "false colour");
+   processor.displayProperties.setContrastReversal (all || settings == "reversal");
+   if (all || settings == "clipping") {
+      processor.setClippingOn (true);
+      processor.setClippingLow (20);
+      processor.setClippingHigh (230);
+   }
+   if (settings == "full range") {
+      processor.setBrightnessContrast (0, (1 << bitDepth) - 1);
+   }
+
+   ImageReceiver receiver;
+   QObject::connect (&processor, SIGNAL (imageBuilt (QImage, QString)),
+                     &receiver, SLOT (onImageBuilt (QImage, QString)));
+
+   processor.buildImage ();
+   QTRY_VERIFY_WITH_TIMEOUT (receiver.received, 20000);
+
+   // The processor's own table is used, not one made here.
+   //
+   QVERIFY (processor.getFullLookupData () != NULL);
+
+   const QImage expected = processor.buildCore (false);
+   const QImage actual = receiver.image;
+
+   QCOMPARE (actual.size (), expected.size ());
+   QVERIFY (actual == expected);
+}
+
+//------------------------------------------------------------------------------
+// The full depth table is kept while the settings are unchanged, and is
+// regenerated when any of the settings it depends on change.
+//
+void imageProcessorTest::fullLookupRegeneration ()
+{
+   TestProcessor processor (12);
+
+   processor.getPixelTranslation ();
+   const rgbPixel* table = processor.getFullLookupData ();
+   QVERIFY (table != NULL);
+
+   processor.getPixelTranslation ();
+   QCOMPARE (processor.getFullLookupData (), table);
+
+   processor.displayProperties.setLog (true);
+   processor.getPixelTranslation ();
+   QVERIFY (processor.getFullLookupData () != table);
+   table = processor.getFullLookupData ();
+
+   processor.displayProperties.setFalseColour (true);
+   processor.getPixelTranslation ();
+   QVERIFY (processor.getFullLookupData () != table);
+   table = processor.getFullLookupData ();
+
+   processor.displayProperties.setContrastReversal (true);
+   processor.getPixelTranslation ();
+   QVERIFY (processor.getFullLookupData () != table);
+   table = processor.getFullLookupData ();
+
+   processor.setClippingOn (true);
+   processor.getPixelTranslation ();
+   QVERIFY (processor.getFullLookupData () != table);
+   table = processor.getFullLookupData ();
+
+   processor.setClippingHigh (200);
+   processor.getPixelTranslation ();
+   QVERIFY (processor.getFullLookupData () != table);
+   table = processor.getFullLookupData ();
+
+   processor.setBrightnessContrast (100, 3000);
+   processor.getPixelTranslation ();
+   QVERIFY (processor.getFullLookupData () != table);
+   table = processor.getFullLookupData ();
+
+   // A 16 bit table, then not used at all for a colour format.
+   //
+   processor.setBitDepth (16);
+   processor.getPixelTranslation ();
+   QVERIFY (processor.getFullLookupData () != table);
+   table = processor.getFullLookupData ();
+
+   processor.setFormat (QE::rgb1);
+   processor.getPixelTranslation ();
+   QVERIFY (processor.getFullLookupData () != table);
+
+   // And again, unchanged.
+   //
+   table = processor.getFullLookupData ();
+   processor.getPixelTranslation ();
+   QCOMPARE (processor.getFullLookupData (), table);
+}
+
+//------------------------------------------------------------------------------
+// static
+void imageProcessorTest::bitDepths ()
+{
+   QTest::addColumn<int> ("bitDepth");
+
+   QTest::newRow ("8 bit")  << 8;
+   QTest::newRow ("12 bit") << 12;
+   QTest::newRow ("16 bit") << 16;
+}
+
+//------------------------------------------------------------------------------
+//
+void imageProcessorTest::referenceBenchmark_data ()
+{
+   imageProcessorTest::bitDepths ();
+}
+
+//------------------------------------------------------------------------------
+//
+void imageProcessorTest::referenceBenchmark ()
+{
+   QFETCH (int, bitDepth);
+
+   TestProcessor processor (bitDepth);
+   processor.getPixelTranslation ();
+   QBENCHMARK {
+      processor.buildCore (false);
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+void imageProcessorTest::fullLookupBenchmark_data ()
+{
+   imageProcessorTest::bitDepths ();
+}
+
+//------------------------------------------------------------------------------
+//
+void imageProcessorTest::fullLookupBenchmark ()
+{
+   QFETCH (int, bitDepth);
+
+   TestProcessor processor (bitDepth);
+   processor.getPixelTranslation ();
+   QBENCHMARK {
+      processor.buildCore (true);
+   }
+}
+
+QTEST_MAIN (imageProcessorTest)
+#include "tst_imageProcessor.moc"
+
+// end
@@ -0,0 +1,232 @@
+/*  tst_macroSubstitution.cpp
+ *
+ *  This file is part of the EPICS QT Framework, initially developed at the
+ *  Australian Synchrotron.
+ *
+ *  SPDX-FileCopyrightText: 2026 Australian Synchrotron
+ *  SPDX-License-Identifier: LGPL-3.0-only
+ *
+ *  Author:     Andrew Starritt
+ *  Maintainer: Andrew Starritt
+ *  Contact:    andrews@ansto.gov.au
+ */
+
+// Compares macroSubstitutionList::substitute, which uses the compiled single
+// pass substitution where it can, with the multiple pass substitution algorithm
+// previously used, for nested, recursive (cyclic), undefined and deeply nested
+// macros, references formed by joining values with the surrounding text, and
+// random substitutions. Also benchmarks both.
+//
+
+#include <QString>
+#include <QtTest>
+#include <macroSubstitution.h>
+
+//==============================================================================
+// The substitution as previously performed by macroSubstitutionList::substitute.
+//
+static QString referenceSubstitute (const macroSubstitutionList& list,
+                                    const QString& string)
+{
+   static const int numberOfPasses = 10;
+
+   QString result = string;
+   const int count = list.getCount ();
+
+   if (result.isEmpty() ||
+       !result.contains('$') ||
+       (count == 0)) return result;
+
+   for (int j = 1; j <= numberOfPasses; j++) {
+      const QString preSubstitutionResult = result;
+      for (int i = 0; i < count; i++) {
+         const QString key = QString ("$(%1)").arg (list.getKey (i));
+         result.replace (key, list.getValue (i));
+      }
+
+      if (result == preSubstitutionResult) break;
+   }
+
+   return result;
+}
+
+//==============================================================================
+// Simple linear congruential generator - repeatable.
+//
+class Random {
+public:
+   explicit Random (const quint32 seedIn) { this->seed = seedIn; }
+   int next (const int n)
+   {
+      this->seed = this->seed * 1103515245 + 12345;
+      return int ((this->seed >> 16) % quint32 (n));
+   }
+private:
+   quint32 seed;
+};
+
+//------------------------------------------------------------------------------
+// Form a random string from fragments that make up (or nearly make up)
+// references to the keys A to E, and to the undefined key Z.
+//
+static QString randomText (Random& random, const int length)
+{
+   static const char* const fragments [] = {
+      "$(A)", "$(B)", "$(C)", "$(D)", "$(E)", "$(Z)",
+      "$(", ")", "$", "(", "A", "B", "x", "yz", ":", " "
+   };
+   static const int numberFragments = sizeof (fragments) / sizeof (fragments [0]);
+
+   QString result;
+   for (int j = 0; j < length; j++) {
+      result.append (fragments [random.next (numberFragments)]);
+   }
+   return result;
+}
+
+
+//==============================================================================
+//
+class macroSubstitutionTest : public QObject
+{
+   Q_OBJECT
+private slots:
+   void sameResults_data ();
+   void sameResults ();
+   void randomSameResults ();
+
+   void referenceBenchmark ();
+   void substituteBenchmark ();
+
+private:
+   static QString deepSubstitutions (const int depth);
+   static QString formName ();
+};
+
+//------------------------------------------------------------------------------
+// static
+QString macroSubstitutionTest::deepSubstitutions (const int depth)
+{
+   // K0='$(K1)', K1='$(K2)' ... Kn='end'
+   //
+   QString result;
+   for (int j = 0; j < depth; j++) {
+      result.append (QString ("K%1='$(K%2)', ").arg (j).arg (j + 1));
+   }
+   result.append (QString ("K%1='end'").arg (depth));
+   return result;
+}
+
+//------------------------------------------------------------------------------
+//
+void macroSubstitutionTest::sameResults_data ()
+{
+   QTest::addColumn<QString> ("substitutions");
+   QTest::addColumn<QString> ("string");
+
+   QTest::newRow ("empty")        << "" << "$(A)";
+   QTest::newRow ("no macros")    << "A=1" << "SR11BCM01:CURRENT";
+   QTest::newRow ("simple")       << "A=1, B=2" << "X$(A):Y$(B):$(A)";
+   QTest::newRow ("undefined")    << "A=1" << "$(A)$(Z):$(Z)";
+   QTest::newRow ("empty value")  << "A=, B=2" << "$(A)$(B)";
+   QTest::newRow ("precedence")   << "A=1, A=2" << "$(A)";
+   QTest::newRow ("nested")       << "A='$(B)', B='$(C)', C=3" << "$(A):$(B):$(C)";
+   QTest::newRow ("nested undefined") << "A='$(B)x', B='$(Z)'" << "$(A)";
+   QTest::newRow ("self recursive")   << "A='$(A)x'" << "[$(A)]";
+   QTest::newRow ("mutual recursive") << "A='$(B)', B='$(A)'" << "$(A):$(B)";
+   QTest::newRow ("recursive, unused")<< "A='$(B)', B='$(A)', C=3" << "$(C)";
+   QTest::newRow ("recursive, nested")<< "A='$(B)', B='$(C)$(A)', C=3, D='$(C)'" << "$(D):$(A)";
+   QTest::newRow ("depth 9")      << deepSubstitutions (9) << "$(K0)";
+   QTest::newRow ("depth 10")     << deepSubstitutions (10) << "$(K0)";
+   QTest::newRow ("depth 11")     << deepSubstitutions (11) << "$(K0):$(K5)";
+   QTest::newRow ("depth 20")     << deepSubstitutions (20) << "$(K0)";
+   QTest::newRow ("joined")       << "A=, B=C, C=3" << "$($(A)B)";
+   QTest::newRow ("joined value") << "A='$(', B='C)', C=3" << "$(A)$(B)";
+   QTest::newRow ("partial")      << "A=1" << "$(A$(A)) $( $(A";
+   QTest::newRow ("key with $")   << "$A=1, A=2" << "$($A)$(A)";
+   QTest::newRow ("typical")      << "SECTOR=11, DEV=BCM01, PV='SR$(SECTOR)$(DEV)'"
+                                  << "$(PV):CURRENT_MONITOR";
+}
+
+//------------------------------------------------------------------------------
+//
+void macroSubstitutionTest::sameResults ()
+{
+   QFETCH (QString, substitutions);
+   QFETCH (QString, string);
+
+   const macroSubstitutionList list (substitutions);
+   QCOMPARE (list.substitute (string), referenceSubstitute (list, string));
+}
+
+//------------------------------------------------------------------------------
+//
+void macroSubstitutionTest::randomSameResults ()
+{
+   static const char* const keys [] = { "A", "B", "C", "D", "E" };
+
+   Random random (12345);
+   for (int trial = 0; trial < 20000; trial++) {
+      QString substitutions;
+      const int n = 1 + random.next (5);
+      for (int j = 0; j < n; j++) {
+         substitutions.append (QString ("%1='%2', ")
+                               .arg (keys [random.next (5)])
+                               .arg (randomText (random, random.next (4))));
+      }
+
+      const macroSubstitutionList list (substitutions);
+      const QString string = randomText (random, 1 + random.next (8));
+
+      const QString actual = list.substitute (string);
+      const QString expected = referenceSubstitute (list, string);
+      if (actual != expected) {
+         qDebug () << "substitutions:" << substitutions << " string:" << string;
+      }
+      QCOMPARE (actual, expected);
+   }
+}
+
+//------------------------------------------------------------------------------
+// static
+QString macroSubstitutionTest::formName ()
+{
+   return "$(P)$(SECTOR):$(DEV)$(INST):$(ATTR)_$(SUFFIX)";
+}
+
+//------------------------------------------------------------------------------
+// The sort of substitutions a form and its parents provide.
+//
+static const char* const typicalSubstitutions =
+      "P=SR, SECTOR=11, DEV=BCM, INST=01, ATTR=CURRENT, SUFFIX=MONITOR, "
+      "AREA='$(P)$(SECTOR)', TITLE='Current $(AREA)', A1=1, A2=2, A3=3, A4=4, "
+      "A5=5, A6=6, A7=7, A8=8, A9=9, A10=10, A11=11, A12=12";
+
+//------------------------------------------------------------------------------
+//
+void macroSubstitutionTest::referenceBenchmark ()
+{
+   const macroSubstitutionList list (typicalSubstitutions);
+   const QString name = macroSubstitutionTest::formName ();
+
+   QBENCHMARK {
+      referenceSubstitute (list, name);
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+void macroSubstitutionTest::substituteBenchmark ()
+{
+   const macroSubstitutionList list (typicalSubstitutions);
+   const QString name = macroSubstitutionTest::formName ();
+
+   QBENCHMARK {
+      list.substitute (name);
+   }
+}
+
+QTEST_MAIN (macroSubstitutionTest)
+#include "tst_macroSubstitution.moc"
+
+// end
@@ -0,0 +1,66 @@
+# test.pri
+#
+# This file is part of the EPICS QT Framework, initially developed at
+# the Australian Synchrotron. This file is included into and as part
+# of each of the test project files.
+#
+# SPDX-FileCopyrightText: 2026 Australian Synchrotron
+# SPDX-License-Identifier: LGPL-3.0-only
+#
+# Author:     Andrew Starritt
+# Maintainer: Andrew Starritt
+# Contact:    andrews@ansto.gov.au
+#
+
+_EPICS_HOST_ARCH = $$(EPICS_HOST_ARCH)
+isEmpty( _EPICS_HOST_ARCH ) {
+    error( "EPICS_HOST_ARCH must be defined. Ensure EPICS is installed and EPICS_HOST_ARCH environment variable is defined." )
+}
+
+TEMPLATE = app
+CONFIG += console testcase qwt
+CONFIG -= app_bundle
+QT += core gui xml network widgets uitools testlib
+
+# Locate the framework library and include files as installed by framework.pro.
+#
+TOP = $$PWD/../../..
+
+_QE_TARGET_DIR = $$(QE_TARGET_DIR)
+isEmpty( _QE_TARGET_DIR ) {
+    INSTALL_DIR = $$TOP
+} else {
+    INSTALL_DIR = $$(QE_TARGET_DIR)
+}
+
+MOC_DIR        = O.$$(EPICS_HOST_ARCH)/moc
+OBJECTS_DIR    = O.$$(EPICS_HOST_ARCH)/obj
+
+INCLUDEPATH += $$INSTALL_DIR/include
+
+# Some framework headers include EPICS, ACAI and QWT headers.
+#
+INCLUDEPATH += $$(EPICS_BASE)/include
+unix:INCLUDEPATH += $$(EPICS_BASE)/include/os/Linux
+unix:INCLUDEPATH += $$(EPICS_BASE)/include/compiler/gcc
+win32:INCLUDEPATH += $$(EPICS_BASE)/include/os/WIN32
+win32:INCLUDEPATH += $$(EPICS_BASE)/include/compiler/msvc
+INCLUDEPATH += $$(ACAI)/include
+INCLUDEPATH += $$(QWT_INCLUDE_PATH)
+
+DEFINES += QWT_DLL=TRUE
+win32:DEFINES += EPICS_CALL_DLL
+
+LIBS += -L$$INSTALL_DIR/lib/$$(EPICS_HOST_ARCH) -lQEFramework
+
+# As per framework.pro - the framework headers must be seen as the library saw
+# them, e.g. the QEPvaClient data members depend on PV Access support.
+#
+_PVACCESS_SUPPORT = $$(QE_PVACCESS_SUPPORT)
+equals(_PVACCESS_SUPPORT, "YES") {
+    DEFINES += QE_PVACCESS_SUPPORT
+    LIBS += -L$$(EPICS_BASE)/lib/$$(EPICS_HOST_ARCH) -lpvData  -lpvAccess -lnt
+}
+unix: QMAKE_LFLAGS += -Wl,-rpath,$$INSTALL_DIR/lib/$$(EPICS_HOST_ARCH)
+
+# end
@@ -0,0 +1,43 @@
+# test.pro
+#
+# This file is part of the EPICS QT Framework, initially developed at
+# the Australian Synchrotron.
+#
+# SPDX-FileCopyrightText: 2026 Australian Synchrotron
+# SPDX-License-Identifier: LGPL-3.0-only
+#
+# Author:     Andrew Starritt
+# Maintainer: Andrew Starritt
+# Contact:    andrews@ansto.gov.au
+#
+# Framework unit tests and benchmarks. These are not part of the regular
+# EPICS build, and link against the installed framework library, so build
+# and install the framework first. Then:
+#
+#    cd qeframeworkSup/project/test
+#    qmake -r test.pro
+#    make
+#    make check
+#
+# Benchmark results are output by each test as it is run. Individual tests
+# may be run directly, e.g. ./imageProcessor/tst_imageProcessor -median 5
+#
+
+TEMPLATE = subdirs
+
+SUBDIRS += QEUiTemplateCache
+SUBDIRS += QEAbstract2DData
+SUBDIRS += QEFloatingArray
+SUBDIRS += QESpectrogram
+SUBDIRS += QEPvaClient
+SUBDIRS += macroSubstitution
+SUBDIRS += QEPvNameSearch
+SUBDIRS += QETableModel
+
+# These tests use framework classes that are not exported from the library,
+# which is only possible where all symbols are visible.
+#
+unix:SUBDIRS += yuvConversion
+unix:SUBDIRS += imageProcessor
+
+# end
@@ -0,0 +1,225 @@
+/*  tst_yuvConversion.cpp
+ *
+ *  This file is part of the EPICS QT Framework, initially developed at the
+ *  Australian Synchrotron.
+ *
+ *  SPDX-FileCopyrightText: 2026 Australian Synchrotron
+ *  SPDX-License-Identifier: LGPL-3.0-only
+ *
+ *  Author:     Andrew Starritt
+ *  Maintainer: Andrew Starritt
+ *  Contact:    andrews@ansto.gov.au
+ */
+
+// Compares the yuvConversion YUVJ 4:2:0 to RGB conversion with the per-pixel
+// conversion previously performed by MpegSource::updateImage, both for identical
+// output (zero tolerance) and for speed, using synthetic frames.
+//
+
+#include <QByteArray>
+#include <QString>
+#include <QtTest>
+#include <colourConversion.h>
+#include <yuvConversion.h>
+
+//==============================================================================
+// A synthetic YUVJ 4:2:0 frame. As per FFmpeg frames, the line sizes include
+// some padding.
+//
+class SyntheticFrame {
+public:
+   explicit SyntheticFrame (const int width, const int height);
+
+   QByteArray plane [3];
+   const unsigned char* planes [3];
+   int lineSizes [3];
+   int width;
+   int height;
+};
+
+//------------------------------------------------------------------------------
+//
+SyntheticFrame::SyntheticFrame (const int widthIn, const int heightIn)
+{
+   this->width = widthIn;
+   this->height = heightIn;
+
+   this->lineSizes [0] = this->width + 32;
+   this->lineSizes [1] = (this->width + 1) / 2 + 16;
+   this->lineSizes [2] = this->lineSizes [1];
+
+   const int rows [3] = { this->height, (this->height + 1) / 2, (this->height + 1) / 2 };
+
+   // Simple linear congruential generator - repeatable and covers all values,
+   // including the values that need clipping.
+   //
+   quint32 seed = 12345;
+   for (int p = 0; p < 3; p++) {
+      this->plane [p].resize (this->lineSizes [p] * rows [p]);
+      unsigned char* data = (unsigned char*) this->plane [p].data ();
+      for (int j = 0; j < this->plane [p].size (); j++) {
+         seed = seed * 1103515245 + 12345;
+         data [j] = (unsigned char) (seed >> 16);
+      }
+      this->planes [p] = (const unsigned char*) this->plane [p].constData ();
+   }
+}
+
+
+//==============================================================================
+// The conversion as previously performed by MpegSource::updateImage.
+//
+static void referenceConversion (const SyntheticFrame& frame, unsigned char* buffPtr)
+{
+   const unsigned char* linePtrY = frame.planes [0];
+   const unsigned char* linePtrU = frame.planes [1];
+   const unsigned char* linePtrV = frame.planes [2];
+
+   for (int i = 0; i < frame.height; i++) {
+      for (int j = 0; j < frame.width; j++) {
+         const int uv = j / 2;
+
+         const unsigned char y = linePtrY [j];
+         const unsigned char u = linePtrU [uv];
+         const unsigned char v = linePtrV [uv];
+
+         *buffPtr++ = YUVJ2R (y, u, v);
+         *buffPtr++ = YUVJ2G (y, u, v);
+         *buffPtr++ = YUVJ2B (y, u, v);
+      }
+
+      linePtrY += frame.lineSizes [0];
+      if (i & 1) {
+         linePtrU += frame.lineSizes [1];
+         linePtrV += frame.lineSizes [2];
+      }
+   }
+}
+
+
+//==============================================================================
+//
+class yuvConversionTest : public QObject
+{
+   Q_OBJECT
+private slots:
+   void sameResults_data ();
+   void sameResults ();
+
+   void referenceBenchmark_data ();
+   void referenceBenchmark ();
+   void conversionBenchmark_data ();
+   void conversionBenchmark ();
+
+private:
+   static void frameSizes ();
+};
+
+//------------------------------------------------------------------------------
+//
+void yuvConversionTest::sameResults_data ()
+{
+   QTest::addColumn<int> ("width");
+   QTest::addColumn<int> ("height");
+
+   QTest::newRow ("1x1")         << 1 << 1;
+   QTest::newRow ("7x5")         << 7 << 5;        // less than one vector, odd
+   QTest::newRow ("33x17")       << 33 << 17;      // vector plus remainder
+   QTest::newRow ("640x480")     << 640 << 480;
+   QTest::newRow ("1923x1081")   << 1923 << 1081;  // parallel, odd sizes
+   QTest::newRow ("131072x8")    << 131072 << 8;   // parallel, fewer than 16 rows
+   QTest::newRow ("1048576x1")   << 1048576 << 1;  // parallel, single row
+}
+
+//------------------------------------------------------------------------------
+// The output must be byte-identical to the previous conversion.
+//
+void yuvConversionTest::sameResults ()
+{
+   QFETCH (int, width);
+   QFETCH (int, height);
+
+   const SyntheticFrame frame (width, height);
+   const int size = 3 * width * height;
+
+   QByteArray expected (size, 0);
+   referenceConversion (frame, (unsigned char*) expected.data ());
+
+   QByteArray actual (size, 0);
+   yuvConversion::yuvj420ToRgb (frame.planes, frame.lineSizes, width, height,
+                                (unsigned char*) actual.data ());
+   QVERIFY (actual == expected);
+
+   // And the scalar row reference.
+   //
+   QByteArray rows (size, 0);
+   for (int row = 0; row < height; row++) {
+      yuvConversion::yuvjRowToRgbReference (frame.planes [0] + frame.lineSizes [0] * row,
+                                            frame.planes [1] + frame.lineSizes [1] * (row / 2),
+                                            frame.planes [2] + frame.lineSizes [2] * (row / 2),
+                                            width, (unsigned char*) rows.data () + 3 * width * row);
+   }
+   QVERIFY (rows == expected);
+}
+
+//------------------------------------------------------------------------------
+// static
+void yuvConversionTest::frameSizes ()
+{
+   QTest::addColumn<int> ("width");
+   QTest::addColumn<int> ("height");
+
+   QTest::newRow ("640x480")     << 640 << 480;
+   QTest::newRow ("1920x1080")   << 1920 << 1080;
+   QTest::newRow ("3840x2160")   << 3840 << 2160;
+}
+
+//------------------------------------------------------------------------------
+//
+void yuvConversionTest::referenceBenchmark_data ()
+{
+   yuvConversionTest::frameSizes ();
+}
+
+//------------------------------------------------------------------------------
+//
+void yuvConversionTest::referenceBenchmark ()
+{
+   QFETCH (int, width);
+   QFETCH (int, height);
+
+   const SyntheticFrame frame (width, height);
+   QByteArray rgb (3 * width * height, 0);
+
+   QBENCHMARK {
+      referenceConversion (frame, (unsigned char*) rgb.data ());
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+void yuvConversionTest::conversionBenchmark_data ()
+{
+   yuvConversionTest::frameSizes ();
+}
+
+//------------------------------------------------------------------------------
+//
+void yuvConversionTest::conversionBenchmark ()
+{
+   QFETCH (int, width);
+   QFETCH (int, height);
+
+   const SyntheticFrame frame (width, height);
+   QByteArray rgb (3 * width * height, 0);
+
+   QBENCHMARK {
+      yuvConversion::yuvj420ToRgb (frame.planes, frame.lineSizes, width, height,
+                                   (unsigned char*) rgb.data ());
+   }
+}
+
+QTEST_MAIN (yuvConversionTest)
+#include "tst_yuvConversion.moc"
+
+// end
@@ -0,0 +1,596 @@
+/*  QETaskPool.cpp
+ *
+ *  This file is part of the EPICS QT Framework, initially developed at the
+ *  Australian Synchrotron.
+ *
+ *  SPDX-FileCopyrightText: 2026 Australian Synchrotron
+ *  SPDX-License-Identifier: LGPL-3.0-only
+ *
+ *  Author:     Andrew Starritt
+ *  Maintainer: Andrew Starritt
+ *  Contact:    andrews@ansto.gov.au
+ */
+
+#include "QETaskPool.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QMutexLocker>
+#include <QStringList>
+#include <QThread>
+#include <QEAdaptationParameters.h>
+#include <QECommon.h>
+
+#define DEBUG qDebug () << "QETaskPool" << __LINE__ << __FUNCTION__ << "  "
+
+static bool taskPoolIsDestroyed = false;
+
+//==============================================================================
+// QETask
+//==============================================================================
+//
+QETask::QETask (const Priorities priorityIn) :
+   QObject (NULL),
+   priority (priorityIn)
+{
+   this->state = Created;
+   this->cancelRequested = false;
+   this->submitTime = 0;
+}
+
+//------------------------------------------------------------------------------
+//
+QETask::~QETask () { }
+
+//------------------------------------------------------------------------------
+//
+QETask::States QETask::getState () const
+{
+   QMutexLocker locker (&this->mutex);
+   return this->state;
+}
+
+//------------------------------------------------------------------------------
+//
+bool QETask::isFinished () const
+{
+   QMutexLocker locker (&this->mutex);
+   return (this->state == Finished) || (this->state == Cancelled);
+}
+
+//------------------------------------------------------------------------------
+//
+void QETask::cancel ()
+{
+   QMutexLocker locker (&this->mutex);
+   this->cancelRequested = true;
+
+   // A task that has not been submitted is cancelled immediately.
+   //
+   if (this->state == Created) {
+      this->state = Cancelled;
+      this->finishedCondition.wakeAll ();
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+bool QETask::isCancelRequested () const
+{
+   QMutexLocker locker (&this->mutex);
+   return this->cancelRequested;
+}
+
+//------------------------------------------------------------------------------
+//
+bool QETask::waitForFinished (const int timeout)
+{
+   // Waiting on a pool thread could deadlock the pool if all the pool threads
+   // wait, so the pool thread helps out until the task is finished.
+   //
+   if (!taskPoolIsDestroyed && QETaskPool::isPoolThread ()) {
+      QETaskPool* pool = QETaskPool::singleton ();
+      return pool->helpUntilFinished (pool->currentWorker (), this, timeout);
+   }
+
+   QElapsedTimer timer;
+   timer.start ();
+
+   QMutexLocker locker (&this->mutex);
+   while ((this->state != Finished) && (this->state != Cancelled)) {
+      if (timeout < 0) {
+         this->finishedCondition.wait (&this->mutex);
+      } else {
+         const qint64 remaining = timeout - timer.elapsed ();
+         if (remaining <= 0) return false;
+         this->finishedCondition.wait (&this->mutex, (unsigned long) remaining);
+      }
+   }
+   return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void QETask::completed ()
+{
+   // place holder
+}
+
+//------------------------------------------------------------------------------
+// Called on the GUI thread.
+//
+void QETask::deliver ()
+{
+   if (this->getState () == Finished) {
+      this->completed ();
+   }
+   emit this->finished ();
+}
+
+
+//==============================================================================
+// QETaskPool::Worker
+//==============================================================================
+//
+class QETaskPool::Worker : public QThread {
+public:
+   explicit Worker (QETaskPool* pool, const int index);
+
+   QETaskPool* const pool;
+   const int index;
+
+   QMutex mutex;                       // protects queues
+   Queues queues;
+
+protected:
+   void run ();
+};
+
+//------------------------------------------------------------------------------
+//
+QETaskPool::Worker::Worker (QETaskPool* poolIn, const int indexIn) :
+   QThread (NULL),
+   pool (poolIn),
+   index (indexIn)
+{
+   this->setObjectName (QString ("QETaskPool %1").arg (indexIn));
+}
+
+//------------------------------------------------------------------------------
+//
+void QETaskPool::Worker::run ()
+{
+   while (true) {
+      QETaskPointer task;
+      if (this->pool->takeTask (this, task)) {
+         this->pool->execute (task);
+         continue;
+      }
+
+      // Nothing to do - wait for a new task. The submitter increments the
+      // pending count before it signals under the mutex, so no wake up is lost.
+      //
+      QMutexLocker locker (&this->pool->mutex);
+      if (this->pool->isStopping) break;
+      if (this->pool->pendingCount.loadAcquire () > 0) continue;
+      this->pool->wakeUp.wait (&this->pool->mutex);
+   }
+}
+
+
+//==============================================================================
+// QETaskPool
+//==============================================================================
+// static
+QETaskPool* QETaskPool::singleton ()
+{
+   // As per QECaClientManager, the singleton object created when first needed.
+   //
+   static QETaskPool instance;
+   return &instance;
+}
+
+//------------------------------------------------------------------------------
+// static
+int QETaskPool::requiredThreadCount ()
+{
+   QEAdaptationParameters ap ("QE_");
+   int result = ap.getInt ("task_pool_threads", 0);   // 0 => use CPU count
+   if (result <= 0) {
+      result = QThread::idealThreadCount ();
+   }
+   return LIMIT (result, 1, QETaskPool::maximumThreads);
+}
+
+//------------------------------------------------------------------------------
+//
+QETaskPool::QETaskPool () : QObject (NULL)
+{
+   this->pendingCount.storeRelease (0);
+   this->isStopping = false;
+   this->deliveryIsPending = false;
+
+   this->submittedCount = 0;
+   this->executedCount = 0;
+   this->cancelledCount = 0;
+   this->localCount = 0;
+   this->stolenCount = 0;
+   this->totalLatency = 0;
+   this->maximumLatency = 0;
+   this->totalRunTime = 0;
+   this->maximumRunTime = 0;
+
+   this->timer.start ();
+
+   // Continuations are delivered on the GUI thread, irrespective of which
+   // thread happened to create the pool.
+   //
+   QCoreApplication* app = QCoreApplication::instance ();
+   if (app) {
+      this->moveToThread (app->thread ());
+      QObject::connect (app,  SIGNAL (aboutToQuit ()),
+                        this, SLOT   (aboutToQuitHandler ()));
+   }
+
+   const int number = QETaskPool::requiredThreadCount ();
+   for (int j = 0; j < number; j++) {
+      this->workers.append (new Worker (this, j));
+   }
+
+   for (int j = 0; j < number; j++) {
+      this->workers.value (j)->start ();
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+QETaskPool::~QETaskPool ()
+{
+   this->shutdown ();
+   taskPoolIsDestroyed = true;
+}
+
+//------------------------------------------------------------------------------
+//
+qint64 QETaskPool::now () const
+{
+   return this->timer.nsecsElapsed ();
+}
+
+//------------------------------------------------------------------------------
+//
+QETaskPool::Worker* QETaskPool::currentWorker () const
+{
+   Worker* worker = dynamic_cast<Worker*> (QThread::currentThread ());
+   if (worker && worker->pool == this) return worker;
+   return NULL;
+}
+
+//------------------------------------------------------------------------------
+// static
+bool QETaskPool::submit (const QETaskPointer& task)
+{
+   if (taskPoolIsDestroyed) return false;
+   if (task.isNull ()) return false;
+
+   QETaskPool* self = QETaskPool::singleton ();
+
+   {
+      QMutexLocker taskLocker (&task->mutex);
+      if (task->state != QETask::Created) return false;
+      task->state = QETask::Pending;
+      task->submitTime = self->now ();
+   }
+
+   const int p = task->priority;
+   Worker* worker = self->currentWorker ();
+
+   if (worker) {
+      // Sub-task - add to own queue.
+      //
+      QMutexLocker workerLocker (&worker->mutex);
+      worker->queues.queue [p].append (task);
+   }
+
+   QMutexLocker locker (&self->mutex);
+
+   if (!worker) {
+      if (self->isStopping) {
+         QMutexLocker taskLocker (&task->mutex);
+         task->state = QETask::Cancelled;
+         task->finishedCondition.wakeAll ();
+         return false;
+      }
+      self->shared.queue [p].append (task);
+   }
+
+   self->pendingCount.ref ();
+   self->submittedCount++;
+   self->wakeUp.wakeOne ();
+   return true;
+}
+
+//------------------------------------------------------------------------------
+// static
+int QETaskPool::threadCount ()
+{
+   if (taskPoolIsDestroyed) return 0;
+   return QETaskPool::singleton ()->workers.count ();
+}
+
+//------------------------------------------------------------------------------
+// static
+bool QETaskPool::isPoolThread ()
+{
+   if (taskPoolIsDestroyed) return false;
+   return QETaskPool::singleton ()->currentWorker () != NULL;
+}
+
+//------------------------------------------------------------------------------
+// Takes the highest priority task available, from (in order) own queue (newest
+// first), the shared queue and the other workers' queues (oldest first).
+// The self parameter is NULL when called from a non-pool thread.
+//
+bool QETaskPool::takeTask (Worker* self, QETaskPointer& task)
+{
+   if (this->pendingCount.loadAcquire () <= 0) return false;
+
+   const int number = this->workers.count ();
+   const int first = self ? self->index + 1 : 0;
+
+   for (int p = QETask::NumberOfPriorities - 1; p >= 0; p--) {
+      if (self) {
+         QMutexLocker locker (&self->mutex);
+         TaskQueue& queue = self->queues.queue [p];
+         if (!queue.isEmpty ()) {
+            task = queue.takeLast ();
+            this->pendingCount.deref ();
+            locker.unlock ();
+
+            QMutexLocker poolLocker (&this->mutex);
+            this->localCount++;
+            return true;
+         }
+      }
+
+      {
+         QMutexLocker locker (&this->mutex);
+         TaskQueue& queue = this->shared.queue [p];
+         if (!queue.isEmpty ()) {
+            task = queue.takeFirst ();
+            this->pendingCount.deref ();
+            return true;
+         }
+      }
+
+      for (int k = 0; k < number; k++) {
+         Worker* other = this->workers.value ((first + k) % number);
+         if (other == self) continue;
+
+         QMutexLocker locker (&other->mutex);
+         TaskQueue& queue = other->queues.queue [p];
+         if (!queue.isEmpty ()) {
+            task = queue.takeFirst ();
+            this->pendingCount.deref ();
+            locker.unlock ();
+
+            QMutexLocker poolLocker (&this->mutex);
+            this->stolenCount++;
+            return true;
+         }
+      }
+   }
+
+   return false;
+}
+
+//------------------------------------------------------------------------------
+//
+void QETaskPool::execute (const QETaskPointer& task)
+{
+   bool isCancelled;
+   {
+      QMutexLocker taskLocker (&task->mutex);
+      isCancelled = task->cancelRequested;
+      task->state = isCancelled ? QETask::Cancelled : QETask::Running;
+   }
+
+   const qint64 startTime = this->now ();
+   const qint64 latency = startTime - task->submitTime;
+
+   if (!isCancelled) {
+      task->run ();
+   }
+
+   const qint64 runTime = this->now () - startTime;
+
+   {
+      QMutexLocker taskLocker (&task->mutex);
+      if (!isCancelled) task->state = QETask::Finished;
+      task->finishedCondition.wakeAll ();
+   }
+
+   QMutexLocker locker (&this->mutex);
+
+   if (isCancelled) {
+      this->cancelledCount++;
+   } else {
+      this->executedCount++;
+      this->totalLatency += latency;
+      this->maximumLatency = MAX (this->maximumLatency, latency);
+      this->totalRunTime += runTime;
+      this->maximumRunTime = MAX (this->maximumRunTime, runTime);
+   }
+
+   // Schedule delivery on the GUI thread. One queued call suffices for any
+   // number of completed tasks.
+   //
+   this->completedList.append (task);
+   if (!this->deliveryIsPending && !this->isStopping) {
+      this->deliveryIsPending = true;
+      QMetaObject::invokeMethod (this, "deliverCompleted", Qt::QueuedConnection);
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+bool QETaskPool::helpUntilFinished (Worker* self, QETask* task, const int timeout)
+{
+   QElapsedTimer timer;
+   timer.start ();
+
+   while (!task->isFinished ()) {
+      if ((timeout >= 0) && (timer.elapsed () >= timeout)) return false;
+
+      QETaskPointer other;
+      if (this->takeTask (self, other)) {
+         this->execute (other);
+      } else {
+         // The task is running on another thread - wait a little while.
+         //
+         QMutexLocker taskLocker (&task->mutex);
+         if ((task->state != QETask::Finished) && (task->state != QETask::Cancelled)) {
+            task->finishedCondition.wait (&task->mutex, 1);
+         }
+      }
+   }
+   return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void QETaskPool::shutdown ()
+{
+   {
+      QMutexLocker locker (&this->mutex);
+      if (this->isStopping) return;
+      this->isStopping = true;
+      this->wakeUp.wakeAll ();
+   }
+
+   for (int j = 0; j < this->workers.count (); j++) {
+      Worker* worker = this->workers.value (j);
+      worker->wait ();
+   }
+
+   // Cancel all the tasks still pending.
+   //
+   TaskQueue pending;
+   for (int p = 0; p < QETask::NumberOfPriorities; p++) {
+      pending += this->shared.queue [p];
+      this->shared.queue [p].clear ();
+      for (int j = 0; j < this->workers.count (); j++) {
+         Worker* worker = this->workers.value (j);
+         pending += worker->queues.queue [p];
+         worker->queues.queue [p].clear ();
+      }
+   }
+
+   for (int j = 0; j < pending.count (); j++) {
+      QETask* task = pending.value (j).data ();
+      QMutexLocker taskLocker (&task->mutex);
+      task->state = QETask::Cancelled;
+      task->finishedCondition.wakeAll ();
+   }
+   this->cancelledCount += pending.count ();
+   this->pendingCount.storeRelease (0);
+
+   for (int j = 0; j < this->workers.count (); j++) {
+      delete this->workers.value (j);
+   }
+   this->workers.clear ();
+
+   // Deliver all outstanding completions, including the cancelled tasks, as
+   // no queued deliverCompleted call will now be processed. This is only
+   // possible on the GUI thread while the application still exists, i.e. from
+   // the aboutToQuit handler, and not during static destruction.
+   //
+   this->completedList += pending;
+   if (QCoreApplication::instance () && (QThread::currentThread () == this->thread ())) {
+      this->deliverCompleted ();
+   }
+   this->completedList.clear ();
+}
+
+//------------------------------------------------------------------------------
+// static
+QString QETaskPool::statistics ()
+{
+   if (taskPoolIsDestroyed) return "";
+
+   QETaskPool* self = QETaskPool::singleton ();
+
+   // Queue lengths - high, normal, low.
+   //
+   #define QUEUE_IMAGE(q) QString ("%1/%2/%3")                          \
+      .arg ((q).queue [QETask::High].count ())                          \
+      .arg ((q).queue [QETask::Normal].count ())                        \
+      .arg ((q).queue [QETask::Low].count ())
+
+   QString result;
+   result.append (QString ("threads:        %1\n").arg (self->workers.count ()));
+
+   for (int j = 0; j < self->workers.count (); j++) {
+      Worker* worker = self->workers.value (j);
+      QMutexLocker workerLocker (&worker->mutex);
+      result.append (QString ("queue %1:").arg (j).leftJustified (16));
+      result.append (QString ("%1 (high/normal/low)\n").arg (QUEUE_IMAGE (worker->queues)));
+   }
+
+   QMutexLocker locker (&self->mutex);
+
+   const double executed = MAX (self->executedCount, quint64 (1));
+
+   result.append (QString ("shared queue:   %1 (high/normal/low)\n").arg (QUEUE_IMAGE (self->shared)));
+   result.append (QString ("submitted:      %1\n").arg (self->submittedCount));
+   result.append (QString ("executed:       %1\n").arg (self->executedCount));
+   result.append (QString ("cancelled:      %1\n").arg (self->cancelledCount));
+   result.append (QString ("own queue:      %1\n").arg (self->localCount));
+   result.append (QString ("stolen:         %1\n").arg (self->stolenCount));
+   result.append (QString ("latency:        mean %1 mS, max %2 mS\n")
+                  .arg (double (self->totalLatency) / executed / 1.0e6, 0, 'f', 3)
+                  .arg (double (self->maximumLatency) / 1.0e6, 0, 'f', 3));
+   result.append (QString ("run time:       mean %1 mS, max %2 mS\n")
+                  .arg (double (self->totalRunTime) / executed / 1.0e6, 0, 'f', 3)
+                  .arg (double (self->maximumRunTime) / 1.0e6, 0, 'f', 3));
+
+   #undef QUEUE_IMAGE
+
+   return result;
+}
+
+//------------------------------------------------------------------------------
+// static
+void QETaskPool::dump ()
+{
+   const QStringList lines = QETaskPool::statistics ().split ("\n");
+   for (int j = 0; j < lines.count(); j++) {
+      if (lines.value (j).isEmpty ()) continue;
+      DEBUG << lines.value (j).toStdString().c_str();   // drop quotes
+   }
+}
+
+//------------------------------------------------------------------------------
+// slot
+void QETaskPool::deliverCompleted ()
+{
+   TaskQueue list;
+   {
+      QMutexLocker locker (&this->mutex);
+      list = this->completedList;
+      this->completedList.clear ();
+      this->deliveryIsPending = false;
+   }
+
+   for (int j = 0; j < list.count (); j++) {
+      list.value (j)->deliver ();
+   }
+}
+
+//------------------------------------------------------------------------------
+// slot
+void QETaskPool::aboutToQuitHandler ()
+{
+   this->shutdown ();
+}
+
+// end
@@ -0,0 +1,204 @@
+/*  QETaskPool.h
+ *
+ *  This file is part of the EPICS QT Framework, initially developed at the
+ *  Australian Synchrotron.
+ *
+ *  SPDX-FileCopyrightText: 2026 Australian Synchrotron
+ *  SPDX-License-Identifier: LGPL-3.0-only
+ *
+ *  Author:     Andrew Starritt
+ *  Maintainer: Andrew Starritt
+ *  Contact:    andrews@ansto.gov.au
+ */
+
+#ifndef QE_TASK_POOL_H
+#define QE_TASK_POOL_H
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+#include <QWaitCondition>
+#include <QEFrameworkLibraryGlobal.h>
+
+/// QETask is the base class for work items to be executed by the QETaskPool.
+/// Derived classes implement the run function, which is called on one of the
+/// pool threads, and may implement the completed function, which is called on
+/// the main GUI thread after run has finished, i.e. a continuation. The finished
+/// signal is emitted (also on the GUI thread) after completed has been called,
+/// or when a cancelled task is discarded. This includes tasks cancelled by the
+/// pool shut down, which are delivered within the aboutToQuit signal handling.
+/// However if the pool is instead shut down during static destruction, i.e.
+/// there is no aboutToQuit signal, no further finished signals are emitted.
+///
+/// A task is submitted to the pool at most once. The pool holds a reference to
+/// the task until the finished signal has been emitted, so a submitter that is
+/// not interested in the outcome need not hold a reference.
+///
+/// QETask objects must be created without a parent.
+///
+class QE_FRAMEWORK_LIBRARY_SHARED_EXPORT QETask : public QObject {
+   Q_OBJECT
+public:
+   enum Priorities { Low, Normal, High };
+   static const int NumberOfPriorities = 3;
+
+   enum States {
+      Created,          // not yet submitted
+      Pending,          // submitted, waiting for a pool thread
+      Running,          // run function executing
+      Finished,         // run function has returned
+      Cancelled         // cancelled before run was called
+   };
+
+   explicit QETask (const Priorities priority = Normal);
+   virtual ~QETask ();
+
+   Priorities getPriority () const { return this->priority; }
+
+   // These functions are thread safe.
+   //
+   States getState () const;
+
+   // True once Finished or Cancelled.
+   //
+   bool isFinished () const;
+
+   // Requests cancellation. A pending task will not be run, and a running
+   // task's run function may poll isCancelRequested and return early.
+   //
+   void cancel ();
+   bool isCancelRequested () const;
+
+   // Waits until the task is Finished or Cancelled. Note: this does not wait
+   // for the completed function or the finished signal. When called on a pool
+   // thread, the pool thread executes other tasks while waiting.
+   // Returns false if timed out. A negative timeout means wait indefinitely.
+   //
+   bool waitForFinished (const int timeout = -1);
+
+signals:
+   void finished ();
+
+protected:
+   // Called on a pool thread.
+   //
+   virtual void run () = 0;
+
+   // Called on the GUI thread, only if the run function was called.
+   //
+   virtual void completed ();
+
+private:
+   void deliver ();
+
+   const Priorities priority;
+   mutable QMutex mutex;
+   QWaitCondition finishedCondition;
+   States state;
+   bool cancelRequested;
+   qint64 submitTime;                  // nSec, pool time
+
+   friend class QETaskPool;
+};
+
+typedef QSharedPointer<QETask> QETaskPointer;
+
+
+/// The QETaskPool is a framework-wide pool of threads for executing QETask
+/// objects. The number of threads is determined by the number of CPUs, and
+/// may be overridden by the QE_TASK_POOL_THREADS environment variable, or
+/// equivalent adaptation parameter.
+///
+/// Each pool thread has its own task queues. Tasks submitted from a pool thread,
+/// i.e. sub-tasks, are added to that thread's own queues and processed last in,
+/// first out. Tasks submitted from any other thread are added to the shared
+/// queues and processed first in, first out. An idle pool thread takes tasks
+/// from its own queues, then the shared queues, and then steals from the other
+/// pool threads' queues (oldest first). Higher priority tasks are always taken
+/// before lower priority tasks.
+///
+/// The pool is created when first needed, and is shut down when the application
+/// is about to quit. Any tasks still pending at that time are cancelled, and
+/// all outstanding completions are delivered prior to the shut down returning.
+///
+class QE_FRAMEWORK_LIBRARY_SHARED_EXPORT QETaskPool : private QObject {
+   Q_OBJECT
+public:
+   // Submits the task for execution. Returns false if the task is null, has
+   // already been submitted, or the pool has been shut down. May be called
+   // from any thread.
+   //
+   static bool submit (const QETaskPointer& task);
+
+   // Number of pool threads.
+   //
+   static int threadCount ();
+
+   // Indicates if the calling thread is a pool thread.
+   //
+   static bool isPoolThread ();
+
+   // Diagnostics - queue lengths, task counts and task latency/run times.
+   //
+   static QString statistics ();
+   static void dump ();          // diagnostic debug output only.
+
+private:
+   explicit QETaskPool ();
+   ~QETaskPool ();
+
+   static QETaskPool* singleton ();
+   static int requiredThreadCount ();
+
+   static const int maximumThreads = 64;
+
+   typedef QList<QETaskPointer> TaskQueue;
+   struct Queues {
+      TaskQueue queue [QETask::NumberOfPriorities];
+   };
+
+   class Worker;                       // defined in the cpp file
+   friend class Worker;
+   friend class QETask;
+
+   Worker* currentWorker () const;
+   qint64 now () const;
+   bool takeTask (Worker* self, QETaskPointer& task);
+   void execute (const QETaskPointer& task);
+   bool helpUntilFinished (Worker* self, QETask* task, const int timeout);
+   void shutdown ();
+
+   QVector<Worker*> workers;
+   QElapsedTimer timer;
+   QAtomicInt pendingCount;            // total number of queued tasks
+
+   QMutex mutex;                       // protects all of the following
+   QWaitCondition wakeUp;
+   bool isStopping;
+   Queues shared;
+   TaskQueue completedList;            // awaiting delivery on GUI thread
+   bool deliveryIsPending;
+
+   // Statistics
+   //
+   quint64 submittedCount;
+   quint64 executedCount;
+   quint64 cancelledCount;
+   quint64 localCount;                 // taken from own queues
+   quint64 stolenCount;                // taken from other threads' queues
+   qint64 totalLatency;                // nSec, submit to start
+   qint64 maximumLatency;
+   qint64 totalRunTime;                // nSec
+   qint64 maximumRunTime;
+
+private slots:
+   void deliverCompleted ();
+   void aboutToQuitHandler ();
+};
+
+#endif // QE_TASK_POOL_H
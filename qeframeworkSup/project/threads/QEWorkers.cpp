@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2013-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2013-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Starritt
@@ -12,13 +12,16 @@
  */
 
 #include <QDebug>
+#include <QList>
 #include <QThread>
 
 #include <QEWorkers.h>
+#include <QECommon.h>
+#include <QETaskPool.h>
 
 
 #define DEBUG  qDebug () << "QE Worker::" << __FUNCTION__  << ":" << __LINE__
-#define CTID  ( 1000 + QThread::currentThreadId () % 1000 )
+#define CTID  ( 1000 + quintptr (QThread::currentThreadId ()) % 1000 )
 
 namespace QE {
 
@@ -28,6 +31,7 @@ Worker::Worker () : QObject (NULL)
 {
    this->instance = 0;
    this->number = 0;
+   this->isInitialised = false;
 }
 
 //------------------------------------------------------------------------------
@@ -48,67 +52,41 @@ void Worker::process (QObject* workPackage, const Counts i, const Counts n)
 }
 
 
-//------------------------------------------------------------------------------
-// slot
-void Worker::started ()
-{
-   this->initialise (this->instance, this->number);
-}
-
-//------------------------------------------------------------------------------
-// slot
-void Worker::startProcessing (const QE::SequenceNumbers sequenceNumberIn,
-                              QObject* workPackage)
-{
-   this->sequenceNumber = sequenceNumberIn;
-   this->process (workPackage, this->instance, this->number);
-   emit this->processingComplete (this->sequenceNumber, this->instance);
-}
-
-
 //==============================================================================
+// Performs one worker's part of the work package on a pool thread.
 //
-class WorkerThread : public QThread {
+class WorkerTask : public QETask {
 public:
-   WorkerThread (Worker *worker,
-                 Counts intance,
-                 Counts number,
-                 QObject* parent = 0);
+   explicit WorkerTask (Worker* worker, QObject* workPackage);
 
 protected:
    void run ();
 
 private:
-   Worker *worker;
-
-   friend class WorkerManager;
+   Worker* worker;
+   QObject* workPackage;
 };
 
 //------------------------------------------------------------------------------
 //
-WorkerThread::WorkerThread (Worker *workerIn,
-                            Counts intanceIn,
-                            Counts numberIn,
-                            QObject* parent) : QThread (parent)
+WorkerTask::WorkerTask (Worker* workerIn, QObject* workPackageIn) : QETask (Normal)
 {
    this->worker = workerIn;
-
-
-   this->worker->instance = intanceIn;
-   this->worker->number = numberIn;
-
-   // Ensure the worker is an orphan prior to rehoming it's thread.
-   //
-   this->worker->setParent (NULL);
-   this->worker->moveToThread (this);
+   this->workPackage = workPackageIn;
 }
 
-
 //------------------------------------------------------------------------------
 //
-void WorkerThread::run ()
+void WorkerTask::run ()
 {
-   this->exec();
+   // Work packages are processed one at a time, so no two tasks for the same
+   // worker object are ever running concurrently.
+   //
+   if (!this->worker->isInitialised) {
+      this->worker->initialise (this->worker->instance, this->worker->number);
+      this->worker->isInitialised = true;
+   }
+   this->worker->process (this->workPackage, this->worker->instance, this->worker->number);
 }
 
 
@@ -116,8 +94,11 @@ void WorkerThread::run ()
 //
 class WorkerManager::ReallyPrivate {
 public:
-   WorkerThread* threadList [MAXIMUM_THREADS];
-   bool workerComplete [MAXIMUM_THREADS];
+   WorkerList workForce;
+   QList<QObject*> packageQueue;       // waiting to be processed
+   QList<QETaskPointer> taskList;      // tasks for the current work package
+   int outstanding;                    // number of incomplete tasks
+   bool isBusy;
 };
 
 
@@ -132,32 +113,21 @@ WorkerManager::WorkerManager (const WorkerList& workForce, QObject *parent) : QO
    qRegisterMetaType<QE::Counts> ("QE::Counts");
    qRegisterMetaType<QE::SequenceNumbers> ("QE::SequenceNumbers");
 
-
    this->pd = new ReallyPrivate ();
+   this->pd->outstanding = 0;
+   this->pd->isBusy = false;
 
-   this->number =  workForce.count ();
-   if (this->number > MAXIMUM_THREADS) {
-      this->number = MAXIMUM_THREADS;
-   }
-
-   for (j = 0; j < this->number; j++) {
-      Worker* worker = workForce.value (j);
-      WorkerThread* thread = new WorkerThread (worker, j, this->number, parent);
-
-      this->pd->threadList [j] = thread;
-
-      QObject::connect (thread, SIGNAL (started ()), worker, SLOT (started ()));
-
-      QObject::connect (this,   SIGNAL (startProcessing (const QE::SequenceNumbers, QObject*)),
-                        worker, SLOT   (startProcessing (const QE::SequenceNumbers, QObject*)));
+   this->sequenceNumber = 0;
+   this->workPackage = NULL;
 
-      QObject::connect (worker, SIGNAL (processingComplete (const QE::SequenceNumbers, QE::Counts)),
-                        this,   SLOT   (processingComplete (const QE::SequenceNumbers, QE::Counts)));
-   }
+   this->number = MIN (workForce.count (), MAXIMUM_THREADS);
 
    for (j = 0; j < this->number; j++) {
-      WorkerThread* thread = this->pd->threadList [j];
-      thread->start ();
+      Worker* worker = workForce.value (j);
+      worker->instance = j;
+      worker->number = this->number;
+      worker->isInitialised = false;
+      this->pd->workForce.append (worker);
    }
 }
 
@@ -165,63 +135,84 @@ WorkerManager::WorkerManager (const WorkerList& workForce, QObject *parent) : QO
 //
 WorkerManager::~WorkerManager ()
 {
-   // place holder
+   // Do not leave any tasks referencing the work force.
+   //
+   for (int j = 0; j < this->pd->taskList.count (); j++) {
+      QETaskPointer task = this->pd->taskList.value (j);
+      task->cancel ();
+      task->waitForFinished ();
+   }
+   delete this->pd;
 }
 
 //------------------------------------------------------------------------------
 //
 void WorkerManager::process (QObject* workPackageIn)
 {
-   Counts j;
+   this->pd->packageQueue.append (workPackageIn);
+   if (!this->pd->isBusy) {
+      this->startNext ();
+   }
+}
 
-   this->workPackage = workPackageIn;
+//------------------------------------------------------------------------------
+//
+void WorkerManager::startNext ()
+{
+   if (this->pd->packageQueue.isEmpty ()) return;
+   if (this->number == 0) return;
 
+   this->pd->taskList.clear ();
+   this->workPackage = this->pd->packageQueue.takeFirst ();
    this->sequenceNumber++;
-   for (j = 0; j < this->number; j++) {
-      this->pd->workerComplete [j] = false;
+   this->pd->isBusy = true;
+   this->pd->outstanding = this->number;
+
+   for (int j = 0; j < this->number; j++) {
+      QETaskPointer task (new WorkerTask (this->pd->workForce.value (j), this->workPackage));
+      QObject::connect (task.data (), SIGNAL (finished ()),
+                        this,         SLOT   (processingComplete ()));
+      this->pd->taskList.append (task);
+   }
+
+   int rejected = 0;
+   for (int j = 0; j < this->pd->taskList.count (); j++) {
+      if (!QETaskPool::submit (this->pd->taskList.value (j))) rejected++;
    }
 
-   emit this->startProcessing (this->sequenceNumber, this->workPackage);
+   // A task the pool does not accept, e.g. when the pool is shutting down, is
+   // never run and never signals finished, so account for it here, otherwise
+   // this manager would remain busy forever.
+   //
+   for (int j = 0; j < rejected; j++) {
+      this->processingComplete ();
+   }
 }
 
 //------------------------------------------------------------------------------
 // slot
-void WorkerManager::processingComplete (const QE::SequenceNumbers workerSequenceNumber,
-                                        const QE::Counts instance)
+void WorkerManager::processingComplete ()
 {
-   if (workerSequenceNumber == this->sequenceNumber) {
-      this->pd->workerComplete[instance] = true;
-      // All done??
-      //
-      if (this->isComplete ()) {
-         emit this->complete (this->workPackage);
-      }
-   } else {
-      DEBUG << "sequenceNumber mismatch, "
-            << "instance"   << instance
-            << "returned"   << workerSequenceNumber
-            << ", expected" <<this->sequenceNumber;
-      // otherwise ignore for now.
+   if (!this->pd->isBusy) {
+      DEBUG << "unexpected completion, sequenceNumber" << this->sequenceNumber;
+      return;
    }
 
-}
+   this->pd->outstanding--;
 
-//------------------------------------------------------------------------------
-//
-bool WorkerManager::isComplete ()
-{
-   bool result;
-   Counts j;
+   // All done??
+   //
+   if (this->pd->outstanding <= 0) {
+      this->pd->isBusy = false;
+      this->pd->taskList.clear ();
+      emit this->complete (this->workPackage);
 
-   result = true;               //hypothesize okay.
-   for (j = 0; j < this->number; j++) {
-      if (!this->pd->workerComplete [j]) {
-         result = false;
-         break;
+      // The complete signal receiver may well have called process.
+      //
+      if (!this->pd->isBusy) {
+         this->startNext ();
       }
    }
-
-   return result;
 }
 
 }  // end QE
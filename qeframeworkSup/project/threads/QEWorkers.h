@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2013-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2013-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Starritt
@@ -21,13 +21,18 @@
 #include <QThread>
 
 /*!
- * Proof of concept class - NOT currently in use.
- *
  * When manager's process function called, each worker class object process
  * function is called (in a separate thread).
+ *
+ * This is now a thin facade over the QETaskPool, i.e. each part of the work is
+ * submitted as a QETask, and the number of workers is no longer limited by the
+ * number of threads. Work packages are processed one at a time, in the order
+ * in which process is called.
  */
 
-#define MAXIMUM_THREADS   16
+// Maximum work force size - as limited by the Counts type.
+//
+#define MAXIMUM_THREADS   255
 
 namespace QE {
 
@@ -43,8 +48,11 @@ public:
 
 private:
    // Derived classes may override this function.
-   // This is executed once in the context of the associated thread
-   // when the thread is started.
+   // This is executed once, just before the first call to process, and in the
+   // context of the same pool thread as that first call. Note: there are no
+   // longer dedicated threads, so subsequent process calls may well be in the
+   // context of other pool threads. Any thread affine set up, e.g. thread local
+   // storage, must be performed within process itself.
    //
    virtual void initialise (const Counts i, const Counts n);
 
@@ -53,7 +61,9 @@ private:
    // The nominal workPackage is represented as a QObject and is the same object
    // as passed to the manager process function.
    //
-   // Each call to process is in the context of a separate thread.
+   // Each call to process is in the context of one of the QETaskPool threads.
+   // The parts of a work package may be processed concurrently on different
+   // threads, but no two calls for the same worker object are ever concurrent.
    //
    // It is the responsibilty of the derived class's process function to ensure:
    // a/ that it performs the rquired part and only the required part of
@@ -67,21 +77,13 @@ private:
    Counts getInstance () { return instance; }
    Counts getNumber   () { return number; }
 
-private slots:
-   void started ();
-
-   void startProcessing (const QE::SequenceNumbers sequenceNumber,
-                         QObject* workPackage);
-
-signals:
-   void processingComplete (const QE::SequenceNumbers sequenceNumber,
-                            const QE::Counts instance);
 private:
    Counts instance;
    Counts number;
-   SequenceNumbers sequenceNumber;
+   bool isInitialised;
 
-   friend class WorkerThread;
+   friend class WorkerManager;
+   friend class WorkerTask;
 };
 
 
@@ -97,7 +99,7 @@ typedef QList <Worker*> WorkerList;
 class WorkerManager : public QObject {
    Q_OBJECT
 public:
-   // The workForce should be between 1 and MAXIMUM_THREADS (16) workers.
+   // The workForce should be between 1 and MAXIMUM_THREADS (255) workers.
    // Additional worker objects are ignored.
    // Note: the worker objects are created independently of the manager.
    // Also they must be disposed of independently of the manager.
@@ -106,6 +108,9 @@ public:
                            QObject* parent = 0);
    virtual ~WorkerManager ();
 
+   // If a work package is currently being processed, the work package is
+   // queued and processed once the current work package is complete.
+   //
    void process (QObject* workPackage);
 
    Counts getNumber () { return number; }
@@ -120,28 +125,19 @@ private:
    SequenceNumbers sequenceNumber;     // task identifier
    QObject* workPackage;
 
-   bool isComplete ();
+   void startNext ();
 
-   // Internally we declare a number of WorkerThread pointer items.
+   // Internally we hold the work force and the current tasks.
    // Declareing these in the header of a QObject seems to make the Qt SDK
    // get very upset and confused, so need to hide this a little.
    //
    class ReallyPrivate;
    ReallyPrivate* pd;
 
-signals:
-   // Sent to the work force objects.
-   //
-   void startProcessing (const QE::SequenceNumbers sequenceNumber,
-                         QObject* workPackage);
-
 private slots:
-   // From the work force.
+   // From the work force tasks, on the GUI thread.
    //
-   void processingComplete (const QE::SequenceNumbers sequenceNumber,
-                            const QE::Counts instance);
-
-   friend class WorkerThread;
+   void processingComplete ();
 };
 
 }
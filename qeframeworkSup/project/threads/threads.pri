@@ -4,7 +4,7 @@
 # the Australian Synchrotron. This file is included into and as part
 # of the overall framework.pro project file.
 #
-# SPDX-FileCopyrightText: 2017-2025 Australian Synchrotron
+# SPDX-FileCopyrightText: 2017-2026 Australian Synchrotron
 # SPDX-License-Identifier: LGPL-3.0-only
 #
 # Author:     Andrew Starritt
@@ -14,8 +14,10 @@
 
 INCLUDEPATH +=  threads
 
+HEADERS +=  threads/QETaskPool.h
 HEADERS +=  threads/QEWorkers.h
 
+SOURCES +=  threads/QETaskPool.cpp
 SOURCES +=  threads/QEWorkers.cpp
 
 # end
@@ -18,6 +18,7 @@
 #include <QECommon.h>
 #include <UserMessage.h>
 #include <QEStripChartRangeDialog.h>
+#include <QETaskPool.h>
 
 #define DEBUG qDebug () << "QEAbstract2DData" << __LINE__ << __FUNCTION__ << "  "
 
@@ -31,6 +32,56 @@ static const double noValue = -281474976710656.0;
 
 static const double minSpan = 1.0e-3;   /// duplicate
 
+// Binning calculations involving fewer source values than this are done on
+// the calling thread.
+//
+static const qint64 binningParallelThreshold = 256 * 1024;
+
+//==============================================================================
+// Bins a stripe of rows on a pool thread.
+//
+class QEAbstract2DDataBinningTask : public QETask {
+public:
+   explicit QEAbstract2DDataBinningTask (const QEAbstract2DData* owner,
+                                         const QEAbstract2DData::SourceRows* sourceRows,
+                                         double* const* outputs,
+                                         const int firstRow, const int lastRow);
+protected:
+   void run ();
+
+private:
+   const QEAbstract2DData* owner;
+   const QEAbstract2DData::SourceRows* sourceRows;
+   double* const* outputs;
+   const int firstRow;
+   const int lastRow;
+};
+
+//------------------------------------------------------------------------------
+//
+QEAbstract2DDataBinningTask::QEAbstract2DDataBinningTask (const QEAbstract2DData* ownerIn,
+                                                          const QEAbstract2DData::SourceRows* sourceRowsIn,
+                                                          double* const* outputsIn,
+                                                          const int firstRowIn,
+                                                          const int lastRowIn) :
+   QETask (QETask::High),
+   owner (ownerIn),
+   sourceRows (sourceRowsIn),
+   outputs (outputsIn),
+   firstRow (firstRowIn),
+   lastRow (lastRowIn)
+{
+}
+
+//------------------------------------------------------------------------------
+//
+void QEAbstract2DDataBinningTask::run ()
+{
+   this->owner->binRows (*this->sourceRows, this->outputs,
+                         this->firstRow, this->lastRow);
+}
+
+
 
 //------------------------------------------------------------------------=-----
 // Constructor with no initialisation
@@ -98,8 +149,14 @@ void QEAbstract2DData::commonSetup ()
    this->sliceColOffset = 0;
    this->slicedNumberOfRows = 0;
    this->slicedNumberOfCols = 0;
+   this->binnedNumberOfRows = 0;
+   this->binnedNumberOfCols = 0;
    this->displayedNumberOfRows = 0;
    this->displayedNumberOfCols = 0;
+   this->binnedRowOrigin = 0;
+   this->isScrollUpdate = false;
+   this->scrollRowShift = 0;
+   this->scrollChangedRow = -1;
 
    // Set default porpety values.
    //
@@ -229,34 +286,62 @@ int QEAbstract2DData::getEffectiveDataWidth () const
 }
 
 //------------------------------------------------------------------------------
-// Gets raw/source data value
-double QEAbstract2DData::getDataValue (const int sourceRow, const int sourceCol,
-                                       const double defaultValue) const
+//
+void QEAbstract2DData::getSourceRows (SourceRows& sourceRows) const
 {
-   const QEFloatingArray emptyArray;
-   double result = defaultValue;
+   const int number = MAX (this->rawNumberOfRows, 0);
+   sourceRows.resize (number);
 
    if (this->getDataFormat() == array1D) {
-      QEFloatingArray dataSet = data.value (sourceRow, emptyArray);
-      result = dataSet.value (sourceCol, defaultValue);
+      for (int r = 0; r < number; r++) {
+         if (r < this->data.count()) {
+            const QEFloatingArray& dataSet = this->data.at (r);
+            sourceRows [r].values = dataSet.constData();
+            sourceRows [r].count = dataSet.count();
+         } else {
+            sourceRows [r].values = NULL;
+            sourceRows [r].count = 0;
+         }
+      }
    } else {
       // array2D
-      const QEFloatingArray dataSet = data.value (0, emptyArray);
-      const int effectiveDataWidth = this->getEffectiveDataWidth();
-      const int index = effectiveDataWidth * sourceRow + sourceCol;
-      result = dataSet.value (index, defaultValue);
-   }
+      // Note: a column index beyond the data width (only possible with an
+      // explicit slice) refers to the start of the next row - as always.
+      //
+      const double* values = NULL;
+      int total = 0;
+      if (this->data.count() > 0) {
+         const QEFloatingArray& dataSet = this->data.at (0);
+         values = dataSet.constData();
+         total = dataSet.count();
+      }
 
-   return result;
+      const int width = this->getEffectiveDataWidth();
+      for (int r = 0; r < number; r++) {
+         const qint64 start = qint64 (width) * r;
+         const qint64 remaining = total - start;
+         sourceRows [r].values = (remaining > 0) ? values + start : NULL;
+         sourceRows [r].count = (remaining > 0) ? int (remaining) : 0;
+      }
+   }
 }
 
 //------------------------------------------------------------------------------
-// Fins the bined value for the "rectangle" in the source data bounded by
+// Finds the bined value for the "rectangle" in the source data bounded by
 // the rows r1 to r2 inclusive and the columns c1 to c2 inclusive.
+// This works directly on the source rows, and in the case of median binning
+// uses the scratch buffer and a partial sort.
 //
-double QEAbstract2DData::getBinnedValue (const int r1, const int r2,
-                                         const int c1, const int c2) const
+double QEAbstract2DData::getBinnedValue (const SourceRows& sourceRows,
+                                         const int r1, const int r2,
+                                         const int c1, const int c2,
+                                         std::vector<double>& scratch) const
 {
+   #define SOURCE_VALUE(r, c) \
+      ((((r) >= 0) && ((r) < sourceRows.count()) && \
+        ((c) >= 0) && ((c) < sourceRows.at (r).count)) ? \
+        sourceRows.at (r).values [c] : noValue)
+
    const int number = (r2 - r1 + 1)*(c2 - c1 + 1);
    double result = noValue;
 
@@ -268,7 +353,7 @@ double QEAbstract2DData::getBinnedValue (const int r1, const int r2,
    } else if (number == 1) {
       // Both bin sizes must both be one - just extract the value.
       //
-      result = this->getDataValue (r1, c1, noValue);
+      result = SOURCE_VALUE (r1, c1);
 
    }
    // We need to bin the data.
@@ -278,17 +363,21 @@ double QEAbstract2DData::getBinnedValue (const int r1, const int r2,
       //
       const int row = (r1 + r2) / 2;
       const int col = (c1 + c2) / 2;
-      result = this->getDataValue (row, col, noValue);
+      result = SOURCE_VALUE (row, col);
    }
 
    else if (this->mDataBinning ==  mean) {
       // Take average of all values. Ignore noValue elements.
+      // Each source value is in only one bin, so direct accumulation visits
+      // each value once. Same order as always, so the same rounding.
       //
       double total = 0.0;
       int count = 0;
-      for (int r = r1; r <= r2; r++) {
-         for (int c = c1; c <= c2; c++) {
-            double value = this->getDataValue (r, c, noValue);
+      for (int r = MAX (r1, 0); r <= MIN (r2, sourceRows.count() - 1); r++) {
+         const SourceRow& row = sourceRows.at (r);
+         const int last = MIN (c2, row.count - 1);
+         for (int c = MAX (c1, 0); c <= last; c++) {
+            const double value = row.values [c];
             if (value != noValue) {
                total += value;
                count += 1;
@@ -304,23 +393,26 @@ double QEAbstract2DData::getBinnedValue (const int r1, const int r2,
    }
 
    else if (this->mDataBinning == median) {
-      // Take median of all values
+      // Take median of all values.
+      // The nth_element partial sort yields the same value as a full sort.
       //
-      std::vector<double> theBin;
+      scratch.clear();
 
-      for (int r = r1; r <= r2; r++) {
-         for (int c = c1; c <= c2; c++) {
-            double value = this->getDataValue (r, c, noValue);
+      for (int r = MAX (r1, 0); r <= MIN (r2, sourceRows.count() - 1); r++) {
+         const SourceRow& row = sourceRows.at (r);
+         const int last = MIN (c2, row.count - 1);
+         for (int c = MAX (c1, 0); c <= last; c++) {
+            const double value = row.values [c];
             if (value != noValue) {
-               theBin.push_back (value);
+               scratch.push_back (value);
             }
          }
       }
 
-      const int count = theBin.size();
+      const int count = scratch.size();
       if (count > 0) {
-         std::sort(theBin.begin(), theBin.end());
-         result = theBin[count/2];
+         std::nth_element (scratch.begin(), scratch.begin() + count/2, scratch.end());
+         result = scratch [count/2];
       } else {
          result = noValue;
       }
@@ -329,6 +421,8 @@ double QEAbstract2DData::getBinnedValue (const int r1, const int r2,
       DEBUG << "unexpected binning option " << this->mDataBinning;
    }
 
+   #undef SOURCE_VALUE
+
    return result;
 }
 
@@ -350,16 +444,22 @@ double QEAbstract2DData::getValue (const int displayRow, const int displayCol,
       return defaultValue;
    }
 
-   if (displayRow >= this->cachedData.count()) {
+   if ((displayRow >= this->displayedNumberOfRows) ||
+       (displayCol >= this->displayedNumberOfCols)) {
       return defaultValue;
    }
 
-   OneDVectorData row = this->cachedData.value (displayRow);
-   if (displayCol >= row.count()) {
+   int binnedRow;
+   int binnedCol;
+   this->displayToBinned (displayRow, displayCol, binnedRow, binnedCol);
+
+   const int number = this->binnedData.count();
+   if ((binnedRow < 0) || (binnedRow >= number)) {
       return defaultValue;
    }
 
-   double result = row.value (displayCol, noValue);
+   const OneDVectorData& row = this->binnedData.at ((binnedRow + this->binnedRowOrigin) % number);
+   double result = row.value (binnedCol, noValue);
    if (result == noValue) {
       return defaultValue;
    }
@@ -367,6 +467,63 @@ double QEAbstract2DData::getValue (const int displayRow, const int displayCol,
    return result;
 }
 
+//------------------------------------------------------------------------------
+// The displayed row is either a binned row (possibly reversed) or a binned
+// column, depending on the rotation. Rather than map each element, we map the
+// first element and then step through the binned data.
+//
+void QEAbstract2DData::getDisplayedRowValues (const int displayRow,
+                                              const int firstCol, const int number,
+                                              double* values,
+                                              const double defaultValue) const
+{
+   if (number <= 0) return;
+
+   const int binnedRows = this->binnedData.count();
+   const bool rowIsValid = (binnedRows > 0) && (displayRow >= 0) &&
+                           (displayRow < this->displayedNumberOfRows) &&
+                           (binnedRows == this->binnedNumberOfRows);
+
+   if (!rowIsValid) {
+      for (int j = 0; j < number; j++) values [j] = defaultValue;
+      return;
+   }
+
+   // Find binned position of col 0 and the step per displayed col.
+   //
+   int r0, c0, r1, c1;
+   this->displayToBinned (displayRow, 0, r0, c0);
+   this->displayToBinned (displayRow, 1, r1, c1);
+   const int rowStep = r1 - r0;
+   const int colStep = c1 - c0;
+
+   // No rotation or 180 degree rotation - the displayed row is one binned row,
+   // i.e. contiguous storage, traversed forwards or backwards.
+   //
+   const double* rowData = NULL;
+   if (rowStep == 0) {
+      rowData = this->binnedData.at ((r0 + this->binnedRowOrigin) % binnedRows).constData();
+   }
+
+   for (int j = 0; j < number; j++) {
+      const int col = firstCol + j;
+      double value = noValue;
+
+      if ((col >= 0) && (col < this->displayedNumberOfCols)) {
+         const int binnedCol = c0 + col * colStep;
+         if (rowData) {
+            value = rowData [binnedCol];
+         } else {
+            const int binnedRow = r0 + col * rowStep;
+            const OneDVectorData& row = this->binnedData.at ((binnedRow + this->binnedRowOrigin) % binnedRows);
+            value = row.at (binnedCol);
+         }
+      }
+
+      values [j] = (value != noValue) ? value : defaultValue;
+   }
+}
+
 //------------------------------------------------------------------------------
 //
 int QEAbstract2DData::getUpdateCount () const
@@ -467,6 +624,128 @@ void QEAbstract2DData::getNumberRowsAndCols (int& numberRows, int& numberCols) c
    numberCols = this->displayedNumberOfCols;
 }
 
+//------------------------------------------------------------------------------
+//
+bool QEAbstract2DData::getScrollUpdate (int& rowShift, int& colShift,
+                                        QRect& changed) const
+{
+   rowShift = 0;
+   colShift = 0;
+   changed = QRect ();
+
+   if (!this->isScrollUpdate) return false;
+
+   // The values in binned row k + 1 move to binned row k. As the binned to
+   // display mapping is linear, the displacement is the same for all rows.
+   //
+   if ((this->scrollRowShift > 0) && (this->binnedNumberOfRows >= 2)) {
+      int r0, c0, r1, c1;
+      this->binnedToDisplay (0, 0, r0, c0);
+      this->binnedToDisplay (1, 0, r1, c1);
+      rowShift = r0 - r1;
+      colShift = c0 - c1;
+   }
+
+   if ((this->scrollChangedRow >= 0) && (this->binnedNumberOfCols > 0)) {
+      int r0, c0, r1, c1;
+      this->binnedToDisplay (this->scrollChangedRow, 0, r0, c0);
+      this->binnedToDisplay (this->scrollChangedRow, this->binnedNumberOfCols - 1, r1, c1);
+      changed = QRect (QPoint (MIN (c0, c1), MIN (r0, r1)),
+                       QPoint (MAX (c0, c1), MAX (r0, r1)));
+   }
+
+   return true;
+}
+
+//------------------------------------------------------------------------------
+// As we apply slice, bin, rotate, then flip, we must first un-flip, then
+// un-rotate.
+//
+void QEAbstract2DData::displayToBinned (const int displayRow, const int displayCol,
+                                        int& binnedRow, int& binnedCol) const
+{
+   int sourceRow = displayRow;
+   int sourceCol = displayCol;
+
+   if (this->mVerticalFlip)
+      sourceRow = this->displayedNumberOfRows - 1 - sourceRow;
+
+   if (this->mHorizontalFlip)
+      sourceCol = this->displayedNumberOfCols - 1 - sourceCol;
+
+   switch (this->mRotation) {
+      int temp;
+
+      case QE::NoRotation:
+         // pass
+         break;
+
+      case QE::Rotate90Right:
+         temp = sourceCol;
+         sourceCol = sourceRow;
+         sourceRow = this->displayedNumberOfCols - 1 - temp;
+         break;
+
+      case QE::Rotate90Left:
+         temp = sourceRow;
+         sourceRow = sourceCol;
+         sourceCol = this->displayedNumberOfRows - 1 - temp;
+         break;
+
+      case QE::Rotate180:
+         sourceRow = this->displayedNumberOfRows - 1 - sourceRow;
+         sourceCol = this->displayedNumberOfCols - 1 - sourceCol;
+         break;
+   }
+
+   binnedRow = sourceRow;
+   binnedCol = sourceCol;
+}
+
+//------------------------------------------------------------------------------
+// The inverse of displayToBinned - rotate, then flip.
+//
+void QEAbstract2DData::binnedToDisplay (const int binnedRow, const int binnedCol,
+                                        int& displayRow, int& displayCol) const
+{
+   int row = binnedRow;
+   int col = binnedCol;
+
+   switch (this->mRotation) {
+      int temp;
+
+      case QE::NoRotation:
+         // pass
+         break;
+
+      case QE::Rotate90Right:
+         temp = row;
+         row = col;
+         col = this->displayedNumberOfCols - 1 - temp;
+         break;
+
+      case QE::Rotate90Left:
+         temp = col;
+         col = row;
+         row = this->displayedNumberOfRows - 1 - temp;
+         break;
+
+      case QE::Rotate180:
+         row = this->displayedNumberOfRows - 1 - row;
+         col = this->displayedNumberOfCols - 1 - col;
+         break;
+   }
+
+   if (this->mVerticalFlip)
+      row = this->displayedNumberOfRows - 1 - row;
+
+   if (this->mHorizontalFlip)
+      col = this->displayedNumberOfCols - 1 - col;
+
+   displayRow = row;
+   displayCol = col;
+}
+
 //------------------------------------------------------------------------------
 //
 QString QEAbstract2DData::getUnits() const
@@ -636,92 +915,193 @@ void QEAbstract2DData::calculateDataVisulationValues()
          break;
    }
 
-   // Lastly slice, bin and rotate the data to create cachedData
-   //
-   this->cachedData.clear();
-
+   // Lastly slice and bin the data to create binnedData.
    // Do a 2D size - all fill with noData for now.
    //
-   this->cachedData.reserve (this->displayedNumberOfRows);
-   for (int r = 0; r < this->displayedNumberOfRows; r++) {
-      OneDVectorData row (this->displayedNumberOfCols, noValue);
-      this->cachedData.append(row);
+   this->binnedData.clear();
+   this->binnedData.reserve (this->binnedNumberOfRows);
+   for (int r = 0; r < this->binnedNumberOfRows; r++) {
+      OneDVectorData row (this->binnedNumberOfCols, noValue);
+      this->binnedData.append(row);
    }
+   this->binnedRowOrigin = 0;
 
    // Determine the value in each cell.
    //
-   for (int r = 0; r < this->displayedNumberOfRows; r++) {
-      for (int c = 0; c < this->displayedNumberOfCols; c++) {
+   this->calculateBinnedRows (0, this->binnedNumberOfRows);
 
-         // Start with no rotation and no flipping.
-         //
-         int sourceRow = r;
-         int sourceCol = c;
+   // Lastly call hook function.
+   //
+   this->updateDataVisulation ();
+}
 
-         // Processes: slicing, binning, rotation and flips.
-         // As we apply slice, bin, rotate, then flip, we must first un-flip/un-rotate,
-         // de-bin and and then un-slice.
-         //
-         if (this->mVerticalFlip)
-            sourceRow = this->displayedNumberOfRows - 1 - sourceRow;
-
-         if (this->mHorizontalFlip)
-            sourceCol = this->displayedNumberOfCols - 1 - sourceCol;
-
-         switch (this->mRotation) {
-            int temp;
-
-            case QE::NoRotation:
-               // pass
-               break;
-
-            case QE::Rotate90Right:
-               // Do the rotation
-               //
-               temp = sourceCol;
-               sourceCol = sourceRow;
-               sourceRow = this->displayedNumberOfCols - 1 - temp;
-               break;
-
-            case QE::Rotate90Left:
-               // Do the rotation
-               //
-               temp = sourceRow;
-               sourceRow = sourceCol;
-               sourceCol = this->displayedNumberOfRows - 1 - temp;
-               break;
-
-            case QE::Rotate180:
-               // Do the rotation
-               //
-               sourceRow = this->displayedNumberOfRows - 1 - sourceRow;
-               sourceCol = this->displayedNumberOfCols - 1 - sourceCol;
-               break;
-         }
+//------------------------------------------------------------------------------
+//
+void QEAbstract2DData::calculateBinnedRows (const int firstRow, const int lastRow)
+{
+   const int number = this->binnedData.count();
+   if ((firstRow < 0) || (lastRow > number) || (firstRow >= lastRow)) return;   // sanity check
 
-         // First/last are inclusive
-         //
-         int sourceRowFirst = this->sliceRowOffset + sourceRow * rowBin;
-         int sourceRowLast  = sourceRowFirst + rowBin - 1;
+   SourceRows sourceRows;
+   this->getSourceRows (sourceRows);
 
-         int sourceColFirst = this->sliceColOffset + sourceCol * colBin;
-         int sourceColLast  = sourceColFirst + colBin - 1;
+   // Get the output row pointers here, on the calling thread, as this may
+   // cause the rows to detach.
+   //
+   QVector<double*> outputs (number);
+   for (int r = firstRow; r < lastRow; r++) {
+      outputs [r] = this->binnedData [(r + this->binnedRowOrigin) % number].data();
+   }
+
+   // Small calculations, or no pool threads to speak of - just do it here.
+   //
+   const int rowCount = lastRow - firstRow;
+   const qint64 work = qint64 (rowCount) * this->mVerticalBin * this->slicedNumberOfCols;
+   const int threads = QETaskPool::threadCount ();
+   if ((work < binningParallelThreshold) || (rowCount < 2) || (threads < 2)) {
+      this->binRows (sourceRows, outputs.constData(), firstRow, lastRow);
+      return;
+   }
 
-         // The last bin will be smaller if not an number not an exact multiple
-         // of the bin size. Should we allow bin to extend outside of the slice?
+   // Split into stripes. The calling thread bins the last stripe itself.
+   //
+   const int stripes = MIN (threads, rowCount);
+   const int stripe = (rowCount + stripes - 1) / stripes;
+
+   QList<QETaskPointer> taskList;
+   QList<int> firstRowList;
+   int row = firstRow;
+   while (row + stripe < lastRow) {
+      QETaskPointer task (new QEAbstract2DDataBinningTask (this, &sourceRows, outputs.constData(),
+                                                           row, row + stripe));
+      if (!QETaskPool::submit (task)) {
+         // Pool no longer available - do it here.
          //
-         sourceRowLast = MIN (sourceRowLast, rowLast);
-         sourceColLast = MIN (sourceColLast, colLast);
+         this->binRows (sourceRows, outputs.constData(), row, row + stripe);
+      } else {
+         taskList.append (task);
+         firstRowList.append (row);
+      }
+      row += stripe;
+   }
+
+   this->binRows (sourceRows, outputs.constData(), row, lastRow);
 
-         double value = this->getBinnedValue (sourceRowFirst, sourceRowLast,
-                                              sourceColFirst, sourceColLast);
-         this->cachedData[r][c] = value;
+   for (int j = 0; j < taskList.count (); j++) {
+      QETaskPointer task = taskList.value (j);
+      task->waitForFinished ();
+
+      // Cancelled if the application is quitting - belts 'n' braces.
+      //
+      if (task->getState () == QETask::Cancelled) {
+         const int first = firstRowList.value (j);
+         this->binRows (sourceRows, outputs.constData(), first, MIN (first + stripe, lastRow));
       }
    }
+}
 
-   // Lastly call hook function.
+//------------------------------------------------------------------------------
+//
+void QEAbstract2DData::binRows (const SourceRows& sourceRows, double* const* outputs,
+                                const int firstRow, const int lastRow) const
+{
+   std::vector<double> scratch;   // re-used for each bin
+   scratch.reserve (this->mVerticalBin * this->mHorizontalBin);
+
+   for (int r = firstRow; r < lastRow; r++) {
+      this->binRow (sourceRows, r, outputs [r], scratch);
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+void QEAbstract2DData::binRow (const SourceRows& sourceRows, const int binnedRow,
+                               double* output, std::vector<double>& scratch) const
+{
+   const int rowBin = this->mVerticalBin;
+   const int colBin = this->mHorizontalBin;
+   const int rowLast = this->sliceRowOffset + this->slicedNumberOfRows - 1;
+   const int colLast = this->sliceColOffset + this->slicedNumberOfCols - 1;
+
+   // First/last are inclusive
    //
+   const int sourceRowFirst = this->sliceRowOffset + binnedRow * rowBin;
+   int sourceRowLast  = sourceRowFirst + rowBin - 1;
+
+   // The last bin will be smaller if not an number not an exact multiple
+   // of the bin size. Should we allow bin to extend outside of the slice?
+   //
+   sourceRowLast = MIN (sourceRowLast, rowLast);
+
+   for (int c = 0; c < this->binnedNumberOfCols; c++) {
+      const int sourceColFirst = this->sliceColOffset + c * colBin;
+      int sourceColLast  = sourceColFirst + colBin - 1;
+      sourceColLast = MIN (sourceColLast, colLast);
+
+      output [c] = this->getBinnedValue (sourceRows, sourceRowFirst, sourceRowLast,
+                                         sourceColFirst, sourceColLast, scratch);
+   }
+}
+
+//------------------------------------------------------------------------------
+// Called when a data set has been added. When accumulating 1D data sets, each
+// new data set either fills the next row, or once numberOfSets have been
+// accumulated, all the rows are shifted by one. In the latter case, we just
+// advance the ring origin rather than recalculating every binned row.
+// This is only possible when each binned row is made from one data set, i.e.
+// when the vertical bin size is one.
+//
+bool QEAbstract2DData::scrollDataVisulationValues (const int previousCount)
+{
+   if (this->mDataFormat != array1D) return false;
+   if (this->mVerticalBin != 1) return false;
+   if (previousCount < 1) return false;
+   if (this->binnedNumberOfRows < 1) return false;
+   if (this->binnedData.count() != this->binnedNumberOfRows) return false;
+   if (this->rawNumberOfRows != this->mNumberOfSets) return false;
+
+   // All data sets must be the same size as the current number of cols.
+   // We need only check the newest and the oldest - the others have been
+   // checked before.
+   //
+   const int count = this->data.count();
+   if (this->data.last().count() != this->rawNumberOfCols) return false;
+   if (this->data.first().count() != this->rawNumberOfCols) return false;
+
+   int changedRow;
+   if (count == previousCount) {
+      // Oldest data set removed - all rows shift by one.
+      // The last binned row needs calculating from scratch.
+      //
+      this->scrollRowShift = 1;
+      this->binnedRowOrigin = (this->binnedRowOrigin + 1) % this->binnedNumberOfRows;
+      changedRow = this->binnedNumberOfRows - 1;
+
+   } else if (count == previousCount + 1) {
+      // Still accumulating - the new data set is in the next row.
+      //
+      this->scrollRowShift = 0;
+      changedRow = (count - 1) - this->sliceRowOffset;
+      if ((changedRow < 0) || (changedRow >= this->binnedNumberOfRows)) {
+         changedRow = -1;   // not within the slice
+      }
+
+   } else {
+      return false;
+   }
+
+   this->scrollChangedRow = changedRow;
+   if (changedRow >= 0) {
+      this->calculateBinnedRows (changedRow, changedRow + 1);
+   }
+
+   // Call the hook function, but only flag a scroll update during this call.
+   //
+   this->isScrollUpdate = true;
    this->updateDataVisulation ();
+   this->isScrollUpdate = false;
+
+   return true;
 }
 
 //==============================================================================
@@ -795,6 +1175,8 @@ void QEAbstract2DData::onDataArrayUpdate (const QEFloatingArrayUpdate& update)
       return;
    }
 
+   const int previousCount = this->data.count ();
+
    QEFloatingArray data (update.values);
    this->data.append (data);
 
@@ -805,7 +1187,11 @@ void QEAbstract2DData::onDataArrayUpdate (const QEFloatingArrayUpdate& update)
 
    this->updateCount = (this->updateCount + 1) % 1000000000;
 
-   this->calculateDataVisulationValues ();
+   // Try scrolling first - only calculate everything if needs be.
+   //
+   if (!this->scrollDataVisulationValues (previousCount)) {
+      this->calculateDataVisulationValues ();
+   }
 
    // Invoke common alarm handling processing.
    //
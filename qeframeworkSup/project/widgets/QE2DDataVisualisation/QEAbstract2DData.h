@@ -14,6 +14,7 @@
 #ifndef QE_ABSTRACT_2D_DATA_H
 #define QE_ABSTRACT_2D_DATA_H
 
+#include <vector>
 #include <QList>
 #include <QMenu>
 #include <QString>
@@ -33,6 +34,7 @@
 #include <QEAbstractWidget.h>
 
 class QEStripChartRangeDialog;   // differed
+class QEAbstract2DDataBinningTask;
 
 /// \brief The QEAbstract2DData class.
 /// This is the base class for the QESpectogram, QEWaterfall and QESurface
@@ -316,6 +318,16 @@ protected:
    double getValue (const int displayRow, const int displayCol,
                     const double defaultValue) const;
 
+   // This function provides the values for number displayed columns, starting
+   // at firstCol, of the displayed row. It is equivalent to, but much faster
+   // than, calling getValue for each column. It only reads the data, so may be
+   // called from other threads provided the data is not updated concurrently.
+   //
+   void getDisplayedRowValues (const int displayRow,
+                               const int firstCol, const int number,
+                               double* values,
+                               const double defaultValue) const;
+
    // Provides the quazi frame count modulo 1,000,000,000.
    //
    int getUpdateCount () const;
@@ -333,6 +345,16 @@ protected:
    //
    void getNumberRowsAndCols (int& numberRows, int& numberCols) const;
 
+   // When dataFormat is array1D and the binned data has only scrolled, i.e.
+   // a new data set has been added but no slice, bin, rotation or flip
+   // parameter has changed, this returns true and provides the displacement
+   // of the previously displayed values (in display rows and cols) together
+   // with the displayed region that has new values, which may be empty.
+   // This allows sub classes to update incrementally.
+   // Only valid when called from within the updateDataVisulation hook function.
+   //
+   bool getScrollUpdate (int& rowShift, int& colShift, QRect& changed) const;
+
    // Get the data engineering units and precision.
    //
    QString getUnits() const;
@@ -347,18 +369,57 @@ private:
    void setReadOut (const QString& text);
    void calculateDataVisulationValues ();
 
+   // Attempts an incremental update following the addition of a data set.
+   // Returns false if a full recalculation is required.
+   //
+   bool scrollDataVisulationValues (const int previousCount);
+
+   // Raw/source data row - pointer to and number of available values.
+   // For 2D data, the count is the number of values from the start of the row
+   // to the end of the data.
+   //
+   struct SourceRow {
+      const double* values;
+      int count;
+   };
+   typedef QVector<SourceRow> SourceRows;
+
+   void getSourceRows (SourceRows& sourceRows) const;
+
+   // Calculates the values for binned rows firstRow to lastRow - 1.
+   // Large calculations are split across the QETaskPool threads.
+   //
+   void calculateBinnedRows (const int firstRow, const int lastRow);
+
+   // The binning kernels. These only read the source data and write to the
+   // given output rows, so may be called on pool threads.
+   //
+   void binRows (const SourceRows& sourceRows, double* const* outputs,
+                 const int firstRow, const int lastRow) const;
+   void binRow (const SourceRows& sourceRows, const int binnedRow,
+                double* output, std::vector<double>& scratch) const;
+
+   // Conversion between displayed and binned row/col positions, i.e. applies
+   // or un-applies any rotation and flips.
+   //
+   void displayToBinned (const int displayRow, const int displayCol,
+                         int& binnedRow, int& binnedCol) const;
+   void binnedToDisplay (const int binnedRow, const int binnedCol,
+                         int& displayRow, int& displayCol) const;
+
    // Gets the actual minimum and maximum data values otherwise min and max left
    // "as is", i.e. unchanged. Therefore caller should supply sensible default.
    //
    void getDataMinMaxValues (double& min, double& max) const;
 
-   // Gets raw/source data value
+   // Finds the binned value for the "rectangle" in the source data bounded
+   // by the rows r1 to r2 inclusive and the columns c1 to c2 inclusive.
+   // The scratch buffer is used for median binning.
    //
-   double getDataValue (const int sourceRow, const int sourceCol,
-                        const double defaultValue) const;
-
-   double getBinnedValue (const int r1, const int r2,
-                          const int c1, const int c2) const;
+   double getBinnedValue (const SourceRows& sourceRows,
+                          const int r1, const int r2,
+                          const int c1, const int c2,
+                          std::vector<double>& scratch) const;
 
 
    QCaVariableNamePropertyManager dnpm;   // data name
@@ -402,12 +463,21 @@ private:
    typedef QList<QEFloatingArray> TwoDimensionalData;
    TwoDimensionalData data;
 
-   // This is the post sliced, binned and rotated data.
-   // Irrespective of mDataFormat, this a 2D representation of the data
+   // This is the post sliced and binned data, held as a ring of binned rows.
+   // Irrespective of mDataFormat, this a 2D representation of the data.
+   // Rotation and flips are applied on access, so that when 1D data sets are
+   // accumulated, only the new binned row needs to be calculated.
    //
    typedef QVector<double>         OneDVectorData;
    typedef QVector<OneDVectorData> TwoDVectorData;
-   TwoDVectorData cachedData;
+   TwoDVectorData binnedData;
+   int binnedRowOrigin;         // ring index of binned row 0
+
+   // Scroll update information - see getScrollUpdate.
+   //
+   bool isScrollUpdate;
+   int scrollRowShift;          // number binned rows scrolled, 0 or 1
+   int scrollChangedRow;        // the recalculated binned row or -1
 
    int updateCount;
 
@@ -433,6 +503,8 @@ private:
    int displayedNumberOfRows;   // number rows of data after any flip/rotation
    int displayedNumberOfCols;   // number cols of data after any flip/rotation
 
+   friend class QEAbstract2DDataBinningTask;
+
 public slots:
    void usePvNameProperties (const QEPvNameProperties& properties);
 
@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2020-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2020-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Starritt
@@ -12,13 +12,73 @@
  */
 
 #include "QESpectrogram.h"
+#include <string.h>
 #include <QDebug>
+#include <QList>
 #include <QECommon.h>
+#include <QETaskPool.h>
 
 #define DEBUG qDebug () << "QESpectrogram" << __LINE__ << __FUNCTION__ << "  "
 
 static const double minSpan = 1.0e-3;     /// duplicate
 
+//==============================================================================
+// Renders a stripe of rows on a pool thread.
+//
+class QESpectrogramRenderTask : public QETask {
+public:
+   explicit QESpectrogramRenderTask (const QESpectrogram* owner,
+                                     uchar* bits, const int bytesPerLine,
+                                     const QRect& area,
+                                     const int firstRow, const int lastRow,
+                                     const double scale, const double offset,
+                                     const double defaultValue);
+protected:
+   void run ();
+
+private:
+   const QESpectrogram* owner;
+   uchar* const bits;
+   const int bytesPerLine;
+   const QRect area;
+   const int firstRow;
+   const int lastRow;
+   const double scale;
+   const double offset;
+   const double defaultValue;
+};
+
+//------------------------------------------------------------------------------
+//
+QESpectrogramRenderTask::QESpectrogramRenderTask (const QESpectrogram* ownerIn,
+                                                  uchar* bitsIn, const int bytesPerLineIn,
+                                                  const QRect& areaIn,
+                                                  const int firstRowIn, const int lastRowIn,
+                                                  const double scaleIn, const double offsetIn,
+                                                  const double defaultValueIn) :
+   QETask (QETask::High),
+   owner (ownerIn),
+   bits (bitsIn),
+   bytesPerLine (bytesPerLineIn),
+   area (areaIn),
+   firstRow (firstRowIn),
+   lastRow (lastRowIn),
+   scale (scaleIn),
+   offset (offsetIn),
+   defaultValue (defaultValueIn)
+{
+}
+
+//------------------------------------------------------------------------------
+//
+void QESpectrogramRenderTask::run ()
+{
+   this->owner->renderRows (this->bits, this->bytesPerLine, this->area,
+                            this->firstRow, this->lastRow,
+                            this->scale, this->offset, this->defaultValue);
+}
+
+
 //------------------------------------------------------------------------------
 //
 QESpectrogram:: QESpectrogram (QWidget* parent) :
@@ -79,6 +139,16 @@ void QESpectrogram::commonSetup ()
    this->mScaleWrap = 1;
    this->mMargin = 4;
 
+   this->imageScaling.min = 0.0;
+   this->imageScaling.max = 0.0;
+   this->imageScaling.useFalseColour = false;
+   this->imageScaling.scaleWrap = 0;
+   this->imageScaling.logScale = false;
+
+   this->lookupUseFalseColour = false;
+   this->lookupScaleWrap = 0;
+   this->lookupLogScale = false;
+
    // Set up the pixel maps
    //
    for (int j = 0; j < 256; j++) {
@@ -181,8 +251,83 @@ void QESpectrogram::updateDataVisulation ()
    //
    max = MAX (max, min + minSpan);
 
-   const int scaledMin = 0;
-   const int maxLoops = this->getScaleWrap() - 1;   // zero based count
+   // Base class worries about image rotation and flipping.
+   // Get displayed number of row and cols.
+   //
+   int imageWidth;
+   int imageHeight;
+   this->getNumberRowsAndCols (imageHeight, imageWidth);
+
+   ImageScaling scaling;
+   scaling.min = min;
+   scaling.max = max;
+   scaling.useFalseColour = this->getUseFalseColour();
+   scaling.scaleWrap = this->getScaleWrap();
+   scaling.logScale = this->getLogScale();
+
+   // Can we just scroll the existing image?
+   //
+   int rowShift;
+   int colShift;
+   QRect changed;
+   const bool canScroll = this->getScrollUpdate (rowShift, colShift, changed) &&
+                          !this->image.isNull() &&
+                          (this->image.width() == imageWidth) &&
+                          (this->image.height() == imageHeight) &&
+                          QESpectrogram::isSameScaling (scaling, this->imageScaling);
+
+   if (canScroll) {
+      this->scrollImage (rowShift, colShift);
+      if (!changed.isEmpty()) {
+         this->renderImage (this->image, changed, min, max);
+      }
+   } else {
+      // Create the new image
+      //
+      QImage workImage = QImage (imageWidth, imageHeight, QImage::Format_RGB32);
+      this->renderImage (workImage, workImage.rect(), min, max);
+
+      // Update "the" image.
+      //
+      this->image = workImage;
+   }
+   this->imageScaling = scaling;
+
+   // Trigger a paintEvent.
+   //
+   this->plotArea->update ();
+}
+
+//------------------------------------------------------------------------------
+// static
+bool QESpectrogram::isSameScaling (const ImageScaling& a, const ImageScaling& b)
+{
+   return (a.min == b.min) && (a.max == b.max) &&
+          (a.useFalseColour == b.useFalseColour) &&
+          (a.scaleWrap == b.scaleWrap) &&
+          (a.logScale == b.logScale);
+}
+
+//------------------------------------------------------------------------------
+//
+void QESpectrogram::updatePixelLookup ()
+{
+   const bool useFalseColour = this->getUseFalseColour();
+   const int scaleWrap = this->getScaleWrap();
+   const bool logScale = this->getLogScale();
+
+   if (!this->pixelLookup.isEmpty() &&
+       (useFalseColour == this->lookupUseFalseColour) &&
+       (scaleWrap == this->lookupScaleWrap) &&
+       (logScale == this->lookupLogScale)) {
+      return;   // still good
+   }
+
+   this->lookupUseFalseColour = useFalseColour;
+   this->lookupScaleWrap = scaleWrap;
+   this->lookupLogScale = logScale;
+
+   const int maxLoops = scaleWrap - 1;   // zero based count
 
    // Calc the spread between two break points - in this region only the
    // hue of the colout changes, not brightness or intensity.
@@ -190,67 +335,162 @@ void QESpectrogram::updateDataVisulation ()
    const int wrapSpread = (this->breakPoint2 - this->breakPoint1);
    const int scaledMax = 255 + (maxLoops * wrapSpread);
 
+   const RgbPixelMaps* pixelMap = useFalseColour ?
+            &this->falseColourPixelMap :
+            &this->grayScalePixelMap;
+
+   this->pixelLookup.resize (scaledMax + 1);
+   for (int scaled = 0; scaled <= scaledMax; scaled++) {
+      int index = scaled;
+      int loops = (index - this->breakPoint1) / wrapSpread;
+      loops = MIN (loops, maxLoops);
+
+      index = index - (loops*wrapSpread);    // wrap index.
+      index = LIMIT (index, 0, 255);         // belts 'n' braces limit
+
+      if (logScale) {
+         // Compare with  QEImage/imageProcessor.cpp - approx line 1276
+         // Here is used a slightly larger constant so that 255 maps to 255, not 254.
+         //
+         index = int (LOG10 (index + 1.0) * 105.9903);
+      }
+
+      this->pixelLookup [scaled] = (*pixelMap) [index];
+   }
+}
+
+//------------------------------------------------------------------------------
+// Calculates the pixels within the region of the target image.
+// Large regions are split into stripes of rows which are rendered in parallel
+// using the QETaskPool.
+//
+void QESpectrogram::renderImage (QImage& target, const QRect& region,
+                                 const double min, const double max)
+{
+   const QRect area = region & target.rect();
+   if (area.isEmpty()) return;
+
+   this->updatePixelLookup ();
+
    // Calc linear scaling constants m,c for y = m.x + c scaling
    //
-   const double scale = double (scaledMax - scaledMin)/(max - min);
+   const int scaledMax = this->pixelLookup.count() - 1;
+   const double scale = double (scaledMax)/(max - min);
    const double offset = -scale * min;
 
-   // 8 cases:
-   // grey scale vs. false colour
-   // data source: 1D vs. 2D
-   // orientation: vertical vs horizontal
-   //
-   RgbPixelMaps* pixelMap = this->getUseFalseColour() ?
-            &this->falseColourPixelMap :
-            &this->grayScalePixelMap;
-
-   // Base class worries about image rotation and flipping.
-   // Get displayed number of row and cols.
+   // Get the bits on this thread - scanLine/bits may detach.
    //
-   int imageWidth;
-   int imageHeight;
-   this->getNumberRowsAndCols (imageHeight, imageWidth);
+   uchar* bits = target.bits();
+   const int bytesPerLine = target.bytesPerLine();
+
+   const int height = area.height();
+   const int threads = QETaskPool::threadCount ();
+   if ((area.width() * height < parallelThreshold) || (threads < 2)) {
+      this->renderRows (bits, bytesPerLine, area, area.top(), area.bottom() + 1,
+                        scale, offset, min);
+      return;
+   }
 
-   // Create the new image
+   // Split into stripes. The calling thread renders the last stripe itself.
    //
-   QImage workImage = QImage (imageWidth, imageHeight, QImage::Format_RGB32);
+   const int number = MIN (threads, MAX (height / 16, 1));
+   const int stripe = (height + number - 1) / number;
+
+   QList<QETaskPointer> taskList;
+   QList<int> firstRowList;
+   int firstRow = area.top();
+   while (firstRow + stripe <= area.bottom()) {
+      QETaskPointer task (new QESpectrogramRenderTask (this, bits, bytesPerLine, area,
+                                                       firstRow, firstRow + stripe,
+                                                       scale, offset, min));
+      if (!QETaskPool::submit (task)) {
+         // Pool no longer available - do it here.
+         //
+         this->renderRows (bits, bytesPerLine, area, firstRow, firstRow + stripe,
+                           scale, offset, min);
+      } else {
+         taskList.append (task);
+         firstRowList.append (firstRow);
+      }
+      firstRow += stripe;
+   }
 
-   for (int row = 0; row < imageHeight; row++) {
-      rgbPixel* rowOut = (rgbPixel*)(workImage.scanLine (row));
+   this->renderRows (bits, bytesPerLine, area, firstRow, area.bottom() + 1,
+                     scale, offset, min);
 
-      for (int col = 0; col < imageWidth; col++) {
+   for (int j = 0; j < taskList.count (); j++) {
+      QETaskPointer task = taskList.value (j);
+      task->waitForFinished ();
 
-         double value = this->getValue (row, col, min);
+      // Cancelled if the application is quitting - belts 'n' braces.
+      //
+      if (task->getState () == QETask::Cancelled) {
+         const int row = firstRowList.value (j);
+         this->renderRows (bits, bytesPerLine, area, row, row + stripe,
+                           scale, offset, min);
+      }
+   }
+}
 
-         // scale (y = m.x + c), wrap and limit.
-         //
-         value = scale*value + offset;
-         value = LIMIT (value, scaledMin, scaledMax);
+//------------------------------------------------------------------------------
+// Renders rows firstRow to lastRow - 1 of the area. This only reads the data
+// and the pixel lookup table, so may be run on pool threads.
+//
+void QESpectrogram::renderRows (uchar* bits, const int bytesPerLine, const QRect& area,
+                                const int firstRow, const int lastRow,
+                                const double scale, const double offset,
+                                const double defaultValue) const
+{
+   const int width = area.width();
+   const int scaledMax = this->pixelLookup.count() - 1;
+   const rgbPixel* lookup = this->pixelLookup.constData();
 
-         int index = int (value);
-         int loops = (index - this->breakPoint1) / wrapSpread;
-         loops = MIN (loops, maxLoops);
+   QVector<double> values (width);
+   double* rowValues = values.data();
 
-         index = index - (loops*wrapSpread);    // wrap index.
-         index = LIMIT (index, 0, 255);         // belts 'n' braces limit
+   for (int row = firstRow; row < lastRow; row++) {
+      this->getDisplayedRowValues (row, area.left(), width, rowValues, defaultValue);
 
-         if (this->getLogScale()) {
-            // Compare with  QEImage/imageProcessor.cpp - approx line 1276
-            // Here is used a slightly larger constant so that 255 maps to 255, not 254.
-            //
-            index = int (LOG10 (index + 1.0) * 105.9903);
-         }
+      rgbPixel* rowOut = (rgbPixel*)(bits + qint64 (bytesPerLine) * row) + area.left();
 
-         rowOut [col] = (*pixelMap) [index];    // look up and assign to image pixel.
+      for (int col = 0; col < width; col++) {
+         // scale (y = m.x + c) and limit, then look up and assign to image pixel.
+         //
+         double value = scale*rowValues [col] + offset;
+         value = LIMIT (value, 0, scaledMax);
+         rowOut [col] = lookup [int (value)];
       }
    }
-
-   // Update "the" image and trigger a paintEvent.
-   //
-   this->image = workImage;
-   this->plotArea->update ();
 }
 
+//------------------------------------------------------------------------------
+// Moves the pixel at (row, col) to (row + rowShift, col + colShift).
+// The vacated pixels are left as is - the caller re-renders them.
+//
+void QESpectrogram::scrollImage (const int rowShift, const int colShift)
+{
+   const int width = this->image.width();
+   const int height = this->image.height();
+   const int bytesPerLine = this->image.bytesPerLine();
+   uchar* bits = this->image.bits();   // detaches if needs be
+
+   if ((rowShift != 0) && (ABS (rowShift) < height)) {
+      // Rows are contiguous - one move does the lot.
+      //
+      const int number = height - ABS (rowShift);
+      uchar* target = bits + bytesPerLine * MAX (rowShift, 0);
+      const uchar* source = bits + bytesPerLine * MAX (-rowShift, 0);
+      memmove (target, source, size_t (bytesPerLine) * number);
+   }
+
+   if ((colShift != 0) && (ABS (colShift) < width)) {
+      const size_t size = (width - ABS (colShift)) * sizeof (rgbPixel);
+      for (int row = 0; row < height; row++) {
+         rgbPixel* rowData = (rgbPixel*)(bits + bytesPerLine * row);
+         memmove (rowData + MAX (colShift, 0), rowData + MAX (-colShift, 0), size);
+      }
+   }
+}
 
 //------------------------------------------------------------------------------
 // Build the specific context menu
@@ -454,4 +694,11 @@ int QESpectrogram::getMargin () const
    return this->mMargin;
 }
 
+//------------------------------------------------------------------------------
+//
+const QImage& QESpectrogram::getImage () const
+{
+   return this->image;
+}
+
 // end
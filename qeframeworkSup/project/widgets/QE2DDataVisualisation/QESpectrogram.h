@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2020-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2020-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Starritt
@@ -19,6 +19,7 @@
 #include <QPainter>
 #include <QRect>
 #include <QString>
+#include <QVector>
 #include <QWidget>
 #include <QEAbstract2DData.h>
 #include <QEFrameworkLibraryGlobal.h>
@@ -117,6 +118,11 @@ protected:
    QMenu* buildContextMenu ();                        // Build the specific context menu
    void contextMenuTriggered (int selectedItemNum);   // An action was selected from the context menu
 
+   // The current image, one pixel per displayed data element, i.e. before
+   // scaling to the widget size.
+   //
+   const QImage& getImage () const;
+
 private:
    // Structure used when setting current image. Cribbed from QEImage.
    //
@@ -126,7 +132,29 @@ private:
 
    typedef rgbPixel RgbPixelMaps [256];
 
+   // The scaling used to create the current image. When unchanged and the base
+   // class indicates the data have only scrolled, the image is shifted and only
+   // the new row (or column) of pixels is calculated.
+   //
+   struct ImageScaling {
+      double min;
+      double max;
+      bool useFalseColour;
+      int scaleWrap;
+      bool logScale;
+   };
+
+   static bool isSameScaling (const ImageScaling& a, const ImageScaling& b);
+
    void commonSetup ();
+   void renderImage (QImage& target, const QRect& region,
+                     const double min, const double max);
+   void renderRows (uchar* bits, const int bytesPerLine, const QRect& area,
+                    const int firstRow, const int lastRow,
+                    const double scale, const double offset,
+                    const double defaultValue) const;
+   void updatePixelLookup ();
+   void scrollImage (const int rowShift, const int colShift);
    void paintSpectrogram ();
    void spectrogramMouseMove (const QPoint& pos);
    rgbPixel getFalseColor (const unsigned char value);  // also sets breakPoint1/2
@@ -140,10 +168,26 @@ private:
    QHBoxLayout* layout;    // holds the widget - any layout type will do
 
    QImage image;
+   ImageScaling imageScaling;
 
    RgbPixelMaps grayScalePixelMap;
    RgbPixelMaps falseColourPixelMap;
 
+   // Maps the integer scaled value, 0 to 255 + wraps, directly to a pixel, i.e.
+   // the scale wrap and log scale transforms are pre-applied. This is rebuilt
+   // when the false colour, scale wrap or log scale settings change.
+   //
+   QVector<rgbPixel> pixelLookup;
+   bool lookupUseFalseColour;
+   int lookupScaleWrap;
+   bool lookupLogScale;
+
+   // Images with fewer pixels than this are rendered on the calling thread.
+   //
+   static const int parallelThreshold = 256 * 1024;
+
+   friend class QESpectrogramRenderTask;
+
    int breakPoint1;       // first colour scale break point
    int breakPoint2;       // second colour scale break point
 
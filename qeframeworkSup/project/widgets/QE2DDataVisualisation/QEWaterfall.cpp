@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2020-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2020-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Starritt
@@ -13,12 +13,12 @@
 
 #include "QEWaterfall.h"
 #include <math.h>
-#include <QBrush>
 #include <QDebug>
 #include <QPainter>
 #include <QPen>
 #include <QPointF>
 #include <QPolygonF>
+#include <QVector>
 #include <QECommon.h>
 #include <QEDisplayRanges.h>
 
@@ -84,6 +84,11 @@ void QEWaterfall::commonSetup ()
    this->mBackgroundColour = QColor ("#ffffff");
    this->mMargin = 4;
 
+   this->layerUpdateCount = 0;
+   this->layersAreValid = false;
+   this->compositeIsValid = false;
+   this->mapIsValid = false;
+
    // NOTE: The axis objects are used as painters, not as widgets.
    //
    this->xAxis = new QEAxisPainter (NULL);
@@ -126,6 +131,16 @@ QSize QEWaterfall::sizeHint () const
 //
 void QEWaterfall::updateDataVisulation ()
 {
+   // Try to just add the new trace, otherwise a full redraw is required.
+   //
+   Geometry g;
+   this->calculateGeometry (g);
+   if (!this->scrollLayers (g)) {
+      this->layersAreValid = false;
+   }
+   this->compositeIsValid = false;
+   this->mapIsValid = false;
+
    this->plotArea->update ();  // trigger a paint event
 }
 
@@ -162,32 +177,46 @@ bool QEWaterfall::eventFilter (QObject* watched, QEvent* event)
 }
 
 //------------------------------------------------------------------------------
-//
-void QEWaterfall::paintWaterfall ()
+// static
+bool QEWaterfall::isSameSettings (const Geometry& a, const Geometry& b)
 {
-   // If background is dark, choose white as oen colour.
-   //
-   const QColor penColour = QEUtilities::fontColour (this->mBackgroundColour);
+   return (a.size == b.size) &&
+          (a.pixelRatio == b.pixelRatio) &&
+          (a.numberRows == b.numberRows) &&
+          (a.numberCols == b.numberCols) &&
+          (a.min == b.min) &&
+          (a.max == b.max) &&
+          (a.angle == b.angle) &&
+          (a.traceGap == b.traceGap) &&
+          (a.penWidth == b.penWidth) &&
+          (a.traceColour == b.traceColour) &&
+          (a.backgroundColour == b.backgroundColour) &&
+          (a.mutableHue == b.mutableHue) &&
+          (a.dataFormat == b.dataFormat);
+}
 
-   this->xAxis->setPenColour (penColour);
-   this->yAxis->setPenColour (penColour);
+//------------------------------------------------------------------------------
+//
+void QEWaterfall::calculateGeometry (Geometry& g) const
+{
+   QRect rect = this->plotArea->geometry();
 
-   double min;
-   double max;
-   this->getScaleModeMinMaxValues (min, max);
+   g.size = rect.size();
+   g.pixelRatio = this->plotArea->devicePixelRatioF();
 
-   int numberCols;
-   int numberRows;
-   this->getNumberRowsAndCols (numberRows, numberCols);
+   this->getScaleModeMinMaxValues (g.min, g.max);
+   this->getNumberRowsAndCols (g.numberRows, g.numberCols);
 
-   // Set up painter.
-   //
-   QPainter painter (this->plotArea);
-   QRect rect = this->plotArea->geometry();
+   g.angle = this->mAngle;
+   g.traceGap = this->mTraceGap;
+   g.traceColour = this->mTraceColour;
+   g.backgroundColour = this->mBackgroundColour;
+   g.mutableHue = this->mMutableHue;
+   g.dataFormat = this->getDataFormat ();
 
-   // We want rect in the plot area, not plot area in QESpectrogram.
+   // If background is dark, choose white as oen colour.
    //
-   rect.moveTo (0, 0);
+   g.penColour = QEUtilities::fontColour (this->mBackgroundColour);
 
    // Do the geometry.
    //
@@ -196,35 +225,41 @@ void QEWaterfall::paintWaterfall ()
    const double cosAlpha = cos (alpha);
 
    // Separation between plot lines.
+   // The x and y separations are rounded to whole pixels, so that the rendered
+   // traces may be scrolled by exactly one trace offset.
    //
    const double ds = this->mTraceGap;
 
-   const double dsx = ds * sinAlpha;      // x separation
-   const double dsy = ds * cosAlpha;      // y separation
+   g.dsx = qRound (ds * sinAlpha);      // x separation
+   g.dsy = qRound (ds * cosAlpha);      // y separation
+
+   g.penWidth = (this->mTraceWidth >= 1)
+         ? this->mTraceWidth
+         : MAX(1, int ((ds + 4) / 8));
 
    // Vertical split into four regions sized ay, by, cy and dy (top to bottom)
    //
-   const double ay = 20.0;                // gap at top
-   const double by = numberRows * dsy;    // slope bit
-   const double dy = 36.0;                // room for axis
-   const double cy = rect.height() - (ay + by + dy);
+   g.ay = 20.0;                         // gap at top
+   g.by = g.numberRows * g.dsy;         // slope bit
+   g.dy = 36.0;                         // room for axis
+   g.cy = rect.height() - (g.ay + g.by + g.dy);
 
    // Horizontal split into four regions sized ax, bx, cx and dx (right to left)
    //
-   const double ax = 20.0;                // gap at left
-   const double bx = numberRows * dsx;    // slope bit
-   const double dx = 52.0;                // room for axis
-   const double cx = rect.width() - (ax + bx + dx);
+   g.ax = 20.0;                         // gap at left
+   g.bx = g.numberRows * g.dsx;         // slope bit
+   g.dx = 52.0;                         // room for axis
+   g.cx = rect.width() - (g.ax + g.bx + g.dx);
 
    // Now we can calculate scalin4g for form y = m.x + c
    //
-   const double yScale = -cy / (max - min);      // -ve because +y is downwards.
-   const double yOffset = (ay + by) - yScale*max;
+   g.yScale = -g.cy / (g.max - g.min);      // -ve because +y is downwards.
+   g.yOffset = (g.ay + g.by) - g.yScale*g.max;
 
-   const double xScale = +cx / (numberCols - 1.0);
-   const double xOffset = dx - xScale * 0;
+   g.xScale = +g.cx / (g.numberCols - 1.0);
+   g.xOffset = g.dx - g.xScale * 0;
 
-   QPointF rowDelta = QPointF (+dsx, -dsy);      // y -ve because +y is downwards.
+   g.rowDelta = QPointF (+g.dsx, -g.dsy);      // y -ve because +y is downwards.
 
    // Rear points on the bounding cuboid.
    //
@@ -239,136 +274,387 @@ void QEWaterfall::paintWaterfall ()
    //    |/                                  /
    //    1----------------------------------7
    //
-   const QPointF k1 = QPointF (dx, ay + by + cy);
-   const QPointF k2 = QPointF (dx, ay + by);
-   const QPointF k3 = QPointF (dx + bx, ay);
-   const QPointF k4 = QPointF (dx + bx, ay + cy);
-   const QPointF k5 = QPointF (dx + cx + bx, ay);
-   const QPointF k6 = QPointF (dx + cx + bx, ay + cy);
-   const QPointF k7 = QPointF (dx + cx, ay + by + cy);
+   g.k1 = QPointF (g.dx, g.ay + g.by + g.cy);
+   g.k2 = QPointF (g.dx, g.ay + g.by);
+   g.k3 = QPointF (g.dx + g.bx, g.ay);
+   g.k4 = QPointF (g.dx + g.bx, g.ay + g.cy);
+   g.k5 = QPointF (g.dx + g.cx + g.bx, g.ay);
+   g.k6 = QPointF (g.dx + g.cx + g.bx, g.ay + g.cy);
+   g.k7 = QPointF (g.dx + g.cx, g.ay + g.by + g.cy);
+}
+
+//------------------------------------------------------------------------------
+// Each trace has an identity, used to find the pixels drawn by that trace.
+// For 1D data, this is associated with the data set, so that it is preserved
+// as the traces scroll.
+//
+int QEWaterfall::traceSequence (const Geometry& g, const int row) const
+{
+   const int coRow = g.numberRows - 1 - row;
+   return (g.dataFormat == array1D) ? this->getUpdateCount() - coRow : coRow;
+}
 
-   // Start painting and drawing.
+//------------------------------------------------------------------------------
+// The identity is encoded as a non-zero RGB value.
+// static
+QRgb QEWaterfall::traceId (const int sequence)
+{
+   const int limit = 0xFFFFFF;
+   return 0xFF000000 | QRgb (((sequence % limit) + limit) % limit + 1);
+}
+
+//------------------------------------------------------------------------------
+// Calculates the trace polyline for the given display row. When decimate is
+// true and there are more points than pixels, each pixel column is reduced to
+// the first, minimum, maximum and last points, which preserves the visible
+// extent of the trace.
+//
+QPolygonF QEWaterfall::traceLine (const Geometry& g, const int row,
+                                  const bool decimate) const
+{
+   const int numberCols = g.numberCols;
+   const int coRow = g.numberRows - 1 - row;
+
+   QVector<double> values (numberCols);
+   this->getDisplayedRowValues (row, 0, numberCols, values.data(), g.min);
+
+   // Calc the offset applies to each row.
    //
-   // Fill background.
+   const QPointF offset = (coRow + 0.5) * g.rowDelta;
+
+   QPolygonF line;
+
+   const int pixels = int (g.cx * g.pixelRatio);
+   if (!decimate || (numberCols <= 2 * pixels)) {
+      line.reserve (numberCols);
+      for (int col = 0; col < numberCols; col++) {
+         // col is the x coordinate, value is the y coordinate.
+         //
+         QPointF item = QPointF (col           * g.xScale + g.xOffset,
+                                 values [col]  * g.yScale + g.yOffset);
+         item += offset;
+         line.append (item);
+      }
+      return line;
+   }
+
+   line.reserve (4 * (pixels + 1));
+
+   int col = 0;
+   while (col < numberCols) {
+      // Find the extent of this pixel column.
+      //
+      const int pixel = int (col * g.xScale * g.pixelRatio);
+      int last = col;
+      int minCol = col;
+      int maxCol = col;
+      while ((last + 1 < numberCols) &&
+             (int ((last + 1) * g.xScale * g.pixelRatio) == pixel)) {
+         last++;
+         if (values [last] < values [minCol]) minCol = last;
+         if (values [last] > values [maxCol]) maxCol = last;
+      }
+
+      // Add first, min/max in the order they occur, and last - no duplicates.
+      //
+      int cols [4];
+      int n = 0;
+      cols [n++] = col;
+      const int a = MIN (minCol, maxCol);
+      const int b = MAX (minCol, maxCol);
+      if (a != cols [n - 1]) cols [n++] = a;
+      if (b != cols [n - 1]) cols [n++] = b;
+      if (last != cols [n - 1]) cols [n++] = last;
+
+      for (int j = 0; j < n; j++) {
+         QPointF item = QPointF (cols [j]          * g.xScale + g.xOffset,
+                                 values [cols [j]] * g.yScale + g.yOffset);
+         item += offset;
+         line.append (item);
+      }
+
+      col = last + 1;
+   }
+
+   return line;
+}
+
+//------------------------------------------------------------------------------
+// Draws the trace for the given display row into both the trace layer and the
+// trace id layer. No antialiasing is used, so both have the same coverage.
+//
+void QEWaterfall::drawTrace (QPainter& tracePainter, QPainter& idPainter,
+                             const Geometry& g, const int row) const
+{
+   // row 0 is oldest row, row numberRows - 1 is latest row.
    //
-   painter.fillRect (rect, this->mBackgroundColour);
+   const int coRow = g.numberRows - 1 - row;
 
    QPen pen;
+   pen.setWidth (g.penWidth);
    pen.setStyle (Qt::SolidLine);
-   pen.setWidth (1);
-   pen.setColor (penColour);
-   painter.setPen (pen);
 
-   // Draw rear edges of bounding cuboid.
-   //
-   // painter.drawLine (k1, k2);  /// axis
-   painter.drawLine (k2, k3);
-   painter.drawLine (k1, k4);
-   painter.drawLine (k3, k4);
-   painter.drawLine (k3, k5);
-   painter.drawLine (k4, k6);
-   // painter.drawLine (k1, k7);  /// axis
-   painter.drawLine (k5, k6);
-   painter.drawLine (k6, k7);
+   if (g.mutableHue) {
+      int h, s, l;
+      g.traceColour.getHsl (&h, &s, &l);
 
-   const int pw = (this->mTraceWidth >= 1)
-         ? this->mTraceWidth
-         : MAX(1, int ((ds + 4) / 8));
+      // Modify hue - we add a constant 36000 (a somewhat arbitary offset),
+      // becaue % is a remainder operator, not a modulo operator.
+      // For 2D data use a fixed count, for 1D use update cout so that
+      // same hue assoicated with the same data set.
+      //
+      int hueOffset = (g.dataFormat == array1D) ? this->getUpdateCount() : 0;
+      h += (12 * (36000 + hueOffset - coRow)) % 360;
 
-   pen.setWidth (pw);
-   pen.setColor (this->mTraceColour);
-   pen.setStyle (Qt::SolidLine);
+      QColor c;
+      c.setHsl (h, s, l);
+      pen.setColor (c);
+   } else {
+      pen.setColor (g.traceColour);
+   }
 
-   QBrush brush;
-   brush.setStyle (Qt::SolidPattern);
-   brush.setColor (this->mBackgroundColour);
+   const QPolygonF line = this->traceLine (g, row, true);
 
-   QEWaterfall::PosToSrcMap::clear (this);
+   tracePainter.setPen (pen);
+   tracePainter.drawPolyline (line);
 
-   for (int row = 0; row < numberRows; row++) {
-      // row 0 is oldest row, row numberRows - 1 is latest row.
-      //
-      const int coRow = numberRows - 1 - row;
+   pen.setColor (QColor::fromRgb (QEWaterfall::traceId (this->traceSequence (g, row))));
+   idPainter.setPen (pen);
+   idPainter.drawPolyline (line);
+}
+
+//------------------------------------------------------------------------------
+// Full redraw of the background, trace and trace id layers.
+//
+void QEWaterfall::renderLayers (const Geometry& g)
+{
+   const QSize deviceSize = g.size * g.pixelRatio;
 
-      if (this->mMutableHue) {
-         int h, s, l;
-         this->mTraceColour.getHsl (&h, &s, &l);
+   // Fill background and draw rear edges of bounding cuboid.
+   //
+   this->backgroundLayer = QImage (deviceSize, QImage::Format_RGB32);
+   this->backgroundLayer.setDevicePixelRatio (g.pixelRatio);
+   this->backgroundLayer.fill (g.backgroundColour);
+   {
+      QPainter painter (&this->backgroundLayer);
+
+      QPen pen;
+      pen.setStyle (Qt::SolidLine);
+      pen.setWidth (1);
+      pen.setColor (g.penColour);
+      painter.setPen (pen);
 
-         // Modify hue - we add a constant 36000 (a somewhat arbitary offset),
-         // becaue % is a remainder operator, not a modulo operator.
-         // For 2D data use a fixed count, for 1D use update cout so that
-         // same hue assoicated with the same data set.
-         //
-         int hueOffset = (this->getDataFormat () == array1D) ? this->getUpdateCount() : 0;
-         h += (12 * (36000 + hueOffset - coRow)) % 360;
-
-         QColor c;
-         c.setHsl (h, s, l);
-         pen.setColor (c);
-      } else {
-         pen.setColor (this->mTraceColour);
+      // painter.drawLine (k1, k2);  /// axis
+      painter.drawLine (g.k2, g.k3);
+      painter.drawLine (g.k1, g.k4);
+      painter.drawLine (g.k3, g.k4);
+      painter.drawLine (g.k3, g.k5);
+      painter.drawLine (g.k4, g.k6);
+      // painter.drawLine (k1, k7);  /// axis
+      painter.drawLine (g.k5, g.k6);
+      painter.drawLine (g.k6, g.k7);
+   }
+
+   // Draw the traces, oldest first.
+   //
+   this->traceLayer = QImage (deviceSize, QImage::Format_ARGB32_Premultiplied);
+   this->traceLayer.setDevicePixelRatio (g.pixelRatio);
+   this->traceLayer.fill (Qt::transparent);
+
+   this->traceIdLayer = QImage (deviceSize, QImage::Format_RGB32);
+   this->traceIdLayer.setDevicePixelRatio (g.pixelRatio);
+   this->traceIdLayer.fill (0);
+   {
+      QPainter tracePainter (&this->traceLayer);
+      QPainter idPainter (&this->traceIdLayer);
+      for (int row = 0; row < g.numberRows; row++) {
+         this->drawTrace (tracePainter, idPainter, g, row);
       }
+   }
 
-      QPolygonF line;
-      line.reserve (numberCols);
+   this->layerGeometry = g;
+   this->layerUpdateCount = this->getUpdateCount();
+   this->layersAreValid = true;
+}
 
-      // Calc the offset applies to each row.
-      //
-      const QPointF offset = (coRow + 0.5) * rowDelta;
+//------------------------------------------------------------------------------
+// Returns a copy of the image, shifted by offset (in logical pixels).
+// Vacated pixels are zero, i.e. transparent.
+//
+QImage QEWaterfall::shiftedImage (const QImage& image, const QPoint& offset) const
+{
+   QImage result (image.size(), image.format());
+   result.setDevicePixelRatio (image.devicePixelRatio());
+   result.fill (0);
 
-      for (int col = 0; col < numberCols; col++) {
+   QPainter painter (&result);
+   painter.setCompositionMode (QPainter::CompositionMode_Source);
+   painter.drawImage (offset, image);
+   return result;
+}
 
-         double value = this->getValue (row, col, min);
+//------------------------------------------------------------------------------
+// Incremental update - only applicable when a new 1D data set has been added
+// and the existing traces have scrolled by one trace towards the rear.
+// Returns false if a full redraw is required.
+//
+bool QEWaterfall::scrollLayers (const Geometry& g)
+{
+   if (!this->layersAreValid) return false;
+   if (!QEWaterfall::isSameSettings (g, this->layerGeometry)) return false;
+   if (g.numberRows < 2) return false;
 
-         // col is the x coordinate, value is the y coordinate.
-         //
-         QPointF item = QPointF (col   * xScale + xOffset,
-                                 value * yScale + yOffset);
-         item += offset;
-         line.append (item);
+   // Whole device pixel shifts only.
+   //
+   if (g.pixelRatio != double (int (g.pixelRatio))) return false;
 
-         // Insert plot info into look up structure.
-         //
-         QEWaterfall::PosToSrcMap lookUp (int (item.x()), int (item.y()), row, col);
-         lookUp.insert (this);
+   // Traces identities depend on the update count.
+   //
+   if (this->getUpdateCount() != this->layerUpdateCount + 1) return false;
+
+   // The front (latest) row must be the only new row, and all other rows
+   // must have moved back one row.
+   //
+   int rowShift;
+   int colShift;
+   QRect changed;
+   if (!this->getScrollUpdate (rowShift, colShift, changed)) return false;
+   if ((rowShift != -1) || (colShift != 0)) return false;
+   if (changed != QRect (0, g.numberRows - 1, g.numberCols, 1)) return false;
+
+   // The oldest trace, as rendered, now falls off the back.
+   //
+   const int droppedSequence = this->layerUpdateCount - (g.numberRows - 1);
+   const QRgb droppedId = QEWaterfall::traceId (droppedSequence) & 0xFFFFFF;
+
+   // Move the traces back by one trace.
+   //
+   const QPoint offset = QPoint (int (g.dsx), int (-g.dsy));
+   this->traceLayer = this->shiftedImage (this->traceLayer, offset);
+   this->traceIdLayer = this->shiftedImage (this->traceIdLayer, offset);
+
+   // Erase the pixels where the dropped trace is still visible.
+   // Being the rearmost trace, there is nothing else under it.
+   //
+   const int width = this->traceIdLayer.width();
+   const int height = this->traceIdLayer.height();
+   for (int y = 0; y < height; y++) {
+      QRgb* idLine = (QRgb*) this->traceIdLayer.scanLine (y);
+      QRgb* traceLine = (QRgb*) this->traceLayer.scanLine (y);
+      for (int x = 0; x < width; x++) {
+         if ((idLine [x] & 0xFFFFFF) == droppedId) {
+            idLine [x] = 0;
+            traceLine [x] = 0;
+         }
       }
+   }
 
-      painter.setPen (pen);
-      painter.setBrush (brush);
-      painter.drawPolyline (line);
+   // And draw the new trace on top.
+   //
+   {
+      QPainter tracePainter (&this->traceLayer);
+      QPainter idPainter (&this->traceIdLayer);
+      this->drawTrace (tracePainter, idPainter, g, g.numberRows - 1);
    }
 
+   this->layerUpdateCount = this->getUpdateCount();
+   return true;
+}
+
+//------------------------------------------------------------------------------
+// Composites the layers, the front cuboid edges and the axes.
+//
+void QEWaterfall::renderComposite (const Geometry& g)
+{
+   this->composite = QPixmap (g.size * g.pixelRatio);
+   this->composite.setDevicePixelRatio (g.pixelRatio);
+
+   QPainter painter (&this->composite);
+   painter.drawImage (0, 0, this->backgroundLayer);
+   painter.drawImage (0, 0, this->traceLayer);
+
    // Re-draw the bounding edges that can get "zapped".
    //
+   QPen pen;
+   pen.setStyle (Qt::SolidLine);
    pen.setWidth (1);
-   pen.setColor (penColour);
+   pen.setColor (g.penColour);
    painter.setPen (pen);
-   painter.drawLine (k5, k6);
-   painter.drawLine (k6, k7);
+   painter.drawLine (g.k5, g.k6);
+   painter.drawLine (g.k6, g.k7);
 
    // Now do the axis.
    //
+   this->xAxis->setPenColour (g.penColour);
+   this->yAxis->setPenColour (g.penColour);
+
    double minOut, maxOut, majorOut;
 
-   QEDisplayRanges xRange (0.0, numberCols - 1);
+   QEDisplayRanges xRange (0.0, g.numberCols - 1);
    xRange.adjustMinMax (5, true, minOut, maxOut, majorOut);
    this->xAxis->setMinimum (0);
-   this->xAxis->setMaximum (numberCols);
+   this->xAxis->setMaximum (g.numberCols);
    this->xAxis->setMinorInterval (majorOut / 5.0); // Default major minor ratio is 5
 
-   QRect xAxisArea (dx -   axisIndents, ay + by + cy,
-                    cx + 2*axisIndents, dy);
+   QRect xAxisArea (g.dx -   axisIndents, g.ay + g.by + g.cy,
+                    g.cx + 2*axisIndents, g.dy);
    this->xAxis->paint (painter, 8, xAxisArea);
 
-   QEDisplayRanges yRange (min, max);
+   QEDisplayRanges yRange (g.min, g.max);
    yRange.adjustMinMax (5, true, minOut, maxOut, majorOut);
    this->yAxis->setMinimum (minOut);
    this->yAxis->setMaximum (maxOut);
    this->yAxis->setMinorInterval (majorOut / 5.0); // Default major minor ratio is 5
 
-   QRect yAxisArea (0,  ay + by - axisIndents,
-                    dx, cy      + 2*axisIndents);
+   QRect yAxisArea (0,  g.ay + g.by - axisIndents,
+                    g.dx, g.cy      + 2*axisIndents);
    this->yAxis->paint (painter, 8, yAxisArea);
+
+   this->compositeIsValid = true;
+}
+
+//------------------------------------------------------------------------------
+// Rebuilds the pixel position to data source look up structure.
+// This uses every point, not the decimated trace lines.
+//
+void QEWaterfall::rebuildPosToSrcMap (const Geometry& g)
+{
+   QEWaterfall::PosToSrcMap::clear (this);
+
+   for (int row = 0; row < g.numberRows; row++) {
+      const QPolygonF line = this->traceLine (g, row, false);
+      for (int col = 0; col < line.count(); col++) {
+         const QPointF item = line.at (col);
+         QEWaterfall::PosToSrcMap lookUp (int (item.x()), int (item.y()), row, col);
+         lookUp.insert (this);
+      }
+   }
+
+   this->mapIsValid = true;
+}
+
+//------------------------------------------------------------------------------
+// Only redraws what is needed, and then just draws the composite pixmap.
+//
+void QEWaterfall::paintWaterfall ()
+{
+   Geometry g;
+   this->calculateGeometry (g);
+   if (g.size.isEmpty()) return;
+
+   if (!this->layersAreValid ||
+       !QEWaterfall::isSameSettings (g, this->layerGeometry)) {
+      this->renderLayers (g);
+      this->compositeIsValid = false;
+      this->mapIsValid = false;
+   }
+
+   if (!this->compositeIsValid) {
+      this->renderComposite (g);
+   }
+
+   QPainter painter (this->plotArea);
+   painter.drawPixmap (0, 0, this->composite);
 }
 
 //------------------------------------------------------------------------------
@@ -378,6 +664,14 @@ void QEWaterfall::waterfallMouseMove (const QPoint& pos)
    int row;
    int col;
 
+   // The look up structure is only built when needed.
+   //
+   if (!this->mapIsValid) {
+      Geometry g;
+      this->calculateGeometry (g);
+      this->rebuildPosToSrcMap (g);
+   }
+
    // Convert the mosue postion into a data element index - if we can.
    //
    bool found = QEWaterfall::PosToSrcMap::findNearest (this, pos.x(), pos.y(), row, col);
@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2020-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2020-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Starritt
@@ -16,7 +16,13 @@
 
 #include <QColor>
 #include <QHBoxLayout>
+#include <QImage>
 #include <QList>
+#include <QPainter>
+#include <QPixmap>
+#include <QPointF>
+#include <QPolygonF>
+#include <QSize>
 #include <QString>
 #include <QWidget>
 #include <QEAbstract2DData.h>
@@ -118,10 +124,77 @@ protected:
    void updateDataVisulation ();   // hook function
 
 private:
+   // All the values required to render the waterfall. The first group are the
+   // settings which, if changed, require a full redraw.
+   //
+   struct Geometry {
+      QSize size;
+      double pixelRatio;
+      int numberRows;
+      int numberCols;
+      double min;
+      double max;
+      int angle;
+      int traceGap;
+      int penWidth;
+      QColor traceColour;
+      QColor backgroundColour;
+      bool mutableHue;
+      DataFormats dataFormat;
+
+      // Derived values.
+      //
+      QColor penColour;
+      double dsx;                      // whole pixels
+      double dsy;                      // whole pixels
+      double ay, by, cy, dy;
+      double ax, bx, cx, dx;
+      double xScale, xOffset;
+      double yScale, yOffset;
+      QPointF rowDelta;
+      QPointF k1, k2, k3, k4, k5, k6, k7;
+   };
+
+   static bool isSameSettings (const Geometry& a, const Geometry& b);
+
    void commonSetup ();
    void waterfallMouseMove (const QPoint& pos);
    void paintWaterfall ();
 
+   void calculateGeometry (Geometry& g) const;
+   void renderLayers (const Geometry& g);
+   bool scrollLayers (const Geometry& g);
+   void renderComposite (const Geometry& g);
+   void rebuildPosToSrcMap (const Geometry& g);
+   void drawTrace (QPainter& tracePainter, QPainter& idPainter,
+                   const Geometry& g, const int row) const;
+   QPolygonF traceLine (const Geometry& g, const int row,
+                        const bool decimate) const;
+   int traceSequence (const Geometry& g, const int row) const;
+   static QRgb traceId (const int sequence);
+   QImage shiftedImage (const QImage& image, const QPoint& offset) const;
+
+   // Retained mode rendering. The background (fill and rear cuboid edges) and
+   // the traces are rendered into separate offscreen layers. These, together
+   // with the front cuboid edges and the axes, are composited into a pixmap,
+   // and paint events just draw the pixmap.
+   //
+   // When a new 1D data set arrives and the traces have simply scrolled, the
+   // trace layer is shifted by one trace offset, the oldest trace is erased,
+   // and only the new trace is drawn. The trace id layer holds the identity of
+   // the trace drawn at each pixel, which allows the oldest trace to be erased.
+   // All layers are redrawn when any of the geometry settings change.
+   //
+   QImage backgroundLayer;
+   QImage traceLayer;
+   QImage traceIdLayer;
+   QPixmap composite;
+   Geometry layerGeometry;           // used to render the layers
+   int layerUpdateCount;
+   bool layersAreValid;
+   bool compositeIsValid;
+   bool mapIsValid;                  // PosToSrcMap - rebuilt on demand
+
    // The display area is split into 20 x 40 grid into which each display point
    // is allocated. See PosToSrcMap for more detail.
    //
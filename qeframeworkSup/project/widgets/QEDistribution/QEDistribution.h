@@ -82,6 +82,21 @@ public:
    /// Index used to select a single item of data for processing. The default is 0.
    ///
    Q_PROPERTY (int arrayIndex READ getArrayIndex WRITE setArrayIndex)
+
+   /// Absolute deadband. Numeric updates within this deadband of the last value
+   /// presented are not passed on to the widget. The default is 0.0, i.e. no deadband.
+   ///
+   Q_PROPERTY (double deadband READ getDeadband WRITE setDeadband)
+
+   /// Relative deadband, expressed as a percentage of the last value presented.
+   /// The default is 0.0, i.e. no deadband.
+   ///
+   Q_PROPERTY (double relativeDeadband READ getRelativeDeadband WRITE setRelativeDeadband)
+
+   /// Maximum rate (Hz) at which updates are passed on to the widget. The most recent
+   /// value is always presented eventually. The default is 0.0, i.e. no limit.
+   ///
+   Q_PROPERTY (double maxUpdateRate READ getMaxUpdateRate WRITE setMaxUpdateRate)
    //
    // END-SINGLE-VARIABLE-V2-PROPERTIES =================================================
 
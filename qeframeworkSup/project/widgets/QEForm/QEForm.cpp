@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2009-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2009-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Rhyder
@@ -29,14 +29,18 @@
 
 #include "QEForm.h"
 #include <QDebug>
-#include <QUiLoader>
 #include <QString>
 #include <QDir>
 #include <QFileInfo>
 #include <QMetaType>
 #include <QVBoxLayout>
 #include <QPainter>
+#include <QShowEvent>
+#include <QEAdaptationParameters.h>
 #include <QEScaling.h>
+#include <QEUiTemplateCache.h>
+#include <QEStartupProfiler.h>
+#include <QEChannelOpenScheduler.h>
 #include <ContainerProfile.h>
 #include <QEPlatform.h>
 #include <QEWidget.h>
@@ -102,12 +106,18 @@ void QEForm::commonInit( const bool alertIfUINoFoundIn, const bool loadManuallyI
 
    this->savedCurrentPath = "";
 
+   this->profileId = 0;   // remains 0 unless startup profiling enabled
+
    this->setAcceptDrops(true);
 
    this->ui = NULL;
 
    this->placeholderLabel = NULL;
 
+   this->deferLoadUntilShown = false;
+   this->loadIsDeferred = false;
+   this->loadIsPending = false;
+
    this->disconnectedCountRef = NULL;
    this->connectedCountRef = NULL;
 
@@ -160,6 +170,9 @@ QEForm::~QEForm()
    // Close any existing form
    if( this->ui )
       this->ui->close();
+
+   // Ensure the startup profile summary is output, even if incomplete.
+   QEStartupProfiler::formClosed( this->profileId );
 }
 
 //------------------------------------------------------------------------------
@@ -203,6 +216,7 @@ void QEForm::establishConnection( unsigned int variableIndex )
       // been processed. It may be loaded immediately by calling readUiFile() now,
       // but this keeps things a bit more interactive.
       this->uiFileName = newFileName;
+      this->loadIsPending = true;
       QTimer::singleShot( 0, this, SLOT(reloadLater()));
    }
 }
@@ -219,6 +233,22 @@ void QEForm::clearUiFileNames ()
 // Load the form once all events have been processed.
 void QEForm::reloadLater()
 {
+   // Nothing to do if already loaded in the mean time, e.g. by a restore.
+   if( !this->loadIsPending && !this->loadIsDeferred )
+   {
+      return;
+   }
+   this->loadIsPending = false;
+
+   // An embedded form that will not be visible when its window is shown, e.g. one
+   // on a non-current tab, may defer loading until it is first shown.
+   if( this->isLoadDeferrable() && !this->isVisibleTo( this->window() ) )
+   {
+      this->loadIsDeferred = true;
+      this->displayPlaceholder( QString( "Load deferred until shown: " ).append( this->uiFileName ) );
+      return;
+   }
+
    // Load the form
    readUiFile();
 
@@ -253,6 +283,10 @@ void QEForm::reloadLater()
 // The file read depends on the value of uiFileName
 bool QEForm::readUiFile()
 {
+   // Any deferred or pending load is now moot.
+   this->loadIsDeferred = false;
+   this->loadIsPending = false;
+
    // Close any pre-existing gui in the form
    if( this->ui )
    {
@@ -264,6 +298,10 @@ bool QEForm::readUiFile()
    bool fileLoaded = false;
    this->savedCurrentPath = "";
 
+   // Any previous load profile is now finished with.
+   QEStartupProfiler::formClosed( this->profileId );
+   this->profileId = 0;
+
    // If no name has been provided...
    if (this->uiFileName.isEmpty())
    {
@@ -278,7 +316,9 @@ bool QEForm::readUiFile()
 
       // Try to open the UI file
       QString substitutedFileName =  substituteThis( uiFileName );
+      this->profileId = QEStartupProfiler::beginForm( substitutedFileName );
       QFile* uiFile = openQEFile( substitutedFileName, QIODevice::ReadOnly );
+      QEStartupProfiler::mark( this->profileId, QEStartupProfiler::Open );
 
       // If the file was not found and opened, notify as appropriate
       if( !uiFile )
@@ -354,13 +394,12 @@ bool QEForm::readUiFile()
          // Clear any placeholder
          clearPlaceholder();
 
-         // Load the gui
-         QUiLoader loader;
-
+         // Load the gui. The template cache avoids re-reading the ui file for
+         // each and every instance of a form, e.g. within a QEFormGrid.
          if( isResourceFile ) {
             // Just load it.
             //
-            this->ui = loader.load( uiFile );
+            this->ui = QEUiTemplateCache::load( uiFile, this->fullUiFileName );
          } else {
             // This is a regular file.
             // Change the current directory to the directory holding the ui file before
@@ -378,13 +417,14 @@ bool QEForm::readUiFile()
             bool b = QDir::setCurrent( loaderPath );
             if (!b) DEBUG << "set loader path " << loaderPath << " failed";
 
-            this->ui = loader.load( uiFile );
+            this->ui = QEUiTemplateCache::load( uiFile, this->fullUiFileName );
 
             // Now reset the current path back to where we were.
             //
             this->resetCurrentPath();
          }
          uiFile->close();
+         QEStartupProfiler::mark( this->profileId, QEStartupProfiler::Load );
 
          if( !ui )
          {
@@ -393,11 +433,13 @@ bool QEForm::readUiFile()
          }
 
          // Apply scaling. This may be re-applied if this is an embedded QEForm, but
-         // function is idempotent as can be applied one or more times. However on
-         // the first call it also captures baseline scaling info and we need to do
-         // this as soon as possble post construction prior to any other manipulation.
+         // function is idempotent as can be applied one or more times, and skips this
+         // sub-tree if already scaled. However on the first call it also captures
+         // baseline scaling info and we need to do this as soon as possble post
+         // construction prior to any other manipulation.
          //
          QEScaling::applyToWidget( ui );
+         QEStartupProfiler::mark( this->profileId, QEStartupProfiler::Scale );
 
          // Set the window title (performing macro substitutions if required)
          this->setupWindowTitle( uiFile->fileName() );
@@ -431,6 +473,10 @@ bool QEForm::readUiFile()
          // Note, this is only required when QE widgets are not loaded within a form and not directly by 'designer'.
          // When loaded directly by 'designer' they are activated (a CA connection is established) as soon as either
          // the variable name or variable name substitution properties are set
+         //
+         // Channel open requests are batched until the ui has been added to the
+         // form, so that the channels of visible widgets can be opened first.
+         QEChannelOpenScheduler::beginBatch();
          if( !getDontActivateYet() )
          {
             QEWidget* containedWidget;
@@ -445,6 +491,7 @@ bool QEForm::readUiFile()
                containedWidget->activate();
             }
          }
+         QEStartupProfiler::mark( this->profileId, QEStartupProfiler::Activate );
 
          // If the published profile was published within this method, release it so nothing created later tries to use this object's services
          if( localProfile )
@@ -513,6 +560,10 @@ bool QEForm::readUiFile()
             lo->addWidget( ui );
          }
 
+         // Now action the batched channel open requests.
+         QEChannelOpenScheduler::endBatch();
+         QEStartupProfiler::mark( this->profileId, QEStartupProfiler::Finalise );
+
          // Release the QFile
          delete uiFile;
          uiFile = NULL;
@@ -523,6 +574,8 @@ bool QEForm::readUiFile()
       }
    }
 
+   QEStartupProfiler::endForm( this->profileId );
+
    // Signal the form has finished loading the .ui file. fileLoaded is true if reading the .ui file was successfull.
    // This signal is required since the loading completes in an event.
    emit formLoaded( fileLoaded );
@@ -716,6 +769,9 @@ void QEForm::fileChanged ( const QString & /*path*/ )
       // Ensure we aren't monitoring files any more
       this->fileMon.clearPath();
 
+      // Ensure the cached ui template is not used.
+      QEUiTemplateCache::invalidate( this->fullUiFileName );
+
       // Reload the file
       this->reloadFile();
    }
@@ -759,6 +815,47 @@ void QEForm::resizeEvent ( QResizeEvent * event )
    }
 }
 
+//------------------------------------------------------------------------------
+// The form is being shown.
+// Load the form if loading was deferred until the form was first shown.
+void QEForm::showEvent( QShowEvent* event )
+{
+   QEAbstractWidget::showEvent( event );
+
+   if( this->loadIsDeferred )
+   {
+      // As per establishConnection, load once all events have been processed.
+      QTimer::singleShot( 0, this, SLOT(reloadLater()));
+   }
+}
+
+//------------------------------------------------------------------------------
+// Only embedded forms that load themselves when activated may defer loading,
+// and never when in designer.
+bool QEForm::isLoadDeferrable() const
+{
+   if( this->loadManually || this->inDesigner() || !this->parentWidget() )
+      return false;
+
+   return this->deferLoadUntilShown || QEForm::deferEmbeddedFormsIsEnabled();
+}
+
+//------------------------------------------------------------------------------
+// [static]
+bool QEForm::deferEmbeddedFormsIsEnabled()
+{
+   static bool determined = false;
+   static bool enabled = false;
+
+   if( !determined )
+   {
+      QEAdaptationParameters ap( "QE_" );
+      enabled = ap.getBool( "defer_embedded_forms" );
+      determined = true;
+   }
+   return enabled;
+}
+
 //------------------------------------------------------------------------------
 // Get the version of the framework that loaded this form.
 // Note this may vary within the same application.
@@ -912,6 +1009,29 @@ bool QEForm::getResizeContents() const
    return this->resizeContents;
 }
 
+//------------------------------------------------------------------------------
+// Flag indicating an embedded form should defer loading its .ui file until
+// the form is first shown.
+//
+void QEForm::setDeferLoadUntilShown( bool deferLoadUntilShownIn )
+{
+   this->deferLoadUntilShown = deferLoadUntilShownIn;
+}
+
+//------------------------------------------------------------------------------
+//
+bool QEForm::getDeferLoadUntilShown() const
+{
+   return this->deferLoadUntilShown;
+}
+
+//------------------------------------------------------------------------------
+//
+bool QEForm::isLoadDeferred() const
+{
+   return this->loadIsDeferred;
+}
+
 //------------------------------------------------------------------------------
 // Save configuration
 void QEForm::saveConfiguration( PersistanceManager* pm )
@@ -1020,13 +1140,69 @@ void QEForm::restoreConfiguration( PersistanceManager* pm, restorePhases restore
       }
    }
 
-   // Reload the file in the correct environment if the environment it was created in was not correct
+   // Reload the file in the correct environment if the environment it was created in was not correct.
+   // If loading has been deferred, load the form now so that the widgets it contains exist and
+   // can restore their own configuration.
+   const bool wasDeferred = this->loadIsDeferred;
    if( environmentChanged )
    {
       this->setupProfile( getGuiLaunchConsumer(), pathList, getParentPath(), macroSubstitutions );
       this->reloadFile();
       this->releaseProfile();
    }
+   else if( wasDeferred )
+   {
+      this->readUiFile();
+   }
+
+   if( wasDeferred )
+   {
+      this->setEmbeddedFileMonitoringIsEnabled( this, this->fileMonitoringIsEnabled );
+      this->restoreContainedWidgets( pm );
+   }
+}
+
+//------------------------------------------------------------------------------
+// The QE widgets within a deferred form that has just been loaded during a restore
+// were not around when the restore signal was emitted, so we restore them here.
+void QEForm::restoreContainedWidgets( PersistanceManager* pm )
+{
+   this->loadNestedForms();
+
+   QList<QWidget*> widgets = this->findChildren<QWidget*>();
+   for( int j = 0; j < widgets.count(); j++ )
+   {
+      QEWidget* qewidget = dynamic_cast <QEWidget*>( widgets.value( j ) );
+      if( qewidget )
+      {
+         qewidget->restoreConfiguration( pm, FRAMEWORK );
+      }
+   }
+}
+
+//------------------------------------------------------------------------------
+// Any forms nested within a form that has just been loaded are only loaded once all
+// events have been processed, or are deferred until shown. Load them now so that
+// the widgets they contain exist when restoring. Loading a form may create further
+// nested forms, so keep going until there are none left to load.
+void QEForm::loadNestedForms()
+{
+   bool loaded = true;
+   while( loaded )
+   {
+      loaded = false;
+      QList<QEForm*> forms = this->findChildren<QEForm*>();
+      for( int j = 0; j < forms.count(); j++ )
+      {
+         QEForm* form = forms.value( j );
+         if( form->loadIsPending || form->loadIsDeferred )
+         {
+            form->readUiFile();
+            form->setEmbeddedFileMonitoringIsEnabled( form, form->fileMonitoringIsEnabled );
+            loaded = true;
+         }
+      }
+   }
 }
 
 //------------------------------------------------------------------------------
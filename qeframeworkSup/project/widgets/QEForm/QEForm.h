@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2009-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2009-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Rhyder
@@ -55,6 +55,12 @@ public:
    void setResizeContents( bool resizeContentsIn );                 /// Set flag indicating form should resize contents to match form size (otherwise resize form to match contents)
    bool getResizeContents() const;                                  /// Get flag indicating form should resize contents to match form size (otherwise resize form to match contents)
 
+   void setDeferLoadUntilShown( bool deferLoadUntilShownIn );       /// Set flag indicating an embedded form should defer loading its .ui file until first shown
+   bool getDeferLoadUntilShown() const;                             /// Get flag indicating an embedded form should defer loading its .ui file until first shown
+   bool isLoadDeferred() const;                                     /// Returns true if the form is waiting to be shown before loading its .ui file
+
+   static bool deferEmbeddedFormsIsEnabled();                       /// Returns true if the QE_DEFER_EMBEDDED_FORMS adaptation parameter is set, i.e. all embedded forms defer loading until first shown
+
    QString getContainedFrameworkVersion() const;                    /// Get the version of the first QE widget (if any) of QE widgets by QUILoader
    QString getUniqueIdentifier() const;                             /// Get a unique identifier string for this form. This identifier should be persistant across application runs as it is based on the QEForm's position in the widget hierarchy. The same widget will generate the same identifier when opened within the same GUI.
    void setUniqueIdentifier( QString name );                        /// Set a unique identifier string for this form. This identifier should be persistant across application runs as it is based on the QEForm's position in the widget hierarchy. The same widget will generate the same identifier when opened within the same GUI.
@@ -91,6 +97,7 @@ protected:
    // no implementation - void setVariableNameSubstitutions( QString variableNameSubstitutionsIn );
    bool handleGuiLaunchRequests;
    bool resizeContents;
+   bool deferLoadUntilShown;
 
 private:
    static void setEmbeddedFileMonitoringIsEnabled( QWidget* widget, bool fileMonitoringIsEnabled );
@@ -103,9 +110,11 @@ private:
    bool fileMonitoringIsEnabled; // Only when true  does form honor any fileChanged signals from fileMon.
    QEFileMonitor fileMon;
    QString savedCurrentPath;
+   int profileId;                // Startup profile id, 0 when not profiling
 
    void newMessage( QString msg, message_types type );
    void resizeEvent ( QResizeEvent * event );
+   void showEvent ( QShowEvent * event );  // Loads the form if loading was deferred until shown
    unsigned int childMessageFormId;
 
    QString containedFrameworkVersion;
@@ -134,6 +143,12 @@ private:
 
    bool loadManually;                                          // Set true when QEForm will be manually loaded by calling QEForm::readUiFile()
 
+   bool isLoadDeferrable() const;                              // True if this is an embedded form that may defer loading until shown
+   void restoreContainedWidgets( PersistanceManager* pm );     // Restore the configuration of the QE widgets created by a deferred load
+   bool loadIsDeferred;                                        // Set true while waiting to be shown before loading the .ui file
+   bool loadIsPending;                                         // Set true while waiting for reloadLater() to load the .ui file
+   void loadNestedForms();                                     // Load any nested forms now, rather than later or when shown
+
 signals:
    void formLoaded( bool fileLoaded );                         // The form has finished loading a .ui file. fileLoaded is true if reading the .ui file was successfull. This signal is required since the loading completes in an event.
 
@@ -174,6 +189,15 @@ public:
    ///
    Q_PROPERTY(bool resizeContents READ getResizeContents WRITE setResizeContents)
 
+   /// If set, an embedded QEForm (i.e. a sub form within another form) that is not visible when its parent form
+   /// is loaded, for example a QEForm on a non-current tab of a QTabWidget, does not load its .ui file, and hence
+   /// does not create any widgets nor connect to any channels, until the QEForm is first shown. Until then a
+   /// placeholder is displayed.
+   /// Defaults to false. Note, all embedded forms defer loading if the QE_DEFER_EMBEDDED_FORMS environment
+   /// variable, or equivalent adaptation parameter, is defined as true.
+   ///
+   Q_PROPERTY(bool deferLoadUntilShown READ getDeferLoadUntilShown WRITE setDeferLoadUntilShown)
+
    /// Widgets or applications that use messages from the framework have the option of filtering on this ID
    /// Messages that the QEForm widget catches with its message filters will be regenerated using this ID
    ///
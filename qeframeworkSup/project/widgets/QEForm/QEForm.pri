@@ -13,10 +13,12 @@
 #
 
 HEADERS += \
-    widgets/QEForm/QEForm.h
+    widgets/QEForm/QEForm.h \
+    widgets/QEForm/QEUiTemplateCache.h
 
 SOURCES += \
-    widgets/QEForm/QEForm.cpp
+    widgets/QEForm/QEForm.cpp \
+    widgets/QEForm/QEUiTemplateCache.cpp
 
 INCLUDEPATH += \
     widgets/QEForm
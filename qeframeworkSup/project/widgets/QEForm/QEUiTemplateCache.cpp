@@ -0,0 +1,264 @@
+/*  QEUiTemplateCache.cpp
+ *
+ *  This file is part of the EPICS QT Framework, initially developed at the
+ *  Australian Synchrotron.
+ *
+ *  SPDX-FileCopyrightText: 2026 Australian Synchrotron
+ *  SPDX-License-Identifier: LGPL-3.0-only
+ *
+ *  Author:     Andrew Starritt
+ *  Maintainer: Andrew Starritt
+ *  Contact:    andrews@ansto.gov.au
+ */
+
+#include "QEUiTemplateCache.h"
+#include <QApplication>
+#include <QBuffer>
+#include <QDebug>
+#include <QFileInfo>
+#include <QStringList>
+#include <QUiLoader>
+#include <QEAdaptationParameters.h>
+#include <QEFileMonitor.h>
+
+#define DEBUG qDebug () << "QEUiTemplateCache" << __LINE__ << __FUNCTION__ << "  "
+
+static bool uiTemplateCacheIsDestroyed = false;
+
+//------------------------------------------------------------------------------
+// static
+bool QEUiTemplateCache::isEnabled ()
+{
+   static bool determined = false;
+   static bool enabled = true;
+
+   if (!determined) {
+      QEAdaptationParameters ap ("QE_");
+      enabled = !ap.getBool ("disable_ui_template_cache");  // default is false
+      determined = true;
+   }
+   return enabled;
+}
+
+//------------------------------------------------------------------------------
+// static
+QEUiTemplateCache* QEUiTemplateCache::singleton ()
+{
+   // As per QECaClientManager, the singleton object created when first needed.
+   //
+   static QEUiTemplateCache instance;
+   return &instance;
+}
+
+//------------------------------------------------------------------------------
+//
+QEUiTemplateCache::QEUiTemplateCache () : QObject (NULL)
+{
+   this->totalBytes = 0;
+   this->hits = 0;
+   this->misses = 0;
+
+   QObject::connect (qApp, SIGNAL (aboutToQuit ()),
+                     this, SLOT   (aboutToQuitHandler ()));
+}
+
+//------------------------------------------------------------------------------
+//
+QEUiTemplateCache::~QEUiTemplateCache ()
+{
+   uiTemplateCacheIsDestroyed = true;
+}
+
+//------------------------------------------------------------------------------
+// static
+QWidget* QEUiTemplateCache::load (QFile* uiFile, const QString& fullPath,
+                                  QWidget* parentWidget)
+{
+   if (!uiFile) return NULL;   // sanity check
+
+   if (uiTemplateCacheIsDestroyed) {
+      QUiLoader loader;
+      return loader.load (uiFile, parentWidget);
+   }
+
+   QEUiTemplateCache* self = QEUiTemplateCache::singleton ();
+   QUiLoader* loader = self->acquireLoader ();
+   QWidget* result = NULL;
+
+   if (QEUiTemplateCache::isEnabled ()) {
+      QByteArray content = self->getContent (uiFile, fullPath);
+      QBuffer buffer (&content);
+      buffer.open (QIODevice::ReadOnly);
+      result = loader->load (&buffer, parentWidget);
+      buffer.close ();
+   } else {
+      result = loader->load (uiFile, parentWidget);
+   }
+
+   self->releaseLoader (loader);
+   return result;
+}
+
+//------------------------------------------------------------------------------
+// Returns cached content if still valid, otherwise reads from the file.
+//
+QByteArray QEUiTemplateCache::getContent (QFile* uiFile, const QString& fullPath)
+{
+   const bool isResourceFile = fullPath.startsWith (":");
+
+   QDateTime lastModified;
+   qint64 size = 0;
+   if (!isResourceFile) {
+      const QFileInfo fileInfo (fullPath);
+      lastModified = fileInfo.lastModified ();
+      size = fileInfo.size ();
+   }
+
+   if (this->cache.contains (fullPath)) {
+      const Entry& entry = this->cache [fullPath];
+      if (isResourceFile ||
+          ((entry.lastModified == lastModified) && (entry.size == size))) {
+         this->hits++;
+         return entry.content;
+      }
+      this->remove (fullPath);   // stale
+   }
+
+   this->misses++;
+
+   Entry entry;
+   entry.content = uiFile->readAll ();
+   entry.lastModified = lastModified;
+   entry.size = size;
+   entry.monitor = NULL;
+
+   if (!isResourceFile) {
+      entry.monitor = new QEFileMonitor (fullPath, this);
+      QObject::connect (entry.monitor, SIGNAL (fileChanged (const QString&)),
+                        this,          SLOT   (fileChanged (const QString&)));
+   }
+
+   this->insert (fullPath, entry);
+   return entry.content;
+}
+
+//------------------------------------------------------------------------------
+//
+void QEUiTemplateCache::insert (const QString& fullPath, const Entry& entry)
+{
+   // Evict oldest entries if needs be to keep within limit.
+   //
+   while (!this->insertOrder.isEmpty () &&
+          (this->totalBytes + entry.content.size () > QEUiTemplateCache::maxCacheBytes)) {
+      this->remove (this->insertOrder.first ());
+   }
+
+   this->cache.insert (fullPath, entry);
+   this->insertOrder.append (fullPath);
+   this->totalBytes += entry.content.size ();
+}
+
+//------------------------------------------------------------------------------
+//
+void QEUiTemplateCache::remove (const QString& fullPath)
+{
+   if (!this->cache.contains (fullPath)) return;
+
+   const Entry entry = this->cache.take (fullPath);
+   this->insertOrder.removeAll (fullPath);
+   this->totalBytes -= entry.content.size ();
+
+   if (entry.monitor) {
+      QObject::disconnect (entry.monitor, NULL, this, NULL);
+      entry.monitor->deleteLater ();
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+QUiLoader* QEUiTemplateCache::acquireLoader ()
+{
+   // Forms may be nested, so a loader is only re-used once released.
+   //
+   if (!this->freeLoaders.isEmpty ()) {
+      return this->freeLoaders.takeLast ();
+   }
+   return new QUiLoader (this);
+}
+
+//------------------------------------------------------------------------------
+//
+void QEUiTemplateCache::releaseLoader (QUiLoader* loader)
+{
+   this->freeLoaders.append (loader);
+}
+
+//------------------------------------------------------------------------------
+// static
+void QEUiTemplateCache::invalidate (const QString& fullPath)
+{
+   if (uiTemplateCacheIsDestroyed) return;
+   QEUiTemplateCache::singleton ()->remove (fullPath);
+}
+
+//------------------------------------------------------------------------------
+// static
+void QEUiTemplateCache::clear ()
+{
+   if (uiTemplateCacheIsDestroyed) return;
+
+   QEUiTemplateCache* self = QEUiTemplateCache::singleton ();
+   while (!self->insertOrder.isEmpty ()) {
+      self->remove (self->insertOrder.first ());
+   }
+}
+
+//------------------------------------------------------------------------------
+// static
+QString QEUiTemplateCache::statistics ()
+{
+   if (uiTemplateCacheIsDestroyed) return "";
+
+   const QEUiTemplateCache* self = QEUiTemplateCache::singleton ();
+
+   QString result;
+   result.append (QString ("entries: %1\n").arg (self->cache.count ()));
+   result.append (QString ("bytes:   %1\n").arg (self->totalBytes));
+   result.append (QString ("hits:    %1\n").arg (self->hits));
+   result.append (QString ("misses:  %1\n").arg (self->misses));
+   result.append (QString ("loaders: %1\n").arg (self->freeLoaders.count ()));
+   return result;
+}
+
+//------------------------------------------------------------------------------
+// static
+void QEUiTemplateCache::dump ()
+{
+   const QStringList lines = QEUiTemplateCache::statistics ().split ("\n");
+   for (int j = 0; j < lines.count(); j++) {
+      if (lines.value (j).isEmpty ()) continue;
+      DEBUG << lines.value (j).toStdString().c_str();   // drop quotes
+   }
+}
+
+//------------------------------------------------------------------------------
+// slot
+void QEUiTemplateCache::fileChanged (const QString& path)
+{
+   this->remove (path);
+}
+
+//------------------------------------------------------------------------------
+// slot
+void QEUiTemplateCache::aboutToQuitHandler ()
+{
+   // Delete the loaders while the application, and hence any loaded designer
+   // plugins, still exist.
+   //
+   while (!this->freeLoaders.isEmpty ()) {
+      delete this->freeLoaders.takeLast ();
+   }
+   QEUiTemplateCache::clear ();
+}
+
+// end
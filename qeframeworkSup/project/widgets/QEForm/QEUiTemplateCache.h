@@ -0,0 +1,110 @@
+/*  QEUiTemplateCache.h
+ *
+ *  This file is part of the EPICS QT Framework, initially developed at the
+ *  Australian Synchrotron.
+ *
+ *  SPDX-FileCopyrightText: 2026 Australian Synchrotron
+ *  SPDX-License-Identifier: LGPL-3.0-only
+ *
+ *  Author:     Andrew Starritt
+ *  Maintainer: Andrew Starritt
+ *  Contact:    andrews@ansto.gov.au
+ */
+
+#ifndef QE_UI_TEMPLATE_CACHE_H
+#define QE_UI_TEMPLATE_CACHE_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QWidget>
+#include <QEFrameworkLibraryGlobal.h>
+
+class QEFileMonitor;   // differed
+class QUiLoader;       // differed
+
+/// The QEUiTemplateCache provides a process wide cache of ui file templates,
+/// keyed by the resolved ui file path and validated using the file's last
+/// modification time and size. The cache is used by QEForm, and hence by
+/// QEFormGrid and QEDynamicFormGrid, so that a ui file used by many forms is
+/// read from disk once, and is re-read only when it changes. Cached entries
+/// are also invalidated by means of a QEFileMonitor.
+///
+/// It also maintains a pool of QUiLoader objects. The construction of a
+/// QUiLoader involves scanning the designer plugin directories, so loaders
+/// are re-used rather than being created for each form.
+///
+/// Note: QUiLoader provides no public means to build widgets from a previously
+/// parsed DOM, so each instantiation parses the cached ui XML from memory.
+///
+/// The cache may be disabled by defining the QE_DISABLE_UI_TEMPLATE_CACHE
+/// environment variable, or equivalent adaptation parameter, as true.
+///
+/// All functions must be called from the main GUI thread.
+///
+class QE_FRAMEWORK_LIBRARY_SHARED_EXPORT QEUiTemplateCache : private QObject {
+   Q_OBJECT
+public:
+   static bool isEnabled ();
+
+   // Creates the widget hierarchy defined by the ui file, which must already
+   // be open for reading. The fullPath is the cleaned absolute file path and
+   // is used as the cache key. Resource files (i.e. those starting with ':')
+   // are cached but never re-validated, as they cannot change.
+   // Returns NULL if the widgets could not be created.
+   //
+   static QWidget* load (QFile* uiFile, const QString& fullPath,
+                         QWidget* parentWidget = NULL);
+
+   // Explicitly removes the path from, or clears, the cache.
+   //
+   static void invalidate (const QString& fullPath);
+   static void clear ();
+
+   // Diagnostics - number of entries, bytes cached, hits and misses.
+   //
+   static QString statistics ();
+   static void dump ();          // diagnostic debug output only.
+
+private:
+   explicit QEUiTemplateCache ();
+   ~QEUiTemplateCache ();
+
+   static QEUiTemplateCache* singleton ();
+
+   struct Entry {
+      QByteArray content;
+      QDateTime lastModified;
+      qint64 size;
+      QEFileMonitor* monitor;    // NULL for resource files
+   };
+
+   // Overall limit on cached content.
+   //
+   static const qint64 maxCacheBytes = 64 * 1024 * 1024;
+
+   QByteArray getContent (QFile* uiFile, const QString& fullPath);
+   void insert (const QString& fullPath, const Entry& entry);
+   void remove (const QString& fullPath);
+
+   QUiLoader* acquireLoader ();
+   void releaseLoader (QUiLoader* loader);
+
+   QHash<QString, Entry> cache;
+   QList<QString> insertOrder;     // oldest first - used for eviction
+   qint64 totalBytes;
+   int hits;
+   int misses;
+
+   QList<QUiLoader*> freeLoaders;
+
+private slots:
+   void fileChanged (const QString& path);
+   void aboutToQuitHandler ();
+};
+
+#endif // QE_UI_TEMPLATE_CACHE_H
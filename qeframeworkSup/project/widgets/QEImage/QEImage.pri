@@ -4,7 +4,7 @@
 # the Australian Synchrotron. This file is included into and as part
 # of the overall framework.pro project file.
 #
-# SPDX-FileCopyrightText: 2017-2025 Australian Synchrotron
+# SPDX-FileCopyrightText: 2017-2026 Australian Synchrotron
 # SPDX-License-Identifier: LGPL-3.0-only
 #
 # Author:     Andrew Starritt
@@ -64,7 +64,8 @@ HEADERS += \
     widgets/QEImage/imageProcessor.h \
     widgets/QEImage/imageProperties.h \
     widgets/QEImage/imageMarkupLegendSetText.h \
-    widgets/QEImage/mpeg.h
+    widgets/QEImage/mpeg.h \
+    widgets/QEImage/yuvConversion.h
 
 
 SOURCES += \
@@ -97,7 +98,8 @@ SOURCES += \
     widgets/QEImage/imageProcessor.cpp \
     widgets/QEImage/imageProperties.cpp \
     widgets/QEImage/imageMarkupLegendSetText.cpp  \
-    widgets/QEImage/mpeg.cpp
+    widgets/QEImage/mpeg.cpp \
+    widgets/QEImage/yuvConversion.cpp
 
 INCLUDEPATH += \
     widgets/QEImage
@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2015-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2015-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Rhyder
@@ -224,6 +224,7 @@ void imageProcessor::buildImage()
                                         pixelHigh,
                                         bitDepth,
                                         pixelLookup,
+                                        fullPixelLookup,
                                         formatOption,
                                         imageDataSize,
                                         imageDisplayProps,
@@ -251,6 +252,7 @@ imagePropertiesCore::imagePropertiesCore( QByteArray imageDataIn,
                                           int pixelHighIn,
                                           unsigned int bitDepthIn,
                                           imageDisplayProperties::rgbPixel* pixelLookupIn,
+                                          const QVector<imageDisplayProperties::rgbPixel>& fullPixelLookupIn,
                                           QE::ImageFormatOptions formatOptionIn,
                                           unsigned long imageDataSizeIn,
                                           imageDisplayProperties* imageDisplayPropsIn,
@@ -266,6 +268,7 @@ imagePropertiesCore::imagePropertiesCore( QByteArray imageDataIn,
     pixelHigh = pixelHighIn;
     bitDepth = bitDepthIn;
     pixelLookup = pixelLookupIn;
+    fullPixelLookup = fullPixelLookupIn;
     formatOption = formatOptionIn;
     imageDataSize = imageDataSizeIn;
     imageDisplayProps = imageDisplayPropsIn;
@@ -417,6 +420,27 @@ QImage imagePropertiesCore::buildImageCore()
     {
         case QE::Mono:
         {
+            // If there is a full depth lookup table covering every possible (masked) pixel value, use it.
+            // It includes the scaling for local brightness and contrast, so each pixel is a single lookup.
+            if( (unsigned long)(fullPixelLookup.size()) > mask )
+            {
+                const imageDisplayProperties::rgbPixel* fullLookup = fullPixelLookup.constData();
+                LOOP_START
+                    unsigned int inPixel;
+
+                    // Extract pixel
+                    inPixel =  (*(unsigned int*) (&dataIn[dataIndex*bytesPerPixel]))&mask;
+
+                    // Accumulate pixel statistics
+                    valP = inPixel;
+                    BUILD_STATS
+
+                    // Select displayed pixel
+                    dataOut[buffIndex] = fullLookup[inPixel];
+                LOOP_END
+                break;
+            }
+
             LOOP_START
                 unsigned int inPixel;
 
@@ -1190,6 +1214,8 @@ int imageProcessor::getScanOption()
 // Generate a lookup table to convert raw pixel values to display pixel values taking into
 // account, clipping, and contrast reversal.
 // Note, the table will be used to translate each colour in an RGB format.
+// For mono images a full depth table is also generated (see getFullPixelTranslation()),
+// but only if any of the settings it depends on have changed.
 //
 void imageProcessor::getPixelTranslation()
 {
@@ -1199,16 +1225,19 @@ void imageProcessor::getPixelTranslation()
     // If there is an image options control, get the relevent options
     bool contrastReversal;
     bool logBrightness;
+    bool falseColour;
 
     if( imageDisplayProps )
     {
         contrastReversal = imageDisplayProps->getContrastReversal();
         logBrightness = imageDisplayProps->getLog();
+        falseColour = imageDisplayProps->getFalseColour();
     }
     else
     {
         contrastReversal = false;
         logBrightness = false;
+        falseColour = false;
     }
 
     // If there is an image options control, and we have retrieved high and low pixels from an image, get the relevent options
@@ -1271,7 +1300,7 @@ void imageProcessor::getPixelTranslation()
             }
 
             // Save translated pixel
-            if( imageDisplayProps->getFalseColour() )
+            if( falseColour )
             {
                 pixelLookup[value] = getFalseColor ((unsigned char)translatedValue);
             }
@@ -1285,9 +1314,67 @@ void imageProcessor::getPixelTranslation()
 
     }
 
+    // Gather the settings the full depth table depends on.
+    // It is only used for mono images, and only when not too deep.
+    pixelTranslationSettings settings;
+    settings.pixelLow = pixelLow;
+    settings.pixelHigh = pixelHigh;
+    settings.fullLookupSize = 0;
+    if( formatOption == QE::Mono && bitDepth <= FULL_PIXEL_LOOKUP_MAX_BITS )
+    {
+        settings.fullLookupSize = maxPixelValue()+1;
+    }
+    settings.clippingOn = clippingOn;
+    settings.clippingLow = clippingLow;
+    settings.clippingHigh = clippingHigh;
+    settings.contrastReversal = contrastReversal;
+    settings.logBrightness = logBrightness;
+    settings.falseColour = falseColour;
+
+    // Regenerate the full depth table if anything it depends on has changed
+    if( settings != fullPixelLookupSettings )
+    {
+        getFullPixelTranslation( settings.fullLookupSize );
+        fullPixelLookupSettings = settings;
+    }
+
     return;
 }
 
+// Generate a lookup table to convert every possible raw pixel value directly to a display pixel value.
+// This combines the scaling for local brightness and contrast with the 8 bit lookup table generated
+// by getPixelTranslation(), so when building a mono image each pixel is translated with a single lookup.
+// Note, a new table is always created (rather than updating the current table) as the image processing
+// thread may still be using the current table.
+//
+void imageProcessor::getFullPixelTranslation( const unsigned int size )
+{
+    // No table required.
+    if( size == 0 )
+    {
+        fullPixelLookup.clear();
+        return;
+    }
+
+    unsigned int pixelRange = pixelHigh-pixelLow;
+    if( !pixelRange )
+    {
+        pixelRange = 1;
+    }
+
+    // Populate the table, scaling each value exactly as if done pixel by pixel.
+    QVector<imageDisplayProperties::rgbPixel> lookup( size );
+    imageDisplayProperties::rgbPixel* entry = lookup.data();
+    for( unsigned int value = 0; value < size; value++ )
+    {
+        unsigned int scaled;
+        ( (int)value < pixelLow ) ? scaled = 0 : ( (int)value > pixelHigh ) ? scaled = 255 : scaled = ((int)value-pixelLow)*255/pixelRange;
+        entry[value] = pixelLookup[scaled];
+    }
+
+    fullPixelLookup = lookup;
+}
+
 // Determine the maximum pixel value for the current format
 unsigned int imageProcessor::maxPixelValue()
 {
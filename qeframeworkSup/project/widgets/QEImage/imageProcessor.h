@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2015-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2015-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Rhyder
@@ -55,6 +55,7 @@ public:
     // Image information
     int getScanOption();                            ///< Determine the way the input pixel data must be scanned to accommodate the required rotate and flip options.
     void getPixelTranslation();                     ///< Generate a lookup table to convert raw pixel values to display pixel values
+    void getFullPixelTranslation( const unsigned int size ); ///< Generate a lookup table to convert every raw mono pixel value directly to a display pixel value
     unsigned int maxPixelValue();                   ///< Determine the maximum pixel value for the current format
     unsigned int rotatedImageBuffWidth();           ///< Return the image width following any rotation
     unsigned int rotatedImageBuffHeight();          ///< Return the image height following any rotation
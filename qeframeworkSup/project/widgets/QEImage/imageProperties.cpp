@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2015-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2015-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Rhyder
@@ -18,6 +18,33 @@
 
 #include "imageProperties.h"
 
+/// Construction. Initially there is no full depth lookup table.
+pixelTranslationSettings::pixelTranslationSettings()
+{
+    pixelLow = 0;
+    pixelHigh = 0;
+    fullLookupSize = 0;
+    clippingOn = false;
+    clippingLow = 0;
+    clippingHigh = 0;
+    contrastReversal = false;
+    logBrightness = false;
+    falseColour = false;
+}
+
+/// Return true if the settings are identical, i.e. the same lookup tables would be generated
+bool pixelTranslationSettings::operator==( const pixelTranslationSettings& other ) const
+{
+    return pixelLow         == other.pixelLow &&
+           pixelHigh        == other.pixelHigh &&
+           fullLookupSize   == other.fullLookupSize &&
+           clippingOn       == other.clippingOn &&
+           clippingLow      == other.clippingLow &&
+           clippingHigh     == other.clippingHigh &&
+           contrastReversal == other.contrastReversal &&
+           logBrightness    == other.logBrightness &&
+           falseColour      == other.falseColour;
+}
 
 /// Construction. Set all image attributes to sensible defaults
 imageProperties::imageProperties()
@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2015-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2015-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Rhyder
@@ -14,11 +14,34 @@
 #ifndef QE_IMAGE_PROPERTIES_H
 #define QE_IMAGE_PROPERTIES_H
 
+#include <QVector>
 #include "QCaDateTime.h"
 #include <QEEnums.h>
 #include "imageDataFormats.h"
 #include <brightnessContrast.h> // Remove this, or extract the general definitions used (eg rgbPixel) into another include file
 
+// The full depth pixel lookup table (see below) is only generated for images up to this many bits deep
+#define FULL_PIXEL_LOOKUP_MAX_BITS 16
+
+// The settings used to generate the pixel lookup tables.
+// The full depth pixel lookup table is only regenerated when any of these change.
+struct pixelTranslationSettings
+{
+    pixelTranslationSettings();
+
+    bool operator==( const pixelTranslationSettings& other ) const;
+    bool operator!=( const pixelTranslationSettings& other ) const { return !( *this == other ); }
+
+    int pixelLow;
+    int pixelHigh;
+    unsigned int fullLookupSize;        // Number of entries in the full depth table, zero if not used
+    bool clippingOn;
+    unsigned int clippingLow;
+    unsigned int clippingHigh;
+    bool contrastReversal;
+    bool logBrightness;
+    bool falseColour;
+};
 
 // Class to manage core image processing by a seperate thread.
 //
@@ -48,6 +71,7 @@ public:
                          int pixelHighIn,
                          unsigned int bitDepthIn,
                          imageDisplayProperties::rgbPixel* pixelLookupIn,
+                         const QVector<imageDisplayProperties::rgbPixel>& fullPixelLookupIn,
                          QE::ImageFormatOptions formatOptionIn,
                          unsigned long imageDataSizeIn,
                          imageDisplayProperties* imageDisplayPropsIn,
@@ -65,6 +89,7 @@ private:
     int pixelHigh;
     unsigned int bitDepth;
     imageDisplayProperties::rgbPixel* pixelLookup;
+    QVector<imageDisplayProperties::rgbPixel> fullPixelLookup;  // Shared copy of the full depth table, not modified if regenerated while this image is being built
     QE::ImageFormatOptions formatOption;
     unsigned long imageDataSize;      // Size of elements in image data (originating from CA data type)
     imageDisplayProperties* imageDisplayProps;
@@ -148,6 +173,12 @@ protected:
     int pixelLow;
     int pixelHigh;
 
+    // Full depth pixel lookup. Maps raw mono pixel values directly to display pixel
+    // values, i.e. includes the local brightness and contrast scaling as well as pixelLookup.
+    // Only regenerated when the settings it was generated from change.
+    QVector<imageDisplayProperties::rgbPixel> fullPixelLookup;
+    pixelTranslationSettings fullPixelLookupSettings;
+
     // Clipping info (determined from cliping variable data)
     bool clippingOn;
     unsigned int clippingLow;
@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2014-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2014-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Rhyder
@@ -20,10 +20,14 @@
 #include "mpeg.h"
 
 #include <QDebug>
+#include <QList>
+#include <QMetaObject>
 #include <QMutex>
 #include <QMutexLocker>
-#include <colourConversion.h>
+#include <QWaitCondition>
+#include <QEAdaptationParameters.h>
 #include <QEEnums.h>
+#include <yuvConversion.h>
 
 #define DEBUG qDebug() << "mpeg"  << __LINE__ << __FUNCTION__ << "  "
 
@@ -52,8 +56,6 @@ extern "C" {
 #include <libavutil/avutil.h>
 }
 
-#define NBUFFERS  40    // number of buffer objects to create
-
 // set this when the ffmpeg lib is initialised
 //
 static bool ffinit = false;
@@ -63,86 +65,321 @@ static bool ffinit = false;
 static QMutex* ffmpegCodecMutex = new QMutex();
 
 //==============================================================================
+// A decoded and converted frame, formatted like a CA update.
+//
+struct MpegFrame {
+   QByteArray image;
+   unsigned long dataSize;
+   unsigned long elementsPerPixel;
+   unsigned long width;
+   unsigned long height;
+   unsigned long depth;
+   QE::ImageFormatOptions format;
+};
+
+//==============================================================================
+// The frame queue sits between the FFThread and the MpegSource, i.e. between the
+// decode thread and the GUI thread, and also provides a pool of image buffers.
+//
+// The image buffers are plain QByteArrays, so they are reference counted and
+// delivered to the QEImage widget without copying. A pooled buffer is re-used
+// once it is no longer referenced by anything else, i.e. once the widget (and
+// the queue) have released it, otherwise a new buffer is allocated.
 //
-class FFBuffer
+class MpegFrameQueue
 {
 public:
-   FFBuffer ();
-   ~FFBuffer ();
-
-   static FFBuffer* findFreeBuffer ();
-   void release();
-
-   QMutex *mutex;
-   AVFrame* pFrame;
-   AVPixelFormat pix_fmt;
-   int width;
-   int height;
-   int refs;  // used as inUse bool
-   int id;    // for debug messages
+   explicit MpegFrameQueue ();
+   ~MpegFrameQueue ();
+
+   // Decode thread functions.
+   //
+   void frameDecoded ();
+   QByteArray allocateImage (const int size);
+
+   // Adds the frame to the queue as per the frame policy. Returns true when
+   // the GUI thread needs to be notified, i.e. the queue was empty.
+   //
+   bool put (const MpegFrame& frame);
+
+   // GUI thread functions.
+   // take returns false if there is no frame available. The more parameter
+   // indicates if there are still frames in the queue.
+   //
+   bool take (MpegFrame& frame, bool& more);
+   void clear ();
+   void setStopping (const bool stopping);
+
+   void setPolicy (const MpegSource::FramePolicies policy);
+   MpegSource::FramePolicies getPolicy () const;
+   MpegSource::Counters getCounters () const;
+
+private:
+   void recycle (const QByteArray& image);
+
+   static const int queueDepth = 3;
+   static const int poolSize = 6;
+
+   mutable QMutex mutex;
+   QWaitCondition spaceAvailable;
+   QList<MpegFrame> queue;
+   QList<QByteArray> buffers;          // the buffer pool
+   MpegSource::FramePolicies policy;
+   MpegSource::Counters counters;
+   bool stopping;
 };
 
+//------------------------------------------------------------------------------
+//
+MpegFrameQueue::MpegFrameQueue ()
+{
+   this->stopping = false;
+   this->counters.decoded = 0;
+   this->counters.converted = 0;
+   this->counters.displayed = 0;
+   this->counters.dropped = 0;
+
+   QEAdaptationParameters ap ("QE_");
+   const QString name = ap.getString ("mpeg_frame_policy", "drop_oldest").toLower ();
+   if (name == "drop_newest") {
+      this->policy = MpegSource::DropNewest;
+   } else if (name == "block") {
+      this->policy = MpegSource::Block;
+   } else {
+      this->policy = MpegSource::DropOldest;
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+MpegFrameQueue::~MpegFrameQueue () { }
+
+//------------------------------------------------------------------------------
+//
+void MpegFrameQueue::frameDecoded ()
+{
+   QMutexLocker locker (&this->mutex);
+   this->counters.decoded++;
+}
+
+//------------------------------------------------------------------------------
+//
+QByteArray MpegFrameQueue::allocateImage (const int size)
+{
+   QMutexLocker locker (&this->mutex);
+
+   // Find a pooled buffer of the right size that only the pool references.
+   // Taking it out of the pool makes the caller the sole owner, so writing
+   // to it does not cause a detach copy.
+   //
+   for (int j = 0; j < this->buffers.count (); j++) {
+      const QByteArray& buffer = this->buffers.at (j);
+      if ((buffer.size () == size) && buffer.isDetached ()) {
+         return this->buffers.takeAt (j);
+      }
+   }
+
+   return QByteArray (size, Qt::Uninitialized);
+}
+
+//------------------------------------------------------------------------------
+// Mutex must be held by caller.
+//
+void MpegFrameQueue::recycle (const QByteArray& image)
+{
+   if (image.isEmpty ()) return;
+
+   // Discard the oldest buffer when the pool is full. If still referenced
+   // elsewhere, it is freed when that reference is released.
+   //
+   while (this->buffers.count () >= poolSize) {
+      this->buffers.removeFirst ();
+   }
+   this->buffers.append (image);
+}
+
+//------------------------------------------------------------------------------
+//
+bool MpegFrameQueue::put (const MpegFrame& frame)
+{
+   QMutexLocker locker (&this->mutex);
+
+   if (this->stopping) return false;
+   this->counters.converted++;
+
+   if (this->queue.count () >= queueDepth) {
+      switch (this->policy) {
+         case MpegSource::DropOldest:
+            this->queue.removeFirst ();
+            this->counters.dropped++;
+            break;
+
+         case MpegSource::DropNewest:
+            this->counters.dropped++;
+            this->recycle (frame.image);
+            return false;
+
+         case MpegSource::Block:
+            // Wait in short slices, so as to remain responsive to stopping.
+            //
+            while ((this->queue.count () >= queueDepth) && !this->stopping) {
+               this->spaceAvailable.wait (&this->mutex, 100);
+            }
+            if (this->stopping) {
+               this->counters.dropped++;
+               return false;
+            }
+            break;
+      }
+   }
+
+   const bool wasEmpty = this->queue.isEmpty ();
+   this->queue.append (frame);
+   this->recycle (frame.image);
+   return wasEmpty;
+}
+
+//------------------------------------------------------------------------------
+//
+bool MpegFrameQueue::take (MpegFrame& frame, bool& more)
+{
+   QMutexLocker locker (&this->mutex);
+
+   more = false;
+   if (this->queue.isEmpty ()) return false;
+
+   frame = this->queue.takeFirst ();
+   more = !this->queue.isEmpty ();
+   this->counters.displayed++;
+   this->spaceAvailable.wakeAll ();
+   return true;
+}
 
 //------------------------------------------------------------------------------
-// An FFBuffer contains an AVFrame, a mutex for access and some data
 //
-FFBuffer::FFBuffer()
+void MpegFrameQueue::clear ()
 {
-   this->mutex = new QMutex();
-   this->refs = 0;
-   this->id = -1;
+   QMutexLocker locker (&this->mutex);
+   this->counters.dropped += this->queue.count ();
+   this->queue.clear ();
+   this->buffers.clear ();
+   this->spaceAvailable.wakeAll ();
+}
 
-   this->pFrame = av_frame_alloc ();
+//------------------------------------------------------------------------------
+//
+void MpegFrameQueue::setStopping (const bool stoppingIn)
+{
+   QMutexLocker locker (&this->mutex);
+   this->stopping = stoppingIn;
+   this->spaceAvailable.wakeAll ();
 }
 
 //------------------------------------------------------------------------------
 //
-FFBuffer::~FFBuffer()
+void MpegFrameQueue::setPolicy (const MpegSource::FramePolicies policyIn)
 {
-   av_frame_free(&this->pFrame);
+   QMutexLocker locker (&this->mutex);
+   this->policy = policyIn;
+   this->spaceAvailable.wakeAll ();
 }
 
 //------------------------------------------------------------------------------
 //
-void FFBuffer::release()
+MpegSource::FramePolicies MpegFrameQueue::getPolicy () const
 {
-   QMutexLocker locker (this->mutex);
-   this->refs -= 1;
+   QMutexLocker locker (&this->mutex);
+   return this->policy;
 }
 
-// List of FFBuffers to use for raw frames
-static FFBuffer rawbuffers[NBUFFERS];
+//------------------------------------------------------------------------------
+//
+MpegSource::Counters MpegFrameQueue::getCounters () const
+{
+   QMutexLocker locker (&this->mutex);
+   return this->counters;
+}
 
 //------------------------------------------------------------------------------
-// find a free FFBuffer
-// TODO: add array size parameter.
-// static
-FFBuffer* FFBuffer::findFreeBuffer ()
-{
-   for (int i = 0; i < NBUFFERS; i++) {
-      // if we can lock it and it has a 0 refcount, we can use it!
-      if (rawbuffers[i].mutex->tryLock()) {
-         if (rawbuffers[i].refs == 0) {
-            rawbuffers[i].refs += 1;
-            rawbuffers[i].mutex->unlock();
-            return &rawbuffers[i];
-         } else {
-            rawbuffers[i].mutex->unlock();
+// Formats the decoded frame data in a CA like QByteArray, with no line gaps.
+// (Each horizontal line of pixels in in a larger horizontal line of storage.
+//  Observed example: each line was 1624 pixels stored in 1664 bytes with
+//  trailing 40 bytes of value 128 before start of pixel on next line).
+//
+// This is done on the FFThread, so that the GUI thread only receives the ready
+// to use image. The image buffer is allocated out of the source's buffer pool.
+//
+static void convertFrame (const AVFrame* pFrame, const AVPixelFormat pixelFormat,
+                          const int width, const int height,
+                          MpegFrameQueue* frameQueue, MpegFrame& frame)
+{
+   frame.width = width;
+   frame.height = height;
+
+   switch (pixelFormat) {
+      case AV_PIX_FMT_YUVJ420P:
+         {
+            //!!! Since the QEImage widget handles (or should handle) CA image data
+            //!!! in all the formats that are expected in this mpeg stream
+            //!!! perhaps this formatting here should be simply packaging the data in
+            //!!! a QbyteArray and delivering it, rather than perform any conversion.
+
+            // Set up the image information
+            frame.dataSize = 1;
+            frame.depth = 8;
+            frame.elementsPerPixel = 3;
+            frame.format = QE::rgb1;
+
+            frame.image = frameQueue->allocateImage (width * height * 3);
+
+            const unsigned char* planes [3];
+            int lineSizes [3];
+            for (int j = 0; j < 3; j++) {
+               planes [j] = (const unsigned char*) (pFrame->data [j]);
+               lineSizes [j] = pFrame->linesize [j];
+            }
+
+            yuvConversion::yuvj420ToRgb (planes, lineSizes, width, height,
+                                         (unsigned char*) frame.image.data ());
          }
-      }
+         break;
+
+      default:
+         {
+            // Set up the image information
+            frame.dataSize = 1;
+            frame.depth = 8;
+            frame.elementsPerPixel = 1;
+            frame.format = QE::Mono;
+
+            frame.image = frameQueue->allocateImage (width * height);
+
+            // Package the data in a CA like QByteArray
+            char* buffPtr = frame.image.data ();
+            const char* linePtr = (const char*)(pFrame->data[0]);
+            for (int i = 0; i < height; i++) {
+               memcpy (buffPtr, linePtr, width);
+               buffPtr += width;
+               linePtr += pFrame->linesize[0];
+            }
+         }
+         break;
    }
-   return NULL;
 }
 
 //==============================================================================
-// thread that decodes frames from video stream and emits updateSignal when
-// each new frame is available
+// thread that decodes frames from video stream, adds them to the frame queue
+// and emits frameAvailable when the GUI thread needs to be notified.
 //
 // TODO - update to match suggested Qt thread paradigm
 //
-FFThread::FFThread (const QString &url, QObject* parent)
+FFThread::FFThread (const QString &url, MpegFrameQueue* frameQueueIn,
+                    QObject* parent)
    : QThread (parent)
 {
+   this->frameQueue = frameQueueIn;
+   this->pFrame = NULL;
+
    // this is the url to read the stream from.
    // copy using snprintf, this ensures a/ not too big and b/ ends with null char.
    //
@@ -158,12 +395,6 @@ FFThread::FFThread (const QString &url, QObject* parent)
       // only display errors.
       //
       av_log_set_level (AV_LOG_ERROR);
-
-      // Allocate buffer ids - diagnostic only.
-      //
-      for (int i = 0; i < NBUFFERS; i++) {
-         rawbuffers[i].id = i;
-      }
    }
 }
 
@@ -176,6 +407,10 @@ FFThread::~FFThread() { }
 void FFThread::stopGracefully()
 {
    this->stopping = true;
+
+   // Release the decode thread if blocked waiting for queue space.
+   //
+   this->frameQueue->setStopping (true);
 }
 
 //------------------------------------------------------------------------------
@@ -194,7 +429,12 @@ void FFThread::run()
 #endif
 
    if (status == 0) {
+      // The one frame used for decoding - the converted images are held in
+      // the frame queue's buffers.
+      //
+      this->pFrame = av_frame_alloc ();
       this->processStream (pFormatContext);
+      av_frame_free (&this->pFrame);
 
       // And close file.
       //
@@ -274,7 +514,7 @@ void FFThread::processStream (AVFormatContext* pFormatContext)
    // is most likely to be set while in av_read_frame(), so it is important that the 'stopping' flag
    // is checked after the call to av_read_frame().
    // The 'stopping' flag is, however, also checked after other reasonably CPU expensive steps such as decoding the frame,
-   // or steps that wait on resources such as getting a free buffer,
+   // and the frame queue itself does not block once stopping.
    //
    // NOTE, this thread is stopped by mpegSource::stopStream().
    // Refer to that function to see how the 'stopping' flag is used.
@@ -329,35 +569,20 @@ void FFThread::processFrame (AVCodecContext* pCodecContext,
       return;
    }
 
-   // grab a buffer to decode into.
-   //
-   FFBuffer* raw = FFBuffer::findFreeBuffer ();
-   if (raw == NULL) {
-      DEBUG << url << "  Couldn't get a free buffer, skipping packet";
-      return;
-   }
-
-   // If stopping, free resources and leave.
-   //
-   if (this->stopping) {
-      return;
-   }
-
    // Decode video frame.
    //
    int status = avcodec_send_packet (pCodecContext, &packet);
    if (status < 0) {
       DEBUG << url << "  avcodec_send_packet:" << status << ". Shouldn't see this...";
-      raw->release();
       return;
    }
 
-   status = avcodec_receive_frame (pCodecContext, raw->pFrame);
+   status = avcodec_receive_frame (pCodecContext, this->pFrame);
    if (status < 0) {
       DEBUG << url << "  Frame not finished:" << status << ". Shouldn't see this...";
-      raw->release();
       return;
    }
+   this->frameQueue->frameDecoded ();
 
    // If stopping, free resources and leave.
    //
@@ -365,15 +590,24 @@ void FFThread::processFrame (AVCodecContext* pCodecContext,
       return;
    }
 
-   // Fill in the output buffer.
+   // Colour space conversion etc. - off the GUI thread.
    //
-   raw->pix_fmt = pCodecContext->pix_fmt;
-   raw->height = pCodecContext->height;
-   raw->width = pCodecContext->width;
+   MpegFrame frame;
+   convertFrame (this->pFrame, pCodecContext->pix_fmt,
+                 pCodecContext->width, pCodecContext->height,
+                 this->frameQueue, frame);
 
-   // Emit. The d=raw buffer is freed by updateImage out of MpegSource,
+   // If stopping, leave.
    //
-   emit updateSignal (raw);
+   if (this->stopping) {
+      return;
+   }
+
+   // Queue the frame as per the frame policy, and notify the GUI thread if needs be.
+   //
+   if (this->frameQueue->put (frame)) {
+      emit frameAvailable ();
+   }
 }
 
 //==============================================================================
@@ -381,6 +615,7 @@ void FFThread::processFrame (AVCodecContext* pCodecContext,
 MpegSource::MpegSource (QObject* parent) : QObject (parent)
 {
    this->ffThread = NULL;
+   this->frameQueue = new MpegFrameQueue ();
 }
 
 //------------------------------------------------------------------------------
@@ -389,6 +624,7 @@ MpegSource::~MpegSource()
 {
    // Ensure the thread is dead
    this->stopStream();
+   delete this->frameQueue;
 }
 
 //------------------------------------------------------------------------------
@@ -418,11 +654,15 @@ void MpegSource::startStream()
    // Stop any previous activity
    this->stopStream();
 
+   // Discard anything left over from any previous stream.
+   this->frameQueue->clear ();
+   this->frameQueue->setStopping (false);
+
    // create the ffmpeg thread
-   this->ffThread = new FFThread (this->url, this);
+   this->ffThread = new FFThread (this->url, this->frameQueue, this);
 
-   QObject::connect (this->ffThread, SIGNAL(updateSignal(FFBuffer *)),
-                     this,     SLOT  (updateImage (FFBuffer *)));
+   QObject::connect (this->ffThread, SIGNAL(frameAvailable ()),
+                     this,     SLOT  (updateImage ()));
    QObject::connect (this,     SIGNAL(aboutToQuit   ()),
                      this->ffThread, SLOT  (stopGracefully()));
 
@@ -446,126 +686,65 @@ void MpegSource::stopStream()
 }
 
 //------------------------------------------------------------------------------
-// slot [updateSignal  from the FFThread]
 //
-void MpegSource::updateImage (FFBuffer* newbuf) {
-//  DEBUG << newbuf->id << newbuf->refs;
+void MpegSource::setFramePolicy (const FramePolicies policy)
+{
+   this->frameQueue->setPolicy (policy);
+}
 
-   // Ensure an adequate buffer to hold the image data with no line gaps is allocated.
-   // (re)allocate if not present of not the right size.
-   //
-   int buffSize = newbuf->width * newbuf->height * 3;   //!!!??? * 3 for color only
-   imageData.resize( buffSize );
+//------------------------------------------------------------------------------
+//
+MpegSource::FramePolicies MpegSource::getFramePolicy () const
+{
+   return this->frameQueue->getPolicy ();
+}
 
-   // Populate buffer with no line gaps
-   // (Each horizontal line of pixels in in a larger horizontal line of storage.
-   //  Observed example: each line was 1624 pixels stored in 1664 bytes with
-   //  trailing 40 bytes of value 128 before start of pixel on next line).
-   //
-   char* buffPtr = (char*)imageData.data();
+//------------------------------------------------------------------------------
+//
+MpegSource::Counters MpegSource::getCounters () const
+{
+   return this->frameQueue->getCounters ();
+}
 
-   // Set up default image information
-   unsigned long dataSize = 1;
-   unsigned long depth = 8;
-   unsigned long elementsPerPixel = 1;
-   QE::ImageFormatOptions format = QE::Mono;
+//------------------------------------------------------------------------------
+//
+QString MpegSource::statistics () const
+{
+   static const char* const policyNames [] = { "drop oldest", "drop newest", "block" };
+
+   const Counters counters = this->getCounters ();
+   QString result;
+   result.append (QString ("url:       %1\n").arg (this->url));
+   result.append (QString ("policy:    %1\n").arg (policyNames [this->getFramePolicy ()]));
+   result.append (QString ("decoded:   %1\n").arg (counters.decoded));
+   result.append (QString ("converted: %1\n").arg (counters.converted));
+   result.append (QString ("displayed: %1\n").arg (counters.displayed));
+   result.append (QString ("dropped:   %1\n").arg (counters.dropped));
+   return result;
+}
 
-   // older version does not have 'format'
-   //widgets/QEImage/mpeg.cpp: In member function 'void mpegSource::updateImage(FFBuffer*)':
-   //widgets/QEImage/mpeg.cpp:387: error: 'struct AVFrame' has no member named 'format'
+//------------------------------------------------------------------------------
+// slot [frameAvailable from the FFThread]
+//
+void MpegSource::updateImage ()
+{
+   MpegFrame frame;
+   bool more;
+   if (!this->frameQueue->take (frame, more)) return;
 
-   // Format the data in a CA like QByteArray.
+   // If there are more frames queued, come back for them after this one has
+   // been processed. The FFThread only notifies when the queue was empty.
    //
-   switch( newbuf->pix_fmt )
-   {
-      case AV_PIX_FMT_YUVJ420P:
-         {
-            //!!! Since the QEImage widget handles (or should handle) CA image data
-            //!!! in all the formats that are expected in this mpeg stream
-            //!!! perhaps this formatting here should be simply packaging the data in
-            //!!! a QbyteArray and delivering it, rather than perform any conversion.
-
-            // Set up the image information
-            dataSize = 1;
-            depth = 8;
-            elementsPerPixel = 3;
-            format = QE::rgb1;
-
-            const unsigned char* linePtrY = (const unsigned char*)(newbuf->pFrame->data[0]);
-            const unsigned char* linePtrU = (const unsigned char*)(newbuf->pFrame->data[1]);
-            const unsigned char* linePtrV = (const unsigned char*)(newbuf->pFrame->data[2]);
-
-            // For each row...
-            //            qint64 start = QDateTime::currentMSecsSinceEpoch();
-            for( int i = 0; i < newbuf->height; i++ )
-            {
-               // For each pixel...
-               for( int j = 0; j < newbuf->width; j++ )
-               {
-                  unsigned char y,u,v;
-                  unsigned char r,g,b;
-
-                  // Use U and V values for every pair of pixels
-                  int uv = j/2;
-
-                  // Get YUV values
-                  y = linePtrY[j];
-                  u = linePtrU[uv];
-                  v = linePtrV[uv];
-
-                  // Convert to RGB
-                  r = YUVJ2R(y, u, v);
-                  g = YUVJ2G(y, u, v);
-                  b = YUVJ2B(y, u, v);
-
-                  // Save RGB result
-                  *buffPtr++ = r;
-                  *buffPtr++ = g;
-                  *buffPtr++ = b;
-               }
-
-               // Step on to new Y data for every line
-               linePtrY += newbuf->pFrame->linesize[0];
-
-               // Step onto new U and V data every two lines
-               if( i & 1 )
-               {
-                  linePtrU += newbuf->pFrame->linesize[1];
-                  linePtrV += newbuf->pFrame->linesize[2];
-               }
-            }
-            //            qint64 end = QDateTime::currentMSecsSinceEpoch();
-            //            DEBUG <<"decode mS:" << end-start;
-         }
-         break;
-
-      default:
-         {
-            // Set up the image information
-            dataSize = 1;
-            depth = 8;
-            elementsPerPixel = 1;
-            format = QE::Mono;
-
-            // Package the data in a CA like QByteArray
-            const char* linePtr = (const char*)(newbuf->pFrame->data[0]);
-            for( int i = 0; i < newbuf->height; i++ )
-            {
-               memcpy( buffPtr, linePtr, newbuf->width );
-               buffPtr += newbuf->width;
-               linePtr += newbuf->pFrame->linesize[0];
-            }
-         }
-         break;
+   if (more) {
+      QMetaObject::invokeMethod (this, "updateImage", Qt::QueuedConnection);
    }
 
-   // Deliver image update
-   emit setDataImage (this->imageData, dataSize, elementsPerPixel,
-                      newbuf->width, newbuf->height, format, depth);
-
-   // Unlock buffer
-   newbuf->release();
-// DEBUG << newbuf->id << newbuf->refs;
+   // Deliver image update.
+   // Note: QByteArray is implicitly shared, so no image data is copied, and
+   // the buffer returns to the pool once the widget has released it.
+   //
+   emit setDataImage (frame.image, frame.dataSize, frame.elementsPerPixel,
+                      frame.width, frame.height, frame.format, frame.depth);
 }
 
 #else  // ======================================================================
@@ -573,7 +752,7 @@ void MpegSource::updateImage (FFBuffer* newbuf) {
 // When QE_USE_MPEG not in use =>
 // Create stubb class functions.
 //
-FFThread ::FFThread (const QString &, QObject* parent) : QThread (parent) {}
+FFThread ::FFThread (const QString &, MpegFrameQueue*, QObject* parent) : QThread (parent) {}
 
 FFThread::~FFThread () {}
 
@@ -588,7 +767,11 @@ void processFrame (AVCodecContext*, AVPacket&, int) {}
 
 //------------------------------------------------------------------------------
 //
-MpegSource::MpegSource (QObject* parent) : QObject (parent) {}
+MpegSource::MpegSource (QObject* parent) : QObject (parent)
+{
+   this->ffThread = NULL;
+   this->frameQueue = NULL;
+}
 
 MpegSource::~MpegSource () {}
 
@@ -603,7 +786,29 @@ void MpegSource::stopStream () {}
 
 void MpegSource::startStream () {}
 
-void MpegSource::updateImage (FFBuffer*) {}
+void MpegSource::setFramePolicy (const FramePolicies) {}
+
+MpegSource::FramePolicies MpegSource::getFramePolicy () const
+{
+   return DropOldest;
+}
+
+MpegSource::Counters MpegSource::getCounters () const
+{
+   Counters result;
+   result.decoded = 0;
+   result.converted = 0;
+   result.displayed = 0;
+   result.dropped = 0;
+   return result;
+}
+
+QString MpegSource::statistics () const
+{
+   return "---MPEG not enabled in this build---\n";
+}
+
+void MpegSource::updateImage () {}
 
 #endif // QE_USE_MPEG  =========================================================
 
@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2014-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2014-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Rhyder
@@ -24,9 +24,10 @@
 #define MAXSTRING 1024    // size of URL string
 
 // differed
-class FFBuffer;
+class MpegFrameQueue;
 class MpegSource;
 struct AVFormatContext;
+struct AVFrame;
 struct AVPacket;
 struct AVCodecContext;
 
@@ -43,10 +44,13 @@ protected:
    void run();
 
 signals:
-   void updateSignal (FFBuffer*);
+   // Indicates a frame has been added to the frame queue.
+   //
+   void frameAvailable ();
 
 private:
-   explicit FFThread (const QString& url, QObject* parent);
+   explicit FFThread (const QString& url, MpegFrameQueue* frameQueue,
+                      QObject* parent);
    ~FFThread ();
 
    void processStream (AVFormatContext* pFormatContext);
@@ -56,11 +60,22 @@ private:
 
    char url[MAXSTRING];
    bool stopping;
+   MpegFrameQueue* frameQueue;         // owned by the MpegSource
+   AVFrame* pFrame;                    // decode target
 
    friend class MpegSource;
 };
 
 //------------------------------------------------------------------------------
+// Each MpegSource has its own frame queue and pool of image buffers, so that
+// multiple streams are independent of each other.
+//
+// The decoded and converted frames are queued for the GUI thread. When the GUI
+// thread falls behind and the queue is full, the frame policy determines what
+// happens: drop the oldest queued frame, drop the new frame, or block the decode
+// thread until there is space. The default is DropOldest, and may be set using
+// the QE_MPEG_FRAME_POLICY environment variable, or equivalent adaptation
+// parameter, as one of drop_oldest, drop_newest or block.
 //
 class MpegSource : public QObject
 {
@@ -69,11 +84,28 @@ public:
    explicit MpegSource (QObject* parent);
    ~MpegSource();
 
+   enum FramePolicies { DropOldest, DropNewest, Block };
+
+   // Frame counters - cumulative for this source.
+   //
+   struct Counters {
+      quint64 decoded;
+      quint64 converted;
+      quint64 displayed;
+      quint64 dropped;
+   };
+
    QString getURL() const;
    void setURL (const QString& urlIn);
    void stopStream();
    void startStream();
 
+   void setFramePolicy (const FramePolicies policy);
+   FramePolicies getFramePolicy () const;
+
+   Counters getCounters () const;
+   QString statistics () const;
+
 signals:
    void aboutToQuit ();
 
@@ -90,11 +122,10 @@ signals:
 private:
    QString url;
    FFThread* ffThread;
-
-   QByteArray imageData;  // Byte array used to deliver images
+   MpegFrameQueue* frameQueue;
 
 private slots:
-   void updateImage (FFBuffer*);
+   void updateImage ();
 };
 
 #endif // QE_IMAGE_MPEG_H
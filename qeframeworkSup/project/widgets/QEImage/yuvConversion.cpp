@@ -0,0 +1,294 @@
+/*  yuvConversion.cpp
+ *
+ *  This file is part of the EPICS QT Framework, initially developed at the
+ *  Australian Synchrotron.
+ *
+ *  SPDX-FileCopyrightText: 2026 Australian Synchrotron
+ *  SPDX-License-Identifier: LGPL-3.0-only
+ *
+ *  Author:     Andrew Starritt
+ *  Maintainer: Andrew Starritt
+ *  Contact:    andrews@ansto.gov.au
+ */
+
+#include "yuvConversion.h"
+#include <string.h>
+#include <QDebug>
+#include <QList>
+#include <QECommon.h>
+#include <QETaskPool.h>
+#include <colourConversion.h>
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+#define QE_YUV_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+#define DEBUG qDebug () << "yuvConversion" << __LINE__ << __FUNCTION__ << "  "
+
+#ifdef QE_YUV_USE_SSE2
+//------------------------------------------------------------------------------
+// Loads 4 bytes into the low 32 bits.
+//
+static inline __m128i loadFour (const unsigned char* p)
+{
+   int value;
+   memcpy (&value, p, sizeof (value));
+   return _mm_cvtsi32_si128 (value);
+}
+#endif
+
+//==============================================================================
+// Converts a stripe of rows on a pool thread.
+//
+class yuvConversionTask : public QETask {
+public:
+   explicit yuvConversionTask (const unsigned char* const planes [3],
+                               const int lineSizes [3],
+                               const int width,
+                               const int firstRow,
+                               const int lastRow,
+                               unsigned char* rgb);
+protected:
+   void run ();
+
+private:
+   const unsigned char* planes [3];
+   int lineSizes [3];
+   const int width;
+   const int firstRow;
+   const int lastRow;
+   unsigned char* const rgb;
+};
+
+//------------------------------------------------------------------------------
+//
+yuvConversionTask::yuvConversionTask (const unsigned char* const planesIn [3],
+                                      const int lineSizesIn [3],
+                                      const int widthIn,
+                                      const int firstRowIn,
+                                      const int lastRowIn,
+                                      unsigned char* rgbIn) :
+   QETask (QETask::High),
+   width (widthIn),
+   firstRow (firstRowIn),
+   lastRow (lastRowIn),
+   rgb (rgbIn)
+{
+   for (int j = 0; j < 3; j++) {
+      this->planes [j] = planesIn [j];
+      this->lineSizes [j] = lineSizesIn [j];
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+void yuvConversionTask::run ()
+{
+   yuvConversion::convertRows (this->planes, this->lineSizes, this->width,
+                               this->firstRow, this->lastRow, this->rgb);
+}
+
+
+//==============================================================================
+// static
+bool yuvConversion::isVectorised ()
+{
+#ifdef QE_YUV_USE_SSE2
+   return true;
+#else
+   return false;
+#endif
+}
+
+//------------------------------------------------------------------------------
+// static
+void yuvConversion::yuvjRowToRgbReference (const unsigned char* y,
+                                           const unsigned char* u,
+                                           const unsigned char* v,
+                                           const int width,
+                                           unsigned char* rgb)
+{
+   for (int j = 0; j < width; j++) {
+      const int uv = j / 2;    // use U and V values for every pair of pixels
+      const int yj = y [j];
+      const int uj = u [uv];
+      const int vj = v [uv];
+
+      *rgb++ = YUVJ2R (yj, uj, vj);
+      *rgb++ = YUVJ2G (yj, uj, vj);
+      *rgb++ = YUVJ2B (yj, uj, vj);
+   }
+}
+
+//------------------------------------------------------------------------------
+// static
+void yuvConversion::yuvjRowToRgb (const unsigned char* y,
+                                  const unsigned char* u,
+                                  const unsigned char* v,
+                                  const int width,
+                                  unsigned char* rgb)
+{
+   int j = 0;
+
+#ifdef QE_YUV_USE_SSE2
+   // Process 8 pixels at a time, using 32 bit arithmetic as per the macros.
+   // The madd instruction forms the (a*p + b*q) pairs, and the two saturating
+   // packs provide the 0 .. 255 clipping.
+   //
+   const __m128i zero   = _mm_setzero_si128 ();
+   const __m128i offset = _mm_set1_epi16 (128);
+   const __m128i round  = _mm_set1_epi32 (128);
+   const __m128i kR     = _mm_set_epi16 (409, 298, 409, 298, 409, 298, 409, 298);     // y, e
+   const __m128i kG1    = _mm_set_epi16 (-100, 298, -100, 298, -100, 298, -100, 298); // y, d
+   const __m128i kG2    = _mm_set_epi16 (0, -208, 0, -208, 0, -208, 0, -208);         // e, 0
+   const __m128i kB     = _mm_set_epi16 (516, 298, 516, 298, 516, 298, 516, 298);     // y, d
+
+   unsigned char r [16];
+   unsigned char g [16];
+   unsigned char b [16];
+
+   for (; j + 8 <= width; j += 8) {
+      const int uv = j / 2;
+
+      // Load 8 y values and 4 u/v values, each u/v value duplicated.
+      //
+      const __m128i y8  = _mm_loadl_epi64 ((const __m128i*) (y + j));
+      const __m128i y16 = _mm_unpacklo_epi8 (y8, zero);
+
+      __m128i u8 = loadFour (u + uv);
+      __m128i v8 = loadFour (v + uv);
+      u8 = _mm_unpacklo_epi8 (u8, u8);
+      v8 = _mm_unpacklo_epi8 (v8, v8);
+
+      const __m128i d16 = _mm_sub_epi16 (_mm_unpacklo_epi8 (u8, zero), offset);
+      const __m128i e16 = _mm_sub_epi16 (_mm_unpacklo_epi8 (v8, zero), offset);
+
+      // Interleave into (y, e), (y, d) and (e, 0) pairs - low and high halves.
+      //
+      const __m128i yeLo = _mm_unpacklo_epi16 (y16, e16);
+      const __m128i yeHi = _mm_unpackhi_epi16 (y16, e16);
+      const __m128i ydLo = _mm_unpacklo_epi16 (y16, d16);
+      const __m128i ydHi = _mm_unpackhi_epi16 (y16, d16);
+      const __m128i e0Lo = _mm_unpacklo_epi16 (e16, zero);
+      const __m128i e0Hi = _mm_unpackhi_epi16 (e16, zero);
+
+      __m128i rLo = _mm_srai_epi32 (_mm_add_epi32 (_mm_madd_epi16 (yeLo, kR), round), 8);
+      __m128i rHi = _mm_srai_epi32 (_mm_add_epi32 (_mm_madd_epi16 (yeHi, kR), round), 8);
+
+      __m128i gLo = _mm_add_epi32 (_mm_madd_epi16 (ydLo, kG1), _mm_madd_epi16 (e0Lo, kG2));
+      __m128i gHi = _mm_add_epi32 (_mm_madd_epi16 (ydHi, kG1), _mm_madd_epi16 (e0Hi, kG2));
+      gLo = _mm_srai_epi32 (_mm_add_epi32 (gLo, round), 8);
+      gHi = _mm_srai_epi32 (_mm_add_epi32 (gHi, round), 8);
+
+      __m128i bLo = _mm_srai_epi32 (_mm_add_epi32 (_mm_madd_epi16 (ydLo, kB), round), 8);
+      __m128i bHi = _mm_srai_epi32 (_mm_add_epi32 (_mm_madd_epi16 (ydHi, kB), round), 8);
+
+      // Saturate to 0 .. 255, i.e. CLIP.
+      //
+      const __m128i r8 = _mm_packus_epi16 (_mm_packs_epi32 (rLo, rHi), zero);
+      const __m128i g8 = _mm_packus_epi16 (_mm_packs_epi32 (gLo, gHi), zero);
+      const __m128i b8 = _mm_packus_epi16 (_mm_packs_epi32 (bLo, bHi), zero);
+
+      _mm_storeu_si128 ((__m128i*) r, r8);
+      _mm_storeu_si128 ((__m128i*) g, g8);
+      _mm_storeu_si128 ((__m128i*) b, b8);
+
+      for (int k = 0; k < 8; k++) {
+         *rgb++ = r [k];
+         *rgb++ = g [k];
+         *rgb++ = b [k];
+      }
+   }
+#endif
+
+   // Do any remaining pixels, or all of them when not vectorised.
+   // Note: j is always even here.
+   //
+   if (j < width) {
+      yuvConversion::yuvjRowToRgbReference (y + j, u + j / 2, v + j / 2, width - j, rgb);
+   }
+}
+
+//------------------------------------------------------------------------------
+// static
+void yuvConversion::convertRows (const unsigned char* const planes [3],
+                                 const int lineSizes [3],
+                                 const int width,
+                                 const int firstRow,
+                                 const int lastRow,
+                                 unsigned char* rgb)
+{
+   unsigned char* target = rgb + 3 * qint64 (width) * firstRow;
+   for (int row = firstRow; row < lastRow; row++) {
+      // New U and V data every two lines.
+      //
+      const unsigned char* y = planes [0] + qint64 (lineSizes [0]) * row;
+      const unsigned char* u = planes [1] + qint64 (lineSizes [1]) * (row / 2);
+      const unsigned char* v = planes [2] + qint64 (lineSizes [2]) * (row / 2);
+
+      yuvConversion::yuvjRowToRgb (y, u, v, width, target);
+      target += 3 * width;
+   }
+}
+
+//------------------------------------------------------------------------------
+// static
+void yuvConversion::yuvj420ToRgb (const unsigned char* const planes [3],
+                                  const int lineSizes [3],
+                                  const int width,
+                                  const int height,
+                                  unsigned char* rgb)
+{
+   if ((width <= 0) || (height <= 0)) return;
+
+   // Small images, or no pool threads to speak of - just do it here.
+   //
+   const int threads = QETaskPool::threadCount ();
+   if ((qint64 (width) * height < parallelThreshold) || (threads < 2)) {
+      yuvConversion::convertRows (planes, lineSizes, width, 0, height, rgb);
+      return;
+   }
+
+   // Split into stripes, an even number of rows each. The calling thread
+   // converts the last stripe itself.
+   //
+   const int number = MIN (threads, MAX (height / 16, 1));
+   int stripe = (height + number - 1) / number;
+   stripe = (stripe + 1) & ~1;
+
+   QList<QETaskPointer> taskList;
+   QList<int> firstRowList;
+   int firstRow = 0;
+   while (firstRow + stripe < height) {
+      QETaskPointer task (new yuvConversionTask (planes, lineSizes, width,
+                                                 firstRow, firstRow + stripe, rgb));
+      if (!QETaskPool::submit (task)) {
+         // Pool no longer available - do it here.
+         //
+         yuvConversion::convertRows (planes, lineSizes, width,
+                                     firstRow, firstRow + stripe, rgb);
+      } else {
+         taskList.append (task);
+         firstRowList.append (firstRow);
+      }
+      firstRow += stripe;
+   }
+
+   yuvConversion::convertRows (planes, lineSizes, width, firstRow, height, rgb);
+
+   for (int j = 0; j < taskList.count (); j++) {
+      QETaskPointer task = taskList.value (j);
+      task->waitForFinished ();
+
+      // Cancelled if the application is quitting - belts 'n' braces.
+      //
+      if (task->getState () == QETask::Cancelled) {
+         const int row = firstRowList.value (j);
+         yuvConversion::convertRows (planes, lineSizes, width,
+                                     row, MIN (row + stripe, height), rgb);
+      }
+   }
+}
+
+// end
@@ -0,0 +1,80 @@
+/*  yuvConversion.h
+ *
+ *  This file is part of the EPICS QT Framework, initially developed at the
+ *  Australian Synchrotron.
+ *
+ *  SPDX-FileCopyrightText: 2026 Australian Synchrotron
+ *  SPDX-License-Identifier: LGPL-3.0-only
+ *
+ *  Author:     Andrew Starritt
+ *  Maintainer: Andrew Starritt
+ *  Contact:    andrews@ansto.gov.au
+ */
+
+#ifndef QE_IMAGE_YUV_CONVERSION_H
+#define QE_IMAGE_YUV_CONVERSION_H
+
+/// Planar YUVJ to packed RGB conversion, as used by the MPEG image source.
+///
+/// The results are identical to the YUVJ2R, YUVJ2G and YUVJ2B macros out of
+/// colourConversion.h (zero tolerance), i.e. the same integer arithmetic is
+/// used. Where SSE2 is available (always the case for x86-64 builds) the rows
+/// are converted 8 pixels at a time, otherwise a scalar implementation is used.
+///
+/// Large images are split into stripes of rows which are converted in parallel
+/// using the QETaskPool. The caller need not be a GUI thread, and typically is
+/// the MPEG decode thread.
+///
+class yuvConversion
+{
+public:
+   // Converts one row of pixels. The u and v rows are sub-sampled by two
+   // horizontally, i.e. each u/v value applies to a pair of pixels.
+   // The rgb output is 3 bytes per pixel.
+   //
+   static void yuvjRowToRgb (const unsigned char* y,
+                             const unsigned char* u,
+                             const unsigned char* v,
+                             const int width,
+                             unsigned char* rgb);
+
+   // Converts a whole YUVJ 4:2:0 image, i.e. the u and v planes are also
+   // sub-sampled by two vertically. The output has no line gaps, i.e. the
+   // output is width * height * 3 bytes.
+   //
+   static void yuvj420ToRgb (const unsigned char* const planes [3],
+                             const int lineSizes [3],
+                             const int width,
+                             const int height,
+                             unsigned char* rgb);
+
+   // Scalar reference implementation - uses the colourConversion.h macros.
+   //
+   static void yuvjRowToRgbReference (const unsigned char* y,
+                                      const unsigned char* u,
+                                      const unsigned char* v,
+                                      const int width,
+                                      unsigned char* rgb);
+
+   // Indicates if the conversion is vectorised in this build.
+   //
+   static bool isVectorised ();
+
+private:
+   // Converts rows firstRow to lastRow - 1.
+   //
+   static void convertRows (const unsigned char* const planes [3],
+                            const int lineSizes [3],
+                            const int width,
+                            const int firstRow,
+                            const int lastRow,
+                            unsigned char* rgb);
+
+   // Images with fewer pixels than this are converted on the calling thread.
+   //
+   static const int parallelThreshold = 1024 * 1024;
+
+   friend class yuvConversionTask;
+};
+
+#endif // QE_IMAGE_YUV_CONVERSION_H
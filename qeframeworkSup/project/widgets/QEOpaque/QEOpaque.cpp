@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2018-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2018-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Starritt
@@ -177,6 +177,11 @@ QEChannel* QEOpaque::createQcaItem (unsigned int variableIndex)
    QEChannel* result = new QEChannel (pvName, this, PV_VARIABLE_INDEX);
 
    // using setSingleVariableQCaProperties not applicable here
+   // but do apply the client-side update filtering.
+   //
+   result->setAbsoluteDeadband (this->getDeadband ());
+   result->setRelativeDeadband (this->getRelativeDeadband ());
+   result->setMaxUpdateRate (this->getMaxUpdateRate ());
 
    return result;
 }
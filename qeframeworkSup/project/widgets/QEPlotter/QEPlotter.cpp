@@ -2796,13 +2796,50 @@ int QEPlotter::maxActualYSizes () const
 }
 
 //------------------------------------------------------------------------------
+// Returns the first number elements of the source array, padded with zeros into
+// the workspace as need be.
+//
+static const double* zeroPaddedData (const QEFloatingArray& source, const int number,
+                                     QEFloatingArray& workspace)
+{
+   if (source.count () >= number) return source.constData ();
+
+   workspace = source;
+   workspace.reserve (number);
+   while (workspace.count () < number) {
+      workspace.append (0.0);
+   }
+   return workspace.constData ();
+}
+
+//------------------------------------------------------------------------------
+// Replaces any NaN or infinite values with zero, i.e. plot zero as opposed to
+// some "crazy" value.
+//
+static void zeroInvalidValues (QEFloatingArray& data)
+{
+   const int number = data.count ();
+   double* values = data.data ();
+   for (int j = 0; j < number; j++) {
+      if (QEPlatform::isNaN (values [j]) || QEPlatform::isInf (values [j])) {
+         values [j] = 0.0;
+      }
+   }
+}
+
+//------------------------------------------------------------------------------
+// The expressions are evaluated for all elements in one go, i.e. as arrays.
 //
 void QEPlotter::doAnyCalculations ()
 {
    const int x = QEExpressionEvaluation::indexOf ('X');
    const int s = QEExpressionEvaluation::indexOf ('S');
 
-   QEExpressionEvaluation::CalculateArguments userArguments;
+   QEExpressionEvaluation::ArrayArguments userArguments;
+   QEFloatingArray indices;
+   QEFloatingArray xPadding;
+   QEFloatingArray dataPadding [NUMBER_OF_SLOTS];
+   QEFloatingArray slopePadding [NUMBER_OF_SLOTS];
    DataSets* xs;
    DataSets* ys;
    int effectiveXSize;
@@ -2811,23 +2848,23 @@ void QEPlotter::doAnyCalculations ()
    int j;
    int slot;
    int tols;
-   double value;
-   bool okay;
-   bool dataIsAvailable;
 
    xs = &this->xy [0];  // use a alias pointer for brevity
    effectiveXSize = xs->effectiveSize ();
 
+   // The S input, i.e. the index position 0 .. (n-1), is common to all.
+   //
+   indices.reserve (effectiveXSize);
+   for (j = 0; j < effectiveXSize; j++) {
+      indices.append ((double) j);
+   }
+
    switch (xs->dataKind) {
 
       case NotInUse:
-         xs->data.clear ();
-
          // Use default calculation which is just x = index position 0 .. (n-1)
          //
-         for (j = 0; j < effectiveXSize; j++) {
-            xs->data.append ((double) j);
-         }
+         xs->data = indices;
          break;
 
       case DataPVPlot:
@@ -2837,18 +2874,15 @@ void QEPlotter::doAnyCalculations ()
       case CalculationPlot:
          xs->data.clear ();
          if (xs->expressionIsValid) {
-            for (j = 0; j < effectiveXSize; j++) {
-               QEExpressionEvaluation::clear (userArguments);
-               userArguments [Normal][s] = (double) j;
+            QEExpressionEvaluation::clear (userArguments);
+            userArguments [Normal][s].data = indices.constData ();
 
-               value = xs->calculator->evaluate (userArguments, &okay);
-               if (!okay || QEPlatform::isNaN (value) || QEPlatform::isInf (value) ) {
-                  // Plot zero as opposed to some "crazy" value.
-                  //
-                  value = 0.0;
-               }
-               xs->data.append (value);
-            }
+            xs->data.resize (effectiveXSize);
+            xs->calculator->evaluate (userArguments, effectiveXSize, xs->data.data ());
+
+            // Not okay evaluations yield NaN, so also zeroed.
+            //
+            zeroInvalidValues (xs->data);
          }
    }
 
@@ -2870,35 +2904,29 @@ void QEPlotter::doAnyCalculations ()
 
          n = MIN (effectiveXSize, effectiveYSize);
 
-         dataIsAvailable = true;
-         for (j = 0; j < n; j++) {
-            QEExpressionEvaluation::clear (userArguments);
+         QEExpressionEvaluation::clear (userArguments);
 
-            // Pre-defined values: S and X
-            //
-            userArguments [Normal][s] = (double) j;
-            userArguments [Normal][x] = xs->data.value (j);
-            userArguments [Primed][x] = 1.0;    // by defitions.
-
-            for (tols = 1; tols < slot; tols++) {
-               DataSets* ts = &this->xy [tols];
-
-               // TODO: determine if this arg used?
-               userArguments [Normal] [tols - 1] = ts->data.value (j, 0.0);
-               userArguments [Primed] [tols - 1] = ts->dyByDx.value (j, 0.0);
-            }
+         // Pre-defined values: S and X
+         //
+         userArguments [Normal][s].data = indices.constData ();
+         userArguments [Normal][x].data = zeroPaddedData (xs->data, n, xPadding);
+         userArguments [Primed][x].value = 1.0;    // by defitions.
 
-            if (!dataIsAvailable) break;
+         for (tols = 1; tols < slot; tols++) {
+            DataSets* ts = &this->xy [tols];
 
-            value = ys->calculator->evaluate (userArguments, &okay);
-            if (!okay || QEPlatform::isNaN (value) || QEPlatform::isInf (value) ) {
-               // Plot zero as opposed to some "crazy" value.
-               //
-               value = 0.0;
-            }
-            ys->data.append (value);
+            // Short arrays are padded with zeros. Only copied if need be.
+            //
+            userArguments [Normal] [tols - 1].data =
+                  zeroPaddedData (ts->data, n, dataPadding [tols]);
+            userArguments [Primed] [tols - 1].data =
+                  zeroPaddedData (ts->dyByDx, n, slopePadding [tols]);
          }
 
+         ys->data.resize (n);
+         ys->calculator->evaluate (userArguments, n, ys->data.data ());
+         zeroInvalidValues (ys->data);
+
          // Calculate slope of calculated plot.
          //
          ys->dyByDx = ys->data.calcDyByDx (xs->data);
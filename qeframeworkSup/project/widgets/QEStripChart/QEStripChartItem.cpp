@@ -1337,27 +1337,29 @@ void QEStripChartItem::recalcualteBufferedValues ()
       indexList [slot] = 0;
    }
 
-   // We keep track of the previous item so that we can sensibily check
-   // for insignificant value/status changes.
+   // First form the expression inputs for each time point.
    //
-   double previousValue = 0.0;
-   QCaAlarmInfo previousAlarm (CALC_ALARM, INVALID_ALARM);
+   QVector<QCaDateTime> timeList;
+   QVector<bool> hasInputList;
+   QVector<double> inputList [QEStripChart::NUMBER_OF_PVS];
 
-   for (QCaDateTime time = start_time; time <= end_time; time = time.addMSecs(deltaTimeMS)) {
-
-      QEStripChartItem::CalcInputs values;
+   timeList.reserve (n);
+   hasInputList.reserve (n);
+   for (int slot = 0; slot < QEStripChart::NUMBER_OF_PVS; slot++) {
+      inputList [slot].reserve (n);
+   }
 
-      // First initialise all values - undefined artifacts yield zero.
-      //
-      for (int slot = 0; slot < QEStripChart::NUMBER_OF_PVS; slot++) {
-         values [slot] = 0.0;
-      }
+   for (QCaDateTime time = start_time; time <= end_time; time = time.addMSecs(deltaTimeMS)) {
 
       // Find appropriate data indicies.
       //
       bool atLeastOneInput = false;
 
       for (int j = 0; j < QEStripChart::NUMBER_OF_PVS; j++) {
+         // Undefined artifacts yield zero.
+         //
+         double value = 0.0;
+
          // update index to find most recent point with a time
          // less than or equal to time.
          //
@@ -1369,29 +1371,49 @@ void QEStripChartItem::recalcualteBufferedValues ()
          if (w < pointListList [j].count()) {
              QCaDataPoint datum = pointListList [j].value (w);
              if (datum.datetime <= time && datum.isDisplayable()) {
-                values [j] = datum.value;
+                value = datum.value;
                 atLeastOneInput = true;
              }
          }
+
+         inputList [j].append (value);
       }
 
+      timeList.append (time);
+      hasInputList.append (atLeastOneInput);
+   }
+
+   // Next run the calculation for all time points in one go.
+   // Inputs beyond the number of PVs and all primed inputs are zero.
+   //
+   const int number = timeList.count ();
+
+   QEExpressionEvaluation::ArrayArguments userArgs;
+   QEExpressionEvaluation::clear (userArgs);
+   for (int i = 0; i < QEStripChart::NUMBER_OF_PVS; i++) {
+      userArgs [QEExpressionEvaluation::Normal][i].data = inputList [i].constData ();
+   }
+
+   QVector<double> valueList (number);
+   this->calculator->evaluate (userArgs, number, valueList.data ());
+
+   // We keep track of the previous item so that we can sensibily check
+   // for insignificant value/status changes.
+   //
+   double previousValue = 0.0;
+   QCaAlarmInfo previousAlarm (CALC_ALARM, INVALID_ALARM);
+
+   for (int t = 0; t < number; t++) {
+
       QCaDataPoint resultItem;
-      resultItem.datetime = time;
+      resultItem.datetime = timeList.value (t);
 
       bool isOkay = false;
-      if (atLeastOneInput) {
-         // Form user arguments for expression evaluation.
+      if (hasInputList.value (t)) {
+         // Any evaluation that is not okay yields NaN.
          //
-         QEExpressionEvaluation::CalculateArguments userArgs;
-         for (int i = 0; i < ARRAY_LENGTH (userArgs [0]); i++) {
-            double vi = (i < QEStripChart::NUMBER_OF_PVS) ? values [i] : 0.0;
-            userArgs [QEExpressionEvaluation::Normal][i] = vi;
-            userArgs [QEExpressionEvaluation::Primed][i] = 0.0;
-         }
-
-         // Run the calculation.
-         //
-         resultItem.value = this->calculator->evaluate (userArgs, &isOkay);
+         resultItem.value = valueList.value (t);
+         isOkay = true;
 
          // Check for NaN / Infinte  ans set alarm status accordingly.
          //
@@ -1411,10 +1433,14 @@ void QEStripChartItem::recalcualteBufferedValues ()
       resultItem.alarm = alarm;
 
       // Is this the first point or has there been a significant change of value
-      // or status since previous point.
+      // or status since previous point. Any comparison with a NaN is false, so
+      // a change to or from NaN must be checked for explicitly.
       //
+      const bool isNaNChange = QEPlatform::isNaN (resultItem.value) !=
+                               QEPlatform::isNaN (previousValue);
+
       if ((result.count() == 0) ||
-          (resultItem.alarm != previousAlarm) ||
+          (resultItem.alarm != previousAlarm) || isNaNChange ||
           (ABS (resultItem.value - previousValue) > CALC_DEADBAND))
       {
          // Yes - this is asignificant change.
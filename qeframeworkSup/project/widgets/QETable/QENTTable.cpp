@@ -3,7 +3,7 @@
  *  This file is part of the EPICS QT Framework, initially developed at the
  *  Australian Synchrotron.
  *
- *  SPDX-FileCopyrightText: 2018-2025 Australian Synchrotron
+ *  SPDX-FileCopyrightText: 2018-2026 Australian Synchrotron
  *  SPDX-License-Identifier: LGPL-3.0-only
  *
  *  Author:     Andrew Starritt
@@ -23,6 +23,7 @@
 #include <QEFloating.h>
 #include <QHeaderView>
 #include <QENTTableData.h>
+#include <QETableModel.h>
 
 #define DEBUG qDebug () << "QENTTable" << __LINE__ << __FUNCTION__ << "  "
 
@@ -31,6 +32,118 @@
 #define DEFAULT_CELL_HEIGHT     22
 #define NULL_SELECTION          (-1)
 
+//=============================================================================
+// TableModel class - provides the NTTable data to the internal table view.
+// Each table column is a set.
+//=============================================================================
+//
+class QENTTable::TableModel : public QETableModel {
+public:
+   explicit TableModel (QENTTable* owner);
+   ~TableModel ();
+
+   // When blank, no data is presented, but the table shape is retained.
+   //
+   void setBlank (const bool isBlank);
+
+protected:
+   int getSetCount () const;
+   int getElementCount () const;
+   QString getSetTitle (const int set) const;
+   QVariant getElementData (const int set, const int element, const int role) const;
+
+private:
+   QENTTable* owner;
+   bool isBlank;
+};
+
+//-----------------------------------------------------------------------------
+//
+QENTTable::TableModel::TableModel (QENTTable* ownerIn) : QETableModel (ownerIn)
+{
+   this->owner = ownerIn;
+   this->isBlank = false;
+}
+
+//-----------------------------------------------------------------------------
+//
+QENTTable::TableModel::~TableModel () { }
+
+//-----------------------------------------------------------------------------
+//
+void QENTTable::TableModel::setBlank (const bool isBlankIn)
+{
+   if (this->isBlank != isBlankIn) {
+      this->isBlank = isBlankIn;
+      this->titlesChanged ();
+      this->allChanged ();
+   }
+}
+
+//-----------------------------------------------------------------------------
+//
+int QENTTable::TableModel::getSetCount () const
+{
+   return this->owner->tableData->getColCount ();
+}
+
+//-----------------------------------------------------------------------------
+//
+int QENTTable::TableModel::getElementCount () const
+{
+   return this->owner->tableData->getRowCount ();
+}
+
+//-----------------------------------------------------------------------------
+//
+QString QENTTable::TableModel::getSetTitle (const int set) const
+{
+   if (this->isBlank || (set >= this->getSetCount ())) {
+      return QString::number (set + 1);
+   }
+   return this->owner->tableData->getLabels ().value (set, "-");
+}
+
+//-----------------------------------------------------------------------------
+// Called by the view - only for visible cells.
+//
+QVariant QENTTable::TableModel::getElementData (const int set, const int element,
+                                                const int role) const
+{
+   if (this->isBlank) return QVariant ();
+   if (set >= this->getSetCount ()) return QVariant ();
+
+   const QVariantList dataSet = this->owner->tableData->getColData (set);
+
+   switch (role) {
+      case Qt::DisplayRole:
+         {
+            const QVariant datum = dataSet.value (element, QVariant ("-"));
+            const QString image = datum.toString ();
+            return QVariant (QString(" %1 ").arg (image));
+         }
+
+      case Qt::TextAlignmentRole:
+         {
+            // Use the first element to ensure all rows have same alignment.
+            //
+            const QVariant datum = dataSet.value (0, QVariant ("-"));
+            const QMetaType::Type mtype = QEPlatform::metaType (datum);
+            if (mtype == QMetaType::QString) {
+               return QVariant (int (Qt::AlignLeft | Qt::AlignVCenter));
+            } else {
+               return QVariant (int (Qt::AlignRight | Qt::AlignVCenter));
+            }
+         }
+
+      default:
+         break;
+   }
+
+   return QVariant ();
+}
+
+
 //=============================================================================
 // Constructor with no initialisation
 //=============================================================================
@@ -74,7 +187,9 @@ void QENTTable::commonConstruct ()
 
    // We always have at least one row and one col.
    //
-   this->table = new QTableWidget (1, 1);
+   this->model = new TableModel (this);
+   this->table = new QTableView ();
+   this->table->setModel (this->model);
 
    // Copy actual widget size policy to the containing widget, then ensure
    // internal widget will expand to fill container widget.
@@ -130,11 +245,11 @@ void QENTTable::commonConstruct ()
 
    // Table related signals
    //
-   QObject::connect (this->table, SIGNAL (cellClicked      (int, int)),
-                     this,        SLOT   (gridCellClicked  (int, int)));
+   QObject::connect (this->table, SIGNAL (clicked          (const QModelIndex&)),
+                     this,        SLOT   (gridCellClicked  (const QModelIndex&)));
 
-   QObject::connect (this->table, SIGNAL (cellEntered      (int, int)),
-                     this,        SLOT   (gridCellEntered  (int, int)));
+   QObject::connect (this->table, SIGNAL (entered          (const QModelIndex&)),
+                     this,        SLOT   (gridCellEntered  (const QModelIndex&)));
 
    this->table->setMouseTracking (true);   // need this for cell entered.
 
@@ -208,6 +323,11 @@ QEChannel* QENTTable::createQcaItem (unsigned int variableIndex)
    QEChannel* result = new QEChannel (pvName, this, PV_VARIABLE_INDEX);
 
    // using setSingleVariableQCaProperties not applicable here
+   // but do apply the client-side update filtering.
+   //
+   result->setAbsoluteDeadband (this->getDeadband ());
+   result->setRelativeDeadband (this->getRelativeDeadband ());
+   result->setMaxUpdateRate (this->getMaxUpdateRate ());
 
    return result;
 }
@@ -311,7 +431,7 @@ void QENTTable::connectionUpdated (const QEConnectionUpdate& update)
    // widget contents. Om disconnext, this leva last know values
    // on display, albeit grayed out.
    //
-   if (isConnected) this->table->clear();
+   if (isConnected) this->model->setBlank (true);
 
    // Enable internal widget iff connected.
    // Container widget remains enabled, so menues etc. still work.
@@ -347,6 +467,11 @@ void QENTTable::tableDataUpdated (const QEVariantUpdate& update)
    QEChannel* qca = this->getQcaItem (vi);
    if (!qca) return;  // sanity check
 
+   // Keep the previous data so that we can determine what has changed.
+   // Note: the column data lists are implicitly shared, so this is cheap.
+   //
+   const QENTTableData previous = *this->tableData;
+
    if (!this->tableData->assignFromVariant (update.value)) {
       if (update.isMetaUpdate) {
          QString pvname = this->getSubstitutedVariableName (vi);
@@ -366,7 +491,29 @@ void QENTTable::tableDataUpdated (const QEVariantUpdate& update)
       this->pvNameLabel->setText (qualifiedPvName);
    }
 
-   this->populateTable ();
+   this->model->setBlank (false);
+
+   const int cols = this->tableData->getColCount ();
+   if ((previous.getColCount () != cols) ||
+       (previous.getLabels () != this->tableData->getLabels ())) {
+      // Table structure has changed.
+      //
+      this->populateTable ();
+
+   } else {
+      // Just redraw the elements that have changed.
+      //
+      this->model->updateShape ();
+      for (int col = 0; col < cols; col++) {
+         int first;
+         int last;
+         if (QETableModel::findChangedRange (previous.getColData (col),
+                                             this->tableData->getColData (col),
+                                             first, last)) {
+            this->model->elementsChanged (col, first, last);
+         }
+      }
+   }
 
    // Invoke common alarm handling processing.
    //
@@ -393,7 +540,7 @@ void QENTTable::resizeCoulumns ()
    int otherStuff;
    int colWidth;
 
-   count = this->table->columnCount ();
+   count = this->model->columnCount ();
    count = MAX (1, count);
 
    // Allow for side headers and scroll bar.
@@ -413,151 +560,15 @@ void QENTTable::resizeCoulumns ()
 //
 void QENTTable::populateTable ()
 {
-   if (this->isVertical ()) {
-      this->populateVerticalTable ();
-   }  else {
-      this->populateHorizontalTable ();
-   }
+   // Ensure table just large enough to accomodate all row/cols.
+   // The cells are formatted on demand, i.e. only those that are visible.
+   //
+   this->model->updateShape ();
+   this->model->titlesChanged ();
+   this->model->allChanged ();
    this->rePopulateData = false;
 }
 
-//------------------------------------------------------------------------------
-//
-void QENTTable::populateVerticalTable ()
-{
-   if (!this->table) return;      // sanity check
-   if (!this->tableData) return;  // sanity check
-
-   const int cols = this->tableData->getColCount ();
-   const int rows = this->tableData->getRowCount ();
-   const QStringList headers = this->tableData->getLabels();
-
-   QTableWidgetItem* item;
-
-   this->table->setColumnCount (MAX (cols, 1));
-   this->table->setRowCount (MAX (rows, 1));
-
-   for (int col = 0; col < cols; col++) {
-      // Set the title - allocate title item if needs be.
-      //
-      item = this->table->horizontalHeaderItem (col);
-      if (!item) {
-         item = new QTableWidgetItem ();
-         this->table->setHorizontalHeaderItem (col, item);
-      }
-      item->setText (headers.value (col, "-"));
-
-      QVariantList dataSet = this->tableData->getColData (col);
-
-      Qt::Alignment itemAlignment;
-      for (int row = 0; row < rows; row++) {
-         const QVariant datum = dataSet.value (row, QVariant ("-"));
-
-         if (row == 0) {
-            item = this->table->verticalHeaderItem (row);
-            if (!item) {
-               item = new QTableWidgetItem ();
-               this->table->setVerticalHeaderItem (row, item);
-            }
-            item->setText (QString::number(row + 1));
-
-            // Do this once to ensure all rows have same alignment.
-            //
-            const QMetaType::Type mtype = QEPlatform::metaType (datum);
-            if (mtype == QMetaType::QString) {
-               itemAlignment = (Qt::AlignLeft | Qt::AlignVCenter);
-            } else {
-               itemAlignment = (Qt::AlignRight | Qt::AlignVCenter);
-            }
-         }
-
-         // Create table item if needs be.
-         //
-         item = this->table->item (row, col);
-         if (!item) {
-            // We need to allocate item and insert it into the table.
-            //
-            item = new QTableWidgetItem ();
-            item->setFlags (Qt::ItemIsSelectable | Qt::ItemIsEnabled);
-            this->table->setItem (row, col, item);
-         }
-         item->setTextAlignment (itemAlignment);
-
-         const QString image = datum.toString ();
-         item->setText (QString(" %1 ").arg (image));
-      }
-   }
-}
-
-//------------------------------------------------------------------------------
-// keep in step with populateVerticalTable
-//
-void QENTTable::populateHorizontalTable ()
-{
-   if (!this->table) return;      // sanity check
-   if (!this->tableData) return;  // sanity check
-
-   const int cols = this->tableData->getRowCount ();
-   const int rows = this->tableData->getColCount ();
-   const QStringList headers = this->tableData->getLabels();
-
-   QTableWidgetItem* item;
-
-   this->table->setColumnCount (MAX (cols, 1));
-   this->table->setRowCount (MAX (rows, 1));
-
-   for (int row = 0; row < rows; row++) {
-      // Set the title - allocate title item if needs be.
-      //
-      item = this->table->verticalHeaderItem (row);
-      if (!item) {
-         item = new QTableWidgetItem ();
-         this->table->setVerticalHeaderItem (row, item);
-      }
-      item->setText (headers.value (row, "-"));
-
-      QVariantList dataSet = this->tableData->getColData (row);
-
-      Qt::Alignment itemAlignment;
-      for (int col = 0; col < cols; col++) {
-         const QVariant datum = dataSet.value (col, QVariant ("-"));
-
-         if (col == 0) {
-            item = this->table->horizontalHeaderItem (col);
-            if (!item) {
-               item = new QTableWidgetItem ();
-               this->table->setHorizontalHeaderItem (col, item);
-            }
-            item->setText (QString::number(col + 1));
-
-            // Do this once to ensure all cols have same alignment.
-            //
-            const QMetaType::Type mtype = QEPlatform::metaType (datum);
-            if (mtype == QMetaType::QString) {
-               itemAlignment = (Qt::AlignLeft | Qt::AlignVCenter);
-            } else {
-               itemAlignment = (Qt::AlignRight | Qt::AlignVCenter);
-            }
-         }
-
-         // Create table item if needs be.
-         //
-         item = this->table->item (row, col);
-         if (!item) {
-            // We need to allocate item and insert it into the table.
-            //
-            item = new QTableWidgetItem ();
-            item->setFlags (Qt::ItemIsSelectable | Qt::ItemIsEnabled);
-            this->table->setItem (row, col, item);
-         }
-         item->setTextAlignment (itemAlignment);
-
-         const QString image = datum.toString ();
-         item->setText (QString(" %1 ").arg (image));
-      }
-   }
-}
-
 //------------------------------------------------------------------------------
 //
 void QENTTable::timeout ()
@@ -586,9 +597,9 @@ void QENTTable::usePvNameProperties (const QEPvNameProperties& pvNameProperties)
 // User has clicked on cell or used up/down/left/right key to select cell,
 // or we have programtically selected a row/coll.
 //
-void QENTTable::gridCellClicked (int row, int column)
+void QENTTable::gridCellClicked (const QModelIndex& index)
 {
-   this->selection = (this->isVertical () ? row : column);
+   this->selection = (this->isVertical () ? index.row () : index.column ());
 
    // This prevents infinite looping in the case of cyclic connections.
    //
@@ -599,10 +610,10 @@ void QENTTable::gridCellClicked (int row, int column)
 
 //------------------------------------------------------------------------------
 //
-void QENTTable::gridCellEntered (int, int)
+void QENTTable::gridCellEntered (const QModelIndex&)
 {
    // place holder
-   // qDebug () << __FUNCTION__ << row << column;
+   // qDebug () << __FUNCTION__ << index.row () << index.column ();
 }
 
 //------------------------------------------------------------------------------
@@ -695,6 +706,7 @@ void QENTTable::setOrientation (const Qt::Orientation orientationIn)
       } else {
          this->table->setSelectionBehavior (QAbstractItemView::SelectColumns);
       }
+      this->model->setOrientation (this->orientation);
       this->populateTable ();
    }
 }
@@ -20,7 +20,7 @@
 #include <QString>
 #include <QStringList>
 #include <QSize>
-#include <QTableWidget>
+#include <QTableView>
 #include <QTimer>
 #include <QVBoxLayout>
 #include <QVector>
@@ -68,6 +68,21 @@ public:
    ///
    Q_PROPERTY (QString variableSubstitutions READ getVariableNameSubstitutionsProperty WRITE setVariableNameSubstitutionsProperty)
 
+   /// Absolute deadband. Numeric updates within this deadband of the last value
+   /// presented are not passed on to the widget. The default is 0.0, i.e. no deadband.
+   ///
+   Q_PROPERTY (double deadband READ getDeadband WRITE setDeadband)
+
+   /// Relative deadband, expressed as a percentage of the last value presented.
+   /// The default is 0.0, i.e. no deadband.
+   ///
+   Q_PROPERTY (double relativeDeadband READ getRelativeDeadband WRITE setRelativeDeadband)
+
+   /// Maximum rate (Hz) at which updates are passed on to the widget. The most recent
+   /// value is always presented eventually. The default is 0.0, i.e. no limit.
+   ///
+   Q_PROPERTY (double maxUpdateRate READ getMaxUpdateRate WRITE setMaxUpdateRate)
+
    /// Controls if PV name displayed. Default is false.
    ///
    Q_PROPERTY (bool showPvName        READ getShowPvName       WRITE setShowPvName)
@@ -187,17 +202,18 @@ protected:
    void paste (QVariant s);
 
 private:
+   class TableModel;          // private and differed.
+
    void commonConstruct ();   //
    bool isVertical () const;  // True iff the orientation is Qt::Vertical
    void resizeCoulumns ();    // Resizes colums to fit available space
 
-   void populateTable ();             //
-   void populateVerticalTable ();     //
-   void populateHorizontalTable ();   //
+   void populateTable ();     // Re-shapes the table and redraws all cells
 
    QENTTableData* tableData;
    QLabel* pvNameLabel;         // Displays the PV name
-   QTableWidget* table;         // internal widget
+   QTableView* table;           // internal widget
+   TableModel* model;           // provides the table data to the internal widget
    QVBoxLayout* layout;         // holds the name label and internal widget
    QTimer* rePopulateTimer;
    int displayMaximum;          // not used ... yet.
@@ -213,10 +229,12 @@ private slots:
    void connectionUpdated (const QEConnectionUpdate&);
    void tableDataUpdated (const QEVariantUpdate&);
 
-   void gridCellClicked (int row, int column);
-   void gridCellEntered (int row, int column);
+   void gridCellClicked (const QModelIndex& index);
+   void gridCellEntered (const QModelIndex& index);
 
    void timeout ();
+
+   friend class TableModel;
 };
 
 #endif // QE_TABLE_H
@@ -24,6 +24,7 @@
 #include <QECommon.h>
 #include <QEPlatform.h>
 #include <QEVectorVariants.h>
+#include <QETableModel.h>
 
 #define DEBUG qDebug () << "QETable" << __LINE__ << __FUNCTION__ << "  "
 
@@ -95,174 +96,161 @@ bool QETable::DataSets::isInUse () const
 
 //-----------------------------------------------------------------------------
 //
-void QETable::DataSets::rePopulateTable ()
+QString QETable::DataSets::getTitleText () const
 {
-   QTableWidget* table = this->owner->table;  // alias
-   QString titleText;
-   int currentSize;
-   QTableWidgetItem* item;
-
-   if (!table) return;                   // sainity check
-   if (!this->isInUse ()) return;        // nothing to see here ... move along ...
-
-   // Find own row/col index
-   //
-   this->index = 0;
-   for (int j = 0; j < this->slot; j++) {
-      if (this->owner->dataSet [j].isInUse ()) {
-         this->index++;
-      }
-   }
-
    // Extract the title for this row/col.
    // If null just use the index, if <> use PV name.
    //
-   titleText = this->title;
+   QString titleText = this->title;
    if (titleText.isEmpty ()) {
       titleText.setNum (this->index + 1);
    } else if (titleText == "<>") {
       titleText = this->pvName;
    }
+   return titleText;
+}
 
-   // Ensure table large enough to accomodate all row/cols.
-   //
-   if (this->owner->isVertical ()) {
-      currentSize = table->columnCount ();
-      table->setColumnCount (MAX (currentSize, this->index + 1));
-
-      // Set the title - allocate title item if needs be.
-      //
-      item = table->horizontalHeaderItem (this->index);
-      if (!item) {
-         item = new QTableWidgetItem ();
-         table->setHorizontalHeaderItem (index, item);
-      }
-      item->setText (titleText);
+//-----------------------------------------------------------------------------
+// Called by the model - only for visible cells.
+//
+QVariant QETable::DataSets::getElementData (const int element, const int role) const
+{
+   const bool isData = (element >= 0) && (element < this->data.count ());
+
+   switch (role) {
+      case Qt::DisplayRole:
+         {
+            QString image;
+            if (isData) {
+               const QVariant value = this->data.at (element);
+               bool okay;
+               const double dValue = value.toDouble (&okay);
+               if (okay) {
+                  image = this->stringFormatting.formatString (QVariant (dValue), 0);
+               } else {
+                  image = value.toString();
+               }
+            } else {
+               // Beyond end of data
+               image = "";
+            }
+            return QVariant (QString(" %1 ").arg (image));
+         }
 
-      // Ensure other title is "1" - only need to do the first header item.
-      //
-      item = table->verticalHeaderItem (0);
-      if (!item) {
-         item = new QTableWidgetItem ();
-         table->setVerticalHeaderItem (0, item);
-      }
-      item->setText ("1");
+      case Qt::TextAlignmentRole:
+         {
+            // Use the first element to ensure all rows have same alignment.
+            //
+            const QMetaType::Type mtype = QEPlatform::metaType (this->data.value (0));
+            if (mtype == QMetaType::QString) {
+               return QVariant (int (Qt::AlignLeft | Qt::AlignVCenter));
+            } else {
+               return QVariant (int (Qt::AlignRight | Qt::AlignVCenter));
+            }
+         }
 
-   } else {
-      currentSize = table->rowCount ();
-      table->setRowCount (MAX (currentSize, this->index + 1));
+      case Qt::BackgroundRole:
+         {
+            // Use connected/alarm state to find background colour.
+            //
+            QColor backgroundColour;
+            if (!isData) {
+               backgroundColour = QColor (0xc8c8c8);   // light gray
+            } else if (this->isConnected) {
+               backgroundColour = QColor ("#e0e0e0");   // hypothrsize no alram colour.
+
+               bool useAlarmState = this->owner->getUseAlarmState (alarmInfo);
+               if (useAlarmState) {
+                  backgroundColour = QColor (alarmInfo.getStyleColorName ());
+               }
+            } else {
+               backgroundColour = QColor ("white");
+            }
+            return QVariant (QBrush (backgroundColour, Qt::SolidPattern));
+         }
 
-      // Set the title - allocate title item if needs be.
-      //
-      item = table->verticalHeaderItem (this->index);
-      if (!item) {
-         item = new QTableWidgetItem ();
-         table->setVerticalHeaderItem (index, item);
-      }
-      item->setText (titleText);
+      case Qt::ForegroundRole:
+         {
+            const QColor textColour = this->isConnected ? QColor ("black") : QColor ("grey");
+            return QVariant (QBrush (textColour, Qt::SolidPattern));
+         }
 
-      // Ensure other title is "1" - only need to do the first header item.
-      //
-      item = table->horizontalHeaderItem (0);
-      if (!item) {
-         item = new QTableWidgetItem ();
-         table->setHorizontalHeaderItem (0, item);
-      }
-      item->setText ("1");
+      default:
+         break;
    }
+
+   return QVariant ();
 }
 
-//-----------------------------------------------------------------------------
+//=============================================================================
+// TableModel class - provides the data sets to the internal table view.
+//=============================================================================
 //
-void QETable::DataSets::rePopulateData ()
-{
-   QTableWidget* table = this->owner->table;  // alias
-   QBrush brush;
-   QColor backgroundColour;
-   QColor textColour;
-
-   if (!table) return;                   // sainity check
-   if (!this->isInUse ()) return;        // nothing to see here ... move along ...
-   if (this->index < 0) return;
+class QETable::TableModel : public QETableModel {
+public:
+   explicit TableModel (QETable* owner);
+   ~TableModel ();
 
-   brush.setStyle (Qt::SolidPattern);
+protected:
+   int getSetCount () const;
+   int getElementCount () const;
+   QString getSetTitle (const int set) const;
+   QVariant getElementData (const int set, const int element, const int role) const;
 
-   // Use connected/alarm state to find background/foreground colours.
-   //
-   if (this->isConnected) {
-      backgroundColour = QColor ("#e0e0e0");   // hypothrsize no alram colour.
+private:
+   const DataSets* dataSetOf (const int set) const;
+   QETable* owner;
+};
 
-      bool useAlarmState = this->owner->getUseAlarmState (alarmInfo);
-      if (useAlarmState) {
-         backgroundColour = QColor (alarmInfo.getStyleColorName ());
-      }
+//-----------------------------------------------------------------------------
+//
+QETable::TableModel::TableModel (QETable* ownerIn) : QETableModel (ownerIn)
+{
+   this->owner = ownerIn;
+}
 
-      textColour = QColor ("black");
+//-----------------------------------------------------------------------------
+//
+QETable::TableModel::~TableModel () { }
 
-   } else {
-      backgroundColour = QColor ("white");
-      textColour = QColor ("grey");
-   }
+//-----------------------------------------------------------------------------
+//
+const QETable::DataSets* QETable::TableModel::dataSetOf (const int set) const
+{
+   const int slot = this->owner->inUseSlots.value (set, -1);
+   if ((slot < 0) || (slot >= ARRAY_LENGTH (this->owner->dataSet))) return NULL;
+   return &this->owner->dataSet [slot];
+}
 
-   // Get current table size - set up eslewhere.
-   //
-   int currentSize;
-   if (this->owner->isVertical ()) {
-      currentSize = table->rowCount ();
-   } else {
-      currentSize = table->columnCount ();
-   }
+//-----------------------------------------------------------------------------
+//
+int QETable::TableModel::getSetCount () const
+{
+   return this->owner->inUseSlots.count ();
+}
 
-   Qt::Alignment itemAlignment;
-   for (int j = 0; j <  currentSize; j++) {
-      int row = this->owner->isVertical () ? j : this->index;
-      int col = this->owner->isVertical () ? this->index : j;
-
-      const QVariant element = this->data.value (j);
-      if (j == 0) {
-          // Do this once to ensure all rows have same alignment.
-          //
-          const QMetaType::Type mtype = QEPlatform::metaType (element);
-          if (mtype == QMetaType::QString) {
-             itemAlignment = (Qt::AlignLeft | Qt::AlignVCenter);
-          } else {
-             itemAlignment = (Qt::AlignRight | Qt::AlignVCenter);
-          }
-       }
-
-      QTableWidgetItem* item = table->item (row, col);
-      if (!item) {
-         // We need to allocate item and insert it into the table.
-         //
-         item = new QTableWidgetItem ();
-         item->setFlags (Qt::ItemIsSelectable | Qt::ItemIsEnabled);
-         table->setItem (row, col, item);
-      }
-      item->setTextAlignment (itemAlignment);
-
-      QString image;
-      if (j < this->data.count ()) {
-         const QVariant element = this->data.value (j);
-         bool okay;
-         const double value = element.toDouble (&okay);
-         if (okay) {
-            image = this->stringFormatting.formatString (QVariant (value), 0);
-         } else {
-            image = element.toString();
-         }
-      } else {
-         // Beyond end of data
-         image = "";
-         backgroundColour = QColor (0xc8c8c8);   // light gray
-      }
+//-----------------------------------------------------------------------------
+//
+int QETable::TableModel::getElementCount () const
+{
+   return this->owner->dataSize ();
+}
 
-      item->setText (QString(" %1 ").arg (image));
+//-----------------------------------------------------------------------------
+//
+QString QETable::TableModel::getSetTitle (const int set) const
+{
+   const DataSets* ds = this->dataSetOf (set);
+   return ds ? ds->getTitleText () : QString::number (set + 1);
+}
 
-      brush.setColor (backgroundColour);
-      item->setBackground (brush);
-      brush.setColor (textColour);
-      item->setForeground (brush);
-   }
+//-----------------------------------------------------------------------------
+//
+QVariant QETable::TableModel::getElementData (const int set, const int element,
+                                              const int role) const
+{
+   const DataSets* ds = this->dataSetOf (set);
+   return ds ? ds->getElementData (element, role) : QVariant ();
 }
 
 //==============================================================================
@@ -283,9 +271,11 @@ void QETable::DataSets::rePopulateData ()
 //
 QETable::QETable (QWidget* parent) : QEAbstractDynamicWidget (parent)
 {
-   // Create internal widget. We always have at least one row and one col.
+   // Create internal widget and model. We always have at least one row and one col.
    //
-   this->table = new QTableWidget (1, 1, this);
+   this->model = new TableModel (this);
+   this->table = new QTableView (this);
+   this->table->setModel (this->model);
 
    // Copy actual widget size policy to the containing widget, then ensure
    // internal widget will expand to fill container widget.
@@ -365,11 +355,11 @@ QETable::QETable (QWidget* parent) : QEAbstractDynamicWidget (parent)
 
    // Table related signals
    //
-   QObject::connect (this->table, SIGNAL (cellClicked      (int, int)),
-                     this,        SLOT   (gridCellClicked  (int, int)));
+   QObject::connect (this->table, SIGNAL (clicked          (const QModelIndex&)),
+                     this,        SLOT   (gridCellClicked  (const QModelIndex&)));
 
-   QObject::connect (this->table, SIGNAL (cellEntered      (int, int)),
-                     this,        SLOT   (gridCellEntered  (int, int)));
+   QObject::connect (this->table, SIGNAL (entered          (const QModelIndex&)),
+                     this,        SLOT   (gridCellEntered  (const QModelIndex&)));
 
    this->table->setMouseTracking (true);   // need this for cell entered.
 
@@ -495,6 +485,7 @@ void QETable::stringFormattingChange()
    for (int slot = 0; slot < ARRAY_LENGTH (this->dataSet); slot++) {
       this->dataSet[slot].stringFormatting = this->stringFormatting;
    }
+   this->rePopulateData = true;
 }
 
 //------------------------------------------------------------------------------
@@ -573,32 +564,49 @@ void QETable::dataArrayUpdated (const QEVariantUpdate& update)
    const bool slist = (mtype == QMetaType::QStringList);
    const bool vector = QEVectorVariants::isVectorVariant (update.value);
 
+   DataSets* ds = &this->dataSet [slot];   // alias
+
+   QVariantList newData;
    if (vlist || slist || vector) {
       // The value is some sort of array type, save as is.
       //
-      this->dataSet [slot].data = update.value.toList();
+      newData = update.value.toList();
    } else {
       // The value is a scalar type, create a list of one.
       //
-      QVariantList temp;
-      temp.append (update.value);
-      this->dataSet [slot].data = temp;
+      newData.append (update.value);
    }
-   this->dataSet [slot].alarmInfo = update.alarmInfo;
+
+   // Only the changed elements need be redrawn, unless the alarm state or
+   // meta data (which affect all elements) have changed.
+   //
+   int first;
+   int last;
+   bool isChanged = QETableModel::findChangedRange (ds->data, newData, first, last);
+   if (update.isMetaUpdate || (ds->alarmInfo != update.alarmInfo)) {
+      isChanged = true;
+      first = 0;
+      last = MAX (ds->data.count (), newData.count ());
+   }
+
+   ds->data = newData;
+   ds->alarmInfo = update.alarmInfo;
 
    QEChannel* qca = this->getQcaItem (vi);
    if (qca) {
       // Extract meta info.
       //
-      this->dataSet [slot].stringFormatting.setDbPrecision (qca->getPrecision());
-      this->dataSet [slot].stringFormatting.setDbEgu (qca->getEgu());
-      this->dataSet [slot].stringFormatting.setDbEnumerations (qca->getEnumerations());
+      ds->stringFormatting.setDbPrecision (qca->getPrecision());
+      ds->stringFormatting.setDbEgu (qca->getEgu());
+      ds->stringFormatting.setDbEnumerations (qca->getEnumerations());
    }
 
-   this->dataSet [slot].rePopulateData ();
-   // this->rePopulateData = true;
-
-   // this->rePopulationRequired = true;
+   // The number of rows (or cols when horizontal) may have changed.
+   //
+   this->model->updateShape ();
+   if (isChanged) {
+      this->model->elementsChanged (ds->index, first, last);
+   }
 
    // Signal a database value change to any Link widgets
    //
@@ -625,7 +633,7 @@ void QETable::resizeCoulumns ()
    int otherStuff;
    int colWidth;
 
-   count = this->table->columnCount ();
+   count = this->model->columnCount ();
    count = MAX (1, count);
 
    // Allow for side headers and scroll bar.
@@ -676,26 +684,29 @@ int QETable::dataSize () const
 void QETable::timeout ()
 {
    if (this->rePopulateAll) {
-      this->table->setRowCount (1);
-      this->table->setColumnCount (1);
+      this->model->setOrientation (this->orientation);
       this->rePopulateAll = false;
       this->rePopulateTitles = true;
    }
 
    if (this->rePopulateTitles) {
 
+      // Find own row/col index of each in use data set.
+      //
+      this->inUseSlots.clear ();
       for (int slot = 0; slot < ARRAY_LENGTH (this->dataSet); slot++) {
-         this->dataSet [slot].rePopulateTable ();
+         if (this->dataSet [slot].isInUse ()) {
+            this->dataSet [slot].index = this->inUseSlots.count ();
+            this->inUseSlots.append (slot);
+         } else {
+            this->dataSet [slot].index = -1;
+         }
       }
 
       // Ensure table just large enough to accomodate all row/cols.
       //
-      int number = this->numberInUse ();
-      if (this->isVertical ()) {
-         table->setColumnCount (number);
-      } else {
-         table->setRowCount (number);
-      }
+      this->model->updateShape ();
+      this->model->titlesChanged ();
       this->rePopulateTitles = false;
       this->rePopulateData = true;
    }
@@ -703,17 +714,10 @@ void QETable::timeout ()
    if (this->rePopulateData) {
 
       // Ensure table just large enough to accomodate all row/cols.
+      // The cells are formatted on demand, i.e. only those that are visible.
       //
-      int number = this->dataSize ();
-      if (this->isVertical ()) {
-         table->setRowCount (number);
-      } else {
-         table->setColumnCount (number);
-      }
-
-      for (int slot = 0; slot < ARRAY_LENGTH (this->dataSet); slot++) {
-         this->dataSet [slot].rePopulateData ();
-      }
+      this->model->updateShape ();
+      this->model->allChanged ();
       this->rePopulateData = false;
    }
 
@@ -751,9 +755,9 @@ void QETable::usePvNameProperties (const QEPvNameProperties& pvNameProperties)
 // User has clicked on cell or used up/down/left/right key to select cell,
 // or we have programtically selected a row/coll.
 //
-void QETable::gridCellClicked (int row, int column)
+void QETable::gridCellClicked (const QModelIndex& index)
 {
-   this->selection = (this->isVertical () ? row : column);
+   this->selection = (this->isVertical () ? index.row () : index.column ());
 
    // This prevents infinite looping in the case of cyclic connections.
    //
@@ -764,10 +768,10 @@ void QETable::gridCellClicked (int row, int column)
 
 //------------------------------------------------------------------------------
 //
-void QETable::gridCellEntered (int, int)
+void QETable::gridCellEntered (const QModelIndex&)
 {
    // place holder
-   // qDebug () << __FUNCTION__ << row << column;
+   // qDebug () << __FUNCTION__ << index.row () << index.column ();
 }
 
 //------------------------------------------------------------------------------
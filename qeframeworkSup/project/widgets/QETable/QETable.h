@@ -20,7 +20,7 @@
 #include <QString>
 #include <QStringList>
 #include <QSize>
-#include <QTableWidget>
+#include <QTableView>
 #include <QTimer>
 #include <QVariantList>
 #include <QVector>
@@ -97,7 +97,7 @@ public:
    Q_PROPERTY (QString variableSubstitutions READ getSubstitutions WRITE setSubstitutions)
 
    /// Allows specification of tables titles. If blank, the default, then out-of-the-box
-   /// QTableWidget heading are used, i.e. 1, 2, etc.  If "<>" is specified, then this is
+   /// table heading are used, i.e. 1, 2, etc.  If "<>" is specified, then this is
    /// replaced by the PV name. This is particulary useful when PV na,es are specifed
    /// dynamically or by substitution.
    ///
@@ -317,6 +317,8 @@ protected:
    void restoreConfiguration (PersistanceManager* pm, restorePhases restorePhase);
 
 private:
+   class TableModel;          // private and differed.
+
    bool isVertical () const;  // True iff the orientation is Qt::Vertical
    void resizeCoulumns ();    // Resizes colums to fit available space
    int numberInUse () const;  // Calculate the required number of cols (or rows when horizontal).
@@ -327,7 +329,8 @@ private:
    //
    int slotOf  (const unsigned int vi) { return int (vi); }
 
-   QTableWidget* table;         // internal widget
+   QTableView* table;           // internal widget
+   TableModel* model;           // provides the data to the internal widget
    QHBoxLayout* layout;         // holds the internal widget - any layout type will do
    QTimer* rePopulateTimer;
    int displayMaximum;
@@ -341,6 +344,10 @@ private:
    bool rePopulateTitles;
    bool rePopulateData;
 
+   // The slot of each in use data set, i.e. of each table col (or row when horizontal).
+   //
+   QVector<int> inUseSlots;
+
    // Per PV data.
    //
    class DataSets {
@@ -354,8 +361,11 @@ private:
       QString getPvName () const;
 
       bool isInUse () const;
-      void rePopulateTable ();
-      void rePopulateData ();
+
+      // Provides the col (or row when horizontal) title and cell data.
+      //
+      QString getTitleText () const;
+      QVariant getElementData (const int element, const int role) const;
 
       QVariantList data;
       QCaAlarmInfo alarmInfo;
@@ -365,11 +375,12 @@ private:
       bool isConnected;
       QEStringFormatting stringFormatting;  // each data set gets own copy
 
+      int index;  // <= slot . Is < if unused slots, -1 when not in use
+
    private:
       QETable* owner;
       int slot;
       QString pvName;
-      int index;  // <= slot . Is < if unused slots
    };
 
    DataSets dataSet [MAXIMUM_NUMBER_OF_VARIABLES];
@@ -379,10 +390,12 @@ private slots:
    void connectionUpdated (const QEConnectionUpdate&);
    void dataArrayUpdated (const QEVariantUpdate&);
 
-   void gridCellClicked (int row, int column);
-   void gridCellEntered (int row, int column);
+   void gridCellClicked (const QModelIndex& index);
+   void gridCellEntered (const QModelIndex& index);
 
    void timeout ();
+
+   friend class TableModel;
 };
 
 #endif // QE_TABLE_H
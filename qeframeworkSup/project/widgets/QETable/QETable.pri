@@ -4,7 +4,7 @@
 # the Australian Synchrotron. This file is included into and as part
 # of the overall framework.pro project file.
 #
-# SPDX-FileCopyrightText: 2017-2025 Australian Synchrotron
+# SPDX-FileCopyrightText: 2017-2026 Australian Synchrotron
 # SPDX-License-Identifier: LGPL-3.0-only
 #
 # Author:     Andrew Starritt
@@ -13,10 +13,12 @@
 #
 
 HEADERS += \
+    widgets/QETable/QETableModel.h \
     widgets/QETable/QETable.h \
     widgets/QETable/QENTTable.h
 
 SOURCES += \
+    widgets/QETable/QETableModel.cpp \
     widgets/QETable/QETable.cpp \
     widgets/QETable/QENTTable.cpp
 
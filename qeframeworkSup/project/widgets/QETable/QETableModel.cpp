@@ -0,0 +1,223 @@
+/*  QETableModel.cpp
+ *
+ *  This file is part of the EPICS QT Framework, initially developed at the
+ *  Australian Synchrotron.
+ *
+ *  SPDX-FileCopyrightText: 2026 Australian Synchrotron
+ *  SPDX-License-Identifier: LGPL-3.0-only
+ *
+ *  Author:     Andrew Starritt
+ *  Maintainer: Andrew Starritt
+ *  Contact:    andrews@ansto.gov.au
+ */
+
+#include "QETableModel.h"
+#include <QDebug>
+#include <QECommon.h>
+
+#define DEBUG qDebug () << "QETableModel" << __LINE__ << __FUNCTION__ << "  "
+
+//------------------------------------------------------------------------------
+//
+QETableModel::QETableModel (QObject* parent) : QAbstractTableModel (parent)
+{
+   this->orientation = Qt::Vertical;
+   this->numberOfSets = 1;
+   this->numberOfElements = 1;
+}
+
+//------------------------------------------------------------------------------
+//
+QETableModel::~QETableModel () { }
+
+//------------------------------------------------------------------------------
+//
+bool QETableModel::isVertical () const
+{
+   return (this->orientation != Qt::Horizontal);
+}
+
+//------------------------------------------------------------------------------
+//
+void QETableModel::setOrientation (const Qt::Orientation orientationIn)
+{
+   if (this->orientation != orientationIn) {
+      this->beginResetModel ();
+      this->orientation = orientationIn;
+      this->endResetModel ();
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+Qt::Orientation QETableModel::getOrientation () const
+{
+   return this->orientation;
+}
+
+//------------------------------------------------------------------------------
+//
+void QETableModel::resizeDimension (const bool isRows, int& current, const int required)
+{
+   if (required > current) {
+      if (isRows) {
+         this->beginInsertRows (QModelIndex (), current, required - 1);
+         current = required;
+         this->endInsertRows ();
+      } else {
+         this->beginInsertColumns (QModelIndex (), current, required - 1);
+         current = required;
+         this->endInsertColumns ();
+      }
+
+   } else if (required < current) {
+      if (isRows) {
+         this->beginRemoveRows (QModelIndex (), required, current - 1);
+         current = required;
+         this->endRemoveRows ();
+      } else {
+         this->beginRemoveColumns (QModelIndex (), required, current - 1);
+         current = required;
+         this->endRemoveColumns ();
+      }
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+void QETableModel::updateShape ()
+{
+   // We always have at least one row and one col.
+   //
+   const int sets = MAX (this->getSetCount (), 1);
+   const int elements = MAX (this->getElementCount (), 1);
+
+   this->resizeDimension (!this->isVertical (), this->numberOfSets, sets);
+   this->resizeDimension (this->isVertical (), this->numberOfElements, elements);
+}
+
+//------------------------------------------------------------------------------
+//
+void QETableModel::titlesChanged ()
+{
+   // When vertical, the sets are the columns, i.e. the horizontal header.
+   //
+   const Qt::Orientation header = this->isVertical () ? Qt::Horizontal : Qt::Vertical;
+   emit this->headerDataChanged (header, 0, this->numberOfSets - 1);
+}
+
+//------------------------------------------------------------------------------
+//
+void QETableModel::elementsChanged (const int set, const int firstIn, const int lastIn)
+{
+   if ((set < 0) || (set >= this->numberOfSets)) return;
+
+   const int first = MAX (firstIn, 0);
+   const int last = MIN (lastIn, this->numberOfElements - 1);
+   if (first > last) return;
+
+   emit this->dataChanged (this->indexOf (set, first), this->indexOf (set, last));
+}
+
+//------------------------------------------------------------------------------
+//
+void QETableModel::allChanged ()
+{
+   emit this->dataChanged (this->index (0, 0),
+                           this->index (this->rowCount () - 1, this->columnCount () - 1));
+}
+
+//------------------------------------------------------------------------------
+// static
+bool QETableModel::findChangedRange (const QVariantList& before,
+                                     const QVariantList& after,
+                                     int& first, int& last)
+{
+   const int nb = before.count ();
+   const int na = after.count ();
+   const int n = MAX (nb, na);
+
+   // Elements beyond the end of either list are deemed different.
+   //
+   first = 0;
+   while ((first < nb) && (first < na) && (before.at (first) == after.at (first))) {
+      first++;
+   }
+   if (first >= n) return false;   // same
+
+   last = n - 1;
+   while ((last > first) && (last < nb) && (last < na) && (before.at (last) == after.at (last))) {
+      last--;
+   }
+
+   return true;
+}
+
+//------------------------------------------------------------------------------
+//
+QModelIndex QETableModel::indexOf (const int set, const int element) const
+{
+   return this->isVertical () ? this->index (element, set) : this->index (set, element);
+}
+
+//------------------------------------------------------------------------------
+//
+int QETableModel::rowCount (const QModelIndex& parent) const
+{
+   if (parent.isValid ()) return 0;   // not a tree
+   return this->isVertical () ? this->numberOfElements : this->numberOfSets;
+}
+
+//------------------------------------------------------------------------------
+//
+int QETableModel::columnCount (const QModelIndex& parent) const
+{
+   if (parent.isValid ()) return 0;   // not a tree
+   return this->isVertical () ? this->numberOfSets : this->numberOfElements;
+}
+
+//------------------------------------------------------------------------------
+//
+QVariant QETableModel::data (const QModelIndex& index, int role) const
+{
+   if (!index.isValid ()) return QVariant ();
+
+   const int set     = this->isVertical () ? index.column () : index.row ();
+   const int element = this->isVertical () ? index.row () : index.column ();
+
+   if ((set >= this->numberOfSets) || (element >= this->numberOfElements)) {
+      return QVariant ();
+   }
+
+   return this->getElementData (set, element, role);
+}
+
+//------------------------------------------------------------------------------
+//
+QVariant QETableModel::headerData (int section, Qt::Orientation orientation,
+                                   int role) const
+{
+   if (role != Qt::DisplayRole) {
+      return QAbstractTableModel::headerData (section, orientation, role);
+   }
+
+   // The set header shows the set titles, the element header just numbers the
+   // elements from 1.
+   //
+   const bool isSetHeader = ((orientation == Qt::Horizontal) == this->isVertical ());
+   if (isSetHeader) {
+      return QVariant (this->getSetTitle (section));
+   } else {
+      return QVariant (QString::number (section + 1));
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+Qt::ItemFlags QETableModel::flags (const QModelIndex& index) const
+{
+   if (!index.isValid ()) return Qt::NoItemFlags;
+   return Qt::ItemIsSelectable | Qt::ItemIsEnabled;
+}
+
+// end
@@ -0,0 +1,96 @@
+/*  QETableModel.h
+ *
+ *  This file is part of the EPICS QT Framework, initially developed at the
+ *  Australian Synchrotron.
+ *
+ *  SPDX-FileCopyrightText: 2026 Australian Synchrotron
+ *  SPDX-License-Identifier: LGPL-3.0-only
+ *
+ *  Author:     Andrew Starritt
+ *  Maintainer: Andrew Starritt
+ *  Contact:    andrews@ansto.gov.au
+ */
+
+#ifndef QE_TABLE_MODEL_H
+#define QE_TABLE_MODEL_H
+
+#include <QAbstractTableModel>
+#include <QObject>
+#include <QString>
+#include <QVariant>
+#include <QVariantList>
+#include <QEFrameworkLibraryGlobal.h>
+
+/// This is the common model behind the QETable and QENTTable widgets.
+///
+/// The data is presented as a number of sets, each consisting of a number of
+/// elements. When in the vertical orientation, each set is a column and each
+/// element is a row; when horizontal, the table is transposed. The derived
+/// class provides the data by overriding the get functions below; cell data
+/// is only requested (and hence only formatted) for the visible cells.
+///
+/// The number of sets and elements presented to the view is only updated by
+/// updateShape, and both are always at least one.
+///
+class QE_FRAMEWORK_LIBRARY_SHARED_EXPORT QETableModel : public QAbstractTableModel
+{
+   Q_OBJECT
+public:
+   explicit QETableModel (QObject* parent = 0);
+   virtual ~QETableModel ();
+
+   // Changing the orientation resets the model.
+   //
+   void setOrientation (const Qt::Orientation orientation);
+   Qt::Orientation getOrientation () const;
+
+   // Re-reads the number of sets and elements, and inserts/removes rows and
+   // cols as need be.
+   //
+   void updateShape ();
+
+   // Notify views of changes. For elementsChanged, first and last are inclusive
+   // and limited to the current number of elements.
+   //
+   void titlesChanged ();
+   void elementsChanged (const int set, const int first, const int last);
+   void allChanged ();
+
+   // Finds the range of elements that differ between two lists. Returns false
+   // if the lists are the same.
+   //
+   static bool findChangedRange (const QVariantList& before,
+                                 const QVariantList& after,
+                                 int& first, int& last);
+
+   // Override QAbstractTableModel virtual functions.
+   //
+   int rowCount (const QModelIndex& parent = QModelIndex ()) const;
+   int columnCount (const QModelIndex& parent = QModelIndex ()) const;
+   QVariant data (const QModelIndex& index, int role = Qt::DisplayRole) const;
+   QVariant headerData (int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const;
+   Qt::ItemFlags flags (const QModelIndex& index) const;
+
+protected:
+   // Derived classes provide the data. Note: getElementData may be called for
+   // any set/element within the presented shape, which is not nessarily the
+   // same as the current set/element counts.
+   //
+   virtual int getSetCount () const = 0;
+   virtual int getElementCount () const = 0;
+   virtual QString getSetTitle (const int set) const = 0;
+   virtual QVariant getElementData (const int set, const int element,
+                                    const int role) const = 0;
+
+private:
+   bool isVertical () const;  // True iff the orientation is Qt::Vertical
+   QModelIndex indexOf (const int set, const int element) const;
+   void resizeDimension (const bool isRows, int& current, const int required);
+
+   Qt::Orientation orientation;
+   int numberOfSets;          // as presented to the view(s)
+   int numberOfElements;      // as presented to the view(s)
+};
+
+#endif // QE_TABLE_MODEL_H
@@ -0,0 +1,284 @@
+/*  QEResolvedPathCache.cpp
+ *
+ *  This file is part of the EPICS QT Framework, initially developed at the
+ *  Australian Synchrotron.
+ *
+ *  SPDX-FileCopyrightText: 2026 Australian Synchrotron
+ *  SPDX-License-Identifier: LGPL-3.0-only
+ *
+ *  Author:     Andrew Starritt
+ *  Maintainer: Andrew Starritt
+ *  Contact:    andrews@ansto.gov.au
+ */
+
+#include "QEResolvedPathCache.h"
+#include <QApplication>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QEAdaptationParameters.h>
+#include <QEFileMonitor.h>
+
+#define DEBUG qDebug () << "QEResolvedPathCache" << __LINE__ << __FUNCTION__ << "  "
+
+static bool resolvedPathCacheIsDestroyed = false;
+
+//------------------------------------------------------------------------------
+// static
+bool QEResolvedPathCache::isEnabled ()
+{
+   static bool determined = false;
+   static bool enabled = true;
+
+   if (!determined) {
+      QEAdaptationParameters ap ("QE_");
+      enabled = !ap.getBool ("disable_resolved_path_cache");  // default is false
+      determined = true;
+   }
+   return enabled;
+}
+
+//------------------------------------------------------------------------------
+// static
+QEResolvedPathCache* QEResolvedPathCache::singleton ()
+{
+   // As per QECaClientManager, the singleton object created when first needed.
+   //
+   static QEResolvedPathCache instance;
+   return &instance;
+}
+
+//------------------------------------------------------------------------------
+//
+QEResolvedPathCache::QEResolvedPathCache () : QObject (NULL)
+{
+   this->hits = 0;
+   this->negativeHits = 0;
+   this->misses = 0;
+   this->timer.start ();
+
+   QObject::connect (qApp, SIGNAL (aboutToQuit ()),
+                     this, SLOT   (aboutToQuitHandler ()));
+}
+
+//------------------------------------------------------------------------------
+//
+QEResolvedPathCache::~QEResolvedPathCache ()
+{
+   resolvedPathCacheIsDestroyed = true;
+}
+
+//------------------------------------------------------------------------------
+// static
+QString QEResolvedPathCache::makeKey (const QString& name,
+                                      const QString& parentPath,
+                                      const QStringList& pathList,
+                                      const QStringList& envPathList,
+                                      const QString& currentPath)
+{
+   // Use a separator that cannot sensibly occur in a path.
+   //
+   const QChar sep = QChar ('\n');
+
+   QString key = name;
+   key.append (sep).append (parentPath);
+   key.append (sep).append (pathList.join (QString (sep)));
+   key.append (sep).append (envPathList.join (QString (sep)));
+   key.append (sep).append (currentPath);
+   return key;
+}
+
+//------------------------------------------------------------------------------
+// static
+bool QEResolvedPathCache::lookup (const QString& key, QString& path)
+{
+   if (resolvedPathCacheIsDestroyed) return false;
+   if (!QEResolvedPathCache::isEnabled ()) return false;
+
+   QEResolvedPathCache* self = QEResolvedPathCache::singleton ();
+
+   if (!self->cache.contains (key)) {
+      self->misses++;
+      return false;
+   }
+
+   const Entry& entry = self->cache [key];
+
+   if (entry.path.isEmpty ()) {
+      // Negative entry - has it expired?
+      //
+      if (self->timer.elapsed () >= entry.expiry) {
+         self->remove (key);
+         self->misses++;
+         return false;
+      }
+      self->negativeHits++;
+      path = QString ();
+      return true;
+   }
+
+   // Positive entry - a single check is much cheaper than a full re-search.
+   //
+   if (!QFile::exists (entry.path)) {
+      self->remove (key);
+      self->misses++;
+      return false;
+   }
+
+   self->hits++;
+   path = entry.path;
+   return true;
+}
+
+//------------------------------------------------------------------------------
+// static
+void QEResolvedPathCache::insert (const QString& key, const QString& path,
+                                  const QStringList& searchList)
+{
+   if (resolvedPathCacheIsDestroyed) return;
+   if (!QEResolvedPathCache::isEnabled ()) return;
+
+   QEResolvedPathCache* self = QEResolvedPathCache::singleton ();
+
+   // Keep it simple - just start over if the cache gets too big.
+   //
+   if (self->cache.count () >= QEResolvedPathCache::maxEntries) {
+      QEResolvedPathCache::clear ();
+   }
+
+   self->remove (key);   // belt and braces
+
+   Entry entry;
+   entry.path = path;
+   entry.expiry = self->timer.elapsed () + QEResolvedPathCache::negativeLifetime;
+
+   // For a positive entry, only those directories up to and including that
+   // of the found file are relevant.
+   //
+   for (int j = 0; j < searchList.count (); j++) {
+      const QString filePath = searchList.value (j);
+      const QString directory = QDir::cleanPath (QFileInfo (filePath).absolutePath ());
+      if (!entry.directories.contains (directory)) {
+         entry.directories.append (directory);
+      }
+      if (!path.isEmpty () && (filePath == path)) break;
+   }
+
+   self->cache.insert (key, entry);
+
+   for (int j = 0; j < entry.directories.count (); j++) {
+      self->monitorDirectory (entry.directories.value (j), key);
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+void QEResolvedPathCache::monitorDirectory (const QString& directory, const QString& key)
+{
+   this->directoryKeys [directory].insert (key);
+
+   if (this->monitors.contains (directory)) return;
+
+   // Resource directories never change, and non-existent directories
+   // cannot be monitored (hence negative entries expire).
+   //
+   if (directory.startsWith (":")) return;
+   if (!QFileInfo (directory).isDir ()) return;
+
+   QEFileMonitor* monitor = new QEFileMonitor (directory, this);
+   QObject::connect (monitor, SIGNAL (directoryChanged (const QString&)),
+                     this,    SLOT   (directoryChanged (const QString&)));
+   this->monitors.insert (directory, monitor);
+}
+
+//------------------------------------------------------------------------------
+//
+void QEResolvedPathCache::remove (const QString& key)
+{
+   if (!this->cache.contains (key)) return;
+
+   const Entry entry = this->cache.take (key);
+
+   for (int j = 0; j < entry.directories.count (); j++) {
+      const QString directory = entry.directories.value (j);
+      if (!this->directoryKeys.contains (directory)) continue;
+
+      QSet<QString>& keys = this->directoryKeys [directory];
+      keys.remove (key);
+      if (keys.isEmpty ()) {
+         // No longer of interest.
+         //
+         this->directoryKeys.remove (directory);
+         QEFileMonitor* monitor = this->monitors.take (directory);
+         if (monitor) {
+            QObject::disconnect (monitor, NULL, this, NULL);
+            monitor->deleteLater ();
+         }
+      }
+   }
+}
+
+//------------------------------------------------------------------------------
+// static
+void QEResolvedPathCache::clear ()
+{
+   if (resolvedPathCacheIsDestroyed) return;
+
+   QEResolvedPathCache* self = QEResolvedPathCache::singleton ();
+   const QStringList keys = self->cache.keys ();
+   for (int j = 0; j < keys.count (); j++) {
+      self->remove (keys.value (j));
+   }
+}
+
+//------------------------------------------------------------------------------
+// static
+QString QEResolvedPathCache::statistics ()
+{
+   if (resolvedPathCacheIsDestroyed) return "";
+
+   const QEResolvedPathCache* self = QEResolvedPathCache::singleton ();
+
+   QString result;
+   result.append (QString ("entries:       %1\n").arg (self->cache.count ()));
+   result.append (QString ("directories:   %1\n").arg (self->monitors.count ()));
+   result.append (QString ("hits:          %1\n").arg (self->hits));
+   result.append (QString ("negative hits: %1\n").arg (self->negativeHits));
+   result.append (QString ("misses:        %1\n").arg (self->misses));
+   return result;
+}
+
+//------------------------------------------------------------------------------
+// static
+void QEResolvedPathCache::dump ()
+{
+   const QStringList lines = QEResolvedPathCache::statistics ().split ("\n");
+   for (int j = 0; j < lines.count(); j++) {
+      if (lines.value (j).isEmpty ()) continue;
+      DEBUG << lines.value (j).toStdString().c_str();   // drop quotes
+   }
+}
+
+//------------------------------------------------------------------------------
+// slot
+void QEResolvedPathCache::directoryChanged (const QString& path)
+{
+   // A file has been added, removed or renamed - invalidate all the entries
+   // that involved this directory.
+   //
+   const QSet<QString> keys = this->directoryKeys.value (path);
+   QSet<QString>::const_iterator it;
+   for (it = keys.constBegin (); it != keys.constEnd (); ++it) {
+      this->remove (*it);
+   }
+}
+
+//------------------------------------------------------------------------------
+// slot
+void QEResolvedPathCache::aboutToQuitHandler ()
+{
+   QEResolvedPathCache::clear ();
+}
+
+// end
@@ -0,0 +1,110 @@
+/*  QEResolvedPathCache.h
+ *
+ *  This file is part of the EPICS QT Framework, initially developed at the
+ *  Australian Synchrotron.
+ *
+ *  SPDX-FileCopyrightText: 2026 Australian Synchrotron
+ *  SPDX-License-Identifier: LGPL-3.0-only
+ *
+ *  Author:     Andrew Starritt
+ *  Maintainer: Andrew Starritt
+ *  Contact:    andrews@ansto.gov.au
+ */
+
+#ifndef QE_RESOLVED_PATH_CACHE_H
+#define QE_RESOLVED_PATH_CACHE_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QEFrameworkLibraryGlobal.h>
+
+class QEFileMonitor;   // differed
+
+/// The QEResolvedPathCache class caches the outcome of QEWidget::findQEFile
+/// relative file name searches. The key is formed from the file name and the
+/// search context, i.e. the parent path, path list, environment path list and
+/// the current directory, and the cached value is the resolved file path.
+///
+/// Failed searches are also cached (negative entries), as each failed probe may
+/// be expensive, e.g. on a network file system. Negative entries expire after a
+/// short time as non-existent directories cannot be monitored.
+///
+/// Each directory searched is monitored by a QEFileMonitor, and any directory
+/// change event invalidates all the entries that involved that directory.
+/// Positive entries are also re-validated by checking the file still exists.
+///
+/// The cache may be disabled by defining the QE_DISABLE_RESOLVED_PATH_CACHE
+/// environment variable, or equivalent adaptation parameter, as true.
+///
+/// All functions must be called from the main GUI thread.
+///
+class QE_FRAMEWORK_LIBRARY_SHARED_EXPORT QEResolvedPathCache : private QObject {
+   Q_OBJECT
+public:
+   static bool isEnabled ();
+
+   // Forms the cache key for the given name and search context.
+   //
+   static QString makeKey (const QString& name,
+                           const QString& parentPath,
+                           const QStringList& pathList,
+                           const QStringList& envPathList,
+                           const QString& currentPath);
+
+   // Returns true if the key is in the cache, in which case path is set to the
+   // resolved path, or an empty string for a negative entry.
+   //
+   static bool lookup (const QString& key, QString& path);
+
+   // Adds the search outcome to the cache. The searchList is the list of file
+   // paths probed, used to determine the directories to be monitored.
+   // An empty path denotes a negative entry.
+   //
+   static void insert (const QString& key, const QString& path,
+                       const QStringList& searchList);
+
+   static void clear ();
+
+   // Diagnostics - number of entries, monitored directories, hits and misses.
+   //
+   static QString statistics ();
+   static void dump ();          // diagnostic debug output only.
+
+private:
+   explicit QEResolvedPathCache ();
+   ~QEResolvedPathCache ();
+
+   static QEResolvedPathCache* singleton ();
+
+   struct Entry {
+      QString path;              // empty for a negative entry
+      qint64 expiry;             // negative entries only - mSec
+      QStringList directories;   // directories searched
+   };
+
+   // Limits
+   //
+   static const int maxEntries = 20000;
+   static const qint64 negativeLifetime = 10000;   // mSec
+
+   void remove (const QString& key);
+   void monitorDirectory (const QString& directory, const QString& key);
+
+   QHash<QString, Entry> cache;
+   QHash<QString, QSet<QString> > directoryKeys;      // directory => keys
+   QHash<QString, QEFileMonitor*> monitors;           // directory => monitor
+   QElapsedTimer timer;
+   int hits;
+   int negativeHits;
+   int misses;
+
+private slots:
+   void directoryChanged (const QString& path);
+   void aboutToQuitHandler ();
+};
+
+#endif // QE_RESOLVED_PATH_CACHE_H
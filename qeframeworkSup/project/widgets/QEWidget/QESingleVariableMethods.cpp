@@ -30,6 +30,9 @@ QESingleVariableMethods::QESingleVariableMethods
 {
    this->elementsRequired = REQUIRED_ELEMENTS_UNSPECIFIED;
    this->arrayIndex = 0;
+   this->deadband = 0.0;
+   this->relativeDeadband = 0.0;
+   this->maxUpdateRate = 0.0;
    this->vnpm.setVariableIndex (variableIndex);
 }
 
@@ -142,6 +145,66 @@ int QESingleVariableMethods::getArrayIndex () const
     return this->arrayIndex;
 }
 
+//------------------------------------------------------------------------------
+//
+void QESingleVariableMethods::setDeadband (const double deadbandIn)
+{
+   this->deadband = MAX (0.0, deadbandIn);
+
+   const unsigned int pvIndex = this->vnpm.getVariableIndex();
+   QEChannel* qca = this->owner->getQcaItem (pvIndex);
+   if (qca) {
+      qca->setAbsoluteDeadband (this->deadband);
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+double QESingleVariableMethods::getDeadband () const
+{
+   return this->deadband;
+}
+
+//------------------------------------------------------------------------------
+//
+void QESingleVariableMethods::setRelativeDeadband (const double relativeDeadbandIn)
+{
+   this->relativeDeadband = MAX (0.0, relativeDeadbandIn);
+
+   const unsigned int pvIndex = this->vnpm.getVariableIndex();
+   QEChannel* qca = this->owner->getQcaItem (pvIndex);
+   if (qca) {
+      qca->setRelativeDeadband (this->relativeDeadband);
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+double QESingleVariableMethods::getRelativeDeadband () const
+{
+   return this->relativeDeadband;
+}
+
+//------------------------------------------------------------------------------
+//
+void QESingleVariableMethods::setMaxUpdateRate (const double maxUpdateRateIn)
+{
+   this->maxUpdateRate = MAX (0.0, maxUpdateRateIn);
+
+   const unsigned int pvIndex = this->vnpm.getVariableIndex();
+   QEChannel* qca = this->owner->getQcaItem (pvIndex);
+   if (qca) {
+      qca->setMaxUpdateRate (this->maxUpdateRate);
+   }
+}
+
+//------------------------------------------------------------------------------
+//
+double QESingleVariableMethods::getMaxUpdateRate () const
+{
+   return this->maxUpdateRate;
+}
+
 //------------------------------------------------------------------------------
 // new style
 void QESingleVariableMethods::connectPvNameProperties (const char* useNameSlot)
@@ -176,6 +239,9 @@ void QESingleVariableMethods::setSingleVariableQCaProperties (QEChannel* qca)
          if (this->elementsRequired != REQUIRED_ELEMENTS_UNSPECIFIED) {
             qca->setRequestedElementCount (this->elementsRequired);
          }
+         qca->setAbsoluteDeadband (this->deadband);
+         qca->setRelativeDeadband (this->relativeDeadband);
+         qca->setMaxUpdateRate (this->maxUpdateRate);
       } else {
          DEBUG << "variable index mismatch qca:" << qca->getVariableIndex ()
                << "  property name:" <<  pvIndex;
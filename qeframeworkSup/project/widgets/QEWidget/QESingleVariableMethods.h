@@ -34,6 +34,9 @@ class QEWidget;   // differed
 //   QString variableSubstitutions
 //   int elementsRequired
 //   int arrayIndex
+//   double deadband
+//   double relativeDeadband
+//   double maxUpdateRate
 //
 // Use of this class by inheritance does not preclude a QE widget have more than one variable.
 // Also a second, or third, variable may be manged by adding additional instance(s) of this
@@ -96,6 +99,36 @@ public:
    ///
    int getArrayIndex () const;
 
+   /// Property access function for #deadband property. Numeric scalar updates
+   /// within this absolute deadband of the last value presented are not passed
+   /// on to the widget. Defaults to 0.0, i.e. no deadband.
+   /// If the assocated QEChannel exists, the deadband is applied immediately.
+   ///
+   void setDeadband (const double deadband);
+
+   /// Property access function for #deadband property.
+   ///
+   double getDeadband () const;
+
+   /// Property access function for #relativeDeadband property. As per #deadband,
+   /// but expressed as a percentage of the last value presented. Defaults to 0.0.
+   ///
+   void setRelativeDeadband (const double relativeDeadband);
+
+   /// Property access function for #relativeDeadband property.
+   ///
+   double getRelativeDeadband () const;
+
+   /// Property access function for #maxUpdateRate property. Limits the rate (Hz)
+   /// at which updates are passed on to the widget. The most recent value is
+   /// always presented eventually. Defaults to 0.0, i.e. no limit.
+   ///
+   void setMaxUpdateRate (const double maxUpdateRate);
+
+   /// Property access function for #maxUpdateRate property.
+   ///
+   double getMaxUpdateRate () const;
+
    /// Connects internal variable name property manager's newVariableNameProperty signal
    /// to the specified slot.
    ///
@@ -121,7 +154,7 @@ public:
    //
    // It also does
    //    qca->setRequestedElementCount (this->elementsRequired);
-   // if needs be.
+   // if needs be, and applies the deadband and maximum update rate.
    //
    // The QEChannels are destroyed and re-created as the name/substitution values change
    // so the array index must be re-applied each time the QEChannels is created.
@@ -132,6 +165,9 @@ private:
    QEWidget* owner;
    int elementsRequired;                  // defaults to 0, i.e. not specified
    int arrayIndex;                        // defaults to 0, restricted to >= 0
+   double deadband;                       // defaults to 0.0, i.e. none
+   double relativeDeadband;               // defaults to 0.0, i.e. none
+   double maxUpdateRate;                  // defaults to 0.0, i.e. no limit
    QCaVariableNamePropertyManager vnpm;
 };
 
@@ -32,6 +32,7 @@
 #include <QEForm.h>
 #include <QMainWindow>
 #include <QEGlobalStyle.h>
+#include <QEResolvedPathCache.h>
 
 #define DEBUG qDebug() << "QEWidget" << __LINE__ << __FUNCTION__ << "  "
 
@@ -353,7 +354,11 @@ QFile* QEWidget::findQEFile( QString name, ContainerProfile* profile )
    //  - The current directory
    //  - The environment variable QE_UI_PATH
    //
+   // The outcome of a relative path search is cached, keyed on the name and the
+   // search context, as each probe may be expensive (e.g. on a network file system).
+   //
    QStringList searchList;
+   QString cacheKey;
    if(  QDir::isAbsolutePath( name ) )
    {
       searchList.append( name );
@@ -362,8 +367,21 @@ QFile* QEWidget::findQEFile( QString name, ContainerProfile* profile )
    {
       QFileInfo fileInfo;
 
-      // Add the parent path from any parent QEForm
       QString parentPath =  profile->getParentPath();
+      QStringList pathList = profile->getPathList();
+      QStringList envPathList = profile->getEnvPathList();
+      QString currentPath = QDir::currentPath();
+
+      // Already resolved?
+      cacheKey = QEResolvedPathCache::makeKey( name, parentPath, pathList, envPathList, currentPath );
+      QString resolvedPath;
+      if( QEResolvedPathCache::lookup( cacheKey, resolvedPath ) )
+      {
+         // An empty resolved path means the file was not found last time.
+         return resolvedPath.isEmpty() ? NULL : new QFile( resolvedPath );
+      }
+
+      // Add the parent path from any parent QEForm
       if( !parentPath.isEmpty() )
       {
          fileInfo.setFile( parentPath, name );
@@ -371,7 +389,6 @@ QFile* QEWidget::findQEFile( QString name, ContainerProfile* profile )
       }
 
       // Add the paths from the path list in the container profile
-      QStringList pathList = profile->getPathList();
       for( int i = 0; i < pathList.count(); i++ )
       {
          QString path = pathList[i];
@@ -379,14 +396,13 @@ QFile* QEWidget::findQEFile( QString name, ContainerProfile* profile )
       }
 
       // Add paths from environment variable
-      QStringList envPathList = profile->getEnvPathList();
       for( int i = 0; i < envPathList.count(); i++ )
       {
          addPathToSearchList( envPathList[i], name, searchList );
       }
 
       // Add the current directory
-      fileInfo.setFile( QDir::currentPath(), name );
+      fileInfo.setFile( currentPath, name );
       searchList.append(  fileInfo.filePath() );
    }
 
@@ -400,6 +416,13 @@ QFile* QEWidget::findQEFile( QString name, ContainerProfile* profile )
       delete file;
       file = NULL;
    }
+
+   // Save the outcome of a relative path search, found or not.
+   if( !cacheKey.isEmpty() )
+   {
+      QEResolvedPathCache::insert( cacheKey, file ? file->fileName() : QString(), searchList );
+   }
+
    return file;
 }
 
@@ -30,6 +30,9 @@ HEADERS += $$PWD/QEFrameworkLibraryGlobal.h
 HEADERS += $$PWD/QEGlobalStyle.h
 SOURCES += $$PWD/QEGlobalStyle.cpp
 
+HEADERS += $$PWD/QEResolvedPathCache.h
+SOURCES += $$PWD/QEResolvedPathCache.cpp
+
 HEADERS += $$PWD/QESingleVariableMethods.h
 SOURCES += $$PWD/QESingleVariableMethods.cpp
 
@@ -24,14 +24,22 @@
 
 #include "UserMessage.h"
 #include <QDebug>
+#include <QMap>
+#include <QMutexLocker>
+#include <QPointer>
+#include <QStringList>
+#include <QThread>
+#include <QEAdaptationParameters.h>
 #include <QELog.h>
 
-#define DEBUG qDebug () << "QEDragDrop" << __LINE__ << __FUNCTION__ << "  "
+#define DEBUG qDebug () << "UserMessage" << __LINE__ << __FUNCTION__ << "  "
 
 // Static variables used to manage message signals and slots.
 UserMessageSignal UserMessage::userMessageSignal;
 unsigned int UserMessage::nextMessageFormId = 1;
 
+static bool userMessageSignalIsDestroyed = false;
+
 
 //------------------------------------------------------------------------------
 // Construction
@@ -77,16 +85,17 @@ UserMessage::UserMessage()
                              // for uninterested widgets would be lost (bad)
 
     childFormId = 0;
+    messagesCancelled = false;
 
     // Allow the object receiving messages to pass them back to us
     userMessageSlot.setOwner( this );
 
-    // Need to register the type prior to any connections as this used in inter-thread slignals.
+    // Need to register the types prior to any delivery as these are used in inter-thread messages.
     qRegisterMetaType<message_types> ("message_types");
+    qRegisterMetaType<UserMessage*> ("UserMessage*");
 
-    // Establish the connection between the common message signaler, and this instance's message slot
-    QObject::connect( &userMessageSignal, SIGNAL( message( QString, message_types, unsigned int, unsigned int, UserMessage* ) ),
-                      &userMessageSlot, SLOT( message( QString, message_types, unsigned int, unsigned int, UserMessage* ) ) );
+    // Subscribe this instance's message slot to the common message router
+    userMessageSignal.subscribe( &userMessageSlot );
 
     // Create the QELog master message receiver.
     //
@@ -97,6 +106,19 @@ UserMessage::UserMessage()
 // Destruction
 UserMessage::~UserMessage()
 {
+    // Must be unsubscribed before the message slot is destroyed
+    userMessageSignal.unsubscribe( &userMessageSlot );
+}
+
+//------------------------------------------------------------------------------
+// Update message routing after an ID or filter change
+void UserMessage::updateRoute()
+{
+    // Once cancelled, stay cancelled
+    if( !messagesCancelled )
+    {
+        userMessageSignal.subscribe( &userMessageSlot );
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -105,6 +127,7 @@ UserMessage::~UserMessage()
 void UserMessage::setSourceId( unsigned int sourceIdIn )
 {
     sourceId = sourceIdIn;
+    updateRoute();
 }
 
 //------------------------------------------------------------------------------
@@ -119,6 +142,7 @@ void UserMessage::setFormId( unsigned int formIdIn )
 void UserMessage::setFormFilter( QE::MessageFilterOptions formFilterIn )
 {
     formFilter = formFilterIn;
+    updateRoute();
 }
 
 //------------------------------------------------------------------------------
@@ -126,6 +150,7 @@ void UserMessage::setFormFilter( QE::MessageFilterOptions formFilterIn )
 void UserMessage::setSourceFilter( QE::MessageFilterOptions sourceFilterIn )
 {
     sourceFilter = sourceFilterIn;
+    updateRoute();
 }
 
 //------------------------------------------------------------------------------
@@ -161,6 +186,7 @@ QE::MessageFilterOptions UserMessage::getSourceFilter() const
 void UserMessage::setChildFormId( unsigned int childFormIdIn )
 {
     childFormId = childFormIdIn;
+    updateRoute();
 }
 
 //------------------------------------------------------------------------------
@@ -207,20 +233,215 @@ void UserMessage::sendMessage( QString msg,
     userMessageSignal.sendMessage( msg, type, formId, sourceId, this );
 }
 
+//==============================================================================
+// UserMessageSignal - message router
+//==============================================================================
+// Construction
+UserMessageSignal::UserMessageSignal()
+{
+    nextSerial = 0;
+    messageCount = 0;
+    deliveryCount = 0;
+    lastDeliveries = 0;
+    maxDeliveries = 0;
+}
+
+//------------------------------------------------------------------------------
+// Destruction
+UserMessageSignal::~UserMessageSignal()
+{
+    userMessageSignalIsDestroyed = true;
+}
+
+//------------------------------------------------------------------------------
+// static
+bool UserMessageSignal::routingIsEnabled()
+{
+    static bool determined = false;
+    static bool enabled = true;
+
+    if( !determined )
+    {
+        QEAdaptationParameters ap( "QE_" );
+        enabled = !ap.getBool( "disable_message_routing" );  // default is false
+        determined = true;
+    }
+    return enabled;
+}
+
+//------------------------------------------------------------------------------
+// Add or update the slot's route according to its owner's current settings.
+// The route mirrors the filtering performed by UserMessageSlot::message().
+void UserMessageSignal::subscribe( UserMessageSlot* slot )
+{
+    if( userMessageSignalIsDestroyed ) return;
+
+    const UserMessage* owner = slot->getOwner();
+    if( !owner ) return;
+
+    QMutexLocker locker( &mutex );
+
+    Route route;
+    route.serial = routes.contains( slot ) ? routes.value( slot ).serial : nextSerial++;
+    route.any = ( owner->formFilter == QE::Any ) || ( owner->sourceFilter == QE::Any );
+    route.matchForm = !route.any && ( owner->formFilter == QE::Match );
+    route.formId = owner->childFormId;
+    route.matchSource = !route.any && ( owner->sourceFilter == QE::Match );
+    route.sourceId = owner->sourceId;
+
+    removeRoute( slot );
+
+    routes.insert( slot, route );
+    if( route.any )         anyReceivers.insert( slot );
+    if( route.matchForm )   formReceivers.insert( route.formId, slot );
+    if( route.matchSource ) sourceReceivers.insert( route.sourceId, slot );
+}
+
 //------------------------------------------------------------------------------
-// Emit a signal to all other user message classes
+// Remove the slot's route, no further messages delivered
+void UserMessageSignal::unsubscribe( UserMessageSlot* slot )
+{
+    if( userMessageSignalIsDestroyed ) return;
+
+    QMutexLocker locker( &mutex );
+    removeRoute( slot );
+}
+
+//------------------------------------------------------------------------------
+// Note: caller must hold the mutex
+void UserMessageSignal::removeRoute( UserMessageSlot* slot )
+{
+    if( !routes.contains( slot ) ) return;
+
+    const Route route = routes.take( slot );
+    if( route.any )         anyReceivers.remove( slot );
+    if( route.matchForm )   formReceivers.remove( route.formId, slot );
+    if( route.matchSource ) sourceReceivers.remove( route.sourceId, slot );
+}
+
+//------------------------------------------------------------------------------
+// Deliver a message to all other user message classes whose filters can match.
 // Note, there is only a single UserMessageSignal class instance
-void UserMessageSignal::sendMessage( QString msg,
-                                     message_types type,
-                                     unsigned int formId,
-                                     unsigned int sourceId,
-                                     UserMessage* originator )
+int UserMessageSignal::sendMessage( QString msg,
+                                    message_types type,
+                                    unsigned int formId,
+                                    unsigned int sourceId,
+                                    UserMessage* originator )
+{
+    if( userMessageSignalIsDestroyed ) return 0;
+
+    QMap<quint64, QPointer<UserMessageSlot> > directReceivers;   // ordered by subscription
+    int deliveries = 0;
+
+    {
+        QMutexLocker locker( &mutex );
+
+        // Find the candidate receivers
+        QSet<UserMessageSlot*> candidates;
+        if( routingIsEnabled() )
+        {
+            candidates = anyReceivers;
+            const QList<UserMessageSlot*> formList = formReceivers.values( formId );
+            for( int j = 0; j < formList.count(); j++ ) candidates.insert( formList.value( j ) );
+            const QList<UserMessageSlot*> sourceList = sourceReceivers.values( sourceId );
+            for( int j = 0; j < sourceList.count(); j++ ) candidates.insert( sourceList.value( j ) );
+        }
+        else
+        {
+            const QList<UserMessageSlot*> all = routes.keys();
+            for( int j = 0; j < all.count(); j++ ) candidates.insert( all.value( j ) );
+        }
+        if( originator ) candidates.remove( &originator->userMessageSlot );   // ignore our own messages
+
+        // Queue messages to receivers belonging to other threads now, while
+        // the mutex ensures the receivers cannot be destroyed.
+        QThread* currentThread = QThread::currentThread();
+        QSet<UserMessageSlot*>::const_iterator it;
+        for( it = candidates.constBegin(); it != candidates.constEnd(); ++it )
+        {
+            UserMessageSlot* slot = *it;
+            if( slot->thread() == currentThread )
+            {
+                directReceivers.insert( routes.value( slot ).serial, QPointer<UserMessageSlot>( slot ) );
+            }
+            else
+            {
+                QMetaObject::invokeMethod( slot, "message", Qt::QueuedConnection,
+                                           Q_ARG( QString, msg ),
+                                           Q_ARG( message_types, type ),
+                                           Q_ARG( unsigned int, formId ),
+                                           Q_ARG( unsigned int, sourceId ),
+                                           Q_ARG( UserMessage*, originator ) );
+            }
+        }
+
+        deliveries = candidates.count();
+        messageCount++;
+        deliveryCount += deliveries;
+        lastDeliveries = deliveries;
+        maxDeliveries = qMax( maxDeliveries, deliveries );
+    }
+
+    // Deliver to the receivers in this thread in subscription order, as per the
+    // previous signal/slot connection order. A receiver may be destroyed while
+    // handling an earlier message, hence the guarded pointers.
+    QMap<quint64, QPointer<UserMessageSlot> >::const_iterator dit;
+    for( dit = directReceivers.constBegin(); dit != directReceivers.constEnd(); ++dit )
+    {
+        UserMessageSlot* slot = dit.value().data();
+        if( slot )
+        {
+            slot->message( msg, type, formId, sourceId, originator );
+        }
+    }
+
+    return deliveries;
+}
+
+//------------------------------------------------------------------------------
+// Diagnostics
+QString UserMessageSignal::statistics()
+{
+    if( userMessageSignalIsDestroyed ) return "";
+
+    QMutexLocker locker( &mutex );
+
+    const double average = messageCount > 0 ? double( deliveryCount ) / double( messageCount ) : 0.0;
+
+    QString result;
+    result.append( QString( "subscribers:        %1\n" ).arg( routes.count() ) );
+    result.append( QString( "any subscribers:    %1\n" ).arg( anyReceivers.count() ) );
+    result.append( QString( "form subscribers:   %1\n" ).arg( formReceivers.count() ) );
+    result.append( QString( "source subscribers: %1\n" ).arg( sourceReceivers.count() ) );
+    result.append( QString( "messages:           %1\n" ).arg( messageCount ) );
+    result.append( QString( "deliveries:         %1\n" ).arg( deliveryCount ) );
+    result.append( QString( "last deliveries:    %1\n" ).arg( lastDeliveries ) );
+    result.append( QString( "max deliveries:     %1\n" ).arg( maxDeliveries ) );
+    result.append( QString( "mean deliveries:    %1\n" ).arg( average, 0, 'f', 1 ) );
+    return result;
+}
+
+//------------------------------------------------------------------------------
+// static
+QString UserMessage::messageStatistics()
+{
+    return userMessageSignal.statistics();
+}
+
+//------------------------------------------------------------------------------
+// static
+void UserMessage::dumpMessageStatistics()
 {
-    emit message( msg, type, formId, sourceId, originator );
+    const QStringList lines = UserMessage::messageStatistics().split( "\n" );
+    for( int j = 0; j < lines.count(); j++ )
+    {
+        if( lines.value( j ).isEmpty() ) continue;
+        DEBUG << lines.value( j ).toStdString().c_str();   // drop quotes
+    }
 }
 
 //------------------------------------------------------------------------------
-// Receive a signal from another message class
+// Receive a message from another message class
 // Note, there is a UserMessageSlot for every UserMessage class instance
 void UserMessageSlot::message( QString msg,
                                message_types type,
@@ -252,9 +473,9 @@ void UserMessageSlot::message( QString msg,
 // In summarey if this function is called, there is no re implementation by a derived class, so signals can be disconnected.
 void UserMessage::newMessage( QString, message_types )
 {
-    // Disconnect. If this default implementation of useMessage is called, no derived class is interested in messages
-    QObject::disconnect( &userMessageSignal, SIGNAL( message( QString, message_types, unsigned int, unsigned int, UserMessage* ) ),
-                         &userMessageSlot,   SLOT(   message( QString, message_types, unsigned int, unsigned int, UserMessage* ) ) );
+    // Unsubscribe. If this default implementation of useMessage is called, no derived class is interested in messages
+    messagesCancelled = true;
+    userMessageSignal.unsubscribe( &userMessageSlot );
 }
 
 // end
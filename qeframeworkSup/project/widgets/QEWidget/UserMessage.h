@@ -14,8 +14,12 @@
 #ifndef QE_USER_MESSAGE_H
 #define QE_USER_MESSAGE_H
 
+#include <QHash>
 #include <QMetaType>
+#include <QMultiHash>
+#include <QMutex>
 #include <QObject>
+#include <QSet>
 #include <QEEnums.h>
 #include <QEFrameworkLibraryGlobal.h>
 #include <QtDebug>
@@ -59,30 +63,67 @@ Q_DECLARE_METATYPE (message_types)
 
 
 class UserMessage;
+class UserMessageSlot;
 
-/// Class used to send message signals.
+/// Class used to route messages.
 /// Used only within UserMessage.cpp
 /// A single instance of this class is shared by all instances of
-/// the UserMessage class. This allows every UserMessage class instance to
-/// connect to a single source of messages
+/// the UserMessage class. Rather than broadcasting every message to every
+/// UserMessage class instance, each instance's UserMessageSlot is subscribed in
+/// a routing table keyed by the form ID and source ID that its filters match on.
+/// A message is only delivered to those instances whose filters can match,
+/// i.e. instances with an 'any' filter, or a 'match' filter for the message's
+/// form ID or source ID.
+/// As per an auto connection, a message is delivered directly to receivers
+/// that belong to the sending thread, and is queued for other receivers.
 ///
-class UserMessageSignal : public QObject
+/// The routing may be disabled, i.e. all messages delivered to all subscribers,
+/// by defining the QE_DISABLE_MESSAGE_ROUTING environment variable, or equivalent
+/// adaptation parameter, as true.
+///
+class UserMessageSignal
 {
-    Q_OBJECT
-
 public:
-    void sendMessage( QString msg,
-                      message_types type,
-                      unsigned int formId,
-                      unsigned int sourceId,
-                      UserMessage* originator );    ///< Send a message to all widgets based on the UserMessage class
+    explicit UserMessageSignal();
+    ~UserMessageSignal();
 
-signals:
-    void message( QString msg,
-                  message_types type,
-                  unsigned int formId,
-                  unsigned int sourceId,
-                  UserMessage* originator );        ///< Emit a message signal. Any widget based on the UserMessage class can recieve these messages, filtered on formId and sourceId
+    int sendMessage( QString msg,
+                     message_types type,
+                     unsigned int formId,
+                     unsigned int sourceId,
+                     UserMessage* originator );    ///< Send a message to all widgets based on the UserMessage class whose filters can match. Returns the number of deliveries
+
+    void subscribe( UserMessageSlot* slot );      ///< Add or update the slot's route according to its owner's current ID and filter settings
+    void unsubscribe( UserMessageSlot* slot );    ///< Remove the slot's route, no further messages delivered
+
+    QString statistics();                         ///< Diagnostics - number of subscribers, messages and deliveries
+
+private:
+    static bool routingIsEnabled();
+
+    struct Route {
+        quint64 serial;          // subscription order - used to preserve delivery order
+        bool any;                // filters match any form ID or source ID
+        bool matchForm;          // filter matches on formId
+        unsigned int formId;
+        bool matchSource;        // filter matches on sourceId
+        unsigned int sourceId;
+    };
+
+    void removeRoute( UserMessageSlot* slot );    // Note: caller must hold the mutex
+
+    QMutex mutex;
+    QHash<UserMessageSlot*, Route> routes;                     // All subscribers
+    QSet<UserMessageSlot*> anyReceivers;                       // Subscribers matching any message
+    QMultiHash<unsigned int, UserMessageSlot*> formReceivers;   // Form ID => matching subscribers
+    QMultiHash<unsigned int, UserMessageSlot*> sourceReceivers; // Source ID => matching subscribers
+    quint64 nextSerial;
+
+    // Delivery counters
+    quint64 messageCount;
+    quint64 deliveryCount;
+    int lastDeliveries;
+    int maxDeliveries;
 };
 
 /// Class used to receive message signals.
@@ -102,6 +143,7 @@ public:
 //    ~UserMessageSlot(){}
 
     void setOwner( UserMessage* ownerIn ){ owner = ownerIn; }   ///< Set the UserMessage class this is a part of
+    UserMessage* getOwner() const { return owner; }             ///< Get the UserMessage class this is a part of
 
 public slots:
     void message( QString msg,
@@ -133,7 +175,9 @@ private:
  * this unique form ID to all widgets within the form using the ContainerProfile class.
  *
  * Messages sent by a QE widget are received by all QE widgets and can filter the messages
- * required by form ID and source ID.
+ * required by form ID and source ID. (Internally messages are only routed to those
+ * widgets whose filters can match, so the cost of a message does not depend on the
+ * total number of QE widgets.)
  * The form ID is under the management of the QEForm widget, the source ID is under
  * the control of the GUI designer.
  *
@@ -194,6 +238,9 @@ public:
 
     virtual void newMessage( QString, message_types );          ///< Virtual function to pass messages to derived classes (typicaly logging widgets or application windows)
 
+    static QString messageStatistics();                         ///< Diagnostics - number of subscribers, messages and deliveries per message
+    static void dumpMessageStatistics();                        ///< Diagnostics - debug output of messageStatistics()
+
 
 private:
     static UserMessageSignal userMessageSignal;                 // Single object to send all message signals
@@ -205,6 +252,9 @@ private:
     unsigned int childFormId;                                   // Only relevent for form (QEForm) widgets. Form ID of all child widgets
     QE::MessageFilterOptions formFilter;                          // Message filtering to apply to form ID
     QE::MessageFilterOptions sourceFilter;                        // Message filtering to apply to source ID
+    bool messagesCancelled;                                     // No derived class is interested in messages
+
+    void updateRoute();                                         // Update message routing after an ID or filter change
 };
 
 #endif // QE_USER_MESSAGE_H
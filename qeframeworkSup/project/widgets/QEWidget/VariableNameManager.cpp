@@ -22,7 +22,6 @@
 #include "VariableNameManager.h"
 #include <ContainerProfile.h>
 #include <QDebug>
-#include <macroSubstitution.h>
 
 #define DEBUG qDebug () << "VariableNameManager" << __LINE__ << __FUNCTION__ << "  "
 
@@ -114,6 +113,7 @@ void VariableNameManager::
 setVariableNameSubstitutionsOverride (const QString& macroSubstitutionsOverrideIn)
 {
    this->macroSubstitutionsOverride = macroSubstitutionsOverrideIn;
+   this->compileSubstitutions ();
 }
 
 //------------------------------------------------------------------------------
@@ -143,6 +143,20 @@ void VariableNameManager::setVariableName (const QString& variableName,
 void VariableNameManager::setVariableNameSubstitutions (const QString& macroSubstitutionsIn)
 {
    this->macroSubstitutions = macroSubstitutionsIn;
+   this->compileSubstitutions ();
+}
+
+//------------------------------------------------------------------------------
+// Generate a list where each item in the list is a single substitution
+// in the form MACRO1=VALUE1. The override substitutions are first and so
+// take precedence.
+//
+void VariableNameManager::compileSubstitutions ()
+{
+   QString subs;
+   subs.append (this->macroSubstitutionsOverride).append (",").append (this->macroSubstitutions);
+
+   this->compiledSubstitutions = macroSubstitutionList (subs);
 }
 
 //------------------------------------------------------------------------------
@@ -168,19 +182,8 @@ QString VariableNameManager::doSubstitution (unsigned int variableIndex) const
 //
 QString VariableNameManager::substituteThis (const QString& string) const
 {
-   // Generate a list where each item in the list is a single substitution
-   // in the form MACRO1=VALUE1.
-   //
-   QString subs;
-   subs.append (this->macroSubstitutionsOverride).append (",").append (this->macroSubstitutions);
-
-   //!!! for efficiency, should this be done when substitutions are added or removed??
-   //!!! Build a list of keys and values...
-   // Parse the substitutions
-   macroSubstitutionList parts = macroSubstitutionList (subs);
-
    // return the string with substitutions applied.
-   return parts.substitute (string);
+   return this->compiledSubstitutions.substitute (string);
 }
 
 // end
@@ -17,6 +17,7 @@
 #include <QString>
 #include <QStringList>
 #include <QEFrameworkLibraryGlobal.h>
+#include <macroSubstitution.h>
 
 class QE_FRAMEWORK_LIBRARY_SHARED_EXPORT VariableNameManager {
 public:
@@ -52,9 +53,14 @@ public:
 
 private:
    QString doSubstitution (unsigned int variableIndex) const;
+   void compileSubstitutions ();
 
    QString macroSubstitutions;
    QString macroSubstitutionsOverride;
+
+   // The combined override and default substitutions, parsed and compiled
+   // when either is set rather than for each substitution.
+   macroSubstitutionList compiledSubstitutions;
    QStringList variableNames;
 };
 
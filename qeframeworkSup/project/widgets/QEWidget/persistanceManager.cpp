@@ -109,11 +109,13 @@
  */
 
 #include <persistanceManager.h>
+#include <algorithm>
 #include <QDebug>
 #include <QFile>
 #include <QByteArray>
 #include <QBuffer>
 #include <QMessageBox>
+#include <QXmlStreamReader>
 #include <QEWidget.h>
 
 //------------------------------------------------------------------------------
@@ -147,6 +149,8 @@ public:
 
 QString PersistanceManager::defaultName("Default");
 
+QHash<QString, PersistanceManager::ConfigIndex> PersistanceManager::indexCache;
+
 
 //==============================================================================
 // PersistanceManager class methods
@@ -156,6 +160,8 @@ PersistanceManager::PersistanceManager()
 {
    // Initialise
    restoring = false;
+   saveIndexIsValid = false;
+   saveIndex.rootEnd = -1;
    doc = QDomDocument( "QEConfig" );
 }
 
@@ -165,76 +171,47 @@ PersistanceManager::~PersistanceManager() { }
 
 //------------------------------------------------------------------------------
 // Save the current configuration - set up
+// Only the configuration being saved is built as a DOM. Any other configurations
+// within the file are left untouched as text, see saveEpilog.
 //
 void PersistanceManager::saveProlog( const QString fileName,
                                      const QString rootName,
                                      const QString configName,
                                      const bool warnUser )
 {
-   // Try to read the configuration file we are saving to
-   // If OK, remove the configuration we are overwriting if present.
-   if( openRead( fileName, rootName, false, warnUser ) )
-   {
-      // Get the 'Config' elements
-      QDomNodeList configNodes = docElem.elementsByTagName( "Config" );
-      QDomElement oldConfig;
+   // Try to read and index the configuration file we are saving to.
+   // If this fails, a new file will be created.
+   saveIndexIsValid = readIndex( saveIndex, fileName, rootName, false, warnUser );
 
-      // Look for the configuration with a name matching what we want to save
-      int i;
-      for( i = 0; i < configNodes.count(); i++ )
+   // If a matching name was found and interacting with the user, check it is OK to overwrite
+   if( saveIndexIsValid && saveIndex.positions.contains( configName ) && warnUser )
+   {
+      // Saving will overwrite previous configuration, check with the user this is OK
+      QMessageBox msgBox;
+      msgBox.setText( "A previous configuration will be overwritten. Do you want to continue?" );
+      msgBox.setStandardButtons(QMessageBox::Yes | QMessageBox::No | QMessageBox::Cancel);
+      msgBox.setDefaultButton(QMessageBox::Cancel);
+      switch ( msgBox.exec() )
       {
-         oldConfig = configNodes.at(i).toElement();
-         if( oldConfig.attribute( "Name" ) == configName )
-         {
-            // A matching config name has been found
+         case QMessageBox::Yes:
+            // Yes, continue
             break;
-         }
-      }
 
-      // If a matching name was found...
-      if( i < configNodes.count() )
-      {
-         // If interacting with the user, check it is OK to overwrite
-         if( warnUser )
-         {
-            // Saving will overwrite previous configuration, check with the user this is OK
-            QMessageBox msgBox;
-            msgBox.setText( "A previous configuration will be overwritten. Do you want to continue?" );
-            msgBox.setStandardButtons(QMessageBox::Yes | QMessageBox::No | QMessageBox::Cancel);
-            msgBox.setDefaultButton(QMessageBox::Cancel);
-            switch ( msgBox.exec() )
-            {
-               case QMessageBox::Yes:
-                  // Yes, continue
-                  break;
-
-               case QMessageBox::No:
-               case QMessageBox::Cancel:
-               default:
-                  // No, do nothing
-                  return;
-            }
-         }
-
-         // Remove the old configuration
-         docElem.removeChild( oldConfig );
+         case QMessageBox::No:
+         case QMessageBox::Cancel:
+         default:
+            // No, do nothing - a null config is not saved by saveEpilog
+            doc = QDomDocument( "QEConfig" );
+            config = QDomElement();
+            return;
       }
    }
 
-   // Couldn't read the configuration file, create a new document
-   else
-   {
-      doc.clear();
-      docElem = doc.createElement( rootName );
-   }
-
-   // Add the root to the document
-   doc.appendChild( docElem );
-
-   // Add the configuration name
+   // Create the configuration to be saved
+   doc = QDomDocument( "QEConfig" );
    config = doc.createElement( "Config" );
    config.setAttribute( "Name", configName );
-   docElem.appendChild( config );
+   doc.appendChild( config );
 }
 
 //------------------------------------------------------------------------------
@@ -296,31 +273,44 @@ bool PersistanceManager::saveWidget( QEWidget* qewidget, const QString fileName,
 
 //------------------------------------------------------------------------------
 // Save the current configuration - tidy up
+// The new configuration replaces just the text of the previous configuration of
+// the same name (if any), otherwise it is added at the end of the root element.
+//
 void PersistanceManager::saveEpilog( const QString fileName, const bool warnUser )
 {
-   QFile file( fileName );
-
-   // Write the configuration file
-   if ( file.open( QIODevice::WriteOnly ) )
+   // Save declined by the user?
+   if( config.isNull() )
    {
-      QTextStream ts( &file );
-      ts << doc.toString() ;
-      file.close();
+      return;
    }
 
-   // Handle not writing configuration file
+   const QString image = configImage();
+   QString text;
+
+   const int i = saveIndexIsValid ? saveIndex.positions.value( config.attribute( "Name" ), -1 ) : -1;
+   if( i >= 0 )
+   {
+      // Replace the existing configuration
+      const int start = saveIndex.starts.value( i );
+      const int end = saveIndex.ends.value( i );
+      text = saveIndex.text.left( start ) + image + saveIndex.text.mid( end );
+   }
+   else if( saveIndexIsValid && saveIndex.rootEnd >= 0 )
+   {
+      // Add the new configuration before the root end tag
+      const int rootEnd = saveIndex.rootEnd;
+      text = saveIndex.text.left( rootEnd ) + image + "\n" + saveIndex.text.mid( rootEnd );
+   }
    else
    {
-      QString message = QString( "Could not save configuration. Could not open configuration file ").append( fileName );
-      if( warnUser )
-      {
-         QMessageBox::warning( 0, "Configuration management", message );
-      }
-      else
-      {
-         qDebug() << "Configuration management: " << message;
-      }
+      // No usable file, or empty root element - create a new file
+      text = QString( "<!DOCTYPE QEConfig>\n<%1>\n%2\n</%1>\n" )
+            .arg( saveIndex.rootName ).arg( image );
    }
+
+   writeFile( fileName, text,
+              "Could not save configuration. Could not open configuration file ",
+              warnUser );
 }
 
 //------------------------------------------------------------------------------
@@ -336,12 +326,13 @@ void PersistanceManager::restore( const QString fileName,
    //
    if( lockFile.tryLock( 50 ) ) {
 
-      if( !openRead( fileName, rootName, true, true ) )
+      ConfigIndex index;
+      if( !readIndex( index, fileName, rootName, true, true ) )
       {
          return;
       }
 
-      config = getElement( docElem, "Config", "Name", configName );
+      selectConfig( index, configName );
 
       // Notify any interested objects to collect their persistant data
       restoring = true;
@@ -371,11 +362,12 @@ bool PersistanceManager::restoreWidget( QEWidget* qewidget, const QString fileNa
       return false;
    }
 
-   if( !openRead( fileName, rootName, true, true ) ){
+   ConfigIndex index;
+   if( !readIndex( index, fileName, rootName, true, true ) ){
       return false;
    }
 
-   config = getElement( docElem, "Config", "Name", configName );
+   selectConfig( index, configName );
 
    // Request object restore its persistant data - assume okay for now.
    restoring = true;
@@ -394,10 +386,17 @@ bool PersistanceManager::isRestoring() const
 }
 
 //------------------------------------------------------------------------------
-// Open and read the configuration file
-bool PersistanceManager::openRead( const QString fileName, const QString rootName,
-                                   const bool fileExpected, const bool warnUser )
+// Read and index the configuration file.
+// The file is scanned using a QXmlStreamReader. No DOM is built, and the content
+// of each top level Config element is skipped over, just noting its location.
+bool PersistanceManager::readIndex( ConfigIndex& index,
+                                    const QString fileName, const QString rootName,
+                                    const bool fileExpected, const bool warnUser )
 {
+   index = ConfigIndex();
+   index.rootName = rootName;
+   index.rootEnd = -1;
+
    QFile file( fileName );
    if (!file.open(QIODevice::ReadOnly))
    {
@@ -416,40 +415,206 @@ bool PersistanceManager::openRead( const QString fileName, const QString rootNam
       return false;
    }
 
-   if ( !doc.setContent( &file ) )
+   index.text = QString::fromUtf8( file.readAll() );
+   file.close();
+
+   // Re-use the previous index if the file content is unchanged.
+   // Comparing the text is much cheaper than re-scanning the XML.
+   if( indexCache.contains( fileName ) )
    {
-      QString message = QString( "Could not parse the XML in the config file: ").append( fileName );
+      const ConfigIndex& cached = indexCache[ fileName ];
+      if( cached.rootName == rootName && cached.text == index.text )
+      {
+         index = cached;
+         return true;
+      }
+      indexCache.remove( fileName );
+   }
+
+   QXmlStreamReader reader( index.text );
+   int depth = 0;
+   bool rootOkay = true;
+
+   while( !reader.atEnd() && rootOkay )
+   {
+      reader.readNext();
+
+      if( reader.isStartElement() )
+      {
+         depth++;
+         if( depth == 1 )
+         {
+            rootOkay = ( reader.name() == rootName );
+         }
+         else if( depth == 2 && reader.name() == QLatin1String( "Config" ) )
+         {
+            // The offset is just past the start tag. Attribute values may not
+            // contain a '<', so the last '<' is the start of this start tag.
+            const int start = index.text.lastIndexOf( QChar( '<' ), int( reader.characterOffset() ) - 1 );
+            const QString name = reader.attributes().value( QLatin1String( "Name" ) ).toString();
+
+            reader.skipCurrentElement();
+            depth--;
+
+            if( !index.positions.contains( name ) )
+            {
+               index.positions.insert( name, index.names.count() );
+            }
+            index.names.append( name );
+            index.starts.append( start );
+            index.ends.append( int( reader.characterOffset() ) );
+         }
+      }
+      else if( reader.isEndElement() )
+      {
+         if( depth == 1 )
+         {
+            // Note where new configurations may be inserted. This is not
+            // possible when the root element is an empty element tag.
+            const int start = index.text.lastIndexOf( QChar( '<' ), int( reader.characterOffset() ) - 1 );
+            if( index.text.mid( start, 2 ) == "</" )
+            {
+               index.rootEnd = start;
+            }
+         }
+         depth--;
+      }
+   }
+
+   if( !rootOkay )
+   {
+      QString message = QString( "XML did not contain the expected root element " ).append( rootName ).append( " in the config file: ").append( fileName );
       if( warnUser )
       {
          QMessageBox::warning( 0, "Configuration management", message );
       }
       else
       {
-         qDebug() << "Configuration management: " << message ;
+         qDebug() << "Configuration management: " << message;
       }
-      file.close();
       return false;
    }
-   file.close();
 
-   docElem = doc.documentElement();
-
-   if( docElem.nodeName().compare( rootName ) )
+   if( reader.hasError() || depth != 0 )
    {
-      QString message = QString( "XML did not contain the expected root element " ).append( rootName ).append( " in the config file: ").append( fileName );
+      QString message = QString( "Could not parse the XML in the config file: ").append( fileName );
       if( warnUser )
       {
          QMessageBox::warning( 0, "Configuration management", message );
       }
       else
       {
-         qDebug() << "Configuration management: " << message;
+         qDebug() << "Configuration management: " << message ;
       }
       return false;
    }
+
+   indexCache.insert( fileName, index );
    return true;
 }
 
+//------------------------------------------------------------------------------
+// Parse just the named configuration, if it exists, into the document.
+void PersistanceManager::selectConfig( const ConfigIndex& index, const QString configName )
+{
+   doc = QDomDocument( "QEConfig" );
+   config = QDomElement();
+
+   const int i = index.positions.value( configName, -1 );
+   if( i < 0 )
+   {
+      return;
+   }
+
+   const int start = index.starts.value( i );
+   const int end = index.ends.value( i );
+   if( doc.setContent( index.text.mid( start, end - start ) ) )
+   {
+      config = doc.documentElement();
+   }
+   else
+   {
+      qDebug() << "Configuration management: could not parse configuration" << configName;
+   }
+}
+
+//------------------------------------------------------------------------------
+// Serialise the current configuration
+QString PersistanceManager::configImage() const
+{
+   QString image;
+   QXmlStreamWriter writer( &image );
+   writer.setAutoFormatting( true );
+   writer.setAutoFormattingIndent( 1 );   // as per QDomDocument::toString()
+   writeElement( writer, config );
+   return image;
+}
+
+//------------------------------------------------------------------------------
+// Write an element, and recursively its content
+void PersistanceManager::writeElement( QXmlStreamWriter& writer, const QDomElement& element ) const
+{
+   writer.writeStartElement( element.tagName() );
+
+   const QDomNamedNodeMap attributes = element.attributes();
+   for( int i = 0; i < attributes.count(); i++ )
+   {
+      const QDomAttr attribute = attributes.item( i ).toAttr();
+      writer.writeAttribute( attribute.name(), attribute.value() );
+   }
+
+   for( QDomNode node = element.firstChild(); !node.isNull(); node = node.nextSibling() )
+   {
+      if( node.isElement() )
+      {
+         writeElement( writer, node.toElement() );
+      }
+      else if( node.isCDATASection() )
+      {
+         writer.writeCDATA( node.toCDATASection().data() );
+      }
+      else if( node.isText() )
+      {
+         writer.writeCharacters( node.toText().data() );
+      }
+      else if( node.isComment() )
+      {
+         writer.writeComment( node.toComment().data() );
+      }
+   }
+
+   writer.writeEndElement();
+}
+
+//------------------------------------------------------------------------------
+// Write the configuration file
+bool PersistanceManager::writeFile( const QString fileName, const QString& text,
+                                    const QString& failMessage, const bool warnUser )
+{
+   // Whatever the outcome, any cached index of the file is now stale
+   indexCache.remove( fileName );
+
+   QFile file( fileName );
+   if ( file.open( QIODevice::WriteOnly ) )
+   {
+      file.write( text.toUtf8() );
+      file.close();
+      return true;
+   }
+
+   // Handle not writing configuration file
+   QString message = QString( failMessage ).append( fileName );
+   if( warnUser )
+   {
+      QMessageBox::warning( 0, "Configuration management", message );
+   }
+   else
+   {
+      qDebug() << "Configuration management: " << message;
+   }
+   return false;
+}
+
 //------------------------------------------------------------------------------
 // Add a named configuration. Used during a save signal. The returned element is then loaded with configuration data
 PMElement PersistanceManager::addNamedConfiguration( QString name )
@@ -457,6 +622,12 @@ PMElement PersistanceManager::addNamedConfiguration( QString name )
    QDomElement element = doc.createElement( CONFIG_COMPONENT_KEY );
    element.setAttribute( "Name", name );
    config.appendChild( element );
+
+   // Keep the component index, if any, up to date
+   if( !config.isNull() && indexedConfig == config && !componentIndex.contains( name ) )
+   {
+      componentIndex.insert( name, element );
+   }
    return PMElement( this, element );
 }
 
@@ -465,8 +636,27 @@ PMElement PersistanceManager::addNamedConfiguration( QString name )
 // The returned element contains the configuration data
 PMElement PersistanceManager::getNamedConfiguration( QString name )
 {
-   QDomElement element = getElement( config, CONFIG_COMPONENT_KEY, "Name", name );
-   return PMElement( this, element );
+   // Index the components of the current configuration when first needed, rather
+   // than searching all the components for each of the many restoring widgets.
+   if( indexedConfig != config )
+   {
+      componentIndex.clear();
+      QDomNodeList list = getElementList( config, CONFIG_COMPONENT_KEY );
+      for( int i = 0; i < list.count(); i++ )
+      {
+         QDomElement element = list.at( i ).toElement();
+         if( element.isNull() || !element.hasAttribute( "Name" ) ) continue;
+
+         const QString elementName = element.attribute( "Name" );
+         if( !componentIndex.contains( elementName ) )
+         {
+            componentIndex.insert( elementName, element );
+         }
+      }
+      indexedConfig = config;
+   }
+
+   return PMElement( this, componentIndex.value( name ) );
 }
 
 //------------------------------------------------------------------------------
@@ -496,15 +686,15 @@ QStringList PersistanceManager::getConfigNames( QString fileName, QString rootNa
    QStringList nameList;
 
    // Return the empty list if can't read file
-   if( !openRead( fileName, rootName, false, true ) )
+   ConfigIndex index;
+   if( !readIndex( index, fileName, rootName, false, true ) )
    {
       return nameList;
    }
 
-   QDomNodeList nodeList = docElem.elementsByTagName( "Config" );
-   for( int i = 0; i < nodeList.count(); i++ )
+   for( int i = 0; i < index.names.count(); i++ )
    {
-      QString configName = nodeList.at(i).toElement().attribute( "Name" );
+      QString configName = index.names.at( i );
       if( !configName.isEmpty() )
       {
          if(  configName == PersistanceManager::defaultName )
@@ -556,44 +746,49 @@ void PersistanceManager::deleteConfigs( const QString fileName, const QString ro
       }
    }
 
-   // Try to read the configuration file we are saving to
-   // If OK, remove the configuration we are overwriting if present.
-   if( openRead( fileName, rootName, true, warnUser ) )
+   // Try to read the configuration file we are deleting from.
+   // If OK, remove the text of each of the configurations being deleted.
+   ConfigIndex index;
+   if( !readIndex( index, fileName, rootName, true, warnUser ) )
+   {
+      return;
+   }
+
+   QList<int> removeList;
+   for( int i = 0; i < names.count(); i++ )
    {
-      QDomNodeList nodeList = docElem.elementsByTagName( "Config" );
-      for( int i = 0; i < names.count(); i++ )
+      const int j = index.positions.value( names[i], -1 );
+      if( j >= 0 && !removeList.contains( j ) )
       {
-         for( int j = 0; j < nodeList.count(); j++ )
-         {
-            if( nodeList.at(j).toElement().attribute( "Name" ) == names[i] )
-            {
-               docElem.removeChild( nodeList.at( j ));
-               break;
-            }
-         }
+         removeList.append( j );
       }
    }
 
-   // Recreate the file
-   QFile file( fileName );
-   if ( file.open( QIODevice::WriteOnly ) )
+   if( removeList.isEmpty() )
    {
-      QTextStream ts( &file );
-      ts << doc.toString() ;
-      file.close();
+      return;   // nothing to do
    }
-   else
+
+   // Remove from the end of the file backwards so that the remaining offsets stay valid
+   std::sort( removeList.begin(), removeList.end() );
+   QString text = index.text;
+   for( int k = removeList.count() - 1; k >= 0; k-- )
    {
-      QString message = QString( "Could not save remaining configurations to configuration file ").append( fileName );
-      if( warnUser )
-      {
-         QMessageBox::warning( 0, "Configuration management", message );
-      }
-      else
-      {
-         qDebug() << "Configuration management: " << message;
-      }
+      const int j = removeList.value( k );
+      int start = index.starts.value( j );
+      int end = index.ends.value( j );
+
+      // Tidy up - also remove the indentation and line feed
+      while( start > 0 && ( text.at( start - 1 ) == QChar( ' ' ) || text.at( start - 1 ) == QChar( '\t' ) ) ) start--;
+      if( end < text.length() && text.at( end ) == QChar( '\n' ) ) end++;
+
+      text.remove( start, end - start );
    }
+
+   // Recreate the file
+   writeFile( fileName, text,
+              "Could not save remaining configurations to configuration file ",
+              warnUser );
 }
 
 //------------------------------------------------------------------------------
@@ -26,6 +26,7 @@
 #include <QObject>
 #include <QColor>
 #include <QHash>
+#include <QList>
 #include <QStringList>
 #include <QXmlStreamWriter>
 #include <QEFrameworkLibraryGlobal.h>
@@ -203,7 +204,26 @@ private:
    void saveProlog( const QString fileName, const QString rootName, const QString configName, const bool warnUser );   // common save/saveWidget functionality
    void saveEpilog( const QString fileName, const bool warnUser );                                                     // common save/saveWidget functionality
 
-   bool openRead( const QString fileName, const QString rootName, const bool fileExpected, const bool warnUser );     // Open and read the configuration file. fileExpected is true if the file must be present
+   // Index of the top level Config elements within a configuration file. Only the
+   // Config element being restored is parsed into a DOM, and a save replaces only
+   // the text of the Config element being saved.
+   struct ConfigIndex {
+      QString rootName;                // root element name used when indexed
+      QString text;                    // the file content
+      QStringList names;               // Config names in file order
+      QList<int> starts;               // character offset of each <Config ...>
+      QList<int> ends;                 // character offset following each </Config>
+      QHash<QString, int> positions;   // Config name => first matching index
+      int rootEnd;                     // character offset of the root end tag, or -1
+   };
+
+   bool readIndex( ConfigIndex& index, const QString fileName, const QString rootName,
+                   const bool fileExpected, const bool warnUser );        // Read and index the configuration file. fileExpected is true if the file must be present
+   void selectConfig( const ConfigIndex& index, const QString configName );   // Parse just the named config, if it exists, into doc/config
+   QString configImage() const;                                           // Serialise the current config
+   void writeElement( QXmlStreamWriter& writer, const QDomElement& element ) const;
+   bool writeFile( const QString fileName, const QString& text,
+                   const QString& failMessage, const bool warnUser );     // Write configuration file, warning of any failure
 
    PMElement addElement( QDomElement parent, QString name );               // Add an element, return the new added element
 
@@ -241,10 +261,16 @@ private:
    bool restoring;                     // True if a restore is in progress
    SaveRestoreSignal signal;           // Save/Restore signal object. One instance to signal all QE Widgets and applications
 
-   QDomDocument doc;                   // Save and restore xml document
+   QDomDocument doc;                   // Save and restore xml document - current configuration only
    QDomElement config;                 // Current configuration
 
-   QDomElement docElem;                // Configuration document
+   ConfigIndex saveIndex;              // Index of the file being saved to
+   bool saveIndexIsValid;              // The file being saved to was successfully read and indexed
+
+   QDomElement indexedConfig;                        // The config componentIndex refers to
+   QHash<QString, QDomElement> componentIndex;       // Component name => first matching component element
+
+   static QHash<QString, ConfigIndex> indexCache;    // File name => last index of that file
 
    friend class QEWidget;
 };